@@ -184,9 +184,9 @@ int CMP_CDECL CompressBlockBC2( unsigned char *srcBlock,
     }
 
     CMP_BC15Options *BC15options = (CMP_BC15Options *)options;
+    CMP_BC15Options BC15optionsDefault;
     if (BC15options == NULL)
     {
-        CMP_BC15Options BC15optionsDefault;
         BC15options = &BC15optionsDefault;
         SetDefaultBC15Options(BC15options);
     }
@@ -198,9 +198,9 @@ int CMP_CDECL DecompressBlockBC2( unsigned char cmpBlock[16],
                               CMP_GLOBAL unsigned char srcBlock[64],
                               void *options = NULL) {
     CMP_BC15Options *BC15options = (CMP_BC15Options *)options;
+    CMP_BC15Options BC15optionsDefault;
     if (BC15options == NULL)
     {
-        CMP_BC15Options BC15optionsDefault;
         BC15options = &BC15optionsDefault;
         SetDefaultBC15Options(BC15options);
     }
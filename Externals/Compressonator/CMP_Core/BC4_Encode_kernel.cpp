@@ -135,8 +135,8 @@ int CMP_CDECL CompressBlockBC4(unsigned char *srcBlock,
     }
 
     CMP_BC15Options *BC15options = (CMP_BC15Options *)options;
+    CMP_BC15Options BC15optionsDefault;
     if (BC15options == NULL) {
-      CMP_BC15Options BC15optionsDefault;
       BC15options = &BC15optionsDefault;
       SetDefaultBC15Options(BC15options);
     }
@@ -149,9 +149,9 @@ int CMP_CDECL DecompressBlockBC4(unsigned char cmpBlock[8],
                             CMP_GLOBAL unsigned char srcBlock[16],
                             void *options = NULL) {
     CMP_BC15Options *BC15options = (CMP_BC15Options *)options;
+    CMP_BC15Options BC15optionsDefault;
     if (BC15options == NULL)
     {
-        CMP_BC15Options BC15optionsDefault;
         BC15options = &BC15optionsDefault;
         SetDefaultBC15Options(BC15options);
     }
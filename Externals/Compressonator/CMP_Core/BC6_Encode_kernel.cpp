@@ -3803,7 +3803,7 @@ int CMP_CDECL CreateOptionsBC6(void **options)
 {
     (*options) = new BC6H_Encode;
     if (!options) return CGU_CORE_ERR_NEWMEM;
-    SetDefaultBC6Options((BC6H_Encode *)options);
+    SetDefaultBC6Options((BC6H_Encode *)(*options));
     return CGU_CORE_OK;
 }
 
@@ -3864,9 +3864,9 @@ int CMP_CDECL CompressBlockBC6(CGU_UINT16 *srcBlock,
 
     BC6H_Encode *BC6HEncode = (BC6H_Encode *)options;
 
+    BC6H_Encode BC6HEncodeDefault;
     if (BC6HEncode == NULL)
     {
-        BC6H_Encode BC6HEncodeDefault;
         BC6HEncode = &BC6HEncodeDefault;
         SetDefaultBC6Options(BC6HEncode);
     }
@@ -3891,9 +3891,9 @@ int  CMP_CDECL DecompressBlockBC6(unsigned char cmpBlock[16],
                             void *options = NULL) {
     BC6H_Encode *BC6HEncode = (BC6H_Encode *)options;
 
+    BC6H_Encode BC6HEncodeDefault;
     if (BC6HEncode == NULL)
     {
-        BC6H_Encode BC6HEncodeDefault;
         BC6HEncode = &BC6HEncodeDefault;
         SetDefaultBC6Options(BC6HEncode);
     }
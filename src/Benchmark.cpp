@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+
+#include "Graphics/Texture.h"
+#include "Graphics/TextureUtils.h"
+
+#include "Core/Array.h"
+
+#include "Math/Math.h"
+
+#include <stdio.h>
+#include <stdlib.h> // atoi/qsort
+#include <string.h> // strcmp/memcpy
+#include <math.h> // sinf/cosf
+#include <chrono> // steady_clock
+#include <omp.h>
+
+namespace Benchmark
+{
+	using namespace Graphics;
+
+	// Smooth RGBA32F gradients with a fine checker, same pixels on every run
+	static bool CreatePattern(int iSize, Texture* pOutTexture)
+	{
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = PixelFormatEnum::RGBA32_FLOAT;
+		oDesc.iWidth = iSize;
+		oDesc.iHeight = iSize;
+		if (pOutTexture->Create(oDesc) != ErrorCode::Ok)
+			return false;
+
+		const Texture::TextureFaceData& oFaceData = pOutTexture->GetData().GetFaceData(0, 0);
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+		for (int iY = 0; iY < iSize; ++iY)
+		{
+			float* pLine = (float*)((char*)oFaceData.pData + (size_t)iY * oFaceData.iPitch);
+			for (int iX = 0; iX < iSize; ++iX)
+			{
+				const float fU = (float)iX / iSize;
+				const float fV = (float)iY / iSize;
+				pLine[iX * 4 + 0] = 0.5f + 0.4f * sinf(9.f * fU) * cosf(7.f * fV);
+				pLine[iX * 4 + 1] = 0.5f + 0.3f * cosf(13.f * fU * fV);
+				pLine[iX * 4 + 2] = ((iX / 3 + iY / 5) & 1) ? 0.8f : 0.3f;
+				pLine[iX * 4 + 3] = 1.f - 0.5f * fU;
+			}
+		}
+		return true;
+	}
+
+	static int CompareTimes(const void* pA, const void* pB)
+	{
+		const double fA = *(const double*)pA;
+		const double fB = *(const double*)pB;
+		return (fA < fB) ? -1 : ((fA > fB) ? 1 : 0);
+	}
+
+	// Full chain of the mip reduction engine
+	static ErrorCode GenerateReducedMips(const Texture& oTexture, Texture* pOutTexture)
+	{
+		return GenerateMips(&oTexture, pOutTexture, false);
+	}
+
+	// Full chain of the separable resampler with a box filter, each level is resized from the previous one
+	// and copied in a full chain texture, so both chains pay the same allocation and mip 0 copy
+	static ErrorCode GenerateResampledMips(const Texture& oTexture, Texture* pOutTexture)
+	{
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = oTexture.GetPixelFormat();
+		oDesc.iWidth = oTexture.GetWidth();
+		oDesc.iHeight = oTexture.GetHeight();
+		oDesc.iMipCount = 1;
+		for (int iSize = Math::Max(oDesc.iWidth, oDesc.iHeight); iSize > 1; iSize /= 2)
+			++oDesc.iMipCount;
+
+		Texture oChain;
+		ErrorCode oErr = oChain.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+		memcpy(oChain.GetData().GetFaceData(0, 0).pData, oTexture.GetData().GetFaceData(0, 0).pData, oTexture.GetData().GetFaceData(0, 0).iSlicePitch);
+
+		Texture oLevel, oNextLevel;
+		const Texture* pLevel = &oTexture;
+		for (int iMip = 1; iMip < oDesc.iMipCount; ++iMip)
+		{
+			oErr = ResizeTexture(pLevel, &oNextLevel, Math::Max(pLevel->GetWidth() / 2, 1), Math::Max(pLevel->GetHeight() / 2, 1), ResampleFilterEnum::BOX);
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+			oLevel.Swap(oNextLevel);
+			pLevel = &oLevel;
+			memcpy(oChain.GetData().GetFaceData(iMip, 0).pData, oLevel.GetData().GetFaceData(0, 0).pData, oLevel.GetData().GetFaceData(0, 0).iSlicePitch);
+		}
+		pOutTexture->Swap(oChain);
+		return ErrorCode::Ok;
+	}
+
+	typedef ErrorCode (*MipChainFunc)(const Texture& oTexture, Texture* pOutTexture);
+
+	// Print the best and median time of the full mip chain of a texture
+	static bool BenchmarkMips(const Texture& oTexture, MipChainFunc pMipChainFunc, const char* pName, int iRunCount)
+	{
+		Core::Array<double> oTimes;
+		if (oTimes.resize(iRunCount) == false)
+			return false;
+
+		Texture oMips;
+		for (int iRun = 0; iRun < iRunCount; ++iRun)
+		{
+			// Previous chain is released outside of the timing, only one output is resident
+			oMips.Destroy() == ErrorCode::Ok;
+			const std::chrono::steady_clock::time_point oStartTime = std::chrono::steady_clock::now();
+			ErrorCode oErr = pMipChainFunc(oTexture, &oMips);
+			oTimes[iRun] = std::chrono::duration<double>(std::chrono::steady_clock::now() - oStartTime).count();
+			if (oErr != ErrorCode::Ok)
+			{
+				printf("%-12s %-10s : FAILED (%s)\n", PixelFormatEnumInfos[oTexture.GetPixelFormat()].pShortName, pName, oErr.ToString());
+				return false;
+			}
+		}
+		qsort(&oTimes[0], (size_t)iRunCount, sizeof(double), CompareTimes);
+
+		// Throughput counts the pixels read, all levels but the last one
+		double fPixels = 0.0;
+		for (int iMip = 0; iMip < oMips.GetMipCount() - 1; ++iMip)
+		{
+			const Texture::TextureFaceData& oFaceData = oMips.GetData().GetFaceData(iMip, 0);
+			fPixels += (double)oFaceData.iWidth * oFaceData.iHeight;
+		}
+
+		printf("%-12s %-10s : %2d mips, best %9.2f ms, median %9.2f ms, %8.1f MPixels/s\n",
+			PixelFormatEnumInfos[oTexture.GetPixelFormat()].pShortName, pName, oMips.GetMipCount(),
+			oTimes[0] * 1000.0, oTimes[iRunCount / 2] * 1000.0, fPixels / oTimes[0] / 1000000.0);
+		return true;
+	}
+
+	int Run(int iArgCount, char** pArgs)
+	{
+		int iSize = 8192;
+		int iRunCount = 5;
+		bool bGeneric = true;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--size") == 0 && (iArg + 1) < iArgCount)
+			{
+				iSize = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--runs") == 0 && (iArg + 1) < iArgCount)
+			{
+				iRunCount = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--no-generic") == 0)
+			{
+				bGeneric = false;
+			}
+			else
+			{
+				fprintf(stderr, "Unknown benchmark argument '%s'\n", pArgs[iArg]);
+				return 1;
+			}
+		}
+
+		if (iSize < 2 || iRunCount < 1)
+		{
+			fprintf(stderr, "Invalid benchmark size or run count\n");
+			return 1;
+		}
+
+		int iThreadCount;
+#ifndef DEBUG
+		iThreadCount = omp_get_max_threads();
+#else
+		iThreadCount = 1;
+#endif
+		printf("Mip chains of %dx%d textures, %d runs, %d threads\n", iSize, iSize, iRunCount, iThreadCount);
+
+		const PixelFormatEnum c_eFormats[] = { PixelFormatEnum::RGBA8_UNORM, PixelFormatEnum::RGBA8_UNORM_SRGB, PixelFormatEnum::RGBA32_FLOAT };
+		const int c_iFormatCount = (int)(sizeof(c_eFormats) / sizeof(c_eFormats[0]));
+
+		Texture oPattern;
+		if (CreatePattern(iSize, &oPattern) == false)
+		{
+			fprintf(stderr, "Can't create %dx%d texture\n", iSize, iSize);
+			return 1;
+		}
+
+		int iFailed = 0;
+		for (int iFormat = 0; iFormat < c_iFormatCount; ++iFormat)
+		{
+			// Pattern is moved to the last format instead of copied, it is only needed by the previous ones
+			Texture oTexture;
+			const bool bLast = iFormat == c_iFormatCount - 1;
+			if (c_eFormats[iFormat] == oPattern.GetPixelFormat() && bLast)
+			{
+				oTexture.Swap(oPattern);
+			}
+			else if (ConvertPixelFormat(&oPattern, &oTexture, c_eFormats[iFormat]) != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't convert to %s\n", PixelFormatEnumInfos[c_eFormats[iFormat]].pName);
+				++iFailed;
+				continue;
+			}
+
+			if (BenchmarkMips(oTexture, GenerateReducedMips, "Reduction", iRunCount) == false)
+				++iFailed;
+			if (bGeneric && BenchmarkMips(oTexture, GenerateResampledMips, "Resampler", iRunCount) == false)
+				++iFailed;
+		}
+
+		return iFailed == 0 ? 0 : 1;
+	}
+}
+//namespace Benchmark
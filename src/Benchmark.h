@@ -0,0 +1,15 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+/* Timings of texture operations on generated textures, run by Texeled --benchmark
+Textures only depend on the size, so timings of two builds or two machines can be compared.
+Thread count is the OpenMP one (OMP_NUM_THREADS).
+*/
+namespace Benchmark
+{
+	// Return the process exit code
+	int							Run(int iArgCount, char** pArgs);
+}
+//namespace Benchmark
+
+#endif //__BENCHMARK_H__
@@ -0,0 +1,1220 @@
+#include "CommandLine.h"
+#include "SelfTest.h"
+#include "Benchmark.h"
+
+#include "Graphics/Texture.h"
+#include "Graphics/TextureLoader.h"
+#include "Graphics/TextureWriter.h"
+#include "Graphics/TextureUtils.h"
+#include "Graphics/SphericalHarmonics.h"
+#include "Graphics/TextureCompare.h"
+#include "Graphics/BlockCompression.h"
+#include "Graphics/ConversionCache.h"
+#include "Graphics/TextureFingerprint.h"
+#include "Graphics/TextureAtlas.h"
+#include "Graphics/TiledTexture.h"
+
+#include "Graphics/TextureLoaders/TextureLoaderSTBI.h"
+#include "Graphics/TextureLoaders/TextureLoaderDDS.h"
+#include "Graphics/TextureLoaders/TextureLoaderEXR.h"
+#include "Graphics/TextureLoaders/TextureLoaderKTX.h"
+
+#include "Graphics/TextureWriters/TextureWriterDDS.h"
+#include "Graphics/TextureWriters/TextureWriterPNG.h"
+#include "Graphics/TextureWriters/TextureWriterEXR.h"
+
+#include "Core/FileStream.h"
+#include "Core/StringUtils.h"
+
+#include <stdio.h>
+#include <stdlib.h> // atoi
+#include <string.h> // strcmp
+
+namespace CommandLine
+{
+	static void PrintUsage()
+	{
+		fprintf(stderr,
+			"Usage :\n"
+			"  Texeled [files]\n"
+			"  Texeled --sh9 [--size N] [--irradiance] <file>\n"
+			"    Print the 9 RGB spherical harmonics coefficients of a cubemap or a LatLong texture\n"
+			"    --size N       Use the first mip with a face size lower or equal to N\n"
+			"    --irradiance   Convolve with the cosine lobe, coefficients give irradiance / pi\n"
+			"  Texeled --prefilter-ggx [--samples N] [--mips N] <input> <output>\n"
+			"    Write the GGX prefiltered radiance mips of a cubemap (RGBA 32 float)\n"
+			"    --samples N    Importance samples per texel (64)\n"
+			"    --mips N       Output levels, roughness of level i is i / (N - 1) (full chain)\n"
+			"  Texeled --compare [--no-ssim] [--heatmap <file>] <reference> <file>\n"
+			"    Print RMSE, PSNR, SSIM and max error of each channel for each mip/face/layer and for the whole texture\n"
+			"    --no-ssim      Skip SSIM\n"
+			"    --heatmap F    Write the largest absolute error of each pixel (R 32 float, DDS or EXR)\n"
+			"  Texeled --compress <format> [--quality Q] [--high-quality Q] [--threshold T] [--max-reencoded F] [--error-map <file>] [--cache <dir>] <input> <output>\n"
+			"    Encode to a BC format (BC1 to BC7, 'BC7 sRGB', ...) and print the block errors\n"
+			"    --quality Q        Quality of the first encode (0.05)\n"
+			"    --high-quality Q   Quality of the blocks encoded again, BC6H and BC7 only (0.8)\n"
+			"    --threshold T      Block RMSE above which a block is encoded again, negative to disable (0.002)\n"
+			"    --max-reencoded F  Fraction of the blocks encoded again at most (0.5)\n"
+			"    --error-map F      Write the RMSE of the block of each pixel (R 32 float, DDS or EXR)\n"
+			"  Texeled --convert <format> [--mips] [--filter F] [--quality Q] [--region X Y W H] [--mip N] <input> <output>\n"
+			"    Convert to a pixel format (RGBA8, 'RGBA8 sRGB', RGBA32F, BC7, ...), BC formats are encoded as --compress\n"
+			"    --mips         Generate the full mip chain before converting\n"
+			"    --filter F     Mip filter : Default, Box, Triangle, Kaiser, Lanczos3, Mitchell\n"
+			"    --quality Q    Quality of the first encode of BC formats (0.05)\n"
+			"    --region X Y W H  Only convert this rectangle, snapped to blocks of BC formats\n"
+			"    --mip N        Only convert this mip (0)\n"
+			"  Texeled --tiled-mips [--tile-size N] [--memory MB] <input.dds> <output.dds>\n"
+			"    Generate the full mip chain of a 2D or cubemap DDS larger than memory, tiles are kept in scratch files\n"
+			"    --tile-size N  Tile width and height in pixels (256)\n"
+			"    --memory MB    Memory used by the tile caches (512)\n"
+			"  Texeled --duplicates [--distance N] [--list <file>] <files or @file>...\n"
+			"    Find textures with identical pixels (any file format, with or without mips) and near duplicates\n"
+			"    --distance N   Bits that may differ between perceptual hashes of near duplicates (6)\n"
+			"    --list F       Write path, size, format, exact and perceptual hashes of each texture (tab separated)\n"
+			"    @F             Read paths from F, one per line\n"
+			"  Texeled --atlas [--format F] [--max-size N] [--padding N] [--pot] [--no-mips] <output> <manifest> <files or @file>...\n"
+			"    Pack 2D textures in one texture with mips and write the pixel rect and UVs of each texture (tab separated)\n"
+			"    --format F     Uncompressed pixel format of the atlas (RGBA8)\n"
+			"    --max-size N   Largest width and height (4096)\n"
+			"    --padding N    Edge pixels replicated around each texture, 2^N keeps N mips from bleeding (4)\n"
+			"    --pot          Power of two size, otherwise cropped to the packed textures\n"
+			"    --no-mips      Only the first mip\n"
+			"  Texeled --self-test\n"
+			"    Check texture operations against reference implementations, print one line per check\n"
+			"  Texeled --benchmark [--size N] [--runs N] [--no-generic]\n"
+			"    Time full mip chains of generated RGBA8, RGBA8 sRGB and RGBA32F textures, threads are set by OMP_NUM_THREADS\n"
+			"    --size N       Width and height of mip 0 (8192)\n"
+			"    --runs N       Runs of each chain, best and median times are printed (5)\n"
+			"    --no-generic   Skip the reference chains of the box filter of the separable resampler\n"
+			"  Cache options of --compress and --convert :\n"
+			"    --cache DIR         Reuse outputs stored in the existing directory DIR for identical pixels and parameters\n"
+			"    --cache-size MB     Evict least recently used outputs above MB megabytes (1024, 0 for no limit)\n"
+			"    --cache-entries N   Evict least recently used outputs above N outputs (0 for no limit)\n");
+	}
+
+	static void RegisterLoaders()
+	{
+		Graphics::TextureLoader::RegisterLoaderSTBI();
+		Graphics::TextureLoader::RegisterLoaderDDS();
+		Graphics::TextureLoader::RegisterLoaderEXR();
+		Graphics::TextureLoader::RegisterLoaderKTX();
+	}
+
+	static void RegisterWriters()
+	{
+		Graphics::TextureWriter::RegisterWriterDDS();
+		Graphics::TextureWriter::RegisterWriterPNG();
+		Graphics::TextureWriter::RegisterWriterEXR();
+	}
+
+	static bool LoadTexture(const char* pFilename, Graphics::Texture* pOutTexture)
+	{
+		ErrorCode oErr = Graphics::LoadFromFile(pOutTexture, pFilename);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't load '%s' : %s\n", pFilename, oErr.ToString());
+			return false;
+		}
+		return true;
+	}
+
+	// Load a texture, cross and strip layouts are converted to cubemaps, LatLong textures when bConvertLatLong
+	// Only for commands expecting cubemaps, other 2D textures of these sizes would be reshaped
+	static bool LoadCubemap(const char* pFilename, bool bConvertLatLong, Graphics::Texture* pOutTexture)
+	{
+		if (LoadTexture(pFilename, pOutTexture) == false)
+			return false;
+
+		Graphics::ECubemapFormat eFormat;
+		if (pOutTexture->GetFaceCount() == 1 && pOutTexture->IsArray() == false && pOutTexture->IsVolume() == false
+			&& Graphics::DetermineCubemapFormatFromImageSize(pOutTexture->GetWidth(), pOutTexture->GetHeight(), &eFormat, NULL)
+			&& (eFormat != Graphics::E_CUBEMAPFORMAT_LATLONG || bConvertLatLong))
+		{
+			Graphics::Texture oCubemap;
+			if (Graphics::ConvertTextureToCubemap(*pOutTexture, &oCubemap) == ErrorCode::Ok)
+			{
+				pOutTexture->Swap(oCubemap);
+			}
+		}
+		return true;
+	}
+
+	// Bump when encoders or writers change to invalidate cached outputs
+	static const uint64_t c_iCacheVersion = 2;
+
+	struct CacheOptions
+	{
+		CacheOptions()
+			: pDirectory(NULL)
+			, iMaxSize(1024ULL * 1024 * 1024)
+			, iMaxEntryCount(0)
+		{
+		}
+		const char*				pDirectory;
+		uint64_t				iMaxSize;
+		int						iMaxEntryCount;
+	};
+
+	// Parse a cache option at pArgs[*pArg], false when it is not a cache option
+	static bool ParseCacheOption(int iArgCount, char** pArgs, int* pArg, CacheOptions* pOptions)
+	{
+		int iArg = *pArg;
+		if ((iArg + 1) >= iArgCount)
+			return false;
+		if (strcmp(pArgs[iArg], "--cache") == 0)
+			pOptions->pDirectory = pArgs[iArg + 1];
+		else if (strcmp(pArgs[iArg], "--cache-size") == 0)
+			pOptions->iMaxSize = (uint64_t)(atof(pArgs[iArg + 1]) * 1024.0 * 1024.0);
+		else if (strcmp(pArgs[iArg], "--cache-entries") == 0)
+			pOptions->iMaxEntryCount = atoi(pArgs[iArg + 1]);
+		else
+			return false;
+		*pArg = iArg + 1;
+		return true;
+	}
+
+	static Graphics::PixelFormatEnum FindPixelFormat(const char* pShortName, bool bCompressedOnly)
+	{
+		for (int iFormat = 0; iFormat < Graphics::PixelFormatEnum::_COUNT; ++iFormat)
+		{
+			if ((bCompressedOnly == false || Graphics::PixelFormat::IsCompressed((Graphics::PixelFormatEnum)iFormat))
+				&& Graphics::PixelFormatEnumInfos[iFormat].pShortName != NULL
+				&& strcmp(pShortName, Graphics::PixelFormatEnumInfos[iFormat].pShortName) == 0)
+			{
+				return (Graphics::PixelFormatEnum)iFormat;
+			}
+		}
+		return Graphics::PixelFormatEnum::_NONE;
+	}
+
+	// Key of an output, oHasher has been fed the conversion parameters, the writer depends on the output extension
+	static uint64_t ComputeCacheKey(Core::Hasher64& oHasher, const Graphics::Texture& oTexture, const char* pOutputFilename)
+	{
+		const char* pExtension = strrchr(pOutputFilename, '.');
+		if (pExtension != NULL)
+			oHasher.Update(pExtension, strlen(pExtension));
+		Graphics::HashTexture(&oTexture, &oHasher);
+		return oHasher.Finalize();
+	}
+
+	// True when the output has been copied from the cache
+	static bool FetchFromCache(Graphics::ConversionCache* pCache, const CacheOptions& oOptions, uint64_t iKey, const char* pOutputFilename)
+	{
+		ErrorCode oErr = pCache->Open(oOptions.pDirectory, oOptions.iMaxSize, oOptions.iMaxEntryCount);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't open cache '%s' : %s\n", oOptions.pDirectory, oErr.ToString());
+			return false;
+		}
+		if (pCache->Fetch(iKey, pOutputFilename) == false)
+			return false;
+
+		printf("Cached output %016llx\n", (unsigned long long)iKey);
+		oErr = pCache->Close();
+		if (oErr != ErrorCode::Ok)
+			fprintf(stderr, "Can't write cache index : %s\n", oErr.ToString());
+		return true;
+	}
+
+	// A cache failure only costs the next run a conversion, it doesn't fail the command
+	static void StoreInCache(Graphics::ConversionCache* pCache, uint64_t iKey, const char* pOutputFilename)
+	{
+		if (pCache->IsOpen() == false)
+			return;
+
+		ErrorCode oErr = pCache->Store(iKey, pOutputFilename);
+		if (oErr != ErrorCode::Ok)
+			fprintf(stderr, "Can't store in cache : %s\n", oErr.ToString());
+
+		oErr = pCache->Close();
+		if (oErr != ErrorCode::Ok)
+			fprintf(stderr, "Can't write cache index : %s\n", oErr.ToString());
+	}
+
+	static int RunSH9(int iArgCount, char** pArgs)
+	{
+		Graphics::SHSettings oSettings;
+		const char* pFilename = NULL;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--size") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.iMaxFaceSize = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--irradiance") == 0)
+			{
+				oSettings.bIrradiance = true;
+			}
+			else if (pArgs[iArg][0] != '-' && pFilename == NULL)
+			{
+				pFilename = pArgs[iArg];
+			}
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+
+		if (pFilename == NULL)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		RegisterLoaders();
+
+		Graphics::Texture oTexture;
+		if (LoadCubemap(pFilename, false, &oTexture) == false)
+		{
+			return 1;
+		}
+
+		Graphics::SH9 oSH;
+		ErrorCode oErr = Graphics::ProjectSH9(&oTexture, &oSH, &oSettings);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't project '%s' : %s\n", pFilename, oErr.ToString());
+			return 1;
+		}
+
+		for (int iCoef = 0; iCoef < 9; ++iCoef)
+		{
+			printf("%s: %.9g %.9g %.9g\n", Graphics::SH9CoefficientNames[iCoef], oSH.fCoefficients[iCoef][0], oSH.fCoefficients[iCoef][1], oSH.fCoefficients[iCoef][2]);
+		}
+		return 0;
+	}
+
+	static int RunPrefilterGGX(int iArgCount, char** pArgs)
+	{
+		Graphics::SpecularFilterSettings oSettings;
+		const char* pFilenames[2] = { NULL, NULL };
+		int iFilenameCount = 0;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--samples") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.iSampleCount = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--mips") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.iMipCount = atoi(pArgs[++iArg]);
+			}
+			else if (pArgs[iArg][0] != '-' && iFilenameCount < 2)
+			{
+				pFilenames[iFilenameCount++] = pArgs[iArg];
+			}
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+
+		if (iFilenameCount != 2)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		RegisterLoaders();
+		RegisterWriters();
+
+		Graphics::Texture oTexture;
+		if (LoadCubemap(pFilenames[0], true, &oTexture) == false)
+		{
+			return 1;
+		}
+
+		double fTexelsPerSecond = 0.0;
+		ErrorCode oErr = Graphics::PrefilterSpecularCubemap(oTexture, &oTexture, &oSettings, &fTexelsPerSecond);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't prefilter '%s' : %s\n", pFilenames[0], oErr.ToString());
+			return 1;
+		}
+		printf("%d mips, %d samples, %.2f Mtexels/s\n", oTexture.GetMipCount(), oSettings.iSampleCount, fTexelsPerSecond * 1e-6);
+
+		oErr = Graphics::SaveToFile(&oTexture, NULL, pFilenames[1]);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't save '%s' : %s\n", pFilenames[1], oErr.ToString());
+			return 1;
+		}
+		return 0;
+	}
+
+	// Maps are written as R 32 float, check the writer of the extension before computing them
+	static bool CheckMapWriter(const char* pFilename)
+	{
+		const Graphics::TextureWriterInfo* pWriter = Graphics::FindTextureWriter(pFilename);
+		if (pWriter == NULL)
+		{
+			fprintf(stderr, "Can't save '%s' : Extension not supported\n", pFilename);
+			return false;
+		}
+
+		Graphics::Texture oMap;
+		Graphics::Texture::Desc oDesc;
+		oDesc.ePixelFormat = Graphics::PixelFormatEnum::R32_FLOAT;
+		oDesc.iWidth = 1;
+		oDesc.iHeight = 1;
+		if (oMap.Create(oDesc) != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't save '%s' : Can't create map\n", pFilename);
+			return false;
+		}
+		if (pWriter->pTester != NULL && pWriter->pTester(&oMap) == Graphics::E_SUPPORTED_WRITER_FALSE)
+		{
+			fprintf(stderr, "Can't save '%s' : %s writer doesn't support R 32 float maps\n", pFilename, pWriter->pName);
+			return false;
+		}
+		return true;
+	}
+
+	static void PrintComparison(const char* pName, const Graphics::ChannelComparison* pChannels, int iChannelCount, bool bSSIM)
+	{
+		const char* const c_pChannelNames = "RGBA";
+		for (int iChannel = 0; iChannel < iChannelCount; ++iChannel)
+		{
+			const Graphics::ChannelComparison& oChannel = pChannels[iChannel];
+			printf("%s %c: RMSE %.6f PSNR %.3f", pName, c_pChannelNames[iChannel], oChannel.fRMSE, oChannel.fPSNR);
+			if (bSSIM)
+				printf(" SSIM %.6f", oChannel.fSSIM);
+			printf(" max %.6f\n", oChannel.fMaxError);
+		}
+	}
+
+	static int RunCompare(int iArgCount, char** pArgs)
+	{
+		Graphics::CompareSettings oSettings;
+		const char* pHeatmapFilename = NULL;
+		const char* pFilenames[2] = { NULL, NULL };
+		int iFilenameCount = 0;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--no-ssim") == 0)
+			{
+				oSettings.bSSIM = false;
+			}
+			else if (strcmp(pArgs[iArg], "--heatmap") == 0 && (iArg + 1) < iArgCount)
+			{
+				pHeatmapFilename = pArgs[++iArg];
+			}
+			else if (pArgs[iArg][0] != '-' && iFilenameCount < 2)
+			{
+				pFilenames[iFilenameCount++] = pArgs[iArg];
+			}
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+
+		if (iFilenameCount != 2)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		RegisterLoaders();
+		if (pHeatmapFilename != NULL)
+		{
+			RegisterWriters();
+			if (CheckMapWriter(pHeatmapFilename) == false)
+				return 1;
+		}
+
+		Graphics::Texture oReference, oTexture;
+		if (LoadTexture(pFilenames[0], &oReference) == false || LoadTexture(pFilenames[1], &oTexture) == false)
+		{
+			return 1;
+		}
+
+		Graphics::TextureComparison oComparison;
+		Graphics::Texture oHeatmap;
+		ErrorCode oErr = Graphics::CompareTextures(&oReference, &oTexture, &oComparison, &oSettings, (pHeatmapFilename != NULL) ? &oHeatmap : NULL);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't compare '%s' and '%s' : %s\n", pFilenames[0], pFilenames[1], oErr.ToString());
+			return 1;
+		}
+
+		for (size_t iSubresource = 0; iSubresource < oComparison.oSubresources.size(); ++iSubresource)
+		{
+			const Graphics::SubresourceComparison& oSubresource = oComparison.oSubresources[iSubresource];
+			char pName[64];
+			sprintf_s(pName, sizeof(pName), "Mip %d face %d layer %d", oSubresource.iMip, oSubresource.iFace, oSubresource.iLayer);
+			PrintComparison(pName, oSubresource.oChannels, oComparison.iChannelCount, oSettings.bSSIM);
+		}
+		PrintComparison("Total", oComparison.oTotal, oComparison.iChannelCount, oSettings.bSSIM);
+
+		if (pHeatmapFilename != NULL)
+		{
+			oErr = Graphics::SaveToFile(&oHeatmap, NULL, pHeatmapFilename);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't save '%s' : %s\n", pHeatmapFilename, oErr.ToString());
+				return 1;
+			}
+		}
+		return 0;
+	}
+
+	static int RunCompress(int iArgCount, char** pArgs)
+	{
+		Graphics::BlockCompressionSettings oSettings;
+		Graphics::PixelFormatEnum eFormat = Graphics::PixelFormatEnum::_NONE;
+		const char* pErrorMapFilename = NULL;
+		CacheOptions oCacheOptions;
+		const char* pFilenames[2] = { NULL, NULL };
+		int iFilenameCount = 0;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--quality") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.fQuality = (float)atof(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--high-quality") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.fHighQuality = (float)atof(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--threshold") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.fErrorThreshold = (float)atof(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--max-reencoded") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.fMaxReencodedBlocks = (float)atof(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--error-map") == 0 && (iArg + 1) < iArgCount)
+			{
+				pErrorMapFilename = pArgs[++iArg];
+			}
+			else if (ParseCacheOption(iArgCount, pArgs, &iArg, &oCacheOptions))
+			{
+			}
+			else if (pArgs[iArg][0] != '-' && eFormat == Graphics::PixelFormatEnum::_NONE)
+			{
+				eFormat = FindPixelFormat(pArgs[iArg], true);
+				if (eFormat == Graphics::PixelFormatEnum::_NONE)
+				{
+					fprintf(stderr, "Unknown format '%s'\n", pArgs[iArg]);
+					return 1;
+				}
+			}
+			else if (pArgs[iArg][0] != '-' && iFilenameCount < 2)
+			{
+				pFilenames[iFilenameCount++] = pArgs[iArg];
+			}
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+
+		if (iFilenameCount != 2)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		RegisterLoaders();
+		RegisterWriters();
+
+		if (pErrorMapFilename != NULL && CheckMapWriter(pErrorMapFilename) == false)
+		{
+			return 1;
+		}
+
+		Graphics::Texture oTexture;
+		if (LoadTexture(pFilenames[0], &oTexture) == false)
+		{
+			return 1;
+		}
+
+		// The error map isn't cached, it needs the encode
+		Graphics::ConversionCache oCache;
+		uint64_t iCacheKey = 0;
+		if (oCacheOptions.pDirectory != NULL && pErrorMapFilename == NULL)
+		{
+			Core::Hasher64 oHasher(c_iCacheVersion);
+			oHasher.Update("compress", 8);
+			oHasher.Update(&eFormat, sizeof(eFormat));
+			oHasher.Update(&oSettings, sizeof(oSettings));
+			iCacheKey = ComputeCacheKey(oHasher, oTexture, pFilenames[1]);
+			if (FetchFromCache(&oCache, oCacheOptions, iCacheKey, pFilenames[1]))
+				return 0;
+		}
+
+		Graphics::BlockCompressionReport oReport;
+		Graphics::Texture oErrorMap;
+		ErrorCode oErr = Graphics::CompressTexture(&oTexture, &oTexture, eFormat, &oSettings, &oReport, (pErrorMapFilename != NULL) ? &oErrorMap : NULL);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't compress '%s' : %s\n", pFilenames[0], oErr.ToString());
+			return 1;
+		}
+		printf("%llu blocks, %llu encoded again, block RMSE %.6f max %.6f\n",
+			(unsigned long long)oReport.iBlockCount, (unsigned long long)oReport.iReencodedBlockCount, oReport.fRMSE, oReport.fMaxBlockError);
+
+		oErr = Graphics::SaveToFile(&oTexture, NULL, pFilenames[1]);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't save '%s' : %s\n", pFilenames[1], oErr.ToString());
+			return 1;
+		}
+		StoreInCache(&oCache, iCacheKey, pFilenames[1]);
+
+		if (pErrorMapFilename != NULL)
+		{
+			oErr = Graphics::SaveToFile(&oErrorMap, NULL, pErrorMapFilename);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't save '%s' : %s\n", pErrorMapFilename, oErr.ToString());
+				return 1;
+			}
+		}
+		return 0;
+	}
+
+	static int RunConvert(int iArgCount, char** pArgs)
+	{
+		Graphics::PixelFormatEnum eFormat = Graphics::PixelFormatEnum::_NONE;
+		bool bMips = false;
+		bool bRegion = false;
+		int iRegion[4] = { 0, 0, 0, 0 };
+		int iRegionMip = 0;
+		Graphics::MipSettings oMipSettings;
+		Graphics::BlockCompressionSettings oCompressionSettings;
+		CacheOptions oCacheOptions;
+		const char* pFilenames[2] = { NULL, NULL };
+		int iFilenameCount = 0;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--mips") == 0)
+			{
+				bMips = true;
+			}
+			else if (strcmp(pArgs[iArg], "--filter") == 0 && (iArg + 1) < iArgCount)
+			{
+				const char* pFilter = pArgs[++iArg];
+				int iFilter = 0;
+				while (iFilter < Graphics::ResampleFilterEnum::_COUNT && strcmp(pFilter, Graphics::ResampleFilterEnumStrings[iFilter]) != 0)
+					++iFilter;
+				if (iFilter == Graphics::ResampleFilterEnum::_COUNT)
+				{
+					fprintf(stderr, "Unknown filter '%s'\n", pFilter);
+					return 1;
+				}
+				oMipSettings.eFilter = (Graphics::ResampleFilterEnum)iFilter;
+			}
+			else if (strcmp(pArgs[iArg], "--quality") == 0 && (iArg + 1) < iArgCount)
+			{
+				oCompressionSettings.fQuality = (float)atof(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--region") == 0 && (iArg + 4) < iArgCount)
+			{
+				bRegion = true;
+				for (int iValue = 0; iValue < 4; ++iValue)
+					iRegion[iValue] = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--mip") == 0 && (iArg + 1) < iArgCount)
+			{
+				bRegion = true;
+				iRegionMip = atoi(pArgs[++iArg]);
+			}
+			else if (ParseCacheOption(iArgCount, pArgs, &iArg, &oCacheOptions))
+			{
+			}
+			else if (pArgs[iArg][0] != '-' && eFormat == Graphics::PixelFormatEnum::_NONE)
+			{
+				eFormat = FindPixelFormat(pArgs[iArg], false);
+				if (eFormat == Graphics::PixelFormatEnum::_NONE)
+				{
+					fprintf(stderr, "Unknown format '%s'\n", pArgs[iArg]);
+					return 1;
+				}
+			}
+			else if (pArgs[iArg][0] != '-' && iFilenameCount < 2)
+			{
+				pFilenames[iFilenameCount++] = pArgs[iArg];
+			}
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+
+		if (iFilenameCount != 2)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		RegisterLoaders();
+		RegisterWriters();
+
+		Graphics::Texture oTexture;
+		if (LoadTexture(pFilenames[0], &oTexture) == false)
+		{
+			return 1;
+		}
+
+		Graphics::ConversionCache oCache;
+		uint64_t iCacheKey = 0;
+		if (oCacheOptions.pDirectory != NULL)
+		{
+			Core::Hasher64 oHasher(c_iCacheVersion);
+			oHasher.Update("convert", 7);
+			oHasher.Update(&eFormat, sizeof(eFormat));
+			oHasher.Update(&bMips, sizeof(bMips));
+			if (bRegion)
+			{
+				oHasher.Update(iRegion, sizeof(iRegion));
+				oHasher.Update(&iRegionMip, sizeof(iRegionMip));
+			}
+			if (bMips)
+			{
+				oHasher.Update(&oMipSettings.eFilter, sizeof(oMipSettings.eFilter));
+				oHasher.Update(&oMipSettings.eEdgeMode, sizeof(oMipSettings.eEdgeMode));
+			}
+			if (Graphics::PixelFormat::IsCompressed(eFormat))
+				oHasher.Update(&oCompressionSettings, sizeof(oCompressionSettings));
+			iCacheKey = ComputeCacheKey(oHasher, oTexture, pFilenames[1]);
+			if (FetchFromCache(&oCache, oCacheOptions, iCacheKey, pFilenames[1]))
+				return 0;
+		}
+
+		if (bRegion)
+		{
+			Graphics::TextureView oView(&oTexture, iRegionMip);
+			if (iRegion[2] > 0 && iRegion[3] > 0)
+			{
+				oView.iX = iRegion[0];
+				oView.iY = iRegion[1];
+				oView.iWidth = iRegion[2];
+				oView.iHeight = iRegion[3];
+			}
+
+			// Without mips the region is converted straight from the texture, BC formats are encoded below with the quality settings
+			ErrorCode oErr = (bMips == false && eFormat != oTexture.GetPixelFormat() && Graphics::PixelFormat::IsCompressed(eFormat) == false)
+				? Graphics::ConvertPixelFormat(oView, &oTexture, eFormat)
+				: Graphics::CopyTextureView(oView, &oTexture);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't read region of '%s' : %s\n", pFilenames[0], oErr.ToString());
+				return 1;
+			}
+		}
+
+		if (bMips)
+		{
+			ErrorCode oErr = Graphics::GenerateMips(&oTexture, &oTexture, false, &oMipSettings);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't generate mips of '%s' : %s\n", pFilenames[0], oErr.ToString());
+				return 1;
+			}
+		}
+
+		if (eFormat != oTexture.GetPixelFormat())
+		{
+			ErrorCode oErr = Graphics::PixelFormat::IsCompressed(eFormat)
+				? Graphics::CompressTexture(&oTexture, &oTexture, eFormat, &oCompressionSettings)
+				: Graphics::ConvertPixelFormat(&oTexture, &oTexture, eFormat);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't convert '%s' : %s\n", pFilenames[0], oErr.ToString());
+				return 1;
+			}
+		}
+
+		ErrorCode oErr = Graphics::SaveToFile(&oTexture, NULL, pFilenames[1]);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't save '%s' : %s\n", pFilenames[1], oErr.ToString());
+			return 1;
+		}
+		StoreInCache(&oCache, iCacheKey, pFilenames[1]);
+		return 0;
+	}
+
+	// Out-of-core mip generation, only the tile caches of the two textures are kept in memory
+	static int RunTiledMips(int iArgCount, char** pArgs)
+	{
+		int iTileSize = Graphics::TiledTexture::c_iDefaultTileSize;
+		size_t iMemoryBudget = Graphics::TiledTexture::c_iDefaultMemoryBudget;
+		const char* pFilenames[2] = { NULL, NULL };
+		int iFilenameCount = 0;
+		for (int iArg = 0; iArg < iArgCount; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--tile-size") == 0 && (iArg + 1) < iArgCount)
+			{
+				iTileSize = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--memory") == 0 && (iArg + 1) < iArgCount)
+			{
+				iMemoryBudget = (size_t)atoi(pArgs[++iArg]) * 1024 * 1024;
+			}
+			else if (pArgs[iArg][0] != '-' && iFilenameCount < 2)
+			{
+				pFilenames[iFilenameCount++] = pArgs[iArg];
+			}
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+
+		if (iFilenameCount != 2 || iTileSize <= 0)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		// Budget is shared by the source and the output
+		Graphics::TiledTexture oTexture;
+		{
+			Core::FileStream oStream;
+			if (oStream.Open(pFilenames[0], Core::FileStream::AccessModeEnum::READ) == false)
+			{
+				fprintf(stderr, "Can't open '%s'\n", pFilenames[0]);
+				return 1;
+			}
+			ErrorCode oErr = Graphics::TextureLoader::LoadTiledDDS(&oStream, iTileSize, iMemoryBudget / 2, &oTexture);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't load '%s' : %s\n", pFilenames[0], oErr.ToString());
+				return 1;
+			}
+		}
+
+		Graphics::TiledTexture oMips;
+		ErrorCode oErr = Graphics::GenerateMips(&oTexture, &oMips, false);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't generate mips of '%s' : %s\n", pFilenames[0], oErr.ToString());
+			return 1;
+		}
+		oTexture.Destroy();
+
+		Core::FileStream oStream;
+		if (oStream.Open(pFilenames[1], Core::FileStream::AccessModeEnum::WRITE_SAFE) == false)
+		{
+			fprintf(stderr, "Can't open '%s'\n", pFilenames[1]);
+			return 1;
+		}
+		oErr = Graphics::TextureWriter::WriteTiledDDS(&oMips, &oStream);
+		if (oErr != ErrorCode::Ok)
+		{
+			oStream.Cancel();
+			fprintf(stderr, "Can't save '%s' : %s\n", pFilenames[1], oErr.ToString());
+			return 1;
+		}
+		if (oStream.Close() == false)
+		{
+			fprintf(stderr, "Can't write '%s'\n", pFilenames[1]);
+			return 1;
+		}
+		return 0;
+	}
+
+	struct FileFingerprint
+	{
+		Graphics::TextureFingerprint	oFingerprint;
+		int						iWidth;
+		int						iHeight;
+		Graphics::PixelFormatEnum	ePixelFormat;
+		bool					bValid;
+	};
+
+	// Add paths read from a file, one per line
+	static bool ReadPathList(const char* pListFilename, Core::Array<char*>* pPaths)
+	{
+		FILE* pFile = fopen(pListFilename, "r");
+		if (pFile == NULL)
+			return false;
+
+		char pLine[2048];
+		while (fgets(pLine, sizeof(pLine), pFile) != NULL)
+		{
+			size_t iLength = strlen(pLine);
+			while (iLength > 0 && (pLine[iLength - 1] == '\n' || pLine[iLength - 1] == '\r'))
+				pLine[--iLength] = 0;
+			if (iLength > 0)
+				pPaths->push_back(Core::StringUtils::StrDup(pLine));
+		}
+		fclose(pFile);
+		return true;
+	}
+
+	// Groups of more than one texture, oGroups and oExactGroups index oFiles
+	static void PrintGroups(const char* pTitle, const Core::Array<char*>& oPaths, const Core::Array<FileFingerprint>& oFingerprints, const Core::Array<int>& oFiles, const Core::Array<int>& oGroups, const Core::Array<int>& oExactGroups, bool bNearDuplicates)
+	{
+		// Link the members of each group in index order
+		const int iCount = (int)oFiles.size();
+		Core::Array<int> oNextMembers;
+		Core::Array<int> oFirstMembers;
+		if (oNextMembers.resize(iCount, false) == false || oFirstMembers.resize(iCount, false) == false)
+			return;
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			oFirstMembers[iIndex] = -1;
+		for (int iIndex = iCount - 1; iIndex >= 0; --iIndex)
+		{
+			oNextMembers[iIndex] = oFirstMembers[oGroups[iIndex]];
+			oFirstMembers[oGroups[iIndex]] = iIndex;
+		}
+
+		int iGroupCount = 0;
+		for (int iRoot = 0; iRoot < iCount; ++iRoot)
+		{
+			if (oGroups[iRoot] != iRoot || oNextMembers[iRoot] == -1)
+				continue;
+
+			// Near duplicates groups made of identical textures only were already printed
+			if (bNearDuplicates)
+			{
+				bool bAllIdentical = true;
+				for (int iMember = oNextMembers[iRoot]; iMember != -1 && bAllIdentical; iMember = oNextMembers[iMember])
+					bAllIdentical = oExactGroups[iMember] == oExactGroups[iRoot];
+				if (bAllIdentical)
+					continue;
+			}
+
+			if (iGroupCount++ == 0)
+				printf("%s :\n", pTitle);
+			else
+				printf("\n");
+			const FileFingerprint& oRoot = oFingerprints[oFiles[iRoot]];
+			for (int iMember = iRoot; iMember != -1; iMember = oNextMembers[iMember])
+			{
+				const FileFingerprint& oFile = oFingerprints[oFiles[iMember]];
+				const char* pFormat = Graphics::PixelFormatEnumInfos[oFile.ePixelFormat].pShortName;
+				if (bNearDuplicates && iMember != iRoot)
+					printf("  %s (%dx%d %s, %d bits)\n", oPaths[oFiles[iMember]], oFile.iWidth, oFile.iHeight, pFormat,
+						Graphics::HammingDistance(oFile.oFingerprint.iPerceptualHash, oRoot.oFingerprint.iPerceptualHash));
+				else
+					printf("  %s (%dx%d %s)\n", oPaths[oFiles[iMember]], oFile.iWidth, oFile.iHeight, pFormat);
+			}
+		}
+		if (iGroupCount > 0)
+			printf("\n");
+	}
+
+	static int RunDuplicates(int iArgCount, char** pArgs)
+	{
+		int iMaxDistance = 6;
+		const char* pListFilename = NULL;
+		Core::Array<char*> oPaths;
+		bool bUsage = false;
+		for (int iArg = 0; iArg < iArgCount && bUsage == false; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--distance") == 0 && (iArg + 1) < iArgCount)
+			{
+				iMaxDistance = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--list") == 0 && (iArg + 1) < iArgCount)
+			{
+				pListFilename = pArgs[++iArg];
+			}
+			else if (pArgs[iArg][0] == '@')
+			{
+				if (ReadPathList(pArgs[iArg] + 1, &oPaths) == false)
+				{
+					fprintf(stderr, "Can't read '%s'\n", pArgs[iArg] + 1);
+					bUsage = true;
+				}
+			}
+			else if (pArgs[iArg][0] != '-')
+			{
+				oPaths.push_back(Core::StringUtils::StrDup(pArgs[iArg]));
+			}
+			else
+			{
+				PrintUsage();
+				bUsage = true;
+			}
+		}
+
+		if (bUsage || oPaths.empty() || iMaxDistance < 0)
+		{
+			if (bUsage == false)
+				PrintUsage();
+			for (size_t iPath = 0; iPath < oPaths.size(); ++iPath)
+				free(oPaths[iPath]);
+			return 1;
+		}
+
+		RegisterLoaders();
+
+		// Each job holds one texture, memory is bounded by the thread count and the largest texture
+		const int iCount = (int)oPaths.size();
+		Core::Array<FileFingerprint> oFingerprints;
+		oFingerprints.resize(iCount, false);
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iFile = 0; iFile < iCount; ++iFile)
+		{
+			FileFingerprint& oFile = oFingerprints[iFile];
+			oFile.bValid = false;
+
+			Graphics::Texture oTexture;
+			ErrorCode oErr = Graphics::LoadFromFile(&oTexture, oPaths[iFile]);
+			if (oErr != ErrorCode::Ok)
+				continue;
+
+			oFile.iWidth = oTexture.GetWidth();
+			oFile.iHeight = oTexture.GetHeight();
+			oFile.ePixelFormat = oTexture.GetPixelFormat();
+			oErr = Graphics::ComputeTextureFingerprint(&oTexture, &oFile.oFingerprint);
+			oFile.bValid = oErr == ErrorCode::Ok;
+		}
+
+		// Only loaded textures are grouped
+		Core::Array<int> oValidFiles;
+		Core::Array<Graphics::TextureFingerprint> oValidFingerprints;
+		for (int iFile = 0; iFile < iCount; ++iFile)
+		{
+			if (oFingerprints[iFile].bValid)
+			{
+				oValidFiles.push_back(iFile);
+				oValidFingerprints.push_back(oFingerprints[iFile].oFingerprint);
+			}
+			else
+			{
+				fprintf(stderr, "Can't load '%s'\n", oPaths[iFile]);
+			}
+		}
+
+		Core::Array<int> oExactGroups;
+		Core::Array<int> oNearGroups;
+		ErrorCode oErr = Graphics::GroupExactDuplicates(oValidFingerprints.begin(), (int)oValidFingerprints.size(), &oExactGroups);
+		if (oErr == ErrorCode::Ok)
+			oErr = Graphics::GroupNearDuplicates(oValidFingerprints.begin(), (int)oValidFingerprints.size(), iMaxDistance, &oNearGroups);
+		if (oErr != ErrorCode::Ok)
+		{
+			fprintf(stderr, "Can't group textures : %s\n", oErr.ToString());
+		}
+		else
+		{
+			PrintGroups("Identical pixels", oPaths, oFingerprints, oValidFiles, oExactGroups, oExactGroups, false);
+			PrintGroups("Near duplicates", oPaths, oFingerprints, oValidFiles, oNearGroups, oExactGroups, true);
+			printf("%d textures, %d can't be loaded\n", (int)oValidFiles.size(), iCount - (int)oValidFiles.size());
+		}
+
+		bool bListError = false;
+		if (pListFilename != NULL && oErr == ErrorCode::Ok)
+		{
+			FILE* pList = fopen(pListFilename, "w");
+			if (pList != NULL)
+			{
+				for (int iFile = 0; iFile < iCount; ++iFile)
+				{
+					const FileFingerprint& oFile = oFingerprints[iFile];
+					if (oFile.bValid)
+					{
+						fprintf(pList, "%s\t%d\t%d\t%s\t%016llx\t%016llx\n", oPaths[iFile], oFile.iWidth, oFile.iHeight, Graphics::PixelFormatEnumInfos[oFile.ePixelFormat].pShortName,
+							(unsigned long long)oFile.oFingerprint.iExactHash, (unsigned long long)oFile.oFingerprint.iPerceptualHash);
+					}
+				}
+				fclose(pList);
+			}
+			else
+			{
+				fprintf(stderr, "Can't write '%s'\n", pListFilename);
+				bListError = true;
+			}
+		}
+
+		for (int iFile = 0; iFile < iCount; ++iFile)
+			free(oPaths[iFile]);
+		return (oErr == ErrorCode::Ok && bListError == false) ? 0 : 1;
+	}
+
+	static int RunAtlas(int iArgCount, char** pArgs)
+	{
+		Graphics::AtlasSettings oSettings;
+		const char* pFilenames[2] = { NULL, NULL };
+		int iFilenameCount = 0;
+		Core::Array<char*> oPaths;
+		bool bUsage = false;
+		for (int iArg = 0; iArg < iArgCount && bUsage == false; ++iArg)
+		{
+			if (strcmp(pArgs[iArg], "--max-size") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.iMaxSize = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--padding") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.iPadding = atoi(pArgs[++iArg]);
+			}
+			else if (strcmp(pArgs[iArg], "--format") == 0 && (iArg + 1) < iArgCount)
+			{
+				oSettings.ePixelFormat = FindPixelFormat(pArgs[++iArg], false);
+				if (oSettings.ePixelFormat == Graphics::PixelFormatEnum::_NONE)
+				{
+					fprintf(stderr, "Unknown format '%s'\n", pArgs[iArg]);
+					bUsage = true;
+				}
+			}
+			else if (strcmp(pArgs[iArg], "--no-mips") == 0)
+			{
+				oSettings.bMips = false;
+			}
+			else if (strcmp(pArgs[iArg], "--pot") == 0)
+			{
+				oSettings.bPowerOfTwo = true;
+			}
+			else if (pArgs[iArg][0] == '@' && iFilenameCount == 2)
+			{
+				if (ReadPathList(pArgs[iArg] + 1, &oPaths) == false)
+				{
+					fprintf(stderr, "Can't read '%s'\n", pArgs[iArg] + 1);
+					bUsage = true;
+				}
+			}
+			else if (pArgs[iArg][0] != '-' && iFilenameCount < 2)
+			{
+				pFilenames[iFilenameCount++] = pArgs[iArg];
+			}
+			else if (pArgs[iArg][0] != '-')
+			{
+				oPaths.push_back(Core::StringUtils::StrDup(pArgs[iArg]));
+			}
+			else
+			{
+				PrintUsage();
+				bUsage = true;
+			}
+		}
+
+		if (bUsage || oPaths.empty())
+		{
+			if (bUsage == false)
+				PrintUsage();
+			for (size_t iPath = 0; iPath < oPaths.size(); ++iPath)
+				free(oPaths[iPath]);
+			return 1;
+		}
+
+		RegisterLoaders();
+		RegisterWriters();
+
+		// Textures are loaded as is, without the cubemap conversion of LoadTexture
+		const int iCount = (int)oPaths.size();
+		Core::Array<Graphics::Texture*> oTextures;
+		oTextures.resize(iCount, false);
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iFile = 0; iFile < iCount; ++iFile)
+		{
+			oTextures[iFile] = new Graphics::Texture();
+			if (Graphics::LoadFromFile(oTextures[iFile], oPaths[iFile]) != ErrorCode::Ok)
+				oTextures[iFile]->Destroy() == ErrorCode::Ok;
+		}
+
+		int iResult = 0;
+		for (int iFile = 0; iFile < iCount; ++iFile)
+		{
+			if (oTextures[iFile]->IsValid() == false)
+			{
+				fprintf(stderr, "Can't load '%s'\n", oPaths[iFile]);
+				iResult = 1;
+			}
+		}
+
+		Core::Array<Graphics::AtlasEntry> oEntries;
+		oEntries.resize(iCount, false);
+		Graphics::Texture oAtlas;
+		if (iResult == 0)
+		{
+			ErrorCode oErr = Graphics::BuildTextureAtlas(oTextures.begin(), iCount, &oAtlas, oEntries.begin(), &oSettings);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't build atlas : %s\n", oErr.ToString());
+				iResult = 1;
+			}
+		}
+
+		if (iResult == 0)
+		{
+			ErrorCode oErr = Graphics::SaveToFile(&oAtlas, NULL, pFilenames[0]);
+			if (oErr != ErrorCode::Ok)
+			{
+				fprintf(stderr, "Can't write '%s' : %s\n", pFilenames[0], oErr.ToString());
+				iResult = 1;
+			}
+		}
+
+		if (iResult == 0)
+		{
+			FILE* pManifest = fopen(pFilenames[1], "w");
+			if (pManifest != NULL)
+			{
+				fprintf(pManifest, "# %s %dx%d %d mips\n# path\tx\ty\twidth\theight\tu0\tv0\tu1\tv1\n", pFilenames[0], oAtlas.GetWidth(), oAtlas.GetHeight(), oAtlas.GetMipCount());
+				for (int iFile = 0; iFile < iCount; ++iFile)
+				{
+					const Graphics::AtlasEntry& oEntry = oEntries[iFile];
+					fprintf(pManifest, "%s\t%d\t%d\t%d\t%d\t%.8f\t%.8f\t%.8f\t%.8f\n", oPaths[iFile], oEntry.iX, oEntry.iY, oEntry.iWidth, oEntry.iHeight,
+						oEntry.fU0, oEntry.fV0, oEntry.fU1, oEntry.fV1);
+				}
+				fclose(pManifest);
+				printf("%d textures packed in %dx%d\n", iCount, oAtlas.GetWidth(), oAtlas.GetHeight());
+			}
+			else
+			{
+				fprintf(stderr, "Can't write '%s'\n", pFilenames[1]);
+				iResult = 1;
+			}
+		}
+
+		for (int iFile = 0; iFile < iCount; ++iFile)
+		{
+			delete oTextures[iFile];
+			free(oPaths[iFile]);
+		}
+		return iResult;
+	}
+
+	bool IsCommand(int iArgCount, char** pArgs)
+	{
+		return iArgCount > 1 && pArgs[1][0] == '-' && pArgs[1][1] == '-';
+	}
+
+	int Run(int iArgCount, char** pArgs)
+	{
+		if (iArgCount > 1)
+		{
+			if (strcmp(pArgs[1], "--sh9") == 0)
+				return RunSH9(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--prefilter-ggx") == 0)
+				return RunPrefilterGGX(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--compare") == 0)
+				return RunCompare(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--compress") == 0)
+				return RunCompress(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--convert") == 0)
+				return RunConvert(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--tiled-mips") == 0)
+				return RunTiledMips(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--duplicates") == 0)
+				return RunDuplicates(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--atlas") == 0)
+				return RunAtlas(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--self-test") == 0)
+				return SelfTest::Run(iArgCount - 2, pArgs + 2);
+			if (strcmp(pArgs[1], "--benchmark") == 0)
+				return Benchmark::Run(iArgCount - 2, pArgs + 2);
+		}
+		PrintUsage();
+		return 1;
+	}
+}
+//namespace CommandLine
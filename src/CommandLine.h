@@ -0,0 +1,26 @@
+#ifndef __COMMAND_LINE_H__
+#define __COMMAND_LINE_H__
+
+/* Batch commands run without creating the viewer window
+Usage :
+	Texeled --sh9 [--size N] [--irradiance] <file>
+	Texeled --prefilter-ggx [--samples N] [--mips N] <input> <output>
+	Texeled --compare [--no-ssim] [--heatmap <file>] <reference> <file>
+	Texeled --compress <format> [--quality Q] [--high-quality Q] [--threshold T] [--max-reencoded F] [--error-map <file>] [--cache <dir>] <input> <output>
+	Texeled --convert <format> [--mips] [--filter F] [--quality Q] [--region X Y W H] [--mip N] [--cache <dir>] [--cache-size MB] [--cache-entries N] <input> <output>
+	Texeled --tiled-mips [--tile-size N] [--memory MB] <input.dds> <output.dds>
+	Texeled --duplicates [--distance N] [--list <file>] <files or @file>...
+	Texeled --atlas [--format F] [--max-size N] [--padding N] [--pot] [--no-mips] <output> <manifest> <files or @file>...
+	Texeled --self-test
+	Texeled --benchmark [--size N] [--runs N] [--no-generic]
+*/
+namespace CommandLine
+{
+	// True when the first argument is a command, other arguments are files to open in the viewer
+	bool						IsCommand(int iArgCount, char** pArgs);
+	// Return the process exit code
+	int							Run(int iArgCount, char** pArgs);
+}
+//namespace CommandLine
+
+#endif //__COMMAND_LINE_H__
@@ -39,6 +39,8 @@ namespace Core
 		bool					push_back(const T& oValue);
 		void					pop_back();
 
+		void					swap(Array<T>& oOther);
+
 		T&						front()							{ CORE_ASSERT(m_iSize > 0); return m_pData[0]; }
 		const T&				front() const					{ CORE_ASSERT(m_iSize > 0); return m_pData[0]; }
 		T&						back()							{ CORE_ASSERT(m_iSize > 0); return m_pData[m_iSize - 1]; }
@@ -154,6 +156,14 @@ namespace Core
 		}
 	}
 
+	template <typename T>
+	void Array<T>::swap(Array<T>& oOther)
+	{
+		size_t iSize = m_iSize; m_iSize = oOther.m_iSize; oOther.m_iSize = iSize;
+		size_t iCapacity = m_iCapacity; m_iCapacity = oOther.m_iCapacity; oOther.m_iCapacity = iCapacity;
+		T* pData = m_pData; m_pData = oOther.m_pData; oOther.m_pData = pData;
+	}
+
 	template <typename T>
 	size_t Array<T>::find(const T& oRight) const
 	{
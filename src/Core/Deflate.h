@@ -0,0 +1,32 @@
+#ifndef __CORE_DEFLATE_H__
+#define __CORE_DEFLATE_H__
+
+#include "Core/Array.h"
+
+#include <stdint.h>
+
+// Implemented in Implementations/tinyexr.cpp, on top of the miniz embedded in tinyexr
+namespace Core
+{
+	namespace Deflate
+	{
+		static const int		c_iMinLevel = 0; // Stored blocks only
+		static const int		c_iMaxLevel = 10;
+		static const int		c_iDefaultLevel = 6;
+
+		// Compress to a raw deflate stream (no zlib header/footer), compressed data is appended to pOut
+		// When bFinish is false the stream ends on a byte aligned sync flush block, so independently compressed
+		// streams can be concatenated, only the last one should be finished
+		bool					Compress(const void* pData, size_t iSize, int iLevel, bool bFinish, Array<unsigned char>* pOut);
+
+		// Checksums, initial values are 1 for Adler-32 and 0 for CRC-32
+		uint32_t				Adler32(uint32_t iAdler, const void* pData, size_t iSize);
+		uint32_t				Crc32(uint32_t iCrc, const void* pData, size_t iSize);
+		// Adler-32 of the concatenation of two buffers, iSize2 is the size of the second buffer
+		uint32_t				Adler32Combine(uint32_t iAdler1, uint32_t iAdler2, size_t iSize2);
+	}
+	//namespace Deflate
+}
+//namespace Core
+
+#endif //__CORE_DEFLATE_H__
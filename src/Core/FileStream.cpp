@@ -35,6 +35,9 @@ namespace Core
 		case AccessModeEnum::WRITE_SAFE:
 			pMode = "wb";
 			break;
+		case AccessModeEnum::READ_WRITE:
+			pMode = "w+b";
+			break;
 		default:
 			return false;
 		}
@@ -137,12 +140,12 @@ namespace Core
 
 	bool FileStream::IsSeekable() const
 	{
-		return m_eAccessMode == AccessModeEnum::READ;
+		return m_eAccessMode == AccessModeEnum::READ || m_eAccessMode == AccessModeEnum::READ_WRITE;
 	}
 
 	bool FileStream::IsEndOfStream() const
 	{
-		if (m_pFile != NULL && m_eAccessMode == AccessModeEnum::READ)
+		if (m_pFile != NULL && (m_eAccessMode == AccessModeEnum::READ || m_eAccessMode == AccessModeEnum::READ_WRITE))
 		{
 			return feof((FILE*)m_pFile) != 0;
 		}
@@ -151,12 +154,12 @@ namespace Core
 
 	bool FileStream::IsReadable() const
 	{
-		return m_eAccessMode == AccessModeEnum::READ;
+		return m_eAccessMode == AccessModeEnum::READ || m_eAccessMode == AccessModeEnum::READ_WRITE;
 	}
 
 	bool FileStream::IsWritable() const
 	{
-		return m_eAccessMode == AccessModeEnum::WRITE || m_eAccessMode == AccessModeEnum::WRITE_SAFE;
+		return m_eAccessMode == AccessModeEnum::WRITE || m_eAccessMode == AccessModeEnum::WRITE_SAFE || m_eAccessMode == AccessModeEnum::READ_WRITE;
 	}
 
 	bool FileStream::Seek(size_t iPos, SeekModeEnum eSeekMode)
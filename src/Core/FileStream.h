@@ -14,7 +14,8 @@ namespace Core
 			{
 				READ,
 				WRITE,
-				WRITE_SAFE
+				WRITE_SAFE,
+				READ_WRITE // Random access, truncate existing file
 			};
 		};
 		typedef _AccessModeEnum::Enum AccessModeEnum;
@@ -0,0 +1,156 @@
+#include "Core/Hash.h"
+
+#include <string.h> // memcpy
+
+namespace Core
+{
+	static const uint64_t c_iPrime1 = 11400714785074694791ULL;
+	static const uint64_t c_iPrime2 = 14029467366897019727ULL;
+	static const uint64_t c_iPrime3 = 1609587929392839161ULL;
+	static const uint64_t c_iPrime4 = 9650029242287828579ULL;
+	static const uint64_t c_iPrime5 = 2870177450012600261ULL;
+
+	inline uint64_t RotateLeft(uint64_t iValue, int iBits)
+	{
+		return (iValue << iBits) | (iValue >> (64 - iBits));
+	}
+
+	inline uint64_t Read64(const uint8_t* pData)
+	{
+		uint64_t iValue;
+		memcpy(&iValue, pData, sizeof(iValue));
+		return iValue;
+	}
+
+	inline uint32_t Read32(const uint8_t* pData)
+	{
+		uint32_t iValue;
+		memcpy(&iValue, pData, sizeof(iValue));
+		return iValue;
+	}
+
+	inline uint64_t Round(uint64_t iLane, uint64_t iInput)
+	{
+		iLane += iInput * c_iPrime2;
+		iLane = RotateLeft(iLane, 31);
+		return iLane * c_iPrime1;
+	}
+
+	inline uint64_t MergeRound(uint64_t iHash, uint64_t iLane)
+	{
+		iHash ^= Round(0, iLane);
+		return iHash * c_iPrime1 + c_iPrime4;
+	}
+
+	// Consume whole 32 bytes stripes, return the number of bytes consumed
+	static size_t ProcessStripes(uint64_t* pLanes, const uint8_t* pData, size_t iSize)
+	{
+		uint64_t iLane0 = pLanes[0];
+		uint64_t iLane1 = pLanes[1];
+		uint64_t iLane2 = pLanes[2];
+		uint64_t iLane3 = pLanes[3];
+		const uint8_t* pEnd = pData + (iSize & ~(size_t)31);
+		const uint8_t* pCurrent = pData;
+		while (pCurrent < pEnd)
+		{
+			iLane0 = Round(iLane0, Read64(pCurrent));
+			iLane1 = Round(iLane1, Read64(pCurrent + 8));
+			iLane2 = Round(iLane2, Read64(pCurrent + 16));
+			iLane3 = Round(iLane3, Read64(pCurrent + 24));
+			pCurrent += 32;
+		}
+		pLanes[0] = iLane0;
+		pLanes[1] = iLane1;
+		pLanes[2] = iLane2;
+		pLanes[3] = iLane3;
+		return (size_t)(pCurrent - pData);
+	}
+
+	Hasher64::Hasher64(uint64_t iSeed)
+	{
+		m_iLanes[0] = iSeed + c_iPrime1 + c_iPrime2;
+		m_iLanes[1] = iSeed + c_iPrime2;
+		m_iLanes[2] = iSeed;
+		m_iLanes[3] = iSeed - c_iPrime1;
+		m_iSeed = iSeed;
+		m_iTotalSize = 0;
+		m_iBufferSize = 0;
+	}
+
+	void Hasher64::Update(const void* pData, size_t iSize)
+	{
+		const uint8_t* pBytes = (const uint8_t*)pData;
+		m_iTotalSize += iSize;
+
+		if (m_iBufferSize > 0)
+		{
+			size_t iCopy = sizeof(m_pBuffer) - m_iBufferSize;
+			if (iCopy > iSize)
+				iCopy = iSize;
+			memcpy(m_pBuffer + m_iBufferSize, pBytes, iCopy);
+			m_iBufferSize += iCopy;
+			pBytes += iCopy;
+			iSize -= iCopy;
+			if (m_iBufferSize < sizeof(m_pBuffer))
+				return;
+			ProcessStripes(m_iLanes, m_pBuffer, sizeof(m_pBuffer));
+			m_iBufferSize = 0;
+		}
+
+		size_t iProcessed = ProcessStripes(m_iLanes, pBytes, iSize);
+		m_iBufferSize = iSize - iProcessed;
+		memcpy(m_pBuffer, pBytes + iProcessed, m_iBufferSize);
+	}
+
+	uint64_t Hasher64::Finalize() const
+	{
+		uint64_t iHash;
+		if (m_iTotalSize >= 32)
+		{
+			iHash = RotateLeft(m_iLanes[0], 1) + RotateLeft(m_iLanes[1], 7) + RotateLeft(m_iLanes[2], 12) + RotateLeft(m_iLanes[3], 18);
+			for (int iLane = 0; iLane < 4; ++iLane)
+				iHash = MergeRound(iHash, m_iLanes[iLane]);
+		}
+		else
+		{
+			iHash = m_iSeed + c_iPrime5;
+		}
+		iHash += m_iTotalSize;
+
+		const uint8_t* pCurrent = m_pBuffer;
+		const uint8_t* pEnd = m_pBuffer + m_iBufferSize;
+		while (pCurrent + 8 <= pEnd)
+		{
+			iHash ^= Round(0, Read64(pCurrent));
+			iHash = RotateLeft(iHash, 27) * c_iPrime1 + c_iPrime4;
+			pCurrent += 8;
+		}
+		if (pCurrent + 4 <= pEnd)
+		{
+			iHash ^= (uint64_t)Read32(pCurrent) * c_iPrime1;
+			iHash = RotateLeft(iHash, 23) * c_iPrime2 + c_iPrime3;
+			pCurrent += 4;
+		}
+		while (pCurrent < pEnd)
+		{
+			iHash ^= (*pCurrent) * c_iPrime5;
+			iHash = RotateLeft(iHash, 11) * c_iPrime1;
+			++pCurrent;
+		}
+
+		iHash ^= iHash >> 33;
+		iHash *= c_iPrime2;
+		iHash ^= iHash >> 29;
+		iHash *= c_iPrime3;
+		iHash ^= iHash >> 32;
+		return iHash;
+	}
+
+	uint64_t Hash64(const void* pData, size_t iSize, uint64_t iSeed)
+	{
+		Hasher64 oHasher(iSeed);
+		oHasher.Update(pData, iSize);
+		return oHasher.Finalize();
+	}
+}
+//namespace Core
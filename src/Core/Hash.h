@@ -0,0 +1,32 @@
+#ifndef __CORE_HASH_H__
+#define __CORE_HASH_H__
+
+#include <stdint.h>
+#include <stddef.h> // size_t
+
+namespace Core
+{
+	/* 64 bits non-cryptographic hash (xxHash64)
+	Input is consumed in 32 bytes stripes by four independent multiply/rotate lanes, it runs close to memory bandwidth.
+	Feeding the data in several Update calls gives the same hash as a single call.
+	*/
+	class Hasher64
+	{
+	public:
+								Hasher64(uint64_t iSeed = 0);
+
+		void					Update(const void* pData, size_t iSize);
+		uint64_t				Finalize() const;
+	protected:
+		uint64_t				m_iLanes[4];
+		uint64_t				m_iSeed;
+		uint64_t				m_iTotalSize;
+		uint8_t					m_pBuffer[32];
+		size_t					m_iBufferSize;
+	};
+
+	uint64_t					Hash64(const void* pData, size_t iSize, uint64_t iSeed = 0);
+}
+//namespace Core
+
+#endif //__CORE_HASH_H__
@@ -159,26 +159,39 @@ namespace GraphicResources
 			pInputTexture = &oNewTexture;
 		}
 
+		const int iMipCount = GetDisplayMipCount(*pInputTexture);
+		const int iArraySize = GetDisplayArraySize(*pInputTexture);
+
 		Core::Array<D3D11_SUBRESOURCE_DATA> oInitData;
-		oInitData.resize(pInputTexture->GetMipCount() * pInputTexture->GetFaceCount(), false);
-		for (int iMip = 0, iMipCount = pInputTexture->GetMipCount(); iMip < iMipCount; ++iMip)
+		oInitData.resize(iMipCount * iArraySize, false);
+		for (int iMip = 0; iMip < iMipCount; ++iMip)
 		{
-			for (int iFace = 0, iFaceCount = pInputTexture->GetFaceCount(); iFace < iFaceCount; ++iFace)
+			for (int iElement = 0; iElement < iArraySize; ++iElement)
 			{
-				const Graphics::Texture::TextureFaceData& oFaceData = pInputTexture->GetData().GetFaceData(iMip, iFace);
-				int iIndex = iMip * iFaceCount + iFace;
-				iIndex = iMip + iFace * iMipCount;
-				oInitData[iIndex].pSysMem = oFaceData.pData;
-				oInitData[iIndex].SysMemPitch = Graphics::PixelFormat::GetPitch(pInputTexture->GetPixelFormat(), oFaceData.iWidth);
-				oInitData[iIndex].SysMemSlicePitch = (UINT)oFaceData.iSize;
+				int iIndex = iMip + iElement * iMipCount;
+				if (pInputTexture->IsVolume())
+				{
+					const Graphics::Texture::TextureFaceData& oFaceData = pInputTexture->GetData().GetFaceData(iMip, 0);
+					oInitData[iIndex].pSysMem = (const char*)oFaceData.pData + iElement * oFaceData.iSlicePitch;
+					oInitData[iIndex].SysMemPitch = (UINT)oFaceData.iPitch;
+					oInitData[iIndex].SysMemSlicePitch = (UINT)oFaceData.iSlicePitch;
+				}
+				else
+				{
+					const int iFaceCount = pInputTexture->GetFaceCount();
+					const Graphics::Texture::TextureFaceData& oFaceData = pInputTexture->GetData().GetFaceData(iMip, iElement % iFaceCount, iElement / iFaceCount);
+					oInitData[iIndex].pSysMem = oFaceData.pData;
+					oInitData[iIndex].SysMemPitch = Graphics::PixelFormat::GetPitch(pInputTexture->GetPixelFormat(), oFaceData.iWidth);
+					oInitData[iIndex].SysMemSlicePitch = (UINT)oFaceData.iSize;
+				}
 			}
 		}
 
 		D3D11_TEXTURE2D_DESC desc = { 0 };
 		desc.Width = pInputTexture->GetWidth();
 		desc.Height = pInputTexture->GetHeight();
-		desc.MipLevels = pInputTexture->GetMipCount();
-		desc.ArraySize = pInputTexture->GetFaceCount();
+		desc.MipLevels = iMipCount;
+		desc.ArraySize = iArraySize;
 		desc.Format = eDXGIFormat;
 		desc.SampleDesc.Count = 1;
 		//desc.Usage = D3D11_USAGE_DYNAMIC;
@@ -199,7 +212,7 @@ namespace GraphicResources
 		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
 		srvDesc.Texture2D.MipLevels = desc.MipLevels;
 		srvDesc.Texture2D.MostDetailedMip = 0;
-		srvDesc.Texture2DArray.ArraySize = pTexture->GetFaceCount();
+		srvDesc.Texture2DArray.ArraySize = iArraySize;
 		srvDesc.Texture2DArray.MipLevels = desc.MipLevels;
 		srvDesc.Texture2DArray.MostDetailedMip = 0;
 		hRes = Program::GetInstance()->GetDX11Device()->CreateShaderResourceView(pDX11Texture, &srvDesc, &pDX11TextureView);
@@ -219,6 +232,20 @@ namespace GraphicResources
 		return ErrorCode::Ok;
 	}
 
+	int Texture2D::GetDisplayArraySize(const Graphics::Texture& oTexture)
+	{
+		if (oTexture.IsVolume())
+			return oTexture.GetDepth();
+		return oTexture.GetFaceCount() * oTexture.GetArraySize();
+	}
+
+	int Texture2D::GetDisplayMipCount(const Graphics::Texture& oTexture)
+	{
+		if (oTexture.IsVolume())
+			return 1;
+		return oTexture.GetMipCount();
+	}
+
 	bool Texture2D::GetDXGIFormatFromPixelFormat(Graphics::PixelFormatEnum ePixelFormat, DXGI_FORMAT* pOutDXGIFormat, Graphics::PixelFormatEnum* pOutConvertionFormatRequired)
 	{
 		if (pOutDXGIFormat == NULL)
@@ -255,6 +282,15 @@ namespace GraphicResources
 				eDXGIOutput =  DXGI_FORMAT_B8G8R8A8_UNORM;
 				break;
 
+			// sRGB formats are displayed like their UNorm equivalent (raw values)
+			case Graphics::PixelFormatEnum::RGBA8_UNORM_SRGB:
+				eDXGIOutput =  DXGI_FORMAT_R8G8B8A8_UNORM;
+				break;
+
+			case Graphics::PixelFormatEnum::BGRA8_UNORM_SRGB:
+				eDXGIOutput =  DXGI_FORMAT_B8G8R8A8_UNORM;
+				break;
+
 			case Graphics::PixelFormatEnum::R5G6B5_UNORM:
 				eDXGIOutput = DXGI_FORMAT_B5G6R5_UNORM;
 				eConvertionFormat = Graphics::PixelFormatEnum::B5G6BR_UNORM;
@@ -339,6 +375,22 @@ namespace GraphicResources
 				eDXGIOutput =  DXGI_FORMAT_BC7_UNORM;
 				break;
 
+			case Graphics::PixelFormatEnum::BC1_SRGB:
+				eDXGIOutput =  DXGI_FORMAT_BC1_UNORM;
+				break;
+
+			case Graphics::PixelFormatEnum::BC2_SRGB:
+				eDXGIOutput =  DXGI_FORMAT_BC2_UNORM;
+				break;
+
+			case Graphics::PixelFormatEnum::BC3_SRGB:
+				eDXGIOutput =  DXGI_FORMAT_BC3_UNORM;
+				break;
+
+			case Graphics::PixelFormatEnum::BC7_SRGB:
+				eDXGIOutput =  DXGI_FORMAT_BC7_UNORM;
+				break;
+
 			default:
 				break;
 		}
@@ -48,6 +48,10 @@ namespace GraphicResources
 
 		static ErrorCode				CreateFromTexture(Graphics::Texture* pTexture, Texture2D** pOutTexture2D);
 
+		// Layers, faces and volume slices are all displayed as array elements, volumes only display their first mip
+		static int						GetDisplayArraySize(const Graphics::Texture& oTexture);
+		static int						GetDisplayMipCount(const Graphics::Texture& oTexture);
+
 		static bool						GetDXGIFormatFromPixelFormat(Graphics::PixelFormatEnum ePixelFormat, DXGI_FORMAT* pOutDXGIFormat, Graphics::PixelFormatEnum* pOutConvertionFormatRequired);
 	protected:
 		ID3D11Texture2D*				m_pTexture;
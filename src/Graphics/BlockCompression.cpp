@@ -0,0 +1,577 @@
+#include "Graphics/BlockCompression.h"
+
+#include "Graphics/TextureUtils.h"
+#include "Graphics/PixelFormatConverters.h"
+
+#include "Core/Array.h"
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
+#include "CMP_Core.h"
+
+#include <emmintrin.h> //SIMD
+#include <math.h> // sqrt
+#include <string.h> // memcpy
+#include <algorithm> // nth_element
+
+namespace Graphics
+{
+	BlockCompressionSettings::BlockCompressionSettings()
+	{
+		fQuality = 0.05f;
+		fHighQuality = 0.8f;
+		fErrorThreshold = 0.002f;
+		fMaxReencodedBlocks = 0.5f;
+	}
+
+	BlockCompressionReport::BlockCompressionReport()
+	{
+		iBlockCount = 0;
+		iReencodedBlockCount = 0;
+		fRMSE = 0.0;
+		fMaxBlockError = 0.f;
+	}
+
+	typedef int (CMP_CDECL *CreateOptionsFunc)(void** ppOptions);
+	typedef int (CMP_CDECL *DestroyOptionsFunc)(void* pOptions);
+	typedef int (CMP_CDECL *SetQualityFunc)(void* pOptions, float fQuality);
+
+	// Largest source block, 4x4 RGB16F for BC6H
+	static const int c_iMaxBlockPixelsSize = 16 * 3 * 2;
+
+	struct BlockCodec
+	{
+		PixelFormatEnum				eFormat; // Linear BC format
+		PixelFormatEnum				eSourceFormat; // Uncompressed format read by the encoder
+		int							iPixelSize;
+		int							iComponentCount;
+		bool						bQualityLevels; // BC1-5 encoders of CMP_Core ignore the quality
+		CreateOptionsFunc			pCreateOptions;
+		DestroyOptionsFunc			pDestroyOptions;
+		SetQualityFunc				pSetQuality;
+	};
+
+	// A block row of a slice
+	struct CompressJob
+	{
+		int							iSubresource;
+		int							iSlice;
+		int							iBlockRow;
+		size_t						iFirstBlock; // Index of the first block of the row in the block errors
+	};
+
+	static bool GetBlockCodec(PixelFormatEnum ePixelFormat, BlockCodec* pOutCodec)
+	{
+		BlockCodec& oCodec = *pOutCodec;
+		oCodec.eFormat = PixelFormat::GetLinearFormat(ePixelFormat);
+		switch (oCodec.eFormat)
+		{
+		case PixelFormatEnum::BC1:
+			oCodec.eSourceFormat = PixelFormatEnum::RGBA8_UNORM;
+			oCodec.pCreateOptions = CreateOptionsBC1;
+			oCodec.pDestroyOptions = DestroyOptionsBC1;
+			oCodec.pSetQuality = SetQualityBC1;
+			break;
+		case PixelFormatEnum::BC2:
+			oCodec.eSourceFormat = PixelFormatEnum::RGBA8_UNORM;
+			oCodec.pCreateOptions = CreateOptionsBC2;
+			oCodec.pDestroyOptions = DestroyOptionsBC2;
+			oCodec.pSetQuality = SetQualityBC2;
+			break;
+		case PixelFormatEnum::BC3:
+			oCodec.eSourceFormat = PixelFormatEnum::RGBA8_UNORM;
+			oCodec.pCreateOptions = CreateOptionsBC3;
+			oCodec.pDestroyOptions = DestroyOptionsBC3;
+			oCodec.pSetQuality = SetQualityBC3;
+			break;
+		case PixelFormatEnum::BC4:
+			oCodec.eSourceFormat = PixelFormatEnum::R8_UNORM;
+			oCodec.pCreateOptions = CreateOptionsBC4;
+			oCodec.pDestroyOptions = DestroyOptionsBC4;
+			oCodec.pSetQuality = SetQualityBC4;
+			break;
+		case PixelFormatEnum::BC5:
+			oCodec.eSourceFormat = PixelFormatEnum::RG8_UNORM;
+			oCodec.pCreateOptions = CreateOptionsBC5;
+			oCodec.pDestroyOptions = DestroyOptionsBC5;
+			oCodec.pSetQuality = SetQualityBC5;
+			break;
+		case PixelFormatEnum::BC6H:
+			oCodec.eSourceFormat = PixelFormatEnum::RGB16_FLOAT;
+			oCodec.pCreateOptions = CreateOptionsBC6;
+			oCodec.pDestroyOptions = DestroyOptionsBC6;
+			oCodec.pSetQuality = SetQualityBC6;
+			break;
+		case PixelFormatEnum::BC7:
+			oCodec.eSourceFormat = PixelFormatEnum::RGBA8_UNORM;
+			oCodec.pCreateOptions = CreateOptionsBC7;
+			oCodec.pDestroyOptions = DestroyOptionsBC7;
+			oCodec.pSetQuality = SetQualityBC7;
+			break;
+		default:
+			return false;
+		}
+
+		// sRGB blocks store sRGB encoded colors
+		if (PixelFormat::IsSRGB(ePixelFormat))
+			oCodec.eSourceFormat = PixelFormat::GetSRGBFormat(oCodec.eSourceFormat);
+
+		oCodec.iPixelSize = PixelFormatEnumInfos[oCodec.eSourceFormat].iBlockSize;
+		oCodec.iComponentCount = PixelFormatEnumInfos[oCodec.eFormat].iComponents;
+		oCodec.bQualityLevels = oCodec.eFormat == PixelFormatEnum::BC6H || oCodec.eFormat == PixelFormatEnum::BC7;
+		return true;
+	}
+
+	// 4x4 tightly packed pixels of the codec source format
+	static void EncodeBlock(PixelFormatEnum eFormat, const void* pPixels, void* pBlock, void* pOptions)
+	{
+		unsigned char* pIn = (unsigned char*)pPixels;
+		unsigned char* pOut = (unsigned char*)pBlock;
+		switch (eFormat)
+		{
+		case PixelFormatEnum::BC1:
+			CompressBlockBC1(pIn, 16, pOut, pOptions);
+			break;
+		case PixelFormatEnum::BC2:
+			CompressBlockBC2(pIn, 16, pOut, pOptions);
+			break;
+		case PixelFormatEnum::BC3:
+			CompressBlockBC3(pIn, 16, pOut, pOptions);
+			break;
+		case PixelFormatEnum::BC4:
+			CompressBlockBC4(pIn, 4, pOut, pOptions);
+			break;
+		case PixelFormatEnum::BC5:
+		{
+			unsigned char oChannelA[16];
+			unsigned char oChannelB[16];
+			for (int iPixel = 0; iPixel < 16; ++iPixel)
+			{
+				oChannelA[iPixel] = pIn[iPixel * 2 + 0];
+				oChannelB[iPixel] = pIn[iPixel * 2 + 1];
+			}
+			CompressBlockBC5(oChannelA, 4, oChannelB, 4, pOut, pOptions);
+			break;
+		}
+		case PixelFormatEnum::BC6H:
+			CompressBlockBC6((unsigned short*)pIn, 4 * 3, pOut, pOptions);
+			break;
+		case PixelFormatEnum::BC7:
+			CompressBlockBC7(pIn, 16, pOut, pOptions);
+			break;
+		default:
+			CORE_ASSERT(false);
+		}
+	}
+
+	// Same pixel layout as EncodeBlock
+	static void DecodeBlock(PixelFormatEnum eFormat, const void* pBlock, void* pOutPixels)
+	{
+		unsigned char* pIn = (unsigned char*)pBlock;
+		unsigned char* pOut = (unsigned char*)pOutPixels;
+		switch (eFormat)
+		{
+		case PixelFormatEnum::BC1:
+			DecompressBlockBC1(pIn, pOut, NULL);
+			break;
+		case PixelFormatEnum::BC2:
+			DecompressBlockBC2(pIn, pOut, NULL);
+			break;
+		case PixelFormatEnum::BC3:
+			DecompressBlockBC3(pIn, pOut, NULL);
+			break;
+		case PixelFormatEnum::BC4:
+			DecompressBlockBC4(pIn, pOut, NULL);
+			break;
+		case PixelFormatEnum::BC5:
+		{
+			unsigned char oChannelA[16];
+			unsigned char oChannelB[16];
+			DecompressBlockBC5(pIn, oChannelA, oChannelB, NULL);
+			for (int iPixel = 0; iPixel < 16; ++iPixel)
+			{
+				pOut[iPixel * 2 + 0] = oChannelA[iPixel];
+				pOut[iPixel * 2 + 1] = oChannelB[iPixel];
+			}
+			break;
+		}
+		case PixelFormatEnum::BC6H:
+			DecompressBlockBC6(pIn, (unsigned short*)pOut, NULL);
+			break;
+		case PixelFormatEnum::BC7:
+			DecompressBlockBC7(pIn, pOut, NULL);
+			break;
+		default:
+			CORE_ASSERT(false);
+		}
+	}
+
+	// Sum of squared differences of 8 bits values, iSize is a multiple of 16
+	static uint32_t SquaredErrorUNORM8(const unsigned char* pA, const unsigned char* pB, int iSize)
+	{
+		const __m128i xZero = _mm_setzero_si128();
+		__m128i xSum = _mm_setzero_si128();
+		for (int iOffset = 0; iOffset < iSize; iOffset += 16)
+		{
+			const __m128i xA = _mm_loadu_si128((const __m128i*)(pA + iOffset));
+			const __m128i xB = _mm_loadu_si128((const __m128i*)(pB + iOffset));
+			const __m128i xDiffLow = _mm_sub_epi16(_mm_unpacklo_epi8(xA, xZero), _mm_unpacklo_epi8(xB, xZero));
+			const __m128i xDiffHigh = _mm_sub_epi16(_mm_unpackhi_epi8(xA, xZero), _mm_unpackhi_epi8(xB, xZero));
+			xSum = _mm_add_epi32(xSum, _mm_madd_epi16(xDiffLow, xDiffLow));
+			xSum = _mm_add_epi32(xSum, _mm_madd_epi16(xDiffHigh, xDiffHigh));
+		}
+		xSum = _mm_add_epi32(xSum, _mm_shuffle_epi32(xSum, _MM_SHUFFLE(1, 0, 3, 2)));
+		xSum = _mm_add_epi32(xSum, _mm_shuffle_epi32(xSum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return (uint32_t)_mm_cvtsi128_si32(xSum);
+	}
+
+	static float BlockError(const BlockCodec& oCodec, const void* pSource, const void* pDecoded)
+	{
+		const int iValueCount = 16 * oCodec.iComponentCount;
+		if (oCodec.eFormat == PixelFormatEnum::BC6H)
+		{
+			double fSum = 0.0;
+			for (int iValue = 0; iValue < iValueCount; ++iValue)
+			{
+				float fSource, fDecoded;
+				PixelFormat::Converters::HalfToFloat(((const uint16_t*)pSource)[iValue], &fSource);
+				PixelFormat::Converters::HalfToFloat(((const uint16_t*)pDecoded)[iValue], &fDecoded);
+				fSum += (double)(fDecoded - fSource) * (fDecoded - fSource);
+			}
+			return (float)sqrt(fSum / iValueCount);
+		}
+		const uint32_t iSum = SquaredErrorUNORM8((const unsigned char*)pSource, (const unsigned char*)pDecoded, iValueCount);
+		return (float)sqrt((double)iSum / ((double)iValueCount * 255.0 * 255.0));
+	}
+
+	// 4 lines of a block row in the codec source format, edge pixels are replicated to whole blocks
+	static void LoadBlockRow(const BlockCodec& oCodec, const Texture::TextureFaceData& oFaceData, PixelFormatEnum eSourcePixelFormat, int iSlice, int iBlockRow, const PixelFormat::ConvertionFuncChain& oChain, int iChainLength, void* pLines, size_t iLinePitch)
+	{
+		const int iPixelSize = oCodec.iPixelSize;
+		const int iWidth = oFaceData.iWidth;
+		const int iStartY = iBlockRow * 4;
+		const int iLineCount = Math::Min(4, oFaceData.iHeight - iStartY);
+		const int iPaddedWidth = (iWidth + 3) / 4 * 4;
+
+		const char* pSource = (const char*)oFaceData.pData + (size_t)iSlice * oFaceData.iSlicePitch + (size_t)(iStartY / PixelFormatEnumInfos[eSourcePixelFormat].iBlockHeight) * oFaceData.iPitch;
+		ConvertPixelFormatRegion(
+			pSource, oFaceData.iPitch, eSourcePixelFormat,
+			pLines, iLinePitch, oCodec.eSourceFormat,
+			iWidth, iLineCount,
+			oChain, iChainLength);
+
+		for (int iY = 0; iY < 4; ++iY)
+		{
+			char* pLine = (char*)pLines + iY * iLinePitch;
+			if (iY >= iLineCount)
+			{
+				memcpy(pLine, (char*)pLines + (iLineCount - 1) * iLinePitch, iLinePitch);
+				continue;
+			}
+			for (int iX = iWidth; iX < iPaddedWidth; ++iX)
+			{
+				memcpy(pLine + iX * iPixelSize, pLine + (iWidth - 1) * iPixelSize, iPixelSize);
+			}
+		}
+	}
+
+	static void GetBlockPixels(const void* pLines, size_t iLinePitch, int iPixelSize, int iBlockX, unsigned char* pOutPixels)
+	{
+		for (int iY = 0; iY < 4; ++iY)
+		{
+			memcpy(pOutPixels + iY * 4 * iPixelSize, (const char*)pLines + iY * iLinePitch + (size_t)iBlockX * 4 * iPixelSize, 4 * iPixelSize);
+		}
+	}
+
+	ErrorCode CompressTexture(const Texture* pTexture, Texture* pOutTexture, PixelFormatEnum eWantedPixelFormat, const BlockCompressionSettings* pSettings, BlockCompressionReport* pOutReport, Texture* pOutErrorMap)
+	{
+		if (pTexture == NULL || pOutTexture == NULL || pTexture->IsValid() == false)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		BlockCodec oCodec;
+		if (GetBlockCodec(eWantedPixelFormat, &oCodec) == false)
+		{
+			return ErrorCode(1, "'%s' is not a block compressed format", PixelFormatEnumInfos[eWantedPixelFormat].pName);
+		}
+
+		const PixelFormatEnum eSourcePixelFormat = pTexture->GetPixelFormat();
+		PixelFormat::ConvertionFuncChain oChain;
+		int iChainLength = 0;
+		int iAdditionalBits;
+		if (eSourcePixelFormat != oCodec.eSourceFormat
+			&& PixelFormat::GetConvertionChain(eSourcePixelFormat, oCodec.eSourceFormat, &oChain, &iChainLength, &iAdditionalBits) == false)
+		{
+			return ErrorCode(1, "Format convertion not implemented");
+		}
+
+		BlockCompressionSettings oDefaultSettings;
+		const BlockCompressionSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+
+		const int iMipCount = pTexture->GetMipCount();
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iArraySize = pTexture->GetArraySize();
+		const int iSubresourceCount = iMipCount * iArraySize * iFaceCount;
+		const int iBlockSize = PixelFormatEnumInfos[eWantedPixelFormat].iBlockSize;
+
+		Texture oNewTexture;
+		Texture oErrorMap;
+		{
+			Texture::Desc oDesc;
+			oDesc.ePixelFormat = eWantedPixelFormat;
+			oDesc.iWidth = pTexture->GetWidth();
+			oDesc.iHeight = pTexture->GetHeight();
+			oDesc.iDepth = pTexture->GetDepth();
+			oDesc.iFaceCount = iFaceCount;
+			oDesc.iArraySize = iArraySize;
+			oDesc.iMipCount = iMipCount;
+			if (oNewTexture.Create(oDesc) != ErrorCode::Ok)
+			{
+				return ErrorCode(1, "Can't create new Texture");
+			}
+			if (pOutErrorMap != NULL)
+			{
+				oDesc.ePixelFormat = PixelFormatEnum::R32_FLOAT;
+				ErrorCode oErr = oErrorMap.Create(oDesc);
+				if (oErr != ErrorCode::Ok)
+					return oErr;
+			}
+		}
+
+		// Jobs of each subresource (mips, layers, faces) are consecutive
+		Core::Array<CompressJob> oJobs;
+		size_t iJobCount = 0;
+		size_t iTotalBlockCount = 0;
+		for (int iSubresource = 0; iSubresource < iSubresourceCount; ++iSubresource)
+		{
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iSubresource / (iArraySize * iFaceCount), iSubresource % iFaceCount, (iSubresource / iFaceCount) % iArraySize);
+			iJobCount += (size_t)oFaceData.iDepth * ((oFaceData.iHeight + 3) / 4);
+		}
+		if (oJobs.resize(iJobCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+		size_t iJobIndex = 0;
+		for (int iSubresource = 0; iSubresource < iSubresourceCount; ++iSubresource)
+		{
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iSubresource / (iArraySize * iFaceCount), iSubresource % iFaceCount, (iSubresource / iFaceCount) % iArraySize);
+			for (int iSlice = 0; iSlice < oFaceData.iDepth; ++iSlice)
+			{
+				for (int iBlockRow = 0; iBlockRow * 4 < oFaceData.iHeight; ++iBlockRow)
+				{
+					CompressJob& oJob = oJobs[iJobIndex++];
+					oJob.iSubresource = iSubresource;
+					oJob.iSlice = iSlice;
+					oJob.iBlockRow = iBlockRow;
+					oJob.iFirstBlock = iTotalBlockCount;
+					iTotalBlockCount += (size_t)(oFaceData.iWidth + 3) / 4;
+				}
+			}
+		}
+
+		Core::Array<float> oBlockErrors;
+		if (oBlockErrors.resize(iTotalBlockCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		// Options are only read by the encoders, shared by all jobs
+		const bool bReencode = oSettings.fErrorThreshold >= 0.f && oSettings.fMaxReencodedBlocks > 0.f && oCodec.bQualityLevels;
+		void* pOptions = NULL;
+		void* pHighQualityOptions = NULL;
+		if (oCodec.pCreateOptions(&pOptions) != 0 || oCodec.pSetQuality(pOptions, oSettings.fQuality) != 0
+			|| (bReencode && (oCodec.pCreateOptions(&pHighQualityOptions) != 0 || oCodec.pSetQuality(pHighQualityOptions, oSettings.fHighQuality) != 0)))
+		{
+			if (pOptions != NULL)
+				oCodec.pDestroyOptions(pOptions);
+			if (pHighQualityOptions != NULL)
+				oCodec.pDestroyOptions(pHighQualityOptions);
+			return ErrorCode(1, "Can't create encoder options");
+		}
+
+		bool bError = false;
+
+		// First pass, all blocks at fQuality
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < (int)iJobCount; ++iJob)
+		{
+			const CompressJob& oJob = oJobs[iJob];
+			const int iMip = oJob.iSubresource / (iArraySize * iFaceCount);
+			const int iFace = oJob.iSubresource % iFaceCount;
+			const int iLayer = (oJob.iSubresource / iFaceCount) % iArraySize;
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+			const Texture::TextureFaceData& oNewFaceData = oNewTexture.GetData().GetFaceData(iMip, iFace, iLayer);
+			const int iBlockCountX = (oFaceData.iWidth + 3) / 4;
+
+			const size_t iLinePitch = (size_t)iBlockCountX * 4 * oCodec.iPixelSize;
+			CORE_PTR_VOID pLines = Core::Malloc(iLinePitch * 4);
+			if (pLines == NULL)
+			{
+				bError = true;
+				continue;
+			}
+			LoadBlockRow(oCodec, oFaceData, eSourcePixelFormat, oJob.iSlice, oJob.iBlockRow, oChain, iChainLength, pLines, iLinePitch);
+
+			char* pDestBlocks = (char*)oNewFaceData.pData + (size_t)oJob.iSlice * oNewFaceData.iSlicePitch + (size_t)oJob.iBlockRow * oNewFaceData.iPitch;
+			for (int iBlockX = 0; iBlockX < iBlockCountX; ++iBlockX)
+			{
+				unsigned char oPixels[c_iMaxBlockPixelsSize];
+				unsigned char oDecoded[c_iMaxBlockPixelsSize];
+				GetBlockPixels(pLines, iLinePitch, oCodec.iPixelSize, iBlockX, oPixels);
+				EncodeBlock(oCodec.eFormat, oPixels, pDestBlocks + (size_t)iBlockX * iBlockSize, pOptions);
+				DecodeBlock(oCodec.eFormat, pDestBlocks + (size_t)iBlockX * iBlockSize, oDecoded);
+				oBlockErrors[oJob.iFirstBlock + iBlockX] = BlockError(oCodec, oPixels, oDecoded);
+			}
+
+			Core::Free(pLines);
+		}
+
+		if (bError)
+		{
+			oCodec.pDestroyOptions(pOptions);
+			if (pHighQualityOptions != NULL)
+				oCodec.pDestroyOptions(pHighQualityOptions);
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		// Blocks above the threshold are encoded again, the largest errors first when they exceed the budget
+		float fCutoff = oSettings.fErrorThreshold;
+		size_t iReencodedBlockCount = 0;
+		if (bReencode)
+		{
+			for (size_t iBlock = 0; iBlock < iTotalBlockCount; ++iBlock)
+			{
+				if (oBlockErrors[iBlock] > fCutoff)
+					++iReencodedBlockCount;
+			}
+			const size_t iMaxBlockCount = (size_t)(Math::Min(oSettings.fMaxReencodedBlocks, 1.f) * (float)iTotalBlockCount);
+			Core::Array<float> oAboveThreshold;
+			if (iReencodedBlockCount > iMaxBlockCount && oAboveThreshold.resize(iReencodedBlockCount, false))
+			{
+				size_t iAbove = 0;
+				for (size_t iBlock = 0; iBlock < iTotalBlockCount; ++iBlock)
+				{
+					if (oBlockErrors[iBlock] > fCutoff)
+						oAboveThreshold[iAbove++] = oBlockErrors[iBlock];
+				}
+				// At most iMaxBlockCount errors are above the new cutoff, less with ties
+				const size_t iCutoffIndex = iReencodedBlockCount - iMaxBlockCount - 1;
+				std::nth_element(oAboveThreshold.begin(), oAboveThreshold.begin() + iCutoffIndex, oAboveThreshold.end());
+				fCutoff = oAboveThreshold[iCutoffIndex];
+				iReencodedBlockCount = 0;
+				for (size_t iBlock = 0; iBlock < iTotalBlockCount; ++iBlock)
+				{
+					if (oBlockErrors[iBlock] > fCutoff)
+						++iReencodedBlockCount;
+				}
+			}
+		}
+
+		// Second pass, blocks above the cutoff at fHighQuality, and error map
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < (int)iJobCount; ++iJob)
+		{
+			const CompressJob& oJob = oJobs[iJob];
+			const int iMip = oJob.iSubresource / (iArraySize * iFaceCount);
+			const int iFace = oJob.iSubresource % iFaceCount;
+			const int iLayer = (oJob.iSubresource / iFaceCount) % iArraySize;
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+			const Texture::TextureFaceData& oNewFaceData = oNewTexture.GetData().GetFaceData(iMip, iFace, iLayer);
+			const int iWidth = oFaceData.iWidth;
+			const int iBlockCountX = (iWidth + 3) / 4;
+			float* pErrors = oBlockErrors.begin() + oJob.iFirstBlock;
+
+			bool bRowReencoded = false;
+			for (int iBlockX = 0; bReencode && iBlockX < iBlockCountX; ++iBlockX)
+			{
+				bRowReencoded |= pErrors[iBlockX] > fCutoff;
+			}
+
+			if (bRowReencoded)
+			{
+				const size_t iLinePitch = (size_t)iBlockCountX * 4 * oCodec.iPixelSize;
+				CORE_PTR_VOID pLines = Core::Malloc(iLinePitch * 4);
+				if (pLines == NULL)
+				{
+					bError = true;
+					continue;
+				}
+				LoadBlockRow(oCodec, oFaceData, eSourcePixelFormat, oJob.iSlice, oJob.iBlockRow, oChain, iChainLength, pLines, iLinePitch);
+
+				char* pDestBlocks = (char*)oNewFaceData.pData + (size_t)oJob.iSlice * oNewFaceData.iSlicePitch + (size_t)oJob.iBlockRow * oNewFaceData.iPitch;
+				for (int iBlockX = 0; iBlockX < iBlockCountX; ++iBlockX)
+				{
+					if (pErrors[iBlockX] <= fCutoff)
+						continue;
+
+					unsigned char oPixels[c_iMaxBlockPixelsSize];
+					unsigned char oDecoded[c_iMaxBlockPixelsSize];
+					unsigned char oBlock[16];
+					GetBlockPixels(pLines, iLinePitch, oCodec.iPixelSize, iBlockX, oPixels);
+					EncodeBlock(oCodec.eFormat, oPixels, oBlock, pHighQualityOptions);
+					DecodeBlock(oCodec.eFormat, oBlock, oDecoded);
+					const float fError = BlockError(oCodec, oPixels, oDecoded);
+					// Keep the encoding with the lowest error
+					if (fError < pErrors[iBlockX])
+					{
+						memcpy(pDestBlocks + (size_t)iBlockX * iBlockSize, oBlock, iBlockSize);
+						pErrors[iBlockX] = fError;
+					}
+				}
+
+				Core::Free(pLines);
+			}
+
+			if (pOutErrorMap != NULL)
+			{
+				const Texture::TextureFaceData& oErrorMapData = oErrorMap.GetData().GetFaceData(iMip, iFace, iLayer);
+				const int iStartY = oJob.iBlockRow * 4;
+				const int iLineCount = Math::Min(4, oFaceData.iHeight - iStartY);
+				for (int iY = 0; iY < iLineCount; ++iY)
+				{
+					float* pLine = (float*)((char*)oErrorMapData.pData + (size_t)oJob.iSlice * oErrorMapData.iSlicePitch + (size_t)(iStartY + iY) * oErrorMapData.iPitch);
+					for (int iX = 0; iX < iWidth; ++iX)
+					{
+						pLine[iX] = pErrors[iX / 4];
+					}
+				}
+			}
+		}
+
+		oCodec.pDestroyOptions(pOptions);
+		if (pHighQualityOptions != NULL)
+			oCodec.pDestroyOptions(pHighQualityOptions);
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		if (pOutReport != NULL)
+		{
+			BlockCompressionReport oReport;
+			double fSquaredError = 0.0;
+			for (size_t iBlock = 0; iBlock < iTotalBlockCount; ++iBlock)
+			{
+				fSquaredError += (double)oBlockErrors[iBlock] * oBlockErrors[iBlock];
+				oReport.fMaxBlockError = Math::Max(oReport.fMaxBlockError, oBlockErrors[iBlock]);
+			}
+			oReport.iBlockCount = iTotalBlockCount;
+			oReport.iReencodedBlockCount = iReencodedBlockCount;
+			oReport.fRMSE = (iTotalBlockCount > 0) ? sqrt(fSquaredError / (double)iTotalBlockCount) : 0.0;
+			*pOutReport = oReport;
+		}
+
+		pOutTexture->Swap(oNewTexture);
+		if (pOutErrorMap != NULL)
+			pOutErrorMap->Swap(oErrorMap);
+		return ErrorCode::Ok;
+	}
+}
+//namespace Graphics
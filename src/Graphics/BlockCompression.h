@@ -0,0 +1,40 @@
+#ifndef __GRAPHICS_BLOCK_COMPRESSION_H__
+#define __GRAPHICS_BLOCK_COMPRESSION_H__
+
+#include "Core/ErrorCode.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* BC encoding with per-block error feedback
+	All blocks are encoded at fQuality, decoded back and compared to their source pixels. Blocks with an error above
+	fErrorThreshold are then encoded again at fHighQuality, the largest errors first up to fMaxReencodedBlocks of the blocks,
+	and the encoding with the lowest error is kept. Encode time stays close to fQuality while the worst blocks get fHighQuality.
+	CMP_Core only has quality levels for BC6H and BC7, BC1 to BC5 are encoded once and only get the error report and map.
+	Error of a block is the RMSE of the components of the format, on normalized values (half float values for BC6H).
+	*/
+	struct BlockCompressionSettings
+	{
+		BlockCompressionSettings();
+		float						fQuality; // Quality of the first encode (0-1)
+		float						fHighQuality; // Quality of the blocks encoded again
+		float						fErrorThreshold; // Block RMSE above which a block is encoded again, negative to keep the first encode
+		float						fMaxReencodedBlocks; // Fraction of the blocks encoded again at most, those with the largest errors
+	};
+
+	struct BlockCompressionReport
+	{
+		BlockCompressionReport();
+		uint64_t					iBlockCount;
+		uint64_t					iReencodedBlockCount;
+		double						fRMSE; // Of all blocks
+		float						fMaxBlockError;
+	};
+
+	// pOutErrorMap receives a R32 float texture of the same dimensions, each pixel holds the error of its block
+	ErrorCode						CompressTexture(const Texture* pTexture, Texture* pOutTexture, PixelFormatEnum eWantedPixelFormat, const BlockCompressionSettings* pSettings = NULL, BlockCompressionReport* pOutReport = NULL, Texture* pOutErrorMap = NULL);
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_BLOCK_COMPRESSION_H__
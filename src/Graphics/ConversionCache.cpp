@@ -0,0 +1,314 @@
+#include "Graphics/ConversionCache.h"
+
+#include "Core/FileStream.h"
+#include "Core/Memory.h"
+#include "Core/StringUtils.h"
+
+#include <stdio.h> // remove
+#include <stdlib.h> // free
+
+namespace Graphics
+{
+	static const uint32_t c_iIndexMagic = 0x43435854; // "TXCC"
+	static const uint32_t c_iIndexVersion = 1;
+	static const char* const c_pIndexFilename = "index.bin";
+	static const size_t c_iCopyBufferSize = 1024 * 1024;
+
+	struct IndexHeader
+	{
+		uint32_t					iMagic;
+		uint32_t					iVersion;
+		uint64_t					iEntryCount;
+		uint64_t					iUseCounter;
+	};
+
+	// Copy a file through a write safe stream
+	// Opening a write safe stream creates the destination, a failed copy removes it when it didn't exist before
+	static bool CopyFile(const char* pSourceFilename, const char* pDestFilename, uint64_t* pOutSize)
+	{
+		Core::FileStream oSource;
+		if (oSource.Open(pSourceFilename, Core::FileStream::AccessModeEnum::READ) == false)
+			return false;
+
+		FILE* pExisting = fopen(pDestFilename, "rb");
+		bool bDestExisted = pExisting != NULL;
+		if (pExisting != NULL)
+			fclose(pExisting);
+
+		Core::FileStream oDest;
+		if (oDest.Open(pDestFilename, Core::FileStream::AccessModeEnum::WRITE_SAFE) == false)
+		{
+			oSource.Close();
+			if (bDestExisted == false)
+				remove(pDestFilename);
+			return false;
+		}
+
+		CORE_PTR_VOID pBuffer = Core::Malloc(c_iCopyBufferSize);
+		uint64_t iSize = 0;
+		bool bError = pBuffer == NULL;
+		while (bError == false)
+		{
+			size_t iRead = oSource.Read(pBuffer, c_iCopyBufferSize);
+			if (iRead == 0)
+				break;
+			if (oDest.Write(pBuffer, iRead) != iRead)
+			{
+				bError = true;
+				break;
+			}
+			iSize += iRead;
+		}
+		if (pBuffer != NULL)
+			Core::Free(pBuffer);
+		oSource.Close();
+
+		if (bError)
+		{
+			oDest.Cancel();
+		}
+		else if (oDest.Close() == false)
+		{
+			bError = true;
+		}
+
+		if (bError)
+		{
+			if (bDestExisted == false)
+				remove(pDestFilename);
+			return false;
+		}
+
+		if (pOutSize != NULL)
+			*pOutSize = iSize;
+		return true;
+	}
+
+	ConversionCache::ConversionCache()
+		: m_pDirectory(NULL)
+		, m_iSize(0)
+		, m_iMaxSize(0)
+		, m_iMaxEntryCount(0)
+		, m_iUseCounter(0)
+		, m_iHitCount(0)
+		, m_iMissCount(0)
+	{
+	}
+
+	ConversionCache::~ConversionCache()
+	{
+		if (IsOpen())
+		{
+			ErrorCode oErr = Close();
+			if (oErr != ErrorCode::Ok)
+				return;
+		}
+	}
+
+	ErrorCode ConversionCache::Open(const char* pDirectory, uint64_t iMaxSize, int iMaxEntryCount)
+	{
+		if (IsOpen())
+		{
+			ErrorCode oErr = Close();
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+		}
+
+		m_pDirectory = Core::StringUtils::StrDup(pDirectory);
+		m_iMaxSize = iMaxSize;
+		m_iMaxEntryCount = iMaxEntryCount;
+		m_iSize = 0;
+		m_iUseCounter = 0;
+		m_iHitCount = 0;
+		m_iMissCount = 0;
+		m_oEntries.clear();
+
+		char pIndexFilename[1024];
+		Core::StringUtils::SNPrintf(pIndexFilename, sizeof(pIndexFilename), "%s/%s", m_pDirectory, c_pIndexFilename);
+
+		Core::FileStream oIndex;
+		if (oIndex.Open(pIndexFilename, Core::FileStream::AccessModeEnum::READ) == false)
+			return ErrorCode::Ok; // New cache
+
+		IndexHeader oHeader;
+		if (oIndex.Read(&oHeader, sizeof(oHeader)) != sizeof(oHeader)
+			|| oHeader.iMagic != c_iIndexMagic
+			|| oHeader.iVersion != c_iIndexVersion)
+		{
+			// Unknown index, files of its entries are orphans and overwritten when their keys are stored again
+			oIndex.Close();
+			return ErrorCode::Ok;
+		}
+
+		if (m_oEntries.resize((size_t)oHeader.iEntryCount, false) == false)
+		{
+			oIndex.Close();
+			return ErrorCode(1, "Can't allocate cache index");
+		}
+		size_t iEntriesSize = sizeof(Entry) * (size_t)oHeader.iEntryCount;
+		if (iEntriesSize > 0 && oIndex.Read(&m_oEntries[0], iEntriesSize) != iEntriesSize)
+		{
+			oIndex.Close();
+			m_oEntries.clear();
+			return ErrorCode(1, "Cache index '%s' is truncated", pIndexFilename);
+		}
+		oIndex.Close();
+
+		m_iUseCounter = oHeader.iUseCounter;
+		for (size_t iEntry = 0; iEntry < m_oEntries.size(); ++iEntry)
+			m_iSize += m_oEntries[iEntry].iSize;
+
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ConversionCache::Close()
+	{
+		if (IsOpen() == false)
+			return ErrorCode::Ok;
+
+		Evict();
+
+		char pIndexFilename[1024];
+		Core::StringUtils::SNPrintf(pIndexFilename, sizeof(pIndexFilename), "%s/%s", m_pDirectory, c_pIndexFilename);
+		free(m_pDirectory);
+		m_pDirectory = NULL;
+
+		Core::FileStream oIndex;
+		if (oIndex.Open(pIndexFilename, Core::FileStream::AccessModeEnum::WRITE_SAFE) == false)
+			return ErrorCode(1, "Can't open cache index '%s'", pIndexFilename);
+
+		IndexHeader oHeader;
+		oHeader.iMagic = c_iIndexMagic;
+		oHeader.iVersion = c_iIndexVersion;
+		oHeader.iEntryCount = m_oEntries.size();
+		oHeader.iUseCounter = m_iUseCounter;
+		size_t iEntriesSize = sizeof(Entry) * m_oEntries.size();
+		if (oIndex.Write(&oHeader, sizeof(oHeader)) != sizeof(oHeader)
+			|| (iEntriesSize > 0 && oIndex.Write(&m_oEntries[0], iEntriesSize) != iEntriesSize))
+		{
+			oIndex.Cancel();
+			return ErrorCode(1, "Can't write cache index '%s'", pIndexFilename);
+		}
+		if (oIndex.Close() == false)
+			return ErrorCode(1, "Can't write cache index '%s'", pIndexFilename);
+
+		m_oEntries.clear();
+		m_iSize = 0;
+		return ErrorCode::Ok;
+	}
+
+	bool ConversionCache::Fetch(uint64_t iKey, const char* pFilename)
+	{
+		CORE_ASSERT(IsOpen());
+		size_t iIndex = FindEntry(iKey);
+		if (iIndex == (size_t)-1)
+		{
+			++m_iMissCount;
+			return false;
+		}
+
+		char pEntryFilename[1024];
+		GetEntryFilename(iKey, pEntryFilename, sizeof(pEntryFilename));
+		if (CopyFile(pEntryFilename, pFilename, NULL) == false)
+		{
+			// Entry file deleted or unreadable
+			RemoveEntry(iIndex);
+			++m_iMissCount;
+			return false;
+		}
+
+		m_oEntries[iIndex].iLastUse = ++m_iUseCounter;
+		++m_iHitCount;
+		return true;
+	}
+
+	ErrorCode ConversionCache::Store(uint64_t iKey, const char* pFilename)
+	{
+		CORE_ASSERT(IsOpen());
+		size_t iIndex = FindEntry(iKey);
+		if (iIndex != (size_t)-1)
+			RemoveEntry(iIndex);
+
+		char pEntryFilename[1024];
+		GetEntryFilename(iKey, pEntryFilename, sizeof(pEntryFilename));
+		Entry oEntry;
+		oEntry.iKey = iKey;
+		if (CopyFile(pFilename, pEntryFilename, &oEntry.iSize) == false)
+			return ErrorCode(1, "Can't copy '%s' to '%s'", pFilename, pEntryFilename);
+		oEntry.iLastUse = ++m_iUseCounter;
+
+		if (m_oEntries.push_back(oEntry) == false)
+		{
+			remove(pEntryFilename);
+			return ErrorCode(1, "Can't allocate cache entry");
+		}
+		m_iSize += oEntry.iSize;
+
+		Evict();
+		return ErrorCode::Ok;
+	}
+
+	size_t ConversionCache::FindEntry(uint64_t iKey) const
+	{
+		for (size_t iEntry = 0; iEntry < m_oEntries.size(); ++iEntry)
+		{
+			if (m_oEntries[iEntry].iKey == iKey)
+				return iEntry;
+		}
+		return (size_t)-1;
+	}
+
+	void ConversionCache::RemoveEntry(size_t iIndex)
+	{
+		m_iSize -= m_oEntries[iIndex].iSize;
+		m_oEntries[iIndex] = m_oEntries.back();
+		m_oEntries.pop_back();
+	}
+
+	void ConversionCache::Evict()
+	{
+		while (m_oEntries.empty() == false
+			&& ((m_iMaxSize > 0 && m_iSize > m_iMaxSize)
+				|| (m_iMaxEntryCount > 0 && m_oEntries.size() > (size_t)m_iMaxEntryCount)))
+		{
+			size_t iOldest = 0;
+			for (size_t iEntry = 1; iEntry < m_oEntries.size(); ++iEntry)
+			{
+				if (m_oEntries[iEntry].iLastUse < m_oEntries[iOldest].iLastUse)
+					iOldest = iEntry;
+			}
+
+			char pEntryFilename[1024];
+			GetEntryFilename(m_oEntries[iOldest].iKey, pEntryFilename, sizeof(pEntryFilename));
+			remove(pEntryFilename);
+			RemoveEntry(iOldest);
+		}
+	}
+
+	void ConversionCache::GetEntryFilename(uint64_t iKey, char* pOutFilename, size_t iOutFilenameSize) const
+	{
+		Core::StringUtils::SNPrintf(pOutFilename, iOutFilenameSize, "%s/%016llx.bin", m_pDirectory, (unsigned long long)iKey);
+	}
+
+	void HashTexture(const Texture* pTexture, Core::Hasher64* pHasher)
+	{
+		int32_t pDesc[7] = {
+			pTexture->GetWidth(),
+			pTexture->GetHeight(),
+			pTexture->GetDepth(),
+			(int32_t)pTexture->GetPixelFormat(),
+			pTexture->GetFaceCount(),
+			pTexture->GetArraySize(),
+			pTexture->GetMipCount()
+		};
+		pHasher->Update(pDesc, sizeof(pDesc));
+
+		const Texture::TextureData& oData = pTexture->GetData();
+		if (oData.GetDataSize() > 0)
+		{
+			const void* pData = oData.GetData();
+			pHasher->Update(pData, oData.GetDataSize());
+		}
+	}
+}
+//namespace Graphics
@@ -0,0 +1,67 @@
+#ifndef __GRAPHICS_CONVERSION_CACHE_H__
+#define __GRAPHICS_CONVERSION_CACHE_H__
+
+#include "Core/Array.h"
+#include "Core/ErrorCode.h"
+#include "Core/Hash.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* Persistent cache of conversion outputs for batch runs
+	Entries are output files stored in an existing directory under the hex name of their key, the key being the hash of the
+	source pixels (HashTexture) seeded with the hash of the conversion parameters. An index file keeps the size and the last use
+	of each entry, the least recently used entries are evicted when the cache exceeds its size or entry count limit.
+	The index is only written by Close, concurrent batch runs must use separate directories.
+	*/
+	class ConversionCache
+	{
+	public:
+									ConversionCache();
+									~ConversionCache(); // Close without checking the index write
+
+		// iMaxSize in bytes and iMaxEntryCount, 0 for no limit
+		ErrorCode					Open(const char* pDirectory, uint64_t iMaxSize, int iMaxEntryCount = 0);
+		// Evict above the limits and write the index
+		ErrorCode					Close();
+		bool						IsOpen() const { return m_pDirectory != NULL; }
+
+		// Copy the cached output of iKey to pFilename, false when iKey is not cached or can't be copied
+		bool						Fetch(uint64_t iKey, const char* pFilename);
+		// Copy pFilename in the cache as the output of iKey
+		ErrorCode					Store(uint64_t iKey, const char* pFilename);
+
+		uint64_t					GetSize() const { return m_iSize; }
+		int							GetEntryCount() const { return (int)m_oEntries.size(); }
+		int							GetHitCount() const { return m_iHitCount; }
+		int							GetMissCount() const { return m_iMissCount; }
+	protected:
+		struct Entry
+		{
+			uint64_t				iKey;
+			uint64_t				iSize;
+			uint64_t				iLastUse;
+		};
+
+		size_t						FindEntry(uint64_t iKey) const;
+		void						RemoveEntry(size_t iIndex);
+		void						Evict();
+		void						GetEntryFilename(uint64_t iKey, char* pOutFilename, size_t iOutFilenameSize) const;
+
+		char*						m_pDirectory;
+		Core::Array<Entry>			m_oEntries;
+		uint64_t					m_iSize;
+		uint64_t					m_iMaxSize;
+		int							m_iMaxEntryCount;
+		uint64_t					m_iUseCounter;
+		int							m_iHitCount;
+		int							m_iMissCount;
+	};
+
+	// Feed the desc and all pixels (GetData) of a texture, the hash changes with any pixel, dimension or format change
+	void							HashTexture(const Texture* pTexture, Core::Hasher64* pHasher);
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_CONVERSION_CACHE_H__
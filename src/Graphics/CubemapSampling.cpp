@@ -0,0 +1,518 @@
+#include "Graphics/CubemapSampling.h"
+
+#include "Core/Assert.h"
+
+#include <emmintrin.h> //SIMD
+#include <math.h> // floor/sin/cos/fabs
+
+namespace Graphics
+{
+	namespace CubemapSampling
+	{
+		static const float c_fPi = 3.14159265358979323846f;
+		static const float c_fHalfPi = 1.57079632679489661923f;
+		static const float c_fInvPi = 0.31830988618379067153f;
+
+		// U axis, V axis and normal of each face
+		static const float c_fFaceVectors[Texture::_E_FACE_COUNT][3][3] =
+		{
+			{ { 0.0f,  0.0f, -1.0f }, { 0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f } }, // +x
+			{ { 0.0f,  0.0f,  1.0f }, { 0.0f, -1.0f,  0.0f }, { -1.0f,  0.0f,  0.0f } }, // -x
+			{ { 1.0f,  0.0f,  0.0f }, { 0.0f,  0.0f,  1.0f }, {  0.0f,  1.0f,  0.0f } }, // +y
+			{ { 1.0f,  0.0f,  0.0f }, { 0.0f,  0.0f, -1.0f }, {  0.0f, -1.0f,  0.0f } }, // -y
+			{ { 1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f }, {  0.0f,  0.0f,  1.0f } }, // +z
+			{ {-1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } }  // -z
+		};
+
+		// atan(x) for x in [0, 1], minimax polynomial
+		static inline __m128 AtanUnit(__m128 xX)
+		{
+			const __m128 xX2 = _mm_mul_ps(xX, xX);
+			__m128 xPoly = _mm_set1_ps(-0.0117212f);
+			xPoly = _mm_add_ps(_mm_mul_ps(xPoly, xX2), _mm_set1_ps(0.05265332f));
+			xPoly = _mm_add_ps(_mm_mul_ps(xPoly, xX2), _mm_set1_ps(-0.11643287f));
+			xPoly = _mm_add_ps(_mm_mul_ps(xPoly, xX2), _mm_set1_ps(0.19354346f));
+			xPoly = _mm_add_ps(_mm_mul_ps(xPoly, xX2), _mm_set1_ps(-0.33262347f));
+			xPoly = _mm_add_ps(_mm_mul_ps(xPoly, xX2), _mm_set1_ps(0.99997726f));
+			return _mm_mul_ps(xPoly, xX);
+		}
+
+		static inline __m128 Select(__m128 xMask, __m128 xTrue, __m128 xFalse)
+		{
+			return _mm_or_ps(_mm_and_ps(xMask, xTrue), _mm_andnot_ps(xMask, xFalse));
+		}
+
+		static inline __m128 Atan2(__m128 xY, __m128 xX)
+		{
+			const __m128 xSignMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+			const __m128 xAbsY = _mm_andnot_ps(xSignMask, xY);
+			const __m128 xAbsX = _mm_andnot_ps(xSignMask, xX);
+			const __m128 xMax = _mm_max_ps(_mm_max_ps(xAbsX, xAbsY), _mm_set1_ps(1e-30f));
+			const __m128 xMin = _mm_min_ps(xAbsX, xAbsY);
+
+			__m128 xAngle = AtanUnit(_mm_div_ps(xMin, xMax));
+			xAngle = Select(_mm_cmpgt_ps(xAbsY, xAbsX), _mm_sub_ps(_mm_set1_ps(c_fHalfPi), xAngle), xAngle);
+			xAngle = Select(_mm_cmplt_ps(xX, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(c_fPi), xAngle), xAngle);
+			// Sign of Y
+			return _mm_or_ps(xAngle, _mm_and_ps(xY, xSignMask));
+		}
+
+		void GetFaceDirections(Texture::EFace eFace, int iFaceSize, int iY, float* pOutX, float* pOutY, float* pOutZ)
+		{
+			const float (&oVectors)[3][3] = c_fFaceVectors[eFace];
+			const float fScale = 2.f / iFaceSize;
+			const float fV = (iY + 0.5f) * fScale - 1.f;
+
+			// Constant part for the line : normal + V * V axis
+			const __m128 xBaseX = _mm_set1_ps(oVectors[2][0] + fV * oVectors[1][0]);
+			const __m128 xBaseY = _mm_set1_ps(oVectors[2][1] + fV * oVectors[1][1]);
+			const __m128 xBaseZ = _mm_set1_ps(oVectors[2][2] + fV * oVectors[1][2]);
+			const __m128 xAxisX = _mm_set1_ps(oVectors[0][0]);
+			const __m128 xAxisY = _mm_set1_ps(oVectors[0][1]);
+			const __m128 xAxisZ = _mm_set1_ps(oVectors[0][2]);
+
+			const __m128 xStep = _mm_set1_ps(4.f * fScale);
+			__m128 xU = _mm_sub_ps(_mm_mul_ps(_mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f), _mm_set1_ps(fScale)), _mm_set1_ps(1.f));
+
+			int iX = 0;
+			for (; iX + 4 <= iFaceSize; iX += 4)
+			{
+				_mm_storeu_ps(pOutX + iX, _mm_add_ps(xBaseX, _mm_mul_ps(xU, xAxisX)));
+				_mm_storeu_ps(pOutY + iX, _mm_add_ps(xBaseY, _mm_mul_ps(xU, xAxisY)));
+				_mm_storeu_ps(pOutZ + iX, _mm_add_ps(xBaseZ, _mm_mul_ps(xU, xAxisZ)));
+				xU = _mm_add_ps(xU, xStep);
+			}
+			for (; iX < iFaceSize; ++iX)
+			{
+				const float fU = (iX + 0.5f) * fScale - 1.f;
+				pOutX[iX] = oVectors[2][0] + fV * oVectors[1][0] + fU * oVectors[0][0];
+				pOutY[iX] = oVectors[2][1] + fV * oVectors[1][1] + fU * oVectors[0][1];
+				pOutZ[iX] = oVectors[2][2] + fV * oVectors[1][2] + fU * oVectors[0][2];
+			}
+		}
+
+		void DirectionsToLatLong(const float* pX, const float* pY, const float* pZ, int iCount, float* pOutU, float* pOutV)
+		{
+			const __m128 xHalf = _mm_set1_ps(0.5f);
+			const __m128 xHalfInvPi = _mm_set1_ps(0.5f * c_fInvPi);
+			const __m128 xInvPi = _mm_set1_ps(c_fInvPi);
+			const __m128 xHalfPi = _mm_set1_ps(c_fHalfPi);
+
+			int iIndex = 0;
+			for (; iIndex < iCount; iIndex += 4)
+			{
+				__m128 xX, xY, xZ;
+				if (iIndex + 4 <= iCount)
+				{
+					xX = _mm_loadu_ps(pX + iIndex);
+					xY = _mm_loadu_ps(pY + iIndex);
+					xZ = _mm_loadu_ps(pZ + iIndex);
+				}
+				else
+				{
+					float fX[4] = { 0.f, 0.f, 0.f, 0.f }, fY[4] = { 0.f, 0.f, 0.f, 0.f }, fZ[4] = { 1.f, 1.f, 1.f, 1.f };
+					for (int iLane = 0; iIndex + iLane < iCount; ++iLane)
+					{
+						fX[iLane] = pX[iIndex + iLane];
+						fY[iLane] = pY[iIndex + iLane];
+						fZ[iLane] = pZ[iIndex + iLane];
+					}
+					xX = _mm_loadu_ps(fX);
+					xY = _mm_loadu_ps(fY);
+					xZ = _mm_loadu_ps(fZ);
+				}
+
+				// Longitude from atan2(x, z), colatitude from acos(y / |d|) = pi / 2 - atan2(y, |xz|)
+				const __m128 xPhi = Atan2(xX, xZ);
+				const __m128 xHorizontalLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(xX, xX), _mm_mul_ps(xZ, xZ)));
+				const __m128 xTheta = _mm_sub_ps(xHalfPi, Atan2(xY, xHorizontalLength));
+
+				const __m128 xU = _mm_add_ps(_mm_mul_ps(xPhi, xHalfInvPi), xHalf);
+				const __m128 xV = _mm_mul_ps(xTheta, xInvPi);
+
+				if (iIndex + 4 <= iCount)
+				{
+					_mm_storeu_ps(pOutU + iIndex, xU);
+					_mm_storeu_ps(pOutV + iIndex, xV);
+				}
+				else
+				{
+					float fU[4], fV[4];
+					_mm_storeu_ps(fU, xU);
+					_mm_storeu_ps(fV, xV);
+					for (int iLane = 0; iIndex + iLane < iCount; ++iLane)
+					{
+						pOutU[iIndex + iLane] = fU[iLane];
+						pOutV[iIndex + iLane] = fV[iLane];
+					}
+				}
+			}
+		}
+
+		void SampleBilinear(const float* pImage, int iWidth, int iHeight, const float* pU, const float* pV, int iCount, float* pOutPixels)
+		{
+			CORE_ASSERT(iWidth > 0 && iHeight > 0);
+			const size_t iPitch = (size_t)iWidth * 4;
+			for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			{
+				const float fX = pU[iIndex] * iWidth - 0.5f;
+				const float fY = pV[iIndex] * iHeight - 0.5f;
+				const float fFloorX = floorf(fX);
+				const float fFloorY = floorf(fY);
+				const float fTX = fX - fFloorX;
+				const float fTY = fY - fFloorY;
+
+				int iX0 = (int)fFloorX % iWidth;
+				if (iX0 < 0)
+					iX0 += iWidth;
+				const int iX1 = (iX0 + 1 == iWidth) ? 0 : iX0 + 1;
+				int iY0 = (int)fFloorY;
+				int iY1 = iY0 + 1;
+				iY0 = iY0 < 0 ? 0 : (iY0 >= iHeight ? iHeight - 1 : iY0);
+				iY1 = iY1 < 0 ? 0 : (iY1 >= iHeight ? iHeight - 1 : iY1);
+
+				const float* pLine0 = pImage + iY0 * iPitch;
+				const float* pLine1 = pImage + iY1 * iPitch;
+				const __m128 xTX = _mm_set1_ps(fTX);
+				const __m128 xTY = _mm_set1_ps(fTY);
+				const __m128 xP00 = _mm_loadu_ps(pLine0 + iX0 * 4);
+				const __m128 xP10 = _mm_loadu_ps(pLine0 + iX1 * 4);
+				const __m128 xP01 = _mm_loadu_ps(pLine1 + iX0 * 4);
+				const __m128 xP11 = _mm_loadu_ps(pLine1 + iX1 * 4);
+				const __m128 xTop = _mm_add_ps(xP00, _mm_mul_ps(_mm_sub_ps(xP10, xP00), xTX));
+				const __m128 xBottom = _mm_add_ps(xP01, _mm_mul_ps(_mm_sub_ps(xP11, xP01), xTX));
+				_mm_storeu_ps(pOutPixels + (size_t)iIndex * 4, _mm_add_ps(xTop, _mm_mul_ps(_mm_sub_ps(xBottom, xTop), xTY)));
+			}
+		}
+
+		bool ComputeLongitudes(int iWidth, Core::Array<float>* pOutSin, Core::Array<float>* pOutCos)
+		{
+			if (pOutSin->resize(iWidth, false) == false || pOutCos->resize(iWidth, false) == false)
+				return false;
+
+			for (int iX = 0; iX < iWidth; ++iX)
+			{
+				const double fPhi = ((iX + 0.5) / iWidth - 0.5) * 2.0 * c_fPi;
+				(*pOutSin)[iX] = (float)sin(fPhi);
+				(*pOutCos)[iX] = (float)cos(fPhi);
+			}
+			return true;
+		}
+
+		void GetLatLongDirections(const float* pSinLongitudes, const float* pCosLongitudes, int iWidth, int iHeight, int iY, float* pOutX, float* pOutY, float* pOutZ)
+		{
+			const double fTheta = (iY + 0.5) / iHeight * c_fPi;
+			const float fSinTheta = (float)sin(fTheta);
+			const __m128 xSinTheta = _mm_set1_ps(fSinTheta);
+			const __m128 xCosTheta = _mm_set1_ps((float)cos(fTheta));
+
+			int iX = 0;
+			for (; iX + 4 <= iWidth; iX += 4)
+			{
+				_mm_storeu_ps(pOutX + iX, _mm_mul_ps(_mm_loadu_ps(pSinLongitudes + iX), xSinTheta));
+				_mm_storeu_ps(pOutY + iX, xCosTheta);
+				_mm_storeu_ps(pOutZ + iX, _mm_mul_ps(_mm_loadu_ps(pCosLongitudes + iX), xSinTheta));
+			}
+			for (; iX < iWidth; ++iX)
+			{
+				pOutX[iX] = pSinLongitudes[iX] * fSinTheta;
+				pOutY[iX] = (float)cos(fTheta);
+				pOutZ[iX] = pCosLongitudes[iX] * fSinTheta;
+			}
+		}
+
+		void DirectionsToFaces(const float* pX, const float* pY, const float* pZ, int iCount, int* pOutFaces, float* pOutU, float* pOutV)
+		{
+			const __m128 xSignMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+			const __m128 xZero = _mm_setzero_ps();
+			const __m128 xOne = _mm_set1_ps(1.f);
+			const __m128 xHalf = _mm_set1_ps(0.5f);
+
+			for (int iIndex = 0; iIndex < iCount; iIndex += 4)
+			{
+				float fX[4] = { 1.f, 1.f, 1.f, 1.f }, fY[4] = { 0.f, 0.f, 0.f, 0.f }, fZ[4] = { 0.f, 0.f, 0.f, 0.f };
+				const int iLaneCount = (iIndex + 4 <= iCount) ? 4 : iCount - iIndex;
+				__m128 xX, xY, xZ;
+				if (iLaneCount == 4)
+				{
+					xX = _mm_loadu_ps(pX + iIndex);
+					xY = _mm_loadu_ps(pY + iIndex);
+					xZ = _mm_loadu_ps(pZ + iIndex);
+				}
+				else
+				{
+					for (int iLane = 0; iLane < iLaneCount; ++iLane)
+					{
+						fX[iLane] = pX[iIndex + iLane];
+						fY[iLane] = pY[iIndex + iLane];
+						fZ[iLane] = pZ[iIndex + iLane];
+					}
+					xX = _mm_loadu_ps(fX);
+					xY = _mm_loadu_ps(fY);
+					xZ = _mm_loadu_ps(fZ);
+				}
+
+				const __m128 xAbsX = _mm_andnot_ps(xSignMask, xX);
+				const __m128 xAbsY = _mm_andnot_ps(xSignMask, xY);
+				const __m128 xAbsZ = _mm_andnot_ps(xSignMask, xZ);
+				const __m128 xIsX = _mm_and_ps(_mm_cmpge_ps(xAbsX, xAbsY), _mm_cmpge_ps(xAbsX, xAbsZ));
+				const __m128 xIsY = _mm_andnot_ps(xIsX, _mm_cmpge_ps(xAbsY, xAbsZ));
+				const __m128 xNegX = _mm_cmplt_ps(xX, xZero);
+				const __m128 xNegY = _mm_cmplt_ps(xY, xZero);
+				const __m128 xNegZ = _mm_cmplt_ps(xZ, xZero);
+				const __m128 xMinusY = _mm_xor_ps(xY, xSignMask);
+
+				// Face axes, see c_fFaceVectors
+				const __m128 xSC = Select(xIsX, Select(xNegX, xZ, _mm_xor_ps(xZ, xSignMask)),
+					Select(xIsY, xX, Select(xNegZ, _mm_xor_ps(xX, xSignMask), xX)));
+				const __m128 xTC = Select(xIsY, Select(xNegY, _mm_xor_ps(xZ, xSignMask), xZ), xMinusY);
+				const __m128 xMajor = Select(xIsX, xAbsX, Select(xIsY, xAbsY, xAbsZ));
+				const __m128 xFace = _mm_add_ps(
+					Select(xIsX, xZero, Select(xIsY, _mm_set1_ps(2.f), _mm_set1_ps(4.f))),
+					_mm_and_ps(Select(xIsX, xNegX, Select(xIsY, xNegY, xNegZ)), xOne));
+
+				const __m128 xInvMajor = _mm_div_ps(xHalf, _mm_max_ps(xMajor, _mm_set1_ps(1e-30f)));
+				const __m128 xU = _mm_add_ps(_mm_mul_ps(xSC, xInvMajor), xHalf);
+				const __m128 xV = _mm_add_ps(_mm_mul_ps(xTC, xInvMajor), xHalf);
+				const __m128i xFaceIndex = _mm_cvttps_epi32(xFace);
+
+				if (iLaneCount == 4)
+				{
+					_mm_storeu_ps(pOutU + iIndex, xU);
+					_mm_storeu_ps(pOutV + iIndex, xV);
+					_mm_storeu_si128((__m128i*)(pOutFaces + iIndex), xFaceIndex);
+				}
+				else
+				{
+					float fU[4], fV[4];
+					int iFaces[4];
+					_mm_storeu_ps(fU, xU);
+					_mm_storeu_ps(fV, xV);
+					_mm_storeu_si128((__m128i*)iFaces, xFaceIndex);
+					for (int iLane = 0; iLane < iLaneCount; ++iLane)
+					{
+						pOutU[iIndex + iLane] = fU[iLane];
+						pOutV[iIndex + iLane] = fV[iLane];
+						pOutFaces[iIndex + iLane] = iFaces[iLane];
+					}
+				}
+			}
+		}
+
+		void SampleFacesBilinear(const float* const* pFaces, int iFaceSize, const int* pFacesIndex, const float* pU, const float* pV, int iCount, float* pOutPixels)
+		{
+			const size_t iPitch = (size_t)iFaceSize * 4;
+			const float fMax = (float)(iFaceSize - 1);
+			for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			{
+				float fX = pU[iIndex] * iFaceSize - 0.5f;
+				float fY = pV[iIndex] * iFaceSize - 0.5f;
+				fX = fX < 0.f ? 0.f : (fX > fMax ? fMax : fX);
+				fY = fY < 0.f ? 0.f : (fY > fMax ? fMax : fY);
+				const int iX0 = (int)fX;
+				const int iY0 = (int)fY;
+				const int iX1 = iX0 + 1 < iFaceSize ? iX0 + 1 : iX0;
+				const int iY1 = iY0 + 1 < iFaceSize ? iY0 + 1 : iY0;
+
+				const float* pFace = pFaces[pFacesIndex[iIndex]];
+				const float* pLine0 = pFace + iY0 * iPitch;
+				const float* pLine1 = pFace + iY1 * iPitch;
+				const __m128 xTX = _mm_set1_ps(fX - iX0);
+				const __m128 xTY = _mm_set1_ps(fY - iY0);
+				const __m128 xP00 = _mm_loadu_ps(pLine0 + iX0 * 4);
+				const __m128 xP10 = _mm_loadu_ps(pLine0 + iX1 * 4);
+				const __m128 xP01 = _mm_loadu_ps(pLine1 + iX0 * 4);
+				const __m128 xP11 = _mm_loadu_ps(pLine1 + iX1 * 4);
+				const __m128 xTop = _mm_add_ps(xP00, _mm_mul_ps(_mm_sub_ps(xP10, xP00), xTX));
+				const __m128 xBottom = _mm_add_ps(xP01, _mm_mul_ps(_mm_sub_ps(xP11, xP01), xTX));
+				_mm_storeu_ps(pOutPixels + (size_t)iIndex * 4, _mm_add_ps(xTop, _mm_mul_ps(_mm_sub_ps(xBottom, xTop), xTY)));
+			}
+		}
+
+		size_t GetFaceBordersFloatCount(int iFaceSize, int iBorder)
+		{
+			return ((size_t)2 * iBorder * (iFaceSize + 2 * iBorder) + (size_t)2 * iBorder * iFaceSize) * 4;
+		}
+
+		const float* GetFaceBordersLine(const float* pFaceBorders, int iFaceSize, int iBorder, int iPaddedY)
+		{
+			const size_t iPaddedSize = (size_t)iFaceSize + 2 * iBorder;
+			if (iPaddedY < iBorder)
+				return pFaceBorders + iPaddedSize * 4 * iPaddedY;
+			if (iPaddedY < iBorder + iFaceSize)
+				return pFaceBorders + iPaddedSize * 4 * iBorder + (size_t)2 * iBorder * 4 * (iPaddedY - iBorder);
+			return pFaceBorders + iPaddedSize * 4 * iBorder + (size_t)2 * iBorder * 4 * iFaceSize + iPaddedSize * 4 * (iPaddedY - iBorder - iFaceSize);
+		}
+
+		bool FillFaceBorders(const float* const* pFaces, size_t iFacePitch, int iFaceSize, int iBorder, float* pOutBorders)
+		{
+			CORE_ASSERT(iBorder >= 0 && iBorder <= iFaceSize);
+			const int iPaddedSize = iFaceSize + 2 * iBorder;
+			const size_t iFaceBordersFloatCount = GetFaceBordersFloatCount(iFaceSize, iBorder);
+			const float fScale = 2.f / iFaceSize;
+			// Texel centers closest to the edges
+			const float fEdge = 1.f - 0.5f * fScale;
+
+			// Border texels of a padded line : X, Y, Z, U, V, face and column
+			Core::Array<float> oWorking;
+			if (oWorking.resize((size_t)iPaddedSize * 7, false) == false)
+				return false;
+			float* pX = oWorking.begin();
+			float* pY = pX + iPaddedSize;
+			float* pZ = pY + iPaddedSize;
+			float* pU = pZ + iPaddedSize;
+			float* pV = pU + iPaddedSize;
+			int* pFacesIndex = (int*)(pV + iPaddedSize);
+			int* pColumns = pFacesIndex + iPaddedSize;
+
+			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+			{
+				const float (&oVectors)[3][3] = c_fFaceVectors[iFace];
+				float* pFaceBorders = pOutBorders + iFaceBordersFloatCount * iFace;
+				for (int iPaddedY = 0; iPaddedY < iPaddedSize; ++iPaddedY)
+				{
+					const int iY = iPaddedY - iBorder;
+					const bool bCenterLine = iY >= 0 && iY < iFaceSize;
+					const float fV = (iY + 0.5f) * fScale - 1.f;
+
+					int iCount = 0;
+					for (int iPaddedX = 0; iPaddedX < iPaddedSize; ++iPaddedX)
+					{
+						if (bCenterLine && iPaddedX == iBorder)
+						{
+							iPaddedX += iFaceSize - 1;
+							continue;
+						}
+
+						// Point on the plane of the adjacent face, at the same distance from the shared edge
+						float fU = (iPaddedX - iBorder + 0.5f) * fScale - 1.f;
+						float fLineV = fV;
+						float fNormal;
+						if (fabsf(fU) >= fabsf(fLineV))
+						{
+							fLineV = fLineV < -fEdge ? -fEdge : (fLineV > fEdge ? fEdge : fLineV);
+							fNormal = 2.f - fabsf(fU);
+							fU = fU > 0.f ? 1.f : -1.f;
+						}
+						else
+						{
+							fU = fU < -fEdge ? -fEdge : (fU > fEdge ? fEdge : fU);
+							fNormal = 2.f - fabsf(fLineV);
+							fLineV = fLineV > 0.f ? 1.f : -1.f;
+						}
+						pX[iCount] = oVectors[2][0] * fNormal + oVectors[0][0] * fU + oVectors[1][0] * fLineV;
+						pY[iCount] = oVectors[2][1] * fNormal + oVectors[0][1] * fU + oVectors[1][1] * fLineV;
+						pZ[iCount] = oVectors[2][2] * fNormal + oVectors[0][2] * fU + oVectors[1][2] * fLineV;
+						// Right border of face lines directly follows the left one
+						pColumns[iCount] = (bCenterLine && iPaddedX > iBorder) ? iPaddedX - iFaceSize : iPaddedX;
+						++iCount;
+					}
+
+					DirectionsToFaces(pX, pY, pZ, iCount, pFacesIndex, pU, pV);
+
+					float* pLine = (float*)GetFaceBordersLine(pFaceBorders, iFaceSize, iBorder, iPaddedY);
+					for (int iIndex = 0; iIndex < iCount; ++iIndex)
+					{
+						int iSourceX = (int)(pU[iIndex] * iFaceSize);
+						int iSourceY = (int)(pV[iIndex] * iFaceSize);
+						iSourceX = iSourceX < 0 ? 0 : (iSourceX >= iFaceSize ? iFaceSize - 1 : iSourceX);
+						iSourceY = iSourceY < 0 ? 0 : (iSourceY >= iFaceSize ? iFaceSize - 1 : iSourceY);
+						const float* pSource = (const float*)((const char*)pFaces[pFacesIndex[iIndex]] + iFacePitch * iSourceY) + (size_t)iSourceX * 4;
+						_mm_storeu_ps(pLine + (size_t)pColumns[iIndex] * 4, _mm_loadu_ps(pSource));
+					}
+				}
+			}
+			return true;
+		}
+
+		void GetLineFrames(const float* pX, const float* pY, const float* pZ, int iCount, const LineFrames& oOutFrames)
+		{
+			const __m128 xSignMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+			const __m128 xZero = _mm_setzero_ps();
+			const __m128 xLimit = _mm_set1_ps(0.999f);
+			const __m128 xTiny = _mm_set1_ps(1e-30f);
+
+			for (int iIndex = 0; iIndex < iCount; iIndex += 4)
+			{
+				float fX[4] = { 0.f, 0.f, 0.f, 0.f }, fY[4] = { 0.f, 0.f, 0.f, 0.f }, fZ[4] = { 1.f, 1.f, 1.f, 1.f };
+				const int iLaneCount = (iIndex + 4 <= iCount) ? 4 : iCount - iIndex;
+				for (int iLane = 0; iLane < iLaneCount; ++iLane)
+				{
+					fX[iLane] = pX[iIndex + iLane];
+					fY[iLane] = pY[iIndex + iLane];
+					fZ[iLane] = pZ[iIndex + iLane];
+				}
+				__m128 xNX = _mm_loadu_ps(fX);
+				__m128 xNY = _mm_loadu_ps(fY);
+				__m128 xNZ = _mm_loadu_ps(fZ);
+
+				const __m128 xInvLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xNX, xNX), _mm_mul_ps(xNY, xNY)), _mm_mul_ps(xNZ, xNZ)), xTiny)));
+				xNX = _mm_mul_ps(xNX, xInvLength);
+				xNY = _mm_mul_ps(xNY, xInvLength);
+				xNZ = _mm_mul_ps(xNZ, xInvLength);
+
+				// Tangent = normalize(cross(up, N)), up is Z or X
+				const __m128 xUseZ = _mm_cmplt_ps(_mm_andnot_ps(xSignMask, xNZ), xLimit);
+				__m128 xTX = Select(xUseZ, _mm_xor_ps(xNY, xSignMask), xZero);
+				__m128 xTY = Select(xUseZ, xNX, _mm_xor_ps(xNZ, xSignMask));
+				__m128 xTZ = Select(xUseZ, xZero, xNY);
+				const __m128 xInvTangentLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(_mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xTX, xTX), _mm_mul_ps(xTY, xTY)), _mm_mul_ps(xTZ, xTZ)), xTiny)));
+				xTX = _mm_mul_ps(xTX, xInvTangentLength);
+				xTY = _mm_mul_ps(xTY, xInvTangentLength);
+				xTZ = _mm_mul_ps(xTZ, xInvTangentLength);
+
+				// Bitangent = cross(N, T)
+				const __m128 xBX = _mm_sub_ps(_mm_mul_ps(xNY, xTZ), _mm_mul_ps(xNZ, xTY));
+				const __m128 xBY = _mm_sub_ps(_mm_mul_ps(xNZ, xTX), _mm_mul_ps(xNX, xTZ));
+				const __m128 xBZ = _mm_sub_ps(_mm_mul_ps(xNX, xTY), _mm_mul_ps(xNY, xTX));
+
+				const __m128 xAxes[3][3] = { { xTX, xTY, xTZ }, { xBX, xBY, xBZ }, { xNX, xNY, xNZ } };
+				for (int iAxis = 0; iAxis < 3; ++iAxis)
+				{
+					for (int iComponent = 0; iComponent < 3; ++iComponent)
+					{
+						float* pOut = oOutFrames.pAxes[iAxis][iComponent] + iIndex;
+						if (iLaneCount == 4)
+						{
+							_mm_storeu_ps(pOut, xAxes[iAxis][iComponent]);
+						}
+						else
+						{
+							float fValues[4];
+							_mm_storeu_ps(fValues, xAxes[iAxis][iComponent]);
+							for (int iLane = 0; iLane < iLaneCount; ++iLane)
+								pOut[iLane] = fValues[iLane];
+						}
+					}
+				}
+			}
+		}
+
+		void TransformFromFrames(const LineFrames& oFrames, int iCount, float fX, float fY, float fZ, float* pOutX, float* pOutY, float* pOutZ)
+		{
+			const __m128 xX = _mm_set1_ps(fX);
+			const __m128 xY = _mm_set1_ps(fY);
+			const __m128 xZ = _mm_set1_ps(fZ);
+			float* const pOut[3] = { pOutX, pOutY, pOutZ };
+			for (int iComponent = 0; iComponent < 3; ++iComponent)
+			{
+				const float* pTangent = oFrames.pAxes[0][iComponent];
+				const float* pBitangent = oFrames.pAxes[1][iComponent];
+				const float* pNormal = oFrames.pAxes[2][iComponent];
+				float* pDest = pOut[iComponent];
+				int iIndex = 0;
+				for (; iIndex + 4 <= iCount; iIndex += 4)
+				{
+					const __m128 xSum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pTangent + iIndex), xX), _mm_mul_ps(_mm_loadu_ps(pBitangent + iIndex), xY)), _mm_mul_ps(_mm_loadu_ps(pNormal + iIndex), xZ));
+					_mm_storeu_ps(pDest + iIndex, xSum);
+				}
+				for (; iIndex < iCount; ++iIndex)
+				{
+					pDest[iIndex] = pTangent[iIndex] * fX + pBitangent[iIndex] * fY + pNormal[iIndex] * fZ;
+				}
+			}
+		}
+	}
+	//namespace CubemapSampling
+}
+//namespace Graphics
@@ -0,0 +1,60 @@
+#ifndef __GRAPHICS_CUBEMAP_SAMPLING_H__
+#define __GRAPHICS_CUBEMAP_SAMPLING_H__
+
+#include "Core/Array.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* Cubemap and LatLong projections of RGBA float images
+	Functions process a line of texels at once, 4 texels per SSE register,
+	directions and coordinates are stored as separated X/Y/Z (U/V) arrays.
+	Face orientations follow D3D conventions.
+	LatLong U is the longitude (0 at -Z, 0.5 at +Z), V the colatitude (0 at +Y).
+	*/
+	namespace CubemapSampling
+	{
+		// Directions (not normalized) of texel centers [0, iFaceSize[ of line iY of a face
+		void						GetFaceDirections(Texture::EFace eFace, int iFaceSize, int iY, float* pOutX, float* pOutY, float* pOutZ);
+
+		// LatLong texture coordinates [0, 1] of directions (not normalized), atan2 is a polynomial approximation (error < 1e-5 rad)
+		void						DirectionsToLatLong(const float* pX, const float* pY, const float* pZ, int iCount, float* pOutU, float* pOutV);
+
+		// Bilinear fetch of an RGBA float image at texture coordinates [0, 1], U wraps, V is clamped
+		void						SampleBilinear(const float* pImage, int iWidth, int iHeight, const float* pU, const float* pV, int iCount, float* pOutPixels);
+
+		// Sine and cosine of the longitude of each column of a LatLong image, computed once per image
+		bool						ComputeLongitudes(int iWidth, Core::Array<float>* pOutSin, Core::Array<float>* pOutCos);
+		// Unit directions of texel centers of line iY of a LatLong image
+		void						GetLatLongDirections(const float* pSinLongitudes, const float* pCosLongitudes, int iWidth, int iHeight, int iY, float* pOutX, float* pOutY, float* pOutZ);
+
+		// Face and face texture coordinates [0, 1] of directions (not normalized), selected by major axis
+		void						DirectionsToFaces(const float* pX, const float* pY, const float* pZ, int iCount, int* pOutFaces, float* pOutU, float* pOutV);
+		// Bilinear fetch of RGBA float faces, clamped to face edges
+		void						SampleFacesBilinear(const float* const* pFaces, int iFaceSize, const int* pFacesIndex, const float* pU, const float* pV, int iCount, float* pOutPixels);
+
+		// Borders of a face padded by iBorder texels, stored line by line without the face itself : iBorder lines of iFaceSize + 2 * iBorder texels,
+		// iFaceSize lines of 2 * iBorder texels (left then right border), iBorder lines of iFaceSize + 2 * iBorder texels
+		size_t						GetFaceBordersFloatCount(int iFaceSize, int iBorder);
+		// First texel of padded line iPaddedY in the borders of a face, the right border of face lines follows the left one
+		const float*				GetFaceBordersLine(const float* pFaceBorders, int iFaceSize, int iBorder, int iPaddedY);
+		// Fill the borders of 6 RGBA float faces (D3D order, iFacePitch bytes between lines), borders of each face are stored one after the other
+		// Border texels are unfolded on the adjacent face across the shared edge, corners repeat the closest edge, iBorder <= iFaceSize
+		bool						FillFaceBorders(const float* const* pFaces, size_t iFacePitch, int iFaceSize, int iBorder, float* pOutBorders);
+
+		// Orthonormal frames of a line of directions, tangent, bitangent and normal axes as X/Y/Z arrays
+		struct LineFrames
+		{
+			float*					pAxes[3][3];
+		};
+		// Frames around directions (not normalized), the tangent is built from +Z (+X for directions close to Z)
+		void						GetLineFrames(const float* pX, const float* pY, const float* pZ, int iCount, const LineFrames& oOutFrames);
+		// Directions of a tangent space vector in each frame
+		void						TransformFromFrames(const LineFrames& oFrames, int iCount, float fX, float fY, float fZ, float* pOutX, float* pOutY, float* pOutZ);
+	}
+	//namespace CubemapSampling
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_CUBEMAP_SAMPLING_H__
@@ -231,6 +231,8 @@ const uint32_t DDS_CUBEMAP_ALLFACES                   = ( DDS_CUBEMAP_POSITIVEX
 
 const uint32_t DDS_FLAGS_VOLUME                       = 0x00200000; // DDSCAPS2_VOLUME
 
+const uint32_t DDS_RESOURCE_MISC_TEXTURECUBE          = 0x00000004; // D3D11_RESOURCE_MISC_TEXTURECUBE
+
 const DDS_PIXELFORMAT DDSPF_DXT1                      = { sizeof(DDS_PIXELFORMAT), DDS_FOURCC, MAKEFOURCC('D','X','T','1'), 0, 0, 0, 0, 0 }; // BC1
 const DDS_PIXELFORMAT DDSPF_DXT2                      = { sizeof(DDS_PIXELFORMAT), DDS_FOURCC, MAKEFOURCC('D','X','T','2'), 0, 0, 0, 0, 0 }; // BC2
 const DDS_PIXELFORMAT DDSPF_DXT3                      = { sizeof(DDS_PIXELFORMAT), DDS_FOURCC, MAKEFOURCC('D','X','T','3'), 0, 0, 0, 0, 0 }; // BC2
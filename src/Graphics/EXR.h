@@ -0,0 +1,71 @@
+#ifndef _GRAPHICS_EXR_H_
+#define _GRAPHICS_EXR_H_
+
+/*
+http://www.openexr.com/documentation/openexrfilelayout.pdf
+Scanline single part file:
+UInt32 magic number (0x762F3101)
+UInt32 version and flags (2)
+Header attributes: name\0 type\0 UInt32 size, Byte value[size]
+Byte 0 (end of header)
+UInt64 offsets[block count] (offset of each scanline block from beginning of file)
+for each scanline block
+	Int32 first scanline
+	UInt32 data size
+	Byte data[data size] (for each line of the block, for each channel sorted by name, all pixels of the line)
+end
+*/
+
+#include <stdint.h> // uint32_t
+#include <stddef.h> // size_t
+
+#include "Core/Array.h"
+
+namespace EXR
+{
+	const uint32_t c_iMagic = 0x01312F76;
+	const uint32_t c_iVersion = 2;
+
+	struct _CompressionEnum
+	{
+		enum Enum
+		{
+			NONE = 0,
+			RLE = 1,
+			ZIPS = 2,
+			ZIP = 3,
+			PIZ = 4
+		};
+	};
+	typedef _CompressionEnum::Enum CompressionEnum;
+
+	struct _PixelTypeEnum
+	{
+		enum Enum
+		{
+			UINT = 0,
+			HALF = 1,
+			FLOAT = 2
+		};
+	};
+	typedef _PixelTypeEnum::Enum PixelTypeEnum;
+
+	inline int GetScanlineBlockSize(CompressionEnum eCompression)
+	{
+		switch (eCompression)
+		{
+		case CompressionEnum::ZIP:
+			return 16;
+		case CompressionEnum::PIZ:
+			return 32;
+		default:
+			return 1;
+		}
+	}
+
+	// Compress a scanline block, all channels have the same pixel type. Compressed data are appended to pOut.
+	// Implemented in Implementations/tinyexr.cpp
+	bool CompressBlock(CompressionEnum eCompression, PixelTypeEnum ePixelType, int iChannelCount, int iWidth, int iLineCount, const void* pData, size_t iSize, Core::Array<unsigned char>* pOut);
+}
+
+#endif //_GRAPHICS_EXR_H_
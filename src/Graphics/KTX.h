@@ -90,7 +90,12 @@ namespace KTX
 
 			GL_COMPRESSED_RGBA_S3TC_DXT1_EXT = 0x83F1,
 			GL_COMPRESSED_RGBA_S3TC_DXT3_EXT = 0x83F2,
-			GL_COMPRESSED_RGBA_S3TC_DXT5_EXT = 0x83F3
+			GL_COMPRESSED_RGBA_S3TC_DXT5_EXT = 0x83F3,
+
+			GL_SRGB8_ALPHA8 = 0x8C43,
+			GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT = 0x8C4D,
+			GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT = 0x8C4E,
+			GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT = 0x8C4F
 		};
 	};
 	typedef _PixelFormatEnum::Enum PixelFormatEnum;
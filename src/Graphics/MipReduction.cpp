@@ -0,0 +1,574 @@
+#include "Graphics/MipReduction.h"
+
+#include "Graphics/PixelFormatConverters.h"
+
+#include "Core/Array.h"
+#include "Core/Assert.h"
+
+#include <emmintrin.h> //SIMD
+#include <math.h> //floorf/fabsf
+
+namespace Graphics
+{
+	namespace MipReduction
+	{
+		// Source taps of a destination pixel on one axis
+		struct AxisTaps
+		{
+			int		iFirst;
+			int		iCount;
+			float	fWeights[3];
+		};
+
+		// Taps of destination pixels [iDestStart, iDestEnd[, indexed from iDestStart
+		static void ComputeAxisTaps(int iSourceSize, int iDestSize, int iDestStart, int iDestEnd, Core::Array<AxisTaps>* pOutTaps)
+		{
+			pOutTaps->resize(iDestEnd - iDestStart, false);
+			for (int iDest = iDestStart; iDest < iDestEnd; ++iDest)
+			{
+				AxisTaps& oTaps = (*pOutTaps)[iDest - iDestStart];
+				if (iSourceSize == 1)
+				{
+					oTaps.iFirst = 0;
+					oTaps.iCount = 1;
+					oTaps.fWeights[0] = 1.f;
+				}
+				else if (iSourceSize == iDestSize * 2)
+				{
+					oTaps.iFirst = iDest * 2;
+					oTaps.iCount = 2;
+					oTaps.fWeights[0] = 0.5f;
+					oTaps.fWeights[1] = 0.5f;
+				}
+				else
+				{
+					// Polyphase box: destination pixel covers (2n+1)/n source pixels
+					CORE_ASSERT(iSourceSize == iDestSize * 2 + 1);
+					const float fInvSize = 1.f / (float)iSourceSize;
+					oTaps.iFirst = iDest * 2;
+					oTaps.iCount = 3;
+					oTaps.fWeights[0] = (float)(iDestSize - iDest) * fInvSize;
+					oTaps.fWeights[1] = (float)iDestSize * fInvSize;
+					oTaps.fWeights[2] = (float)(iDest + 1) * fInvSize;
+				}
+			}
+		}
+
+		template <typename T>
+		static T StoreComponent(float fValue);
+
+		template <>
+		uint8_t StoreComponent<uint8_t>(float fValue)
+		{
+			fValue += 0.5f;
+			return (uint8_t)(fValue <= 0.f ? 0.f : (fValue >= 255.f ? 255.f : fValue));
+		}
+
+		template <>
+		float StoreComponent<float>(float fValue)
+		{
+			return fValue;
+		}
+
+		// sRGB color components are filtered in linear space, scaled to [0, 255] like the alpha component
+		inline bool IsSRGBComponent(bool bSRGB, int iComponent)
+		{
+			return bSRGB && iComponent != 3;
+		}
+
+		// Generic separable path, used for odd sizes and 1 pixel wide/high levels
+		template <typename T>
+		static void ReduceGeneric(const uint8_t* pSource, int iSourceWidth, int iSourceHeight, size_t iSourcePitch, int iSourceStartX, int iSourceStartY, uint8_t* pDest, int iDestWidth, int iDestHeight, size_t iDestPitch, int iDestStartX, int iDestStartY, int iDestEndX, int iDestEndY, int iComponents, bool bSRGB)
+		{
+			Core::Array<AxisTaps> oTapsX;
+			Core::Array<AxisTaps> oTapsY;
+			ComputeAxisTaps(iSourceWidth, iDestWidth, iDestStartX, iDestEndX, &oTapsX);
+			ComputeAxisTaps(iSourceHeight, iDestHeight, iDestStartY, iDestEndY, &oTapsY);
+
+			// Only source columns read by the destination columns are filtered vertically
+			int iLineStart, iLineEnd;
+			GetSourceRange(iSourceWidth, iDestWidth, iDestStartX, iDestEndX, &iLineStart, &iLineEnd);
+
+			Core::Array<float> oLine;
+			oLine.resize((iLineEnd - iLineStart) * iComponents, false);
+			float* pLine = oLine.begin();
+
+			// sRGB to linear, scaled to [0, 255]
+			float pDecode[256];
+			if (bSRGB)
+			{
+				const float* pToLinear = PixelFormat::Converters::GetSRGBToLinearTable();
+				for (int i = 0; i < 256; ++i)
+					pDecode[i] = pToLinear[i] * 255.f;
+			}
+
+			const int iLineComponents = (iLineEnd - iLineStart) * iComponents;
+			for (int iY = iDestStartY; iY < iDestEndY; ++iY)
+			{
+				// Vertical pass into a float line
+				const AxisTaps& oTapY = oTapsY[iY - iDestStartY];
+				for (int iTap = 0; iTap < oTapY.iCount; ++iTap)
+				{
+					const T* pSourceLine = (const T*)(pSource + (size_t)(oTapY.iFirst + iTap - iSourceStartY) * iSourcePitch) + (iLineStart - iSourceStartX) * iComponents;
+					const float fWeight = oTapY.fWeights[iTap];
+					for (int iC = 0; iC < iLineComponents; ++iC)
+					{
+						float fValue = IsSRGBComponent(bSRGB, iC % iComponents) ? pDecode[(int)pSourceLine[iC]] : (float)pSourceLine[iC];
+						pLine[iC] = (iTap == 0) ? (fValue * fWeight) : (pLine[iC] + fValue * fWeight);
+					}
+				}
+
+				// Horizontal pass
+				T* pDestLine = (T*)(pDest + (size_t)(iY - iDestStartY) * iDestPitch);
+				for (int iX = iDestStartX; iX < iDestEndX; ++iX)
+				{
+					const AxisTaps& oTapX = oTapsX[iX - iDestStartX];
+					T* pDestPixel = pDestLine + (iX - iDestStartX) * iComponents;
+					for (int iC = 0; iC < iComponents; ++iC)
+					{
+						float fValue = 0.f;
+						for (int iTap = 0; iTap < oTapX.iCount; ++iTap)
+							fValue += pLine[(oTapX.iFirst + iTap - iLineStart) * iComponents + iC] * oTapX.fWeights[iTap];
+
+						if (IsSRGBComponent(bSRGB, iC))
+						{
+							uint8_t iValue;
+							PixelFormat::Converters::LinearToSRGB(fValue / 255.f, &iValue);
+							pDestPixel[iC] = (T)iValue;
+						}
+						else
+						{
+							pDestPixel[iC] = StoreComponent<T>(fValue);
+						}
+					}
+				}
+			}
+		}
+
+		static void Reduce2x2Line_UNorm8(const uint8_t* pLine0, const uint8_t* pLine1, uint8_t* pDest, int iDestWidth, int iComponents)
+		{
+			const __m128i xZero = _mm_setzero_si128();
+			const __m128i xTwo = _mm_set1_epi16(2);
+			int iX = 0;
+			if (iComponents == 4)
+			{
+				for (; iX + 2 <= iDestWidth; iX += 2)
+				{
+					const __m128i xLine0 = _mm_loadu_si128((const __m128i*)(pLine0 + iX * 8));
+					const __m128i xLine1 = _mm_loadu_si128((const __m128i*)(pLine1 + iX * 8));
+					// Source pixels 0-1 and 2-3, summed vertically
+					const __m128i xLo = _mm_add_epi16(_mm_unpacklo_epi8(xLine0, xZero), _mm_unpacklo_epi8(xLine1, xZero));
+					const __m128i xHi = _mm_add_epi16(_mm_unpackhi_epi8(xLine0, xZero), _mm_unpackhi_epi8(xLine1, xZero));
+					__m128i xSum = _mm_add_epi16(_mm_unpacklo_epi64(xLo, xHi), _mm_unpackhi_epi64(xLo, xHi));
+					xSum = _mm_srli_epi16(_mm_add_epi16(xSum, xTwo), 2);
+					_mm_storel_epi64((__m128i*)(pDest + iX * 4), _mm_packus_epi16(xSum, xSum));
+				}
+			}
+			else if (iComponents == 2)
+			{
+				for (; iX + 4 <= iDestWidth; iX += 4)
+				{
+					const __m128i xLine0 = _mm_loadu_si128((const __m128i*)(pLine0 + iX * 4));
+					const __m128i xLine1 = _mm_loadu_si128((const __m128i*)(pLine1 + iX * 4));
+					const __m128i xLo = _mm_add_epi16(_mm_unpacklo_epi8(xLine0, xZero), _mm_unpacklo_epi8(xLine1, xZero));
+					const __m128i xHi = _mm_add_epi16(_mm_unpackhi_epi8(xLine0, xZero), _mm_unpackhi_epi8(xLine1, xZero));
+					// Gather even and odd source pixels (32 bits each)
+					const __m128i xA = _mm_shuffle_epi32(xLo, _MM_SHUFFLE(3, 1, 2, 0));
+					const __m128i xB = _mm_shuffle_epi32(xHi, _MM_SHUFFLE(3, 1, 2, 0));
+					__m128i xSum = _mm_add_epi16(_mm_unpacklo_epi64(xA, xB), _mm_unpackhi_epi64(xA, xB));
+					xSum = _mm_srli_epi16(_mm_add_epi16(xSum, xTwo), 2);
+					_mm_storel_epi64((__m128i*)(pDest + iX * 2), _mm_packus_epi16(xSum, xSum));
+				}
+			}
+			else if (iComponents == 1)
+			{
+				const __m128i xOne = _mm_set1_epi16(1);
+				for (; iX + 8 <= iDestWidth; iX += 8)
+				{
+					const __m128i xLine0 = _mm_loadu_si128((const __m128i*)(pLine0 + iX * 2));
+					const __m128i xLine1 = _mm_loadu_si128((const __m128i*)(pLine1 + iX * 2));
+					const __m128i xLo = _mm_add_epi16(_mm_unpacklo_epi8(xLine0, xZero), _mm_unpacklo_epi8(xLine1, xZero));
+					const __m128i xHi = _mm_add_epi16(_mm_unpackhi_epi8(xLine0, xZero), _mm_unpackhi_epi8(xLine1, xZero));
+					// Horizontal pairs summed in 32 bits then packed back
+					__m128i xSum = _mm_packs_epi32(_mm_madd_epi16(xLo, xOne), _mm_madd_epi16(xHi, xOne));
+					xSum = _mm_srli_epi16(_mm_add_epi16(xSum, xTwo), 2);
+					_mm_storel_epi64((__m128i*)(pDest + iX), _mm_packus_epi16(xSum, xSum));
+				}
+			}
+
+			const int iStride = iComponents * 2;
+			for (; iX < iDestWidth; ++iX)
+			{
+				for (int iC = 0; iC < iComponents; ++iC)
+				{
+					const int iOffset = iX * iStride + iC;
+					const int iSum = pLine0[iOffset] + pLine0[iOffset + iComponents] + pLine1[iOffset] + pLine1[iOffset + iComponents];
+					pDest[iX * iComponents + iC] = (uint8_t)((iSum + 2) >> 2);
+				}
+			}
+		}
+
+		static void Reduce2x2Line_Float(const float* pLine0, const float* pLine1, float* pDest, int iDestWidth, int iComponents)
+		{
+			const __m128 xQuarter = _mm_set1_ps(0.25f);
+			int iX = 0;
+			if (iComponents == 4)
+			{
+				for (; iX < iDestWidth; ++iX)
+				{
+					const __m128 xLine0 = _mm_add_ps(_mm_loadu_ps(pLine0 + iX * 8), _mm_loadu_ps(pLine0 + iX * 8 + 4));
+					const __m128 xLine1 = _mm_add_ps(_mm_loadu_ps(pLine1 + iX * 8), _mm_loadu_ps(pLine1 + iX * 8 + 4));
+					_mm_storeu_ps(pDest + iX * 4, _mm_mul_ps(_mm_add_ps(xLine0, xLine1), xQuarter));
+				}
+			}
+			else if (iComponents == 2)
+			{
+				for (; iX + 2 <= iDestWidth; iX += 2)
+				{
+					const __m128 xA = _mm_add_ps(_mm_loadu_ps(pLine0 + iX * 4), _mm_loadu_ps(pLine1 + iX * 4));
+					const __m128 xB = _mm_add_ps(_mm_loadu_ps(pLine0 + iX * 4 + 4), _mm_loadu_ps(pLine1 + iX * 4 + 4));
+					const __m128 xSum = _mm_add_ps(_mm_movelh_ps(xA, xB), _mm_movehl_ps(xB, xA));
+					_mm_storeu_ps(pDest + iX * 2, _mm_mul_ps(xSum, xQuarter));
+				}
+			}
+			else if (iComponents == 1)
+			{
+				for (; iX + 4 <= iDestWidth; iX += 4)
+				{
+					const __m128 xA = _mm_add_ps(_mm_loadu_ps(pLine0 + iX * 2), _mm_loadu_ps(pLine1 + iX * 2));
+					const __m128 xB = _mm_add_ps(_mm_loadu_ps(pLine0 + iX * 2 + 4), _mm_loadu_ps(pLine1 + iX * 2 + 4));
+					const __m128 xSum = _mm_add_ps(_mm_shuffle_ps(xA, xB, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(xA, xB, _MM_SHUFFLE(3, 1, 3, 1)));
+					_mm_storeu_ps(pDest + iX, _mm_mul_ps(xSum, xQuarter));
+				}
+			}
+
+			// Same summation order as SIMD kernels
+			const int iStride = iComponents * 2;
+			for (; iX < iDestWidth; ++iX)
+			{
+				for (int iC = 0; iC < iComponents; ++iC)
+				{
+					const int iOffset = iX * iStride + iC;
+					const float fSum = (pLine0[iOffset] + pLine1[iOffset]) + (pLine0[iOffset + iComponents] + pLine1[iOffset + iComponents]);
+					pDest[iX * iComponents + iC] = fSum * 0.25f;
+				}
+			}
+		}
+
+		// RGBA/BGRA sRGB, color components are decoded through lookup table, filtered then re-encoded
+		static void Reduce2x2Line_SRGB8(const uint8_t* pLine0, const uint8_t* pLine1, uint8_t* pDest, int iDestWidth)
+		{
+			const float* pToLinear = PixelFormat::Converters::GetSRGBToLinearTable();
+			const uint8_t* pFromLinear = PixelFormat::Converters::GetLinearToSRGBTable();
+			const float fColorScale = 0.25f * (float)(PixelFormat::Converters::c_iLinearToSRGBTableSize - 1);
+			const __m128 xScale = _mm_set_ps(0.25f, fColorScale, fColorScale, fColorScale);
+			const __m128 xHalf = _mm_set1_ps(0.5f);
+
+			for (int iX = 0; iX < iDestWidth; ++iX)
+			{
+				const uint8_t* p00 = pLine0 + iX * 8;
+				const uint8_t* p01 = p00 + 4;
+				const uint8_t* p10 = pLine1 + iX * 8;
+				const uint8_t* p11 = p10 + 4;
+
+				const __m128 x00 = _mm_set_ps((float)p00[3], pToLinear[p00[2]], pToLinear[p00[1]], pToLinear[p00[0]]);
+				const __m128 x01 = _mm_set_ps((float)p01[3], pToLinear[p01[2]], pToLinear[p01[1]], pToLinear[p01[0]]);
+				const __m128 x10 = _mm_set_ps((float)p10[3], pToLinear[p10[2]], pToLinear[p10[1]], pToLinear[p10[0]]);
+				const __m128 x11 = _mm_set_ps((float)p11[3], pToLinear[p11[2]], pToLinear[p11[1]], pToLinear[p11[0]]);
+
+				// Same summation order as the UNorm path, alpha is rounded as (sum + 2) / 4
+				const __m128 xSum = _mm_add_ps(_mm_add_ps(x00, x10), _mm_add_ps(x01, x11));
+				const __m128i xIndices = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(xSum, xScale), xHalf));
+
+				int32_t pIndices[4];
+				_mm_storeu_si128((__m128i*)pIndices, xIndices);
+				pDest[iX * 4 + 0] = pFromLinear[pIndices[0]];
+				pDest[iX * 4 + 1] = pFromLinear[pIndices[1]];
+				pDest[iX * 4 + 2] = pFromLinear[pIndices[2]];
+				pDest[iX * 4 + 3] = (uint8_t)pIndices[3];
+			}
+		}
+
+		bool IsMipReduction(int iSourceWidth, int iSourceHeight, int iDestWidth, int iDestHeight)
+		{
+			return iSourceWidth > 0 && iSourceHeight > 0
+				&& iDestWidth == (iSourceWidth > 1 ? iSourceWidth / 2 : 1)
+				&& iDestHeight == (iSourceHeight > 1 ? iSourceHeight / 2 : 1);
+		}
+
+		bool IsPixelFormatSupported(const PixelFormatInfos& oFormatInfos)
+		{
+			switch (oFormatInfos.eFormat)
+			{
+			case PixelFormatEnum::R8_UNORM:
+			case PixelFormatEnum::RG8_UNORM:
+			case PixelFormatEnum::RGB8_UNORM:
+			case PixelFormatEnum::BGR8_UNORM:
+			case PixelFormatEnum::RGBA8_UNORM:
+			case PixelFormatEnum::BGRA8_UNORM:
+			case PixelFormatEnum::RGBA8_UNORM_SRGB:
+			case PixelFormatEnum::BGRA8_UNORM_SRGB:
+			case PixelFormatEnum::R32_FLOAT:
+			case PixelFormatEnum::RG32_FLOAT:
+			case PixelFormatEnum::RGB32_FLOAT:
+			case PixelFormatEnum::RGBA32_FLOAT:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		void GetSourceRange(int iSourceSize, int iDestSize, int iDestStart, int iDestEnd, int* pOutStart, int* pOutEnd)
+		{
+			if (iSourceSize == 1)
+			{
+				*pOutStart = 0;
+				*pOutEnd = 1;
+			}
+			else
+			{
+				// Last destination pixel of odd sizes read 3 taps
+				*pOutStart = iDestStart * 2;
+				*pOutEnd = iDestEnd * 2 + ((iSourceSize == iDestSize * 2) ? 0 : 1);
+			}
+		}
+
+		bool Reduce(const PixelFormatInfos& oFormatInfos,
+			const void* pSource, int iSourceWidth, int iSourceHeight, size_t iSourcePitch, int iSourceStartY,
+			void* pDest, int iDestWidth, int iDestHeight, size_t iDestPitch,
+			int iDestStartY, int iDestEndY)
+		{
+			CORE_ASSERT(iDestStartY >= 0 && iDestStartY <= iDestEndY && iDestEndY <= iDestHeight);
+			return ReduceRegion(oFormatInfos,
+				pSource, iSourceWidth, iSourceHeight, iSourcePitch, 0, iSourceStartY,
+				(uint8_t*)pDest + (size_t)iDestStartY * iDestPitch, iDestWidth, iDestHeight, iDestPitch,
+				0, iDestStartY, iDestWidth, iDestEndY);
+		}
+
+		bool ReduceRegion(const PixelFormatInfos& oFormatInfos,
+			const void* pSource, int iSourceWidth, int iSourceHeight, size_t iSourcePitch, int iSourceStartX, int iSourceStartY,
+			void* pDest, int iDestWidth, int iDestHeight, size_t iDestPitch,
+			int iDestStartX, int iDestStartY, int iDestEndX, int iDestEndY)
+		{
+			if (IsPixelFormatSupported(oFormatInfos) == false || IsMipReduction(iSourceWidth, iSourceHeight, iDestWidth, iDestHeight) == false)
+				return false;
+
+			CORE_ASSERT(iDestStartX >= 0 && iDestStartX <= iDestEndX && iDestEndX <= iDestWidth);
+			CORE_ASSERT(iDestStartY >= 0 && iDestStartY <= iDestEndY && iDestEndY <= iDestHeight);
+			if (iDestStartX == iDestEndX || iDestStartY == iDestEndY)
+				return true;
+
+			CORE_ASSERT(iSourceStartX >= 0 && iSourceStartX <= ((iSourceWidth > 1) ? iDestStartX * 2 : 0));
+			CORE_ASSERT(iSourceStartY >= 0 && iSourceStartY <= ((iSourceHeight > 1) ? iDestStartY * 2 : 0));
+
+			const uint8_t* pSourceBytes = (const uint8_t*)pSource;
+			uint8_t* pDestBytes = (uint8_t*)pDest;
+			const int iComponents = oFormatInfos.iComponents;
+			const size_t iPixelSize = oFormatInfos.iBitsPerPixel / 8;
+			const bool bFloat = oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT;
+			const bool bSRGB = oFormatInfos.eEncoding == ComponentEncodingEnum::SRGB;
+
+			if ((iSourceWidth == iDestWidth * 2) && (iSourceHeight == iDestHeight * 2))
+			{
+				const int iWidth = iDestEndX - iDestStartX;
+				for (int iY = iDestStartY; iY < iDestEndY; ++iY)
+				{
+					const uint8_t* pLine0 = pSourceBytes + (size_t)(iY * 2 - iSourceStartY) * iSourcePitch + (size_t)(iDestStartX * 2 - iSourceStartX) * iPixelSize;
+					const uint8_t* pLine1 = pLine0 + iSourcePitch;
+					uint8_t* pDestLine = pDestBytes + (size_t)(iY - iDestStartY) * iDestPitch;
+					if (bSRGB)
+						Reduce2x2Line_SRGB8(pLine0, pLine1, pDestLine, iWidth);
+					else if (bFloat)
+						Reduce2x2Line_Float((const float*)pLine0, (const float*)pLine1, (float*)pDestLine, iWidth, iComponents);
+					else
+						Reduce2x2Line_UNorm8(pLine0, pLine1, pDestLine, iWidth, iComponents);
+				}
+			}
+			else if (bFloat)
+			{
+				ReduceGeneric<float>(pSourceBytes, iSourceWidth, iSourceHeight, iSourcePitch, iSourceStartX, iSourceStartY, pDestBytes, iDestWidth, iDestHeight, iDestPitch, iDestStartX, iDestStartY, iDestEndX, iDestEndY, iComponents, bSRGB);
+			}
+			else
+			{
+				ReduceGeneric<uint8_t>(pSourceBytes, iSourceWidth, iSourceHeight, iSourcePitch, iSourceStartX, iSourceStartY, pDestBytes, iDestWidth, iDestHeight, iDestPitch, iDestStartX, iDestStartY, iDestEndX, iDestEndY, iComponents, bSRGB);
+			}
+			return true;
+		}
+
+		// Normalize XYZ of a vector, alpha is kept, null vectors become (0, 0, 1)
+		inline __m128 NormalizeXYZ(__m128 xVector, __m128* pOutLength)
+		{
+			const __m128 xMaskXYZ = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+			__m128 xSquare = _mm_and_ps(_mm_mul_ps(xVector, xVector), xMaskXYZ);
+			__m128 xLengthSquare = _mm_add_ps(
+				_mm_add_ps(_mm_shuffle_ps(xSquare, xSquare, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(xSquare, xSquare, _MM_SHUFFLE(1, 1, 1, 1))),
+				_mm_shuffle_ps(xSquare, xSquare, _MM_SHUFFLE(2, 2, 2, 2)));
+
+			// Reciprocal square root estimate refined by one Newton-Raphson step
+			__m128 xValid = _mm_cmpgt_ps(xLengthSquare, _mm_set1_ps(1e-12f));
+			__m128 xRcp = _mm_rsqrt_ps(_mm_max_ps(xLengthSquare, _mm_set1_ps(1e-12f)));
+			xRcp = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), xRcp), _mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_mul_ps(xLengthSquare, xRcp), xRcp)));
+			*pOutLength = _mm_and_ps(_mm_mul_ps(xLengthSquare, xRcp), xValid);
+
+			__m128 xNormalized = _mm_and_ps(_mm_mul_ps(xVector, xRcp), xValid);
+			xNormalized = _mm_or_ps(xNormalized, _mm_andnot_ps(xValid, _mm_set_ps(0.f, 1.f, 0.f, 0.f)));
+			return _mm_or_ps(_mm_and_ps(xNormalized, xMaskXYZ), _mm_andnot_ps(xMaskXYZ, xVector));
+		}
+
+		void DecodeNormals(float* pPixels, size_t iPixelCount, bool bUNorm, bool bReconstructZ)
+		{
+			const __m128 xScale = bUNorm ? _mm_set_ps(1.f, 2.f, 2.f, 2.f) : _mm_set1_ps(1.f);
+			const __m128 xBias = bUNorm ? _mm_set_ps(0.f, -1.f, -1.f, -1.f) : _mm_setzero_ps();
+			for (size_t iPixel = 0; iPixel < iPixelCount; ++iPixel)
+			{
+				float* pPixel = pPixels + iPixel * 4;
+				__m128 xVector = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pPixel), xScale), xBias);
+				if (bReconstructZ)
+				{
+					// z = sqrt(1 - x^2 - y^2)
+					__m128 xSquare = _mm_mul_ps(xVector, xVector);
+					__m128 xZ = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.f), xSquare), _mm_shuffle_ps(xSquare, xSquare, _MM_SHUFFLE(1, 1, 1, 1)));
+					xZ = _mm_sqrt_ss(_mm_max_ss(xZ, _mm_setzero_ps()));
+					xVector = _mm_shuffle_ps(xVector, _mm_shuffle_ps(xZ, xVector, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+				}
+				__m128 xLength;
+				_mm_storeu_ps(pPixel, NormalizeXYZ(xVector, &xLength));
+			}
+		}
+
+		void EncodeNormals(float* pPixels, size_t iPixelCount, bool bUNorm, bool bStoreLength)
+		{
+			const __m128 xScale = bUNorm ? _mm_set_ps(1.f, 0.5f, 0.5f, 0.5f) : _mm_set1_ps(1.f);
+			const __m128 xBias = bUNorm ? _mm_set_ps(0.f, 0.5f, 0.5f, 0.5f) : _mm_setzero_ps();
+			const __m128 xMaskW = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+			for (size_t iPixel = 0; iPixel < iPixelCount; ++iPixel)
+			{
+				float* pPixel = pPixels + iPixel * 4;
+				__m128 xLength;
+				__m128 xVector = NormalizeXYZ(_mm_loadu_ps(pPixel), &xLength);
+				if (bStoreLength)
+					xVector = _mm_or_ps(_mm_andnot_ps(xMaskW, xVector), _mm_and_ps(xMaskW, xLength));
+				_mm_storeu_ps(pPixel, _mm_add_ps(_mm_mul_ps(xVector, xScale), xBias));
+			}
+		}
+
+		bool IsAlphaCoverageSupported(const PixelFormatInfos& oFormatInfos)
+		{
+			return oFormatInfos.iComponents == 4 && IsPixelFormatSupported(oFormatInfos);
+		}
+
+		size_t CountAlphaCoverage(const PixelFormatInfos& oFormatInfos, const void* pData, int iWidth, int iHeight, size_t iPitch, float fAlphaReference, float fAlphaScale)
+		{
+			CORE_ASSERT(IsAlphaCoverageSupported(oFormatInfos));
+			size_t iCount = 0;
+			if (oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT)
+			{
+				const __m128 xScale = _mm_set1_ps(fAlphaScale);
+				const __m128 xReference = _mm_set1_ps(fAlphaReference);
+				for (int iY = 0; iY < iHeight; ++iY)
+				{
+					const float* pLine = (const float*)((const uint8_t*)pData + (size_t)iY * iPitch);
+					__m128i xCount = _mm_setzero_si128();
+					int iX = 0;
+					for (; iX + 4 <= iWidth; iX += 4)
+					{
+						// Gather alpha of 4 pixels
+						__m128 xHigh01 = _mm_unpackhi_ps(_mm_loadu_ps(pLine + iX * 4), _mm_loadu_ps(pLine + iX * 4 + 4));
+						__m128 xHigh23 = _mm_unpackhi_ps(_mm_loadu_ps(pLine + iX * 4 + 8), _mm_loadu_ps(pLine + iX * 4 + 12));
+						__m128 xAlpha = _mm_movehl_ps(xHigh23, xHigh01);
+						xCount = _mm_sub_epi32(xCount, _mm_castps_si128(_mm_cmpgt_ps(_mm_mul_ps(xAlpha, xScale), xReference)));
+					}
+					uint32_t pCounts[4];
+					_mm_storeu_si128((__m128i*)pCounts, xCount);
+					iCount += pCounts[0] + pCounts[1] + pCounts[2] + pCounts[3];
+					for (; iX < iWidth; ++iX)
+					{
+						if (pLine[iX * 4 + 3] * fAlphaScale > fAlphaReference)
+							++iCount;
+					}
+				}
+			}
+			else
+			{
+				// alpha * scale > reference * 255 <=> alpha > floor(reference * 255 / scale)
+				const float fThreshold = fAlphaScale > 0.f ? floorf(fAlphaReference * 255.f / fAlphaScale) : 255.f;
+				const int iThreshold = fThreshold > 255.f ? 255 : (int)fThreshold;
+				const __m128i xThreshold = _mm_set1_epi32(iThreshold);
+				for (int iY = 0; iY < iHeight; ++iY)
+				{
+					const uint8_t* pLine = (const uint8_t*)pData + (size_t)iY * iPitch;
+					__m128i xCount = _mm_setzero_si128();
+					int iX = 0;
+					for (; iX + 4 <= iWidth; iX += 4)
+					{
+						__m128i xAlpha = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(pLine + iX * 4)), 24);
+						xCount = _mm_sub_epi32(xCount, _mm_cmpgt_epi32(xAlpha, xThreshold));
+					}
+					uint32_t pCounts[4];
+					_mm_storeu_si128((__m128i*)pCounts, xCount);
+					iCount += pCounts[0] + pCounts[1] + pCounts[2] + pCounts[3];
+					for (; iX < iWidth; ++iX)
+					{
+						if (pLine[iX * 4 + 3] > iThreshold)
+							++iCount;
+					}
+				}
+			}
+			return iCount;
+		}
+
+		float FindAlphaCoverageScale(const PixelFormatInfos& oFormatInfos, const void* pData, int iWidth, int iHeight, size_t iPitch, float fAlphaReference, float fCoverage)
+		{
+			const double fPixelCount = (double)iWidth * iHeight;
+			float fMinScale = 0.f;
+			float fMaxScale = 4.f;
+			float fScale = 1.f;
+			// Coverage is a step function on small levels, keep the closest tested scale
+			float fBestScale = 1.f;
+			float fBestError = 2.f;
+			for (int iStep = 0; iStep < 10; ++iStep)
+			{
+				float fCurrentCoverage = (float)(CountAlphaCoverage(oFormatInfos, pData, iWidth, iHeight, iPitch, fAlphaReference, fScale) / fPixelCount);
+				float fError = fabsf(fCurrentCoverage - fCoverage);
+				if (fError < fBestError)
+				{
+					fBestError = fError;
+					fBestScale = fScale;
+				}
+				if (fCurrentCoverage < fCoverage)
+					fMinScale = fScale;
+				else if (fCurrentCoverage > fCoverage)
+					fMaxScale = fScale;
+				else
+					break;
+				fScale = (fMinScale + fMaxScale) * 0.5f;
+			}
+			return fBestScale;
+		}
+
+		void ScaleAlpha(const PixelFormatInfos& oFormatInfos, void* pData, int iWidth, int iHeight, size_t iPitch, float fAlphaScale)
+		{
+			CORE_ASSERT(IsAlphaCoverageSupported(oFormatInfos));
+			for (int iY = 0; iY < iHeight; ++iY)
+			{
+				uint8_t* pLine = (uint8_t*)pData + (size_t)iY * iPitch;
+				if (oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT)
+				{
+					float* pPixels = (float*)pLine;
+					for (int iX = 0; iX < iWidth; ++iX)
+					{
+						float fAlpha = pPixels[iX * 4 + 3] * fAlphaScale;
+						pPixels[iX * 4 + 3] = fAlpha > 1.f ? 1.f : fAlpha;
+					}
+				}
+				else
+				{
+					for (int iX = 0; iX < iWidth; ++iX)
+						pLine[iX * 4 + 3] = StoreComponent<uint8_t>(pLine[iX * 4 + 3] * fAlphaScale);
+				}
+			}
+		}
+	}
+	//namespace MipReduction
+}
+//namespace Graphics
@@ -0,0 +1,56 @@
+#ifndef __GRAPHICS_MIP_REDUCTION_H__
+#define __GRAPHICS_MIP_REDUCTION_H__
+
+#include "Graphics/PixelFormat.h"
+
+namespace Graphics
+{
+	/* Mip level reduction
+	Even sizes use a 2x2 box filter (SSE2 kernels for 1, 2 and 4 components),
+	odd sizes use a 3 taps polyphase box filter so each destination pixel covers
+	exactly 1/dest of the source image. Other ratios are not handled.
+	sRGB formats are filtered in linear space and re-encoded.
+	*/
+	namespace MipReduction
+	{
+		// Destination size need to be half of source size (rounded down, minimum 1) on each axis
+		bool						IsMipReduction(int iSourceWidth, int iSourceHeight, int iDestWidth, int iDestHeight);
+		// 8 bits per component UNORM/sRGB and 32 bits float formats, packed formats like R10G10B10A2 can't be averaged per byte
+		bool						IsPixelFormatSupported(const PixelFormatInfos& oFormatInfos);
+
+		// Source pixels [*pOutStart, *pOutEnd[ of one axis read by destination pixels [iDestStart, iDestEnd[
+		void						GetSourceRange(int iSourceSize, int iDestSize, int iDestStart, int iDestEnd, int* pOutStart, int* pOutEnd);
+
+		// Reduce destination lines [iDestStartY, iDestEndY[, pitches are in bytes
+		// pSource points to source line iSourceStartY, only lines used by the destination lines need to be present
+		bool						Reduce(const PixelFormatInfos& oFormatInfos,
+										const void* pSource, int iSourceWidth, int iSourceHeight, size_t iSourcePitch, int iSourceStartY,
+										void* pDest, int iDestWidth, int iDestHeight, size_t iDestPitch,
+										int iDestStartY, int iDestEndY);
+		// Reduce destination rect [iDestStartX, iDestEndX[ x [iDestStartY, iDestEndY[ of a level, pDest points to its first pixel
+		// pSource points to source pixel (iSourceStartX, iSourceStartY), only pixels of the GetSourceRange of the rect need to be present
+		// Pixels are equal to the same pixels of a whole level reduction
+		bool						ReduceRegion(const PixelFormatInfos& oFormatInfos,
+										const void* pSource, int iSourceWidth, int iSourceHeight, size_t iSourcePitch, int iSourceStartX, int iSourceStartY,
+										void* pDest, int iDestWidth, int iDestHeight, size_t iDestPitch,
+										int iDestStartX, int iDestStartY, int iDestEndX, int iDestEndY);
+
+		// Normal maps are filtered as RGBA float vectors, UNorm maps [0, 1] to [-1, 1], alpha is not mapped
+		// Decoded vectors are renormalized, Z is rebuilt from X and Y when bReconstructZ (two channels formats)
+		void						DecodeNormals(float* pPixels, size_t iPixelCount, bool bUNorm, bool bReconstructZ);
+		// Filtered vectors are renormalized, their length (Toksvig factor) replace alpha when bStoreLength
+		void						EncodeNormals(float* pPixels, size_t iPixelCount, bool bUNorm, bool bStoreLength);
+
+		// Alpha test coverage, 4 components UNorm8/sRGB/Float32 formats, alpha is the last component
+		bool						IsAlphaCoverageSupported(const PixelFormatInfos& oFormatInfos);
+		// Count pixels with alpha * fAlphaScale > fAlphaReference
+		size_t						CountAlphaCoverage(const PixelFormatInfos& oFormatInfos, const void* pData, int iWidth, int iHeight, size_t iPitch, float fAlphaReference, float fAlphaScale);
+		// Binary search of the alpha scale giving the wanted coverage ratio
+		float						FindAlphaCoverageScale(const PixelFormatInfos& oFormatInfos, const void* pData, int iWidth, int iHeight, size_t iPitch, float fAlphaReference, float fCoverage);
+		void						ScaleAlpha(const PixelFormatInfos& oFormatInfos, void* pData, int iWidth, int iHeight, size_t iPitch, float fAlphaScale);
+	}
+	//namespace MipReduction
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_MIP_REDUCTION_H__
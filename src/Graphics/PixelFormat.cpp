@@ -5,6 +5,8 @@
 #include "Graphics/PixelFormatConverters.h"
 #include "Graphics/PixelFormatConvertersCompressed.h"
 
+#include "Math/Math.h"
+
 namespace Graphics
 {
 	extern const char* const ComponentEncodingEnumString[ComponentEncodingEnum::_COUNT] = {
@@ -14,7 +16,8 @@ namespace Graphics
 		"Int",
 		"UInt",
 		"Float",
-		"SNorm"
+		"SNorm",
+		"sRGB"
 	};
 
 	const PixelFormatInfos PixelFormatEnumInfos[PixelFormatEnum::_COUNT] =
@@ -41,7 +44,7 @@ namespace Graphics
 
 		{  PixelFormatEnum::R8_UNORM,              8,   1,   1,   1,   1,   ComponentEncodingEnum::UNORM,  "R8",            "R8 UNorm"                      },
 
-		{  PixelFormatEnum::RG8_UNORM,            16,   1,   1,   2,   2,   ComponentEncodingEnum::UNORM,  "RGB8",          "RG8 UNorm"                     },
+		{  PixelFormatEnum::RG8_UNORM,            16,   1,   1,   2,   2,   ComponentEncodingEnum::UNORM,  "RG8",           "RG8 UNorm"                     },
 
 		{  PixelFormatEnum::RGB8_UNORM,           24,   1,   1,   3,   3,   ComponentEncodingEnum::UNORM,  "RGB8",          "RGB8 UNorm"                    },
 		{  PixelFormatEnum::BGR8_UNORM,           24,   1,   1,   3,   3,   ComponentEncodingEnum::UNORM,  "BGR8",          "BGR8 UNorm"                    },
@@ -49,6 +52,9 @@ namespace Graphics
 		{  PixelFormatEnum::RGBA8_UNORM,          32,   1,   1,   4,   4,   ComponentEncodingEnum::UNORM,  "RGBA8",         "RGBA8 UNorm"                   },
 		{  PixelFormatEnum::BGRA8_UNORM,          32,   1,   1,   4,   4,   ComponentEncodingEnum::UNORM,  "BGRA8",         "BGRA8 UNorm"                   },
 
+		{  PixelFormatEnum::RGBA8_UNORM_SRGB,     32,   1,   1,   4,   4,   ComponentEncodingEnum::SRGB,   "RGBA8 sRGB",    "RGBA8 UNorm sRGB"              },
+		{  PixelFormatEnum::BGRA8_UNORM_SRGB,     32,   1,   1,   4,   4,   ComponentEncodingEnum::SRGB,   "BGRA8 sRGB",    "BGRA8 UNorm sRGB"              },
+
 		{  PixelFormatEnum::R5G6B5_UNORM,         16,   1,   1,   2,   3,   ComponentEncodingEnum::UNORM,  "R5G6B5",        "R5G6B5 UNorm"                  },
 		{  PixelFormatEnum::B5G6BR_UNORM,         16,   1,   1,   2,   3,   ComponentEncodingEnum::UNORM,  "B5G6R5",        "B5G6R5 UNorm"                  },
 
@@ -75,14 +81,66 @@ namespace Graphics
 		{  PixelFormatEnum::BC4,                   4,   4,   4,   8,   1,   ComponentEncodingEnum::UNORM,  "BC4",           "BC4"                           },
 		{  PixelFormatEnum::BC5,                   8,   4,   4,  16,   2,   ComponentEncodingEnum::UNORM,  "BC5",           "BC5"                           },
 		{  PixelFormatEnum::BC6H,                  8,   4,   4,  16,   3,   ComponentEncodingEnum::FLOAT,  "BC6H",          "BC6H"                          },
-		{  PixelFormatEnum::BC7,                   8,   4,   4,  16,   3,   ComponentEncodingEnum::UNORM,  "BC7",           "BC7"                           }
+		{  PixelFormatEnum::BC7,                   8,   4,   4,  16,   4,   ComponentEncodingEnum::UNORM,  "BC7",           "BC7"                           },
+
+		{  PixelFormatEnum::BC1_SRGB,              4,   4,   4,   8,   4,   ComponentEncodingEnum::SRGB,   "BC1 sRGB",      "BC1 (DXT1) sRGB"               },
+		{  PixelFormatEnum::BC2_SRGB,              8,   4,   4,  16,   4,   ComponentEncodingEnum::SRGB,   "BC2 sRGB",      "BC2 (DXT2/3) sRGB"             },
+		{  PixelFormatEnum::BC3_SRGB,              8,   4,   4,  16,   4,   ComponentEncodingEnum::SRGB,   "BC3 sRGB",      "BC3 (DXT4/5) sRGB"             },
+		{  PixelFormatEnum::BC7_SRGB,              8,   4,   4,  16,   4,   ComponentEncodingEnum::SRGB,   "BC7 sRGB",      "BC7 sRGB"                      }
 	};
 
 	namespace PixelFormat
 	{
 		bool IsCompressed(PixelFormatEnum ePixelFormat)
 		{
-			return (ePixelFormat >= PixelFormatEnum::BC1 && ePixelFormat <= PixelFormatEnum::BC7);
+			return (ePixelFormat >= PixelFormatEnum::BC1 && ePixelFormat <= PixelFormatEnum::BC7_SRGB);
+		}
+
+		bool IsSRGB(PixelFormatEnum ePixelFormat)
+		{
+			return PixelFormatEnumInfos[ePixelFormat].eEncoding == ComponentEncodingEnum::SRGB;
+		}
+
+		PixelFormatEnum GetSRGBFormat(PixelFormatEnum ePixelFormat)
+		{
+			switch (ePixelFormat)
+			{
+			case PixelFormatEnum::RGBA8_UNORM:
+				return PixelFormatEnum::RGBA8_UNORM_SRGB;
+			case PixelFormatEnum::BGRA8_UNORM:
+				return PixelFormatEnum::BGRA8_UNORM_SRGB;
+			case PixelFormatEnum::BC1:
+				return PixelFormatEnum::BC1_SRGB;
+			case PixelFormatEnum::BC2:
+				return PixelFormatEnum::BC2_SRGB;
+			case PixelFormatEnum::BC3:
+				return PixelFormatEnum::BC3_SRGB;
+			case PixelFormatEnum::BC7:
+				return PixelFormatEnum::BC7_SRGB;
+			default:
+				return IsSRGB(ePixelFormat) ? ePixelFormat : PixelFormatEnum::_NONE;
+			}
+		}
+
+		PixelFormatEnum GetLinearFormat(PixelFormatEnum ePixelFormat)
+		{
+			switch (ePixelFormat)
+			{
+			case PixelFormatEnum::RGBA8_UNORM_SRGB:
+				return PixelFormatEnum::RGBA8_UNORM;
+			case PixelFormatEnum::BGRA8_UNORM_SRGB:
+				return PixelFormatEnum::BGRA8_UNORM;
+			case PixelFormatEnum::BC1_SRGB:
+				return PixelFormatEnum::BC1;
+			case PixelFormatEnum::BC2_SRGB:
+				return PixelFormatEnum::BC2;
+			case PixelFormatEnum::BC3_SRGB:
+				return PixelFormatEnum::BC3;
+			case PixelFormatEnum::BC7_SRGB:
+				return PixelFormatEnum::BC7;
+			default:
+				return IsSRGB(ePixelFormat) ? PixelFormatEnum::_NONE : ePixelFormat;
+			}
 		}
 
 		int BitPerPixel(PixelFormatEnum ePixelFormat)
@@ -170,6 +228,16 @@ namespace Graphics
 			s_pConvertionMatrix[PixelFormatEnum::BGRA8_UNORM][PixelFormatEnum::RGBA8_UNORM] = { Converters::Convert_BGRA8_To_RGBA8, 1 };
 			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM][PixelFormatEnum::BGRA8_UNORM] = { Converters::Convert_RGBA8_To_BGRA8, 1 };
 
+			// RGBA8 <=> RGBA8 sRGB / BGRA8 <=> BGRA8 sRGB (reinterpretation, bits are kept)
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_Raw32, 0 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::RGBA8_UNORM] = { Converters::Convert_Raw32, 0 };
+			s_pConvertionMatrix[PixelFormatEnum::BGRA8_UNORM][PixelFormatEnum::BGRA8_UNORM_SRGB] = { Converters::Convert_Raw32, 0 };
+			s_pConvertionMatrix[PixelFormatEnum::BGRA8_UNORM_SRGB][PixelFormatEnum::BGRA8_UNORM] = { Converters::Convert_Raw32, 0 };
+
+			// BGRA8 sRGB <=> RGBA8 sRGB
+			s_pConvertionMatrix[PixelFormatEnum::BGRA8_UNORM_SRGB][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_BGRA8_To_RGBA8, 1 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::BGRA8_UNORM_SRGB] = { Converters::Convert_RGBA8_To_BGRA8, 1 };
+
 			// RGB565 <=> RGB8
 			s_pConvertionMatrix[PixelFormatEnum::R5G6B5_UNORM][PixelFormatEnum::RGB8_UNORM] = { Converters::Convert_RGB565_To_RGB8, 8 };
 			s_pConvertionMatrix[PixelFormatEnum::RGB8_UNORM][PixelFormatEnum::R5G6B5_UNORM] = { Converters::Convert_RGB8_To_RGB565, -8 };
@@ -217,6 +285,10 @@ namespace Graphics
 			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM][PixelFormatEnum::RGBA32_FLOAT] = { Converters::Convert_RGBA8_To_RGBA32F, 96 };
 			s_pConvertionMatrix[PixelFormatEnum::RGBA32_FLOAT][PixelFormatEnum::RGBA8_UNORM] = { Converters::Convert_RGBA32F_To_RGBA8, -96 };
 
+			// RGBA8 sRGB <=> RGBA32F (linear)
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::RGBA32_FLOAT] = { Converters::Convert_RGBA8SRGB_To_RGBA32F, 96 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA32_FLOAT][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_RGBA32F_To_RGBA8SRGB, -96 };
+
 			// RGB8 >=> RGB32F
 			s_pConvertionMatrix[PixelFormatEnum::RGB8_UNORM][PixelFormatEnum::RGB32_FLOAT] = { Converters::Convert_RGB8_To_RGB32F, 72 };
 			s_pConvertionMatrix[PixelFormatEnum::RGB32_FLOAT][PixelFormatEnum::RGB8_UNORM] = { Converters::Convert_RGB32F_To_RGB8, -72 };
@@ -255,6 +327,16 @@ namespace Graphics
 			// BC7 <=> RGBA8
 			s_pConvertionMatrix[PixelFormatEnum::BC7][PixelFormatEnum::RGBA8_UNORM] = { Converters::Convert_BC7_To_RGBA8, 28 };
 			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM][PixelFormatEnum::BC7] = { Converters::Convert_RGBA8_To_BC7, -28 };
+
+			// BC sRGB <=> RGBA8 sRGB, blocks store sRGB encoded colors
+			s_pConvertionMatrix[PixelFormatEnum::BC1_SRGB][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_BC1_To_RGBA8, 28 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::BC1_SRGB] = { Converters::Convert_RGBA8_To_BC1, -28 };
+			s_pConvertionMatrix[PixelFormatEnum::BC2_SRGB][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_BC2_To_RGBA8, 28 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::BC2_SRGB] = { Converters::Convert_RGBA8_To_BC2, -28 };
+			s_pConvertionMatrix[PixelFormatEnum::BC3_SRGB][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_BC3_To_RGBA8, 28 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::BC3_SRGB] = { Converters::Convert_RGBA8_To_BC3, -28 };
+			s_pConvertionMatrix[PixelFormatEnum::BC7_SRGB][PixelFormatEnum::RGBA8_UNORM_SRGB] = { Converters::Convert_BC7_To_RGBA8, 28 };
+			s_pConvertionMatrix[PixelFormatEnum::RGBA8_UNORM_SRGB][PixelFormatEnum::BC7_SRGB] = { Converters::Convert_RGBA8_To_BC7, -28 };
 		}
 
 		bool GetConvertionChain(PixelFormatEnum eSourcePixelFormat, PixelFormatEnum eDestPixelFormat, ConvertionFuncChain* pOutChain, int* pOutChainLength, int* pOutAdditionalBits)
@@ -277,77 +359,77 @@ namespace Graphics
 				return true;
 			}
 
-			PixelFormatEnum eCurrentFormat = eSourcePixelFormat;
-			PixelFormatEnum eChain[32] = { PixelFormatEnum::_NONE };
-			int iCurrentChain = 0;
-
-			while (iCurrentChain < 32)
+			// Cheapest chain (Dijkstra), a step losing bits cost more than any lossless detour
+			// Between chains with as many lossy steps, bits are dropped from the widest intermediate format
+			// (RGBA8 => RGBA16F goes through RGBA32F rather than RGBA16)
+			const int c_iStepCost = 1;
+			const int c_iMaxBitsPerPixel = 128;
+			const int c_iLossyStepCost = PixelFormatEnum::_COUNT + c_iMaxBitsPerPixel;
+			const int c_iInfiniteCost = 0x7FFFFFFF;
+
+			int pCost[PixelFormatEnum::_COUNT];
+			PixelFormatEnum pPrevious[PixelFormatEnum::_COUNT];
+			bool pVisited[PixelFormatEnum::_COUNT];
+			for (int i = 0; i < PixelFormatEnum::_COUNT; ++i)
 			{
-				ConvertionFuncDeclaration* pInfos = s_pConvertionMatrix[eCurrentFormat];
+				pCost[i] = c_iInfiniteCost;
+				pPrevious[i] = PixelFormatEnum::_NONE;
+				pVisited[i] = false;
+			}
+			pCost[eSourcePixelFormat] = 0;
 
-				PixelFormatEnum eBestFormat = PixelFormatEnum::_NONE;
-				int iBestAddBits = -999;
-				if (pInfos[eDestPixelFormat].pFunc != NULL)
+			for (;;)
+			{
+				int iCurrent = -1;
+				for (int i = 0; i < PixelFormatEnum::_COUNT; ++i)
 				{
-					eBestFormat = eDestPixelFormat;
-				}
-				else
-				{
-					for (int i = 0; i < PixelFormatEnum::_COUNT; ++i)
-					{
-						if (pInfos[i].pFunc != NULL)
-						{
-							bool bAlreadyInChain = false;
-							for (int iChain = 0; iChain < iCurrentChain; ++iChain)
-							{
-								if (eChain[iChain] == i)
-								{
-									bAlreadyInChain = true;
-									break;
-								}
-							}
-
-							if (bAlreadyInChain)
-								continue;
-
-							if (eBestFormat == PixelFormatEnum::_NONE || pInfos[i].iAdditionalBits >= 0)
-							{
-								eBestFormat = (PixelFormatEnum)i;
-								if (pInfos[i].iAdditionalBits == 0)
-									break;
-							}
-						}
-					}
+					if (pVisited[i] == false && pCost[i] != c_iInfiniteCost && (iCurrent == -1 || pCost[i] < pCost[iCurrent]))
+						iCurrent = i;
 				}
 
-				if (eBestFormat != PixelFormatEnum::_NONE)
+				if (iCurrent == -1 || iCurrent == eDestPixelFormat)
+					break;
+
+				pVisited[iCurrent] = true;
+				ConvertionFuncDeclaration* pInfos = s_pConvertionMatrix[iCurrent];
+				for (int i = 0; i < PixelFormatEnum::_COUNT; ++i)
 				{
-					eChain[iCurrentChain] = eBestFormat;
-					++iCurrentChain;
-					eCurrentFormat = eBestFormat;
-					if (eBestFormat == eDestPixelFormat)
+					if (pInfos[i].pFunc == NULL || pVisited[i])
+						continue;
+
+					int iStepCost = c_iStepCost;
+					if (pInfos[i].iAdditionalBits < 0)
+						iStepCost = c_iLossyStepCost + c_iMaxBitsPerPixel - Math::Min(PixelFormatEnumInfos[iCurrent].iBitsPerPixel, c_iMaxBitsPerPixel);
+					int iCost = pCost[iCurrent] + iStepCost;
+					if (iCost < pCost[i])
 					{
-						break;
+						pCost[i] = iCost;
+						pPrevious[i] = (PixelFormatEnum)iCurrent;
 					}
-					continue;
 				}
-
-				break;
 			}
 
-			if (iCurrentChain > 0 && eChain[iCurrentChain - 1] == eDestPixelFormat)
+			if (eSourcePixelFormat != eDestPixelFormat && pCost[eDestPixelFormat] != c_iInfiniteCost)
 			{
+				PixelFormatEnum eChain[PixelFormatEnum::_COUNT];
+				int iChainLength = 0;
+				for (PixelFormatEnum eFormat = eDestPixelFormat; eFormat != eSourcePixelFormat; eFormat = pPrevious[eFormat])
+				{
+					eChain[iChainLength++] = eFormat;
+				}
+
 				int iAdditionalBits = 0;
-				eCurrentFormat = eSourcePixelFormat;
-				for (int i = 0; i < iCurrentChain; ++i)
+				PixelFormatEnum eCurrentFormat = eSourcePixelFormat;
+				for (int i = 0; i < iChainLength; ++i)
 				{
-					ConvertionFuncDeclaration& oInfo = s_pConvertionMatrix[eCurrentFormat][eChain[i]];
+					PixelFormatEnum eNextFormat = eChain[iChainLength - 1 - i];
+					ConvertionFuncDeclaration& oInfo = s_pConvertionMatrix[eCurrentFormat][eNextFormat];
 					(*pOutChain)[i].pFunc = oInfo.pFunc;
-					(*pOutChain)[i].eFormat = eChain[i];
+					(*pOutChain)[i].eFormat = eNextFormat;
 					iAdditionalBits += oInfo.iAdditionalBits;
-					eCurrentFormat = eChain[i];
+					eCurrentFormat = eNextFormat;
 				}
-				*pOutChainLength = iCurrentChain;
+				*pOutChainLength = iChainLength;
 				*pOutAdditionalBits = iAdditionalBits;
 				return true;
 			}
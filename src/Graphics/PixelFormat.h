@@ -16,6 +16,7 @@ namespace Graphics
 			UINT,
 			FLOAT,
 			SNORM,
+			SRGB, // UNorm with sRGB transfer function on color components, alpha is linear
 
 			_COUNT
 		};
@@ -40,6 +41,9 @@ namespace Graphics
 			RGBA8_UNORM,
 			BGRA8_UNORM,
 
+			RGBA8_UNORM_SRGB,
+			BGRA8_UNORM_SRGB,
+
 			R5G6B5_UNORM,
 			B5G6BR_UNORM,
 
@@ -68,6 +72,11 @@ namespace Graphics
 			BC6H,
 			BC7,
 
+			BC1_SRGB,
+			BC2_SRGB,
+			BC3_SRGB,
+			BC7_SRGB,
+
 			_COUNT,
 			_LAST = _COUNT - 1
 		};
@@ -112,6 +121,10 @@ namespace Graphics
 		bool					GetConvertionChain(PixelFormatEnum eSourcePixelFormat, PixelFormatEnum eDestPixelFormat, ConvertionFuncChain* pOutChain, int* pOutChainLength, int* pOutAdditionalBits);
 		int						GetAvailableConvertion(PixelFormatEnum eSourcePixelFormat, bool bIncludeChains, ConvertionInfoList* pOutAvailablePixelFormat);
 		bool					IsCompressed(PixelFormatEnum ePixelFormat);
+		bool					IsSRGB(PixelFormatEnum ePixelFormat);
+		// Same memory layout with/without sRGB transfer function, _NONE if there is no equivalent
+		PixelFormatEnum			GetSRGBFormat(PixelFormatEnum ePixelFormat);
+		PixelFormatEnum			GetLinearFormat(PixelFormatEnum ePixelFormat);
 		int						BitPerPixel(PixelFormatEnum ePixelFormat);
 		int						BlockSize(PixelFormatEnum ePixelFormat);
 		int						ComponentCount(PixelFormatEnum ePixelFormat);
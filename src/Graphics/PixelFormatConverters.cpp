@@ -3,6 +3,7 @@
 #include "Math/Math.h"
 
 #include <string.h> //memset
+#include <math.h> //powf
 
 namespace Graphics
 {
@@ -112,6 +113,56 @@ namespace Graphics
 				*pOutFloat = iValue / 65535.f;
 			}
 
+			struct SRGBTables
+			{
+				SRGBTables()
+				{
+					for (int i = 0; i < 256; ++i)
+					{
+						float fValue = i / 255.f;
+						pToLinear[i] = (fValue <= 0.04045f) ? (fValue / 12.92f) : powf((fValue + 0.055f) / 1.055f, 2.4f);
+					}
+
+					for (int i = 0; i < c_iLinearToSRGBTableSize; ++i)
+					{
+						float fValue = i / (float)(c_iLinearToSRGBTableSize - 1);
+						float fSRGB = (fValue <= 0.0031308f) ? (fValue * 12.92f) : (1.055f * powf(fValue, 1.f / 2.4f) - 0.055f);
+						pFromLinear[i] = (uint8_t)(Math::Clamp(fSRGB, 0.f, 1.f) * 255.f + 0.5f);
+					}
+				}
+
+				float pToLinear[256];
+				uint8_t pFromLinear[c_iLinearToSRGBTableSize];
+			};
+
+			static const SRGBTables& GetSRGBTables()
+			{
+				static SRGBTables s_oTables;
+				return s_oTables;
+			}
+
+			const float* GetSRGBToLinearTable()
+			{
+				return GetSRGBTables().pToLinear;
+			}
+
+			const uint8_t* GetLinearToSRGBTable()
+			{
+				return GetSRGBTables().pFromLinear;
+			}
+
+			void SRGBToLinear(uint8_t iValue, float* pOutFloat)
+			{
+				*pOutFloat = GetSRGBTables().pToLinear[iValue];
+			}
+
+			void LinearToSRGB(float fValue, uint8_t* pOutByte)
+			{
+				if (fValue > 1.f) fValue = 1.f;
+				if (!(fValue > 0.f)) fValue = 0.f;
+				*pOutByte = GetSRGBTables().pFromLinear[(int)(fValue * (c_iLinearToSRGBTableSize - 1) + 0.5f)];
+			}
+
 			void Convert_R8_To_RGB8(void* pIn, void* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
 			{
 				uint8_t* pIn8 = (uint8_t*)pIn;
@@ -202,6 +253,12 @@ namespace Graphics
 				pOut8->a = pIn8->a;
 			}
 
+			// Same bits, only the interpretation changes (UNorm <=> sRGB)
+			void Convert_Raw32(void* pIn, void* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
+			{
+				*(uint32_t*)pOut = *(uint32_t*)pIn;
+			}
+
 			void Convert_RGB565_To_RGB8(void* pIn, void* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
 			{
 				R5G6B5* pIn565 = (R5G6B5*)pIn;
@@ -240,10 +297,10 @@ namespace Graphics
 
 			void Convert_RGBA8_To_RGBA16(RGBA8* pIn, RGBA16* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
 			{
-				pOut->r = pIn->r * 256;
-				pOut->g = pIn->g * 256;
-				pOut->b = pIn->b * 256;
-				pOut->a = pIn->a * 256;
+				pOut->r = pIn->r * 257;
+				pOut->g = pIn->g * 257;
+				pOut->b = pIn->b * 257;
+				pOut->a = pIn->a * 257;
 			}
 
 			void Convert_RGBA16_To_RGBA8(RGBA16* pIn, RGBA8* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
@@ -407,6 +464,26 @@ namespace Graphics
 				FloatToByte(pInRGBA32F->a, &pOutRGBA8->a);
 			}
 
+			void Convert_RGBA8SRGB_To_RGBA32F(void* pIn, void* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
+			{
+				RGBA8* pInRGBA8 = (RGBA8*)pIn;
+				RGBA32F* pOutRGBA32F = (RGBA32F*)pOut;
+				SRGBToLinear(pInRGBA8->r, &pOutRGBA32F->r);
+				SRGBToLinear(pInRGBA8->g, &pOutRGBA32F->g);
+				SRGBToLinear(pInRGBA8->b, &pOutRGBA32F->b);
+				ByteToFloat(pInRGBA8->a, &pOutRGBA32F->a);
+			}
+
+			void Convert_RGBA32F_To_RGBA8SRGB(void* pIn, void* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
+			{
+				RGBA32F* pInRGBA32F = (RGBA32F*)pIn;
+				RGBA8* pOutRGBA8 = (RGBA8*)pOut;
+				LinearToSRGB(pInRGBA32F->r, &pOutRGBA8->r);
+				LinearToSRGB(pInRGBA32F->g, &pOutRGBA8->g);
+				LinearToSRGB(pInRGBA32F->b, &pOutRGBA8->b);
+				FloatToByte(pInRGBA32F->a, &pOutRGBA8->a);
+			}
+
 			void Convert_RGB8_To_RGB32F(void* pIn, void* pOut, size_t /*iPitchIn*/, size_t /*iPitchOut*/)
 			{
 				RGB8* pInRGBAA8 = (RGB8*)pIn;
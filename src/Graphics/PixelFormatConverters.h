@@ -18,6 +18,15 @@ namespace Graphics
 			void FloatToShort(float fValue, uint16_t* pOutShort);
 			void ShortToFloat(uint16_t iValue, float* pOutFloat);
 
+			// sRGB transfer function lookup tables
+			// Decode table has 256 entries, encode table covers linear [0, 1] in c_iLinearToSRGBTableSize steps
+			const int c_iLinearToSRGBTableSize = 65536;
+			const float* GetSRGBToLinearTable();
+			const uint8_t* GetLinearToSRGBTable();
+
+			void SRGBToLinear(uint8_t iValue, float* pOutFloat);
+			void LinearToSRGB(float fValue, uint8_t* pOutByte);
+
 			void Convert_R8_To_RGB8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGB8_To_R8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RG8_To_RGB8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
@@ -28,6 +37,7 @@ namespace Graphics
 			void Convert_RGB8_To_BGR8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_BGRA8_To_RGBA8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGBA8_To_BGRA8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
+			void Convert_Raw32(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGB565_To_RGB8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGB8_To_RGB565(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_BGR565_To_RGB8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
@@ -51,6 +61,8 @@ namespace Graphics
 			void Convert_RGBA32F_To_RGBA16F(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGBA8_To_RGBA32F(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGBA32F_To_RGBA8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
+			void Convert_RGBA8SRGB_To_RGBA32F(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
+			void Convert_RGBA32F_To_RGBA8SRGB(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGB8_To_RGB32F(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void Convert_RGB32F_To_RGB8(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
 			void ConvertRGBA16ToRGB32F(void* pIn, void* pOut, size_t iPitchIn, size_t iPitchOut);
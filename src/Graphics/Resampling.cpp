@@ -0,0 +1,226 @@
+#include "Graphics/Resampling.h"
+
+#include "Core/Assert.h"
+
+#include <emmintrin.h> //SIMD
+#include <math.h> // sin/sqrt/floor/ceil
+
+namespace Graphics
+{
+	const char* const ResampleFilterEnumStrings[ResampleFilterEnum::_COUNT] =
+	{
+		"Default",
+		"Box",
+		"Triangle",
+		"Kaiser",
+		"Lanczos3",
+		"Mitchell"
+	};
+
+	const char* const EdgeModeEnumStrings[EdgeModeEnum::_COUNT] =
+	{
+		"Clamp",
+		"Wrap",
+		"Cubemap"
+	};
+
+	namespace Resampling
+	{
+		static const double c_fPi = 3.14159265358979323846;
+
+		static double Sinc(double fX)
+		{
+			if (fabs(fX) < 1e-6)
+				return 1.0;
+			return sin(c_fPi * fX) / (c_fPi * fX);
+		}
+
+		// Modified Bessel function of the first kind, order 0
+		static double BesselI0(double fX)
+		{
+			double fSum = 1.0;
+			double fTerm = 1.0;
+			const double fHalfSquare = fX * fX * 0.25;
+			for (int iK = 1; iK < 32 && fTerm > fSum * 1e-12; ++iK)
+			{
+				fTerm *= fHalfSquare / ((double)iK * iK);
+				fSum += fTerm;
+			}
+			return fSum;
+		}
+
+		static double GetFilterRadius(ResampleFilterEnum eFilter)
+		{
+			switch (eFilter)
+			{
+			case ResampleFilterEnum::BOX:
+				return 0.5;
+			case ResampleFilterEnum::TRIANGLE:
+				return 1.0;
+			case ResampleFilterEnum::KAISER:
+			case ResampleFilterEnum::LANCZOS3:
+				return 3.0;
+			default:
+				return 2.0;
+			}
+		}
+
+		static double EvaluateFilter(ResampleFilterEnum eFilter, double fX)
+		{
+			const double fAbsX = fabs(fX);
+			switch (eFilter)
+			{
+			case ResampleFilterEnum::BOX:
+				return (fX >= -0.5 && fX < 0.5) ? 1.0 : 0.0;
+			case ResampleFilterEnum::TRIANGLE:
+				return fAbsX < 1.0 ? 1.0 - fAbsX : 0.0;
+			case ResampleFilterEnum::KAISER:
+			{
+				// Width 3, alpha 4
+				const double c_fWidth = 3.0;
+				const double c_fAlpha = 4.0;
+				if (fAbsX >= c_fWidth)
+					return 0.0;
+				const double fRatio = fX / c_fWidth;
+				return Sinc(fX) * BesselI0(c_fAlpha * sqrt(1.0 - fRatio * fRatio)) / BesselI0(c_fAlpha);
+			}
+			case ResampleFilterEnum::LANCZOS3:
+				return fAbsX < 3.0 ? Sinc(fX) * Sinc(fX / 3.0) : 0.0;
+			default:
+			{
+				// Mitchell-Netravali, B = C = 1/3
+				const double B = 1.0 / 3.0;
+				const double C = 1.0 / 3.0;
+				if (fAbsX < 1.0)
+					return ((12.0 - 9.0 * B - 6.0 * C) * fAbsX * fAbsX * fAbsX + (-18.0 + 12.0 * B + 6.0 * C) * fAbsX * fAbsX + (6.0 - 2.0 * B)) / 6.0;
+				if (fAbsX < 2.0)
+					return ((-B - 6.0 * C) * fAbsX * fAbsX * fAbsX + (6.0 * B + 30.0 * C) * fAbsX * fAbsX + (-12.0 * B - 48.0 * C) * fAbsX + (8.0 * B + 24.0 * C)) / 6.0;
+				return 0.0;
+			}
+			}
+		}
+
+		static int ApplyEdgeMode(EdgeModeEnum eEdgeMode, int iIndex, int iSize, int iBorder)
+		{
+			if (eEdgeMode == EdgeModeEnum::WRAP)
+				return ((iIndex % iSize) + iSize) % iSize + iBorder;
+			return iIndex < -iBorder ? 0 : (iIndex >= iSize + iBorder ? iSize + 2 * iBorder - 1 : iIndex + iBorder);
+		}
+
+		static double GetScaledRadius(ResampleFilterEnum eFilter, int iSourceSize, int iDestSize, double* pOutFilterScale)
+		{
+			// Filter is stretched when minifying so each destination pixel covers its whole footprint
+			const double fScale = (double)iDestSize / (double)iSourceSize;
+			const double fFilterScale = fScale < 1.0 ? fScale : 1.0;
+			if (pOutFilterScale != NULL)
+				*pOutFilterScale = fFilterScale;
+			return GetFilterRadius(eFilter) / fFilterScale;
+		}
+
+		int GetSourceBorder(ResampleFilterEnum eFilter, int iSourceSize, int iDestSize)
+		{
+			// First tap is at least at -radius, last one at most at size - 1 + radius + 1
+			return (int)ceil(GetScaledRadius(eFilter, iSourceSize, iDestSize, NULL)) + 2;
+		}
+
+		bool ComputeAxisWeights(ResampleFilterEnum eFilter, EdgeModeEnum eEdgeMode, int iSourceSize, int iDestSize, AxisWeights* pOutWeights, int iSourceBorder)
+		{
+			CORE_ASSERT(iSourceSize > 0 && iDestSize > 0 && pOutWeights != NULL);
+			CORE_ASSERT(iSourceBorder == 0 || eEdgeMode != EdgeModeEnum::WRAP);
+
+			const double fScale = (double)iDestSize / (double)iSourceSize;
+			double fFilterScale;
+			const double fRadius = GetScaledRadius(eFilter, iSourceSize, iDestSize, &fFilterScale);
+			const int iTapCount = (int)floor(2.0 * fRadius) + 2;
+
+			pOutWeights->iTapCount = iTapCount;
+			if (pOutWeights->oIndices.resize((size_t)iDestSize * iTapCount, false) == false
+				|| pOutWeights->oWeights.resize((size_t)iDestSize * iTapCount, false) == false)
+			{
+				return false;
+			}
+
+			for (int iDest = 0; iDest < iDestSize; ++iDest)
+			{
+				const double fCenter = (iDest + 0.5) / fScale - 0.5;
+				const int iFirst = (int)ceil(fCenter - fRadius);
+				int* pIndices = &pOutWeights->oIndices[(size_t)iDest * iTapCount];
+				float* pWeights = &pOutWeights->oWeights[(size_t)iDest * iTapCount];
+
+				double fSum = 0.0;
+				for (int iTap = 0; iTap < iTapCount; ++iTap)
+				{
+					double fWeight = EvaluateFilter(eFilter, (iFirst + iTap - fCenter) * fFilterScale);
+					pIndices[iTap] = ApplyEdgeMode(eEdgeMode, iFirst + iTap, iSourceSize, iSourceBorder);
+					pWeights[iTap] = (float)fWeight;
+					fSum += fWeight;
+				}
+
+				if (fabs(fSum) < 1e-8)
+				{
+					// Degenerated footprint, take nearest pixel
+					for (int iTap = 0; iTap < iTapCount; ++iTap)
+					{
+						pIndices[iTap] = ApplyEdgeMode(eEdgeMode, (int)floor(fCenter + 0.5), iSourceSize, iSourceBorder);
+						pWeights[iTap] = (iTap == 0) ? 1.f : 0.f;
+					}
+				}
+				else
+				{
+					const float fInvSum = (float)(1.0 / fSum);
+					for (int iTap = 0; iTap < iTapCount; ++iTap)
+						pWeights[iTap] *= fInvSum;
+				}
+			}
+			return true;
+		}
+
+		void ResampleLine(const float* pSource, float* pDest, int iDestStartX, int iDestEndX, const AxisWeights& oWeights, int iSourceStartX)
+		{
+			const int iTapCount = oWeights.iTapCount;
+			const int* pIndices = oWeights.oIndices.begin() + (size_t)iDestStartX * iTapCount;
+			const float* pWeights = oWeights.oWeights.begin() + (size_t)iDestStartX * iTapCount;
+			const int iDestWidth = iDestEndX - iDestStartX;
+			for (int iX = 0; iX < iDestWidth; ++iX)
+			{
+				__m128 xSum = _mm_setzero_ps();
+				for (int iTap = 0; iTap < iTapCount; ++iTap)
+				{
+					xSum = _mm_add_ps(xSum, _mm_mul_ps(_mm_loadu_ps(pSource + (pIndices[iTap] - iSourceStartX) * 4), _mm_set1_ps(pWeights[iTap])));
+				}
+				_mm_storeu_ps(pDest + iX * 4, xSum);
+				pIndices += iTapCount;
+				pWeights += iTapCount;
+			}
+		}
+
+		void BlendLines(const float* const* pLines, const float* pWeights, int iLineCount, float* pDest, int iWidth)
+		{
+			const int iFloatCount = iWidth * 4;
+			int iFloat = 0;
+			// 2 pixels per iteration
+			for (; iFloat + 8 <= iFloatCount; iFloat += 8)
+			{
+				__m128 xSum0 = _mm_setzero_ps();
+				__m128 xSum1 = _mm_setzero_ps();
+				for (int iLine = 0; iLine < iLineCount; ++iLine)
+				{
+					const __m128 xWeight = _mm_set1_ps(pWeights[iLine]);
+					xSum0 = _mm_add_ps(xSum0, _mm_mul_ps(_mm_loadu_ps(pLines[iLine] + iFloat), xWeight));
+					xSum1 = _mm_add_ps(xSum1, _mm_mul_ps(_mm_loadu_ps(pLines[iLine] + iFloat + 4), xWeight));
+				}
+				_mm_storeu_ps(pDest + iFloat, xSum0);
+				_mm_storeu_ps(pDest + iFloat + 4, xSum1);
+			}
+			for (; iFloat < iFloatCount; iFloat += 4)
+			{
+				__m128 xSum = _mm_setzero_ps();
+				for (int iLine = 0; iLine < iLineCount; ++iLine)
+					xSum = _mm_add_ps(xSum, _mm_mul_ps(_mm_loadu_ps(pLines[iLine] + iFloat), _mm_set1_ps(pWeights[iLine])));
+				_mm_storeu_ps(pDest + iFloat, xSum);
+			}
+		}
+	}
+	//namespace Resampling
+}
+//namespace Graphics
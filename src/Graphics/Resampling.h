@@ -0,0 +1,67 @@
+#ifndef __GRAPHICS_RESAMPLING_H__
+#define __GRAPHICS_RESAMPLING_H__
+
+#include "Core/Array.h"
+
+namespace Graphics
+{
+	struct _ResampleFilterEnum
+	{
+		enum Enum
+		{
+			DEFAULT,		// Box reduction for mips, stb_image_resize default filters for resize (Mitchell with wrap edges)
+			BOX,
+			TRIANGLE,
+			KAISER,
+			LANCZOS3,
+			MITCHELL,
+
+			_COUNT
+		};
+	};
+	typedef _ResampleFilterEnum::Enum ResampleFilterEnum;
+	extern const char* const ResampleFilterEnumStrings[ResampleFilterEnum::_COUNT];
+
+	struct _EdgeModeEnum
+	{
+		enum Enum
+		{
+			CLAMP,
+			WRAP, // Tiling textures
+			CUBEMAP, // Cubemap faces read across their edges from the adjacent faces
+
+			_COUNT
+		};
+	};
+	typedef _EdgeModeEnum::Enum EdgeModeEnum;
+	extern const char* const EdgeModeEnumStrings[EdgeModeEnum::_COUNT];
+
+	/* Separable resampling of RGBA float images
+	Weights of each destination pixel are precomputed once per axis,
+	edge mode is applied to source indices so passes never test bounds.
+	*/
+	namespace Resampling
+	{
+		struct AxisWeights
+		{
+			int							iTapCount;
+			Core::Array<int>			oIndices; // Destination size * iTapCount source indices
+			Core::Array<float>			oWeights; // Destination size * iTapCount normalized weights, unused taps have a null weight
+		};
+
+		// Source padded by iSourceBorder texels on each side (cubemap faces) : indices are offset by the border, clamped beyond it
+		bool						ComputeAxisWeights(ResampleFilterEnum eFilter, EdgeModeEnum eEdgeMode, int iSourceSize, int iDestSize, AxisWeights* pOutWeights, int iSourceBorder = 0);
+		// Texels read by the filter beyond each edge of the source
+		int							GetSourceBorder(ResampleFilterEnum eFilter, int iSourceSize, int iDestSize);
+
+		// Horizontal pass of a line of 4 floats pixels, destination pixels [iDestStartX, iDestEndX[, pDest points to pixel iDestStartX
+		// pSource points to source pixel iSourceStartX, taps of the destination pixels must not read before it
+		void						ResampleLine(const float* pSource, float* pDest, int iDestStartX, int iDestEndX, const AxisWeights& oWeights, int iSourceStartX = 0);
+		// Vertical pass, weighted sum of lines of 4 floats pixels
+		void						BlendLines(const float* const* pLines, const float* pWeights, int iLineCount, float* pDest, int iWidth);
+	}
+	//namespace Resampling
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_RESAMPLING_H__
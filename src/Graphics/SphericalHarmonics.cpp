@@ -0,0 +1,270 @@
+#include "Graphics/SphericalHarmonics.h"
+
+#include "Graphics/CubemapSampling.h"
+#include "Graphics/TextureUtils.h"
+
+#include "Core/Array.h"
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
+#include <math.h> // sqrt/sin/cos/atan2
+#include <string.h> // memset
+
+namespace Graphics
+{
+	const char* const SH9CoefficientNames[9] =
+	{
+		"L00",
+		"L1-1",
+		"L10",
+		"L11",
+		"L2-2",
+		"L2-1",
+		"L20",
+		"L21",
+		"L22"
+	};
+
+	SHSettings::SHSettings()
+	{
+		iMaxFaceSize = 0;
+		bIrradiance = false;
+	}
+
+	static const double c_fPi = 3.14159265358979323846;
+
+	// Lines of faces integrated by each job, partial sums of jobs are reduced in job order so results don't depend on threads
+	static const int c_iSHBandHeight = 16;
+
+	struct SHPartialSum
+	{
+		double						fCoefficients[9][3];
+		double						fWeight;
+	};
+
+	// Accumulate a line of texels, directions are normalized here
+	static void AccumulateLine(const float* pPixels, int iPixelStride, const float* pX, const float* pY, const float* pZ, const float* pWeights, float fConstantWeight, int iCount, SHPartialSum* pSum)
+	{
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+		{
+			const double fInvLength = 1.0 / sqrt((double)pX[iIndex] * pX[iIndex] + (double)pY[iIndex] * pY[iIndex] + (double)pZ[iIndex] * pZ[iIndex]);
+			const double fX = pX[iIndex] * fInvLength;
+			const double fY = pY[iIndex] * fInvLength;
+			const double fZ = pZ[iIndex] * fInvLength;
+			const double fWeight = (pWeights != NULL) ? pWeights[iIndex] : fConstantWeight;
+
+			const double fBasis[9] =
+			{
+				0.282094792,
+				0.488602512 * fY,
+				0.488602512 * fZ,
+				0.488602512 * fX,
+				1.092548431 * fX * fY,
+				1.092548431 * fY * fZ,
+				0.315391565 * (3.0 * fZ * fZ - 1.0),
+				1.092548431 * fX * fZ,
+				0.546274215 * (fX * fX - fY * fY)
+			};
+
+			const float* pPixel = pPixels + (size_t)iIndex * iPixelStride;
+			for (int iCoef = 0; iCoef < 9; ++iCoef)
+			{
+				const double fBasisWeight = fBasis[iCoef] * fWeight;
+				pSum->fCoefficients[iCoef][0] += pPixel[0] * fBasisWeight;
+				pSum->fCoefficients[iCoef][1] += pPixel[1] * fBasisWeight;
+				pSum->fCoefficients[iCoef][2] += pPixel[2] * fBasisWeight;
+			}
+			pSum->fWeight += fWeight;
+		}
+	}
+
+	static double CubeAreaElement(double fX, double fY)
+	{
+		return atan2(fX * fY, sqrt(fX * fX + fY * fY + 1.0));
+	}
+
+	bool IsSHProjectable(const Texture* pTexture)
+	{
+		if (pTexture == NULL || pTexture->IsValid() == false || pTexture->IsArray() || pTexture->IsVolume())
+			return false;
+		if (pTexture->GetFaceCount() == Texture::_E_FACE_COUNT)
+			return true;
+		return pTexture->GetWidth() == pTexture->GetHeight() * 2;
+	}
+
+	ErrorCode ProjectSH9(const Texture* pTexture, SH9* pOutSH, const SHSettings* pSettings)
+	{
+		if (pTexture == NULL || pOutSH == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (IsSHProjectable(pTexture) == false)
+		{
+			return ErrorCode(1, "Texture is not a cubemap or a LatLong texture");
+		}
+
+		SHSettings oDefaultSettings;
+		const SHSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+
+		const bool bCubemap = pTexture->GetFaceCount() == Texture::_E_FACE_COUNT;
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+
+		// Decode to RGBA or RGB float
+		PixelFormatEnum eWorkingFormat = PixelFormatEnum::RGBA32_FLOAT;
+		PixelFormat::ConvertionFuncChain oDecodeChain;
+		int iDecodeChainLength = 0;
+		int iAdditionalBits;
+		if (ePixelFormat != PixelFormatEnum::RGBA32_FLOAT && ePixelFormat != PixelFormatEnum::RGB32_FLOAT)
+		{
+			if (PixelFormat::GetConvertionChain(ePixelFormat, PixelFormatEnum::RGBA32_FLOAT, &oDecodeChain, &iDecodeChainLength, &iAdditionalBits) == false)
+			{
+				eWorkingFormat = PixelFormatEnum::RGB32_FLOAT;
+				if (PixelFormat::GetConvertionChain(ePixelFormat, PixelFormatEnum::RGB32_FLOAT, &oDecodeChain, &iDecodeChainLength, &iAdditionalBits) == false)
+				{
+					return ErrorCode(1, "'%s' Pixel format can't be decoded", PixelFormatEnumInfos[ePixelFormat].pName);
+				}
+			}
+		}
+		else
+		{
+			eWorkingFormat = ePixelFormat;
+		}
+		const int iPixelStride = PixelFormatEnumInfos[eWorkingFormat].iComponents;
+
+		// First level small enough
+		int iMip = 0;
+		if (oSettings.iMaxFaceSize > 0)
+		{
+			while (iMip + 1 < pTexture->GetMipCount()
+				&& (bCubemap ? pTexture->GetData().GetFaceData(iMip, 0).iWidth : pTexture->GetData().GetFaceData(iMip, 0).iHeight / 2) > oSettings.iMaxFaceSize)
+			{
+				++iMip;
+			}
+		}
+
+		const Texture::TextureFaceData& oLevelData = pTexture->GetData().GetFaceData(iMip, 0);
+		const int iWidth = oLevelData.iWidth;
+		const int iHeight = oLevelData.iHeight;
+		const int iBlockHeight = PixelFormatEnumInfos[ePixelFormat].iBlockHeight;
+		const int iFaceCount = bCubemap ? Texture::_E_FACE_COUNT : 1;
+		const int iBandCount = (iHeight + c_iSHBandHeight - 1) / c_iSHBandHeight;
+		const int iJobCount = iFaceCount * iBandCount;
+
+		Core::Array<SHPartialSum> oPartialSums;
+		Core::Array<float> oSinLongitudes, oCosLongitudes;
+		if (oPartialSums.resize(iJobCount, false) == false
+			|| (bCubemap == false && CubemapSampling::ComputeLongitudes(iWidth, &oSinLongitudes, &oCosLongitudes) == false))
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			const int iFace = iJob / iBandCount;
+			const int iStartY = (iJob % iBandCount) * c_iSHBandHeight;
+			const int iEndY = Math::Min(iStartY + c_iSHBandHeight, iHeight);
+			SHPartialSum& oSum = oPartialSums[iJob];
+			memset(&oSum, 0, sizeof(oSum));
+
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace);
+			const size_t iLineFloatCount = (size_t)iWidth * iPixelStride;
+
+			// Decoded band (block rows containing the band) followed by X, Y, Z and weight lines
+			const int iDecodeStartY = iStartY - iStartY % iBlockHeight;
+			CORE_PTR_VOID pWorking = Core::Malloc((iLineFloatCount * (iEndY - iDecodeStartY) + (size_t)iWidth * 4) * sizeof(float));
+			if (pWorking == NULL)
+			{
+				bError = true;
+				continue;
+			}
+			float* pBand = (float*)pWorking;
+			float* pX = pBand + iLineFloatCount * (iEndY - iDecodeStartY);
+			float* pY = pX + iWidth;
+			float* pZ = pY + iWidth;
+			float* pWeights = pZ + iWidth;
+
+			const float* pLines;
+			if (iDecodeChainLength > 0)
+			{
+				ConvertPixelFormatRegion(
+					(const char*)oFaceData.pData + (size_t)(iDecodeStartY / iBlockHeight) * oFaceData.iPitch, oFaceData.iPitch, ePixelFormat,
+					pBand, iLineFloatCount * sizeof(float), eWorkingFormat,
+					iWidth, iEndY - iDecodeStartY,
+					oDecodeChain, iDecodeChainLength);
+				pLines = pBand + iLineFloatCount * (iStartY - iDecodeStartY);
+			}
+			else
+			{
+				pLines = (const float*)((const char*)oFaceData.pData + (size_t)iStartY * oFaceData.iPitch);
+			}
+
+			for (int iY = iStartY; iY < iEndY; ++iY)
+			{
+				const float* pLine = pLines + iLineFloatCount * (iY - iStartY);
+				if (bCubemap)
+				{
+					// Solid angle of the texel [u0, u1] x [v0, v1] projected on the unit sphere
+					CubemapSampling::GetFaceDirections((Texture::EFace)iFace, iWidth, iY, pX, pY, pZ);
+					const double fInvSize = 2.0 / iWidth;
+					const double fV0 = iY * fInvSize - 1.0;
+					const double fV1 = fV0 + fInvSize;
+					for (int iX = 0; iX < iWidth; ++iX)
+					{
+						const double fU0 = iX * fInvSize - 1.0;
+						const double fU1 = fU0 + fInvSize;
+						pWeights[iX] = (float)(CubeAreaElement(fU0, fV0) - CubeAreaElement(fU0, fV1) - CubeAreaElement(fU1, fV0) + CubeAreaElement(fU1, fV1));
+					}
+					AccumulateLine(pLine, iPixelStride, pX, pY, pZ, pWeights, 0.f, iWidth, &oSum);
+				}
+				else
+				{
+					// Solid angle of a LatLong texel : dPhi * (cos(theta0) - cos(theta1))
+					CubemapSampling::GetLatLongDirections(oSinLongitudes.begin(), oCosLongitudes.begin(), iWidth, iHeight, iY, pX, pY, pZ);
+					const double fWeight = (2.0 * c_fPi / iWidth) * (cos(c_fPi * iY / iHeight) - cos(c_fPi * (iY + 1) / iHeight));
+					AccumulateLine(pLine, iPixelStride, pX, pY, pZ, NULL, (float)fWeight, iWidth, &oSum);
+				}
+			}
+
+			Core::Free(pWorking);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		SHPartialSum oTotal;
+		memset(&oTotal, 0, sizeof(oTotal));
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			for (int iCoef = 0; iCoef < 9; ++iCoef)
+			{
+				for (int iChannel = 0; iChannel < 3; ++iChannel)
+					oTotal.fCoefficients[iCoef][iChannel] += oPartialSums[iJob].fCoefficients[iCoef][iChannel];
+			}
+			oTotal.fWeight += oPartialSums[iJob].fWeight;
+		}
+
+		// Solid angles sum to 4 pi, remove the residual error
+		const double fNormalization = (oTotal.fWeight > 0.0) ? 4.0 * c_fPi / oTotal.fWeight : 0.0;
+		// Clamped cosine lobe convolution (Ramamoorthi and Hanrahan) divided by pi
+		const double c_fBandFactors[3] = { 1.0, 2.0 / 3.0, 1.0 / 4.0 };
+		const int c_iCoefficientBands[9] = { 0, 1, 1, 1, 2, 2, 2, 2, 2 };
+		for (int iCoef = 0; iCoef < 9; ++iCoef)
+		{
+			const double fScale = fNormalization * (oSettings.bIrradiance ? c_fBandFactors[c_iCoefficientBands[iCoef]] : 1.0);
+			for (int iChannel = 0; iChannel < 3; ++iChannel)
+				pOutSH->fCoefficients[iCoef][iChannel] = (float)(oTotal.fCoefficients[iCoef][iChannel] * fScale);
+		}
+
+		return ErrorCode::Ok;
+	}
+}
+//namespace Graphics
@@ -0,0 +1,32 @@
+#ifndef __GRAPHICS_SPHERICAL_HARMONICS_H__
+#define __GRAPHICS_SPHERICAL_HARMONICS_H__
+
+#include "Core/ErrorCode.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* Order 3 (L2) spherical harmonics projection of environment maps
+	Cubemaps and LatLong textures are integrated with the exact solid angle of each texel.
+	Directions use cubemap axes (+Y up), basis order is L00, L1-1, L10, L11, L2-2, L2-1, L20, L21, L22.
+	*/
+	struct SH9
+	{
+		float						fCoefficients[9][3]; // RGB
+	};
+	extern const char* const SH9CoefficientNames[9];
+
+	struct SHSettings
+	{
+		SHSettings();
+		int							iMaxFaceSize; // Project the first mip with a face size (LatLong height / 2) lower or equal, 0 for mip 0
+		bool						bIrradiance; // Convolve with the clamped cosine lobe, coefficients give irradiance / pi
+	};
+
+	bool							IsSHProjectable(const Texture* pTexture);
+	ErrorCode						ProjectSH9(const Texture* pTexture, SH9* pOutSH, const SHSettings* pSettings = NULL);
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_SPHERICAL_HARMONICS_H__
@@ -5,6 +5,7 @@
 #include <stdlib.h> //malloc/free/NULL
 #include <string.h> //memcpy/memset
 #include <assert.h> //asert
+#include <atomic>
 
 using namespace Graphics;
 
@@ -30,8 +31,10 @@ Texture::TextureFaceData::TextureFaceData()
 	pData = CORE_PTR_NULL;
 	iSize = 0;
 	iPitch = 0;
+	iSlicePitch = 0;
 	iWidth = 0;
 	iHeight = 0;
+	iDepth = 0;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -43,8 +46,10 @@ Texture::TextureData::Desc::Desc()
 	ePixelFormat = PixelFormatEnum::_NONE;
 	iWidth = 0;
 	iHeight = 0;
+	iDepth = 1;
 	iMipCount = 1;
 	iFaceCount = 1;
+	iArraySize = 1;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -55,6 +60,9 @@ Texture::TextureData::TextureData()
 {
 	m_pData = CORE_PTR_NULL;
 	m_iSize = 0;
+	m_iFaceCount = 0;
+	m_iArraySize = 0;
+	m_iMipCount = 0;
 }
 
 Texture::TextureData::~TextureData()
@@ -68,31 +76,49 @@ ErrorCode Texture::TextureData::Create(Desc& oDesc)
 
 	const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oDesc.ePixelFormat];
 
+	size_t iSubresourceCount = (size_t)oDesc.iMipCount * oDesc.iArraySize * oDesc.iFaceCount;
+	if (m_oFaceData.resize(iSubresourceCount, false) == false)
+	{
+		return ErrorCode::Fail;
+	}
+
 	size_t iOffset = 0;
-	size_t iOffsets[_E_FACE_COUNT][c_iMaxMip];
+	size_t iSubresource = 0;
 	for (int iMipIndex = 0; iMipIndex < oDesc.iMipCount; ++iMipIndex)
 	{
 		uint32_t iMipWidth = oDesc.iWidth >> iMipIndex;
 		iMipWidth = iMipWidth > 0 ? iMipWidth : 1;
 		uint32_t iMipHeight = oDesc.iHeight >> iMipIndex;
 		iMipHeight = iMipHeight > 0 ? iMipHeight : 1;
+		uint32_t iMipDepth = oDesc.iDepth >> iMipIndex;
+		iMipDepth = iMipDepth > 0 ? iMipDepth : 1;
 
 		uint32_t iBlockCountX, iBlockCountY;
 		PixelFormat::GetBlockCount(oDesc.ePixelFormat, iMipWidth, iMipHeight, &iBlockCountX, &iBlockCountY);
 
-		for (int iFaceIndex = 0; iFaceIndex < oDesc.iFaceCount; ++iFaceIndex)
+		size_t iSlicePitch = (size_t)iBlockCountX * iBlockCountY * oInfos.iBlockSize;
+		size_t iSize = iSlicePitch * iMipDepth;
+
+		for (int iLayerIndex = 0; iLayerIndex < oDesc.iArraySize; ++iLayerIndex)
 		{
-			size_t iSize = (size_t)iBlockCountX * iBlockCountY * oInfos.iBlockSize;
-
-			m_oFaceData[iFaceIndex][iMipIndex].iWidth = (int)iMipWidth;
-			m_oFaceData[iFaceIndex][iMipIndex].iHeight = (int)iMipHeight;
-			m_oFaceData[iFaceIndex][iMipIndex].iSize = iSize;
-			m_oFaceData[iFaceIndex][iMipIndex].iPitch = (size_t)iBlockCountX * oInfos.iBlockSize;
-			iOffsets[iFaceIndex][iMipIndex] = iOffset;
-			iOffset += iSize;
+			for (int iFaceIndex = 0; iFaceIndex < oDesc.iFaceCount; ++iFaceIndex)
+			{
+				TextureFaceData& oFaceData = m_oFaceData[iSubresource++];
+				oFaceData = TextureFaceData();
+				oFaceData.iWidth = (int)iMipWidth;
+				oFaceData.iHeight = (int)iMipHeight;
+				oFaceData.iDepth = (int)iMipDepth;
+				oFaceData.iSize = iSize;
+				oFaceData.iPitch = (size_t)iBlockCountX * oInfos.iBlockSize;
+				oFaceData.iSlicePitch = iSlicePitch;
+				iOffset += iSize;
+			}
 		}
 	}
 	m_iSize = iOffset;
+	m_iFaceCount = oDesc.iFaceCount;
+	m_iArraySize = oDesc.iArraySize;
+	m_iMipCount = oDesc.iMipCount;
 
 	if (iOffset == 0 || (m_pData = Core::Malloc(iOffset)) == NULL)
 	{
@@ -100,13 +126,12 @@ ErrorCode Texture::TextureData::Create(Desc& oDesc)
 		return ErrorCode::Fail;
 	}
 
-	for (int iMipIndex = 0; iMipIndex < oDesc.iMipCount; ++iMipIndex)
+	iOffset = 0;
+	for (size_t iIndex = 0; iIndex < iSubresourceCount; ++iIndex)
 	{
-		for (int iFaceIndex = 0; iFaceIndex < oDesc.iFaceCount; ++iFaceIndex)
-		{
-			CORE_PTR(char) pDataChar = (CORE_PTR(char))m_pData;
-			m_oFaceData[iFaceIndex][iMipIndex].pData = (pDataChar + iOffsets[iFaceIndex][iMipIndex]);
-		}
+		CORE_PTR(char) pDataChar = (CORE_PTR(char))m_pData;
+		m_oFaceData[iIndex].pData = (pDataChar + iOffset);
+		iOffset += m_oFaceData[iIndex].iSize;
 	}
 
 	return ErrorCode::Ok;
@@ -119,14 +144,11 @@ void Texture::TextureData::Destroy()
 		Core::Free(m_pData);
 		m_pData = CORE_PTR_NULL;
 		m_iSize = 0;
-		for (int iFaceIndex = 0; iFaceIndex < _E_FACE_COUNT; ++iFaceIndex)
-		{
-			for (int iMipIndex = 0; iMipIndex < c_iMaxMip; ++iMipIndex)
-			{
-				m_oFaceData[iFaceIndex][iMipIndex] = TextureFaceData();
-			}
-		}
 	}
+	m_oFaceData.clear();
+	m_iFaceCount = 0;
+	m_iArraySize = 0;
+	m_iMipCount = 0;
 }
 
 bool Texture::TextureData::IsValid() const
@@ -134,6 +156,14 @@ bool Texture::TextureData::IsValid() const
 	return m_pData != NULL;
 }
 
+const Texture::TextureFaceData& Texture::TextureData::GetFaceData(int iMip, int iFace, int iLayer) const
+{
+	CORE_ASSERT(iMip >= 0 && iMip < m_iMipCount);
+	CORE_ASSERT(iFace >= 0 && iFace < m_iFaceCount);
+	CORE_ASSERT(iLayer >= 0 && iLayer < m_iArraySize);
+	return m_oFaceData[((size_t)iMip * m_iArraySize + iLayer) * m_iFaceCount + iFace];
+}
+
 ////////////////////////////////////////////////////////////////
 // Texture::Desc
 ////////////////////////////////////////////////////////////////
@@ -150,16 +180,59 @@ Texture::Desc::Desc()
 	}
 }
 
+////////////////////////////////////////////////////////////////
+// Texture::DirtyRect
+////////////////////////////////////////////////////////////////
+
+Texture::DirtyRect::DirtyRect()
+{
+	iLeft = 0;
+	iTop = 0;
+	iRight = 0;
+	iBottom = 0;
+}
+
+void Texture::DirtyRect::Merge(int iMergeLeft, int iMergeTop, int iMergeRight, int iMergeBottom)
+{
+	if (iMergeRight <= iMergeLeft || iMergeBottom <= iMergeTop)
+		return;
+
+	if (IsEmpty())
+	{
+		iLeft = iMergeLeft;
+		iTop = iMergeTop;
+		iRight = iMergeRight;
+		iBottom = iMergeBottom;
+	}
+	else
+	{
+		iLeft = iMergeLeft < iLeft ? iMergeLeft : iLeft;
+		iTop = iMergeTop < iTop ? iMergeTop : iTop;
+		iRight = iMergeRight > iRight ? iMergeRight : iRight;
+		iBottom = iMergeBottom > iBottom ? iMergeBottom : iBottom;
+	}
+}
+
 /////////////////////////////////////////////////////////////////
 // Texture
 ////////////////////////////////////////////////////////////////
 
+// Textures can be created from several threads
+static std::atomic<uint64_t> s_iNextRevision(1);
+
+static uint64_t NewRevision()
+{
+	return s_iNextRevision++;
+}
+
 Texture::Texture()
 	: m_ePixelFormat(PixelFormatEnum::_NONE)
 	, m_iWidth(0)
 	, m_iHeight(0)
+	, m_iDepth(0)
 	, m_iMipCount(0)
 	, m_iFaceCount(0)
+	, m_iArraySize(0)
 {
 }
 
@@ -178,12 +251,21 @@ ErrorCode Texture::Create(Desc& oDesc)
 	if (!(oDesc.ePixelFormat != PixelFormatEnum::_NONE
 		&& oDesc.iWidth > 0 && oDesc.iWidth <= c_iMaxSize
 		&& oDesc.iHeight > 0 && oDesc.iHeight <= c_iMaxSize
+		&& oDesc.iDepth > 0 && oDesc.iDepth <= c_iMaxSize
+		&& (oDesc.iFaceCount == 1 || oDesc.iFaceCount == _E_FACE_COUNT)
+		&& oDesc.iArraySize > 0 && oDesc.iArraySize <= c_iMaxArraySize
 		&& oDesc.iMipCount > 0 && oDesc.iMipCount <= c_iMaxMip))
 	{
 		//Invalid desc
 		return ErrorCode(1, "Invalid desc");
 	}
 
+	if (oDesc.iDepth > 1 && (oDesc.iFaceCount > 1 || oDesc.iArraySize > 1))
+	{
+		//Volume textures can't be cubemap or array
+		return ErrorCode(1, "Volume texture can't have faces or layers");
+	}
+
 	if (m_iMipCount > 1
 		&& !(oDesc.iWidth && !(oDesc.iWidth & (oDesc.iWidth - 1)))
 		&& !(oDesc.iHeight && !(oDesc.iHeight & (oDesc.iHeight - 1))))
@@ -199,27 +281,42 @@ ErrorCode Texture::Create(Desc& oDesc)
 		return ErrorCode(1, "Can't alloc memory");
 	}
 
+	const size_t iSubresourceCount = (size_t)oDesc.iMipCount * oDesc.iArraySize * oDesc.iFaceCount;
+	if (m_oDirtyRects.resize(iSubresourceCount, false) == false
+		|| m_oRevisions.resize(iSubresourceCount, false) == false)
+	{
+		m_oData.Destroy();
+		return ErrorCode(1, "Can't alloc memory");
+	}
+	ClearDirtyRects();
+	for (size_t iIndex = 0; iIndex < iSubresourceCount; ++iIndex)
+	{
+		m_oRevisions[iIndex] = NewRevision();
+	}
+
 	m_ePixelFormat = oDesc.ePixelFormat;
 	m_iWidth = oDesc.iWidth;
 	m_iHeight = oDesc.iHeight;
+	m_iDepth = oDesc.iDepth;
 	m_iFaceCount = oDesc.iFaceCount;
+	m_iArraySize = oDesc.iArraySize;
 	m_iMipCount = oDesc.iMipCount;
 
+	memset(m_oData.GetData(), 0, m_oData.GetDataSize());
 	if (oDesc.pData[0][0] != NULL)
 	{
 		for (int iMip = 0; iMip < oDesc.iMipCount; ++iMip)
 		{
-			for (int iFace = 0; iFace < _E_FACE_COUNT; ++iFace)
+			for (int iFace = 0; iFace < oDesc.iFaceCount; ++iFace)
 			{
-				const TextureFaceData& oFaceData = m_oData.GetFaceData(iMip, iFace);
-				memcpy(oFaceData.pData, oDesc.pData[iMip][iFace], oFaceData.iSize);
+				if (oDesc.pData[iFace][iMip] != NULL)
+				{
+					const TextureFaceData& oFaceData = m_oData.GetFaceData(iMip, iFace);
+					memcpy(oFaceData.pData, oDesc.pData[iFace][iMip], oFaceData.iSize);
+				}
 			}
 		}
 	}
-	else
-	{
-		memset(m_oData.GetData(), 0, m_oData.GetDataSize());
-	}
 
 	return ErrorCode::Ok;
 }
@@ -229,9 +326,14 @@ ErrorCode Texture::Destroy()
 	if (m_oData.IsValid())
 	{
 		m_oData.Destroy();
+		m_oDirtyRects.clear();
+		m_oRevisions.clear();
 		m_ePixelFormat = PixelFormatEnum::_NONE;
 		m_iWidth = 0;
 		m_iHeight = 0;
+		m_iDepth = 0;
+		m_iFaceCount = 0;
+		m_iArraySize = 0;
 		m_iMipCount = 0;
 		return ErrorCode::Ok;
 	}
@@ -243,19 +345,85 @@ void Texture::Swap(Texture& oOtherTexture)
 {
 	std::swap(m_iWidth, oOtherTexture.m_iWidth);
 	std::swap(m_iHeight, oOtherTexture.m_iHeight);
+	std::swap(m_iDepth, oOtherTexture.m_iDepth);
 	std::swap(m_ePixelFormat, oOtherTexture.m_ePixelFormat);
 	std::swap(m_iFaceCount, oOtherTexture.m_iFaceCount);
+	std::swap(m_iArraySize, oOtherTexture.m_iArraySize);
 	std::swap(m_iMipCount, oOtherTexture.m_iMipCount);
 
 	std::swap(m_oData.m_pData, oOtherTexture.m_oData.m_pData);
 	std::swap(m_oData.m_iSize, oOtherTexture.m_oData.m_iSize);
-	for (int iFace = 0; iFace < _E_FACE_COUNT; ++iFace)
+	std::swap(m_oData.m_iFaceCount, oOtherTexture.m_oData.m_iFaceCount);
+	std::swap(m_oData.m_iArraySize, oOtherTexture.m_oData.m_iArraySize);
+	std::swap(m_oData.m_iMipCount, oOtherTexture.m_oData.m_iMipCount);
+	m_oData.m_oFaceData.swap(oOtherTexture.m_oData.m_oFaceData);
+	m_oDirtyRects.swap(oOtherTexture.m_oDirtyRects);
+	m_oRevisions.swap(oOtherTexture.m_oRevisions);
+}
+
+ErrorCode Texture::ReinterpretPixelFormat(PixelFormatEnum ePixelFormat)
+{
+	const PixelFormatInfos& oCurrentInfos = PixelFormatEnumInfos[m_ePixelFormat];
+	const PixelFormatInfos& oNewInfos = PixelFormatEnumInfos[ePixelFormat];
+	if (IsValid() == false || ePixelFormat == PixelFormatEnum::_NONE
+		|| oNewInfos.iBlockWidth != oCurrentInfos.iBlockWidth
+		|| oNewInfos.iBlockHeight != oCurrentInfos.iBlockHeight
+		|| oNewInfos.iBlockSize != oCurrentInfos.iBlockSize)
 	{
-		for (int iMip = 0; iMip < c_iMaxMip; ++iMip)
-		{
-			std::swap(m_oData.m_oFaceData[iFace][iMip], oOtherTexture.m_oData.m_oFaceData[iFace][iMip]);
-		}
+		return ErrorCode(1, "Pixel formats have different layouts");
 	}
+
+	m_ePixelFormat = ePixelFormat;
+	for (size_t iIndex = 0; iIndex < m_oRevisions.size(); ++iIndex)
+	{
+		m_oRevisions[iIndex] = NewRevision();
+	}
+	return ErrorCode::Ok;
+}
+
+void Texture::MarkDirty(int iMip, int iFace, int iLayer, int iX, int iY, int iWidth, int iHeight)
+{
+	const TextureFaceData& oFaceData = m_oData.GetFaceData(iMip, iFace, iLayer);
+	int iLeft = iX > 0 ? iX : 0;
+	int iTop = iY > 0 ? iY : 0;
+	int iRight = (iX + iWidth) < oFaceData.iWidth ? (iX + iWidth) : oFaceData.iWidth;
+	int iBottom = (iY + iHeight) < oFaceData.iHeight ? (iY + iHeight) : oFaceData.iHeight;
+	m_oDirtyRects[((size_t)iMip * m_iArraySize + iLayer) * m_iFaceCount + iFace].Merge(iLeft, iTop, iRight, iBottom);
+	m_oRevisions[((size_t)iMip * m_iArraySize + iLayer) * m_iFaceCount + iFace] = NewRevision();
+}
+
+const Texture::DirtyRect& Texture::GetDirtyRect(int iMip, int iFace, int iLayer) const
+{
+	CORE_ASSERT(iMip >= 0 && iMip < m_iMipCount);
+	CORE_ASSERT(iFace >= 0 && iFace < m_iFaceCount);
+	CORE_ASSERT(iLayer >= 0 && iLayer < m_iArraySize);
+	return m_oDirtyRects[((size_t)iMip * m_iArraySize + iLayer) * m_iFaceCount + iFace];
+}
+
+bool Texture::HasDirtyRects() const
+{
+	for (size_t iIndex = 0; iIndex < m_oDirtyRects.size(); ++iIndex)
+	{
+		if (m_oDirtyRects[iIndex].IsEmpty() == false)
+			return true;
+	}
+	return false;
+}
+
+void Texture::ClearDirtyRects()
+{
+	for (size_t iIndex = 0; iIndex < m_oDirtyRects.size(); ++iIndex)
+	{
+		m_oDirtyRects[iIndex] = DirtyRect();
+	}
+}
+
+uint64_t Texture::GetRevision(int iMip, int iFace, int iLayer) const
+{
+	CORE_ASSERT(iMip >= 0 && iMip < m_iMipCount);
+	CORE_ASSERT(iFace >= 0 && iFace < m_iFaceCount);
+	CORE_ASSERT(iLayer >= 0 && iLayer < m_iArraySize);
+	return m_oRevisions[((size_t)iMip * m_iArraySize + iLayer) * m_iFaceCount + iFace];
 }
 
 Texture& Texture::operator=(const Texture& /*oTexture*/)
@@ -17,6 +17,7 @@ namespace Graphics
 	public:
 		static const int c_iMaxSize = 32768;
 		static const int c_iMaxMip = 16;
+		static const int c_iMaxArraySize = 2048;
 
 		enum EFace
 		{
@@ -35,10 +36,12 @@ namespace Graphics
 		{
 			TextureFaceData();
 			CORE_PTR_VOID				pData;
-			size_t						iSize;
+			size_t						iSize; // All depth slices
 			size_t						iPitch;
+			size_t						iSlicePitch;
 			int							iWidth;
 			int							iHeight;
+			int							iDepth;
 		};
 
 		struct TextureData
@@ -50,8 +53,10 @@ namespace Graphics
 				Desc();
 				int						iWidth;
 				int						iHeight;
+				int						iDepth; // > 1 for volume textures
 				PixelFormatEnum			ePixelFormat;
 				int						iFaceCount;
+				int						iArraySize;
 				int						iMipCount;
 			};
 			TextureData();
@@ -61,27 +66,46 @@ namespace Graphics
 			void						Destroy();
 			bool						IsValid() const;
 
-			const TextureFaceData&		GetFaceData(int iMip, int iFace) const { return m_oFaceData[iFace][iMip]; }
+			const TextureFaceData&		GetFaceData(int iMip, int iFace, int iLayer = 0) const;
 			CORE_PTR_VOID				GetData() const { return m_pData; }
 			size_t						GetDataSize() const { return m_iSize; }
 		protected:
 			/* Data layout
 			for each mip
-				for each face
-					for each line (y)
-						for each column (x)
+				for each layer
+					for each face
+						for each slice (z)
+							for each line (y)
+								for each column (x)
 			*/
 			CORE_PTR_VOID				m_pData;
 			size_t						m_iSize;
 
-			TextureFaceData				m_oFaceData[_E_FACE_COUNT][c_iMaxMip];
+			int							m_iFaceCount;
+			int							m_iArraySize;
+			int							m_iMipCount;
+			Core::Array<TextureFaceData>	m_oFaceData;
 		};
 
 		struct Desc : TextureData::Desc
 		{
 			Desc();
+			// Initial data of the first layer, all depth slices of a face/mip are contiguous
 			const void*					pData[_E_FACE_COUNT][c_iMaxMip];
 		};
+
+		// Pixels [iLeft, iRight[ x [iTop, iBottom[ of a subresource modified since last ClearDirtyRects
+		struct DirtyRect
+		{
+			DirtyRect();
+			bool						IsEmpty() const { return iRight <= iLeft || iBottom <= iTop; }
+			void						Merge(int iLeft, int iTop, int iRight, int iBottom);
+
+			int							iLeft;
+			int							iTop;
+			int							iRight;
+			int							iBottom;
+		};
 	public:
 		Texture();
 		~Texture();
@@ -93,22 +117,45 @@ namespace Graphics
 
 		int								GetWidth() const { return m_iWidth; }
 		int								GetHeight() const { return m_iHeight; }
+		int								GetDepth() const { return m_iDepth; }
 		PixelFormatEnum					GetPixelFormat() const { return m_ePixelFormat; }
 		int								GetFaceCount() const { return m_iFaceCount; }
+		int								GetArraySize() const { return m_iArraySize; }
 		int								GetMipCount() const { return m_iMipCount; }
 
+		bool							IsVolume() const { return m_iDepth > 1; }
+		bool							IsArray() const { return m_iArraySize > 1; }
+
 		const TextureData&				GetData() const { return m_oData; }
 
+		// Dirty rects are the bounding rect of all regions marked on a subresource, used by GenerateDirtyMips
+		// Marking a region also changes the revision of the subresource
+		void							MarkDirty(int iMip, int iFace, int iLayer, int iX, int iY, int iWidth, int iHeight);
+		const DirtyRect&				GetDirtyRect(int iMip, int iFace, int iLayer = 0) const;
+		bool							HasDirtyRects() const;
+		void							ClearDirtyRects();
+
+		// Unique among all textures, a new revision is given to subresources on Create and MarkDirty, Swap exchanges them with the data
+		// Used as key of caches computed from subresource data
+		uint64_t						GetRevision(int iMip, int iFace, int iLayer = 0) const;
+
 		void							Swap(Texture& oOtherTexture);
+		// Change the pixel format keeping the data, for formats with the same block dimensions and size converted in place by the caller
+		// All subresources get a new revision
+		ErrorCode						ReinterpretPixelFormat(PixelFormatEnum ePixelFormat);
 
 		Texture&						operator=(const Texture& oTexture);
 	protected:
 		int								m_iWidth;
 		int								m_iHeight;
+		int								m_iDepth;
 		PixelFormatEnum					m_ePixelFormat;
 		int								m_iFaceCount;
+		int								m_iArraySize;
 		int								m_iMipCount;
 		TextureData						m_oData;
+		Core::Array<DirtyRect>			m_oDirtyRects;
+		Core::Array<uint64_t>			m_oRevisions;
 	};
 } // namespace Graphics
 
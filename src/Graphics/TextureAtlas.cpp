@@ -0,0 +1,367 @@
+#include "Graphics/TextureAtlas.h"
+
+#include "Core/Array.h"
+
+#include "Math/Math.h"
+
+#include <string.h> // memcpy
+#include <math.h> // sqrt
+#include <algorithm> // sort
+
+namespace Graphics
+{
+	AtlasSettings::AtlasSettings()
+		: ePixelFormat(PixelFormatEnum::RGBA8_UNORM)
+		, iMaxSize(4096)
+		, iPadding(4)
+		, iAlignment(4)
+		, bPowerOfTwo(false)
+		, bMips(true)
+	{
+	}
+
+	struct SkylineNode
+	{
+		int							iX;
+		int							iY;
+		int							iWidth;
+	};
+
+	struct PackOrder
+	{
+		int							iHeight;
+		int							iWidth;
+		int							iIndex;
+
+		// Tallest first, then widest, then input order
+		bool operator<(const PackOrder& oOther) const
+		{
+			if (iHeight != oOther.iHeight)
+				return iHeight > oOther.iHeight;
+			if (iWidth != oOther.iWidth)
+				return iWidth > oOther.iWidth;
+			return iIndex < oOther.iIndex;
+		}
+	};
+
+	// Lowest top of a iWidth rect whose left side is on node iNode, -1 when it doesn't fit
+	static int FitSkyline(const Core::Array<SkylineNode>& oSkyline, int iNode, int iWidth, int iHeight, int iAreaWidth, int iAreaHeight)
+	{
+		int iX = oSkyline[iNode].iX;
+		if (iX + iWidth > iAreaWidth)
+			return -1;
+
+		int iY = 0;
+		int iRemaining = iWidth;
+		for (int iIndex = iNode; iRemaining > 0; ++iIndex)
+		{
+			iY = Math::Max(iY, oSkyline[iIndex].iY);
+			if (iY + iHeight > iAreaHeight)
+				return -1;
+			iRemaining -= oSkyline[iIndex].iWidth;
+		}
+		return iY;
+	}
+
+	bool PackAtlasRects(AtlasRect* pRects, int iCount, int iWidth, int iHeight, int* pOutUsedHeight)
+	{
+		Core::Array<PackOrder> oOrder;
+		if (oOrder.resize(iCount, false) == false)
+			return false;
+		for (int iRect = 0; iRect < iCount; ++iRect)
+		{
+			oOrder[iRect].iHeight = pRects[iRect].iHeight;
+			oOrder[iRect].iWidth = pRects[iRect].iWidth;
+			oOrder[iRect].iIndex = iRect;
+		}
+		std::sort(oOrder.begin(), oOrder.end());
+
+		// Top of the placed rects from left to right, nodes cover the whole width
+		Core::Array<SkylineNode> oSkyline;
+		SkylineNode oFirstNode = { 0, 0, iWidth };
+		if (oSkyline.push_back(oFirstNode) == false)
+			return false;
+
+		int iUsedHeight = 0;
+		for (int iOrder = 0; iOrder < iCount; ++iOrder)
+		{
+			AtlasRect& oRect = pRects[oOrder[iOrder].iIndex];
+			if (oRect.iWidth <= 0 || oRect.iHeight <= 0)
+			{
+				oRect.iX = 0;
+				oRect.iY = 0;
+				continue;
+			}
+
+			// Bottom-left: lowest top, then narrowest node to keep wide gaps for wide rects
+			int iBestNode = -1;
+			int iBestY = 0;
+			int iBestNodeWidth = 0;
+			for (int iNode = 0; iNode < (int)oSkyline.size(); ++iNode)
+			{
+				int iY = FitSkyline(oSkyline, iNode, oRect.iWidth, oRect.iHeight, iWidth, iHeight);
+				if (iY < 0)
+					continue;
+				if (iBestNode < 0 || iY < iBestY || (iY == iBestY && oSkyline[iNode].iWidth < iBestNodeWidth))
+				{
+					iBestNode = iNode;
+					iBestY = iY;
+					iBestNodeWidth = oSkyline[iNode].iWidth;
+				}
+			}
+
+			if (iBestNode < 0)
+				return false;
+
+			oRect.iX = oSkyline[iBestNode].iX;
+			oRect.iY = iBestY;
+			iUsedHeight = Math::Max(iUsedHeight, iBestY + oRect.iHeight);
+
+			// Replace the covered nodes by the rect top, the last covered node keeps its uncovered part
+			int iRight = oRect.iX + oRect.iWidth;
+			int iLast = iBestNode;
+			while (oSkyline[iLast].iX + oSkyline[iLast].iWidth <= iRight && iLast + 1 < (int)oSkyline.size() && oSkyline[iLast + 1].iX < iRight)
+				++iLast;
+
+			SkylineNode oNewNode = { oRect.iX, iBestY + oRect.iHeight, oRect.iWidth };
+			SkylineNode& oLastNode = oSkyline[iLast];
+			int iLastRight = oLastNode.iX + oLastNode.iWidth;
+			if (iLastRight > iRight)
+			{
+				oLastNode.iWidth = iLastRight - iRight;
+				oLastNode.iX = iRight;
+				--iLast;
+			}
+
+			// Nodes iBestNode to iLast are removed, the new node takes the place of the first one
+			int iRemoved = iLast - iBestNode + 1;
+			if (iRemoved == 0)
+			{
+				if (oSkyline.push_back(oNewNode) == false)
+					return false;
+				for (int iNode = (int)oSkyline.size() - 1; iNode > iBestNode; --iNode)
+					oSkyline[iNode] = oSkyline[iNode - 1];
+			}
+			else if (iRemoved > 1)
+			{
+				int iCountNodes = (int)oSkyline.size();
+				for (int iNode = iBestNode + 1; iNode + iRemoved - 1 < iCountNodes; ++iNode)
+					oSkyline[iNode] = oSkyline[iNode + iRemoved - 1];
+				oSkyline.resize(iCountNodes - iRemoved + 1, false);
+			}
+			oSkyline[iBestNode] = oNewNode;
+
+			// Merge with neighbours of the same height
+			if (iBestNode + 1 < (int)oSkyline.size() && oSkyline[iBestNode + 1].iY == oNewNode.iY)
+			{
+				oSkyline[iBestNode].iWidth += oSkyline[iBestNode + 1].iWidth;
+				for (int iNode = iBestNode + 1; iNode + 1 < (int)oSkyline.size(); ++iNode)
+					oSkyline[iNode] = oSkyline[iNode + 1];
+				oSkyline.pop_back();
+			}
+			if (iBestNode > 0 && oSkyline[iBestNode - 1].iY == oNewNode.iY)
+			{
+				oSkyline[iBestNode - 1].iWidth += oSkyline[iBestNode].iWidth;
+				for (int iNode = iBestNode; iNode + 1 < (int)oSkyline.size(); ++iNode)
+					oSkyline[iNode] = oSkyline[iNode + 1];
+				oSkyline.pop_back();
+			}
+		}
+
+		if (pOutUsedHeight != NULL)
+			*pOutUsedHeight = iUsedHeight;
+		return true;
+	}
+
+	static int AlignUp(int iValue, int iAlignment)
+	{
+		return (iValue + iAlignment - 1) / iAlignment * iAlignment;
+	}
+
+	static int NextPowerOfTwo(int iValue)
+	{
+		int iPower = 1;
+		while (iPower < iValue)
+			iPower <<= 1;
+		return iPower;
+	}
+
+	// Replicate the edges of the iWidth x iHeight pixels at (iX, iY) over iPadding pixels around them
+	static void FillGutter(const Texture::TextureFaceData& oFaceData, size_t iPixelSize, int iX, int iY, int iWidth, int iHeight, int iPadding)
+	{
+		char* pData = (char*)oFaceData.pData;
+		int iLeft = Math::Max(iX - iPadding, 0);
+		int iRight = Math::Min(iX + iWidth + iPadding, oFaceData.iWidth);
+		for (int iLine = iY; iLine < iY + iHeight; ++iLine)
+		{
+			char* pLine = pData + (size_t)iLine * oFaceData.iPitch;
+			for (int iColumn = iLeft; iColumn < iX; ++iColumn)
+				memcpy(pLine + iColumn * iPixelSize, pLine + iX * iPixelSize, iPixelSize);
+			for (int iColumn = iX + iWidth; iColumn < iRight; ++iColumn)
+				memcpy(pLine + iColumn * iPixelSize, pLine + (iX + iWidth - 1) * iPixelSize, iPixelSize);
+		}
+
+		size_t iRowSize = (iRight - iLeft) * iPixelSize;
+		const char* pTopLine = pData + (size_t)iY * oFaceData.iPitch + iLeft * iPixelSize;
+		for (int iLine = Math::Max(iY - iPadding, 0); iLine < iY; ++iLine)
+			memcpy(pData + (size_t)iLine * oFaceData.iPitch + iLeft * iPixelSize, pTopLine, iRowSize);
+		const char* pBottomLine = pData + (size_t)(iY + iHeight - 1) * oFaceData.iPitch + iLeft * iPixelSize;
+		for (int iLine = iY + iHeight; iLine < Math::Min(iY + iHeight + iPadding, oFaceData.iHeight); ++iLine)
+			memcpy(pData + (size_t)iLine * oFaceData.iPitch + iLeft * iPixelSize, pBottomLine, iRowSize);
+	}
+
+	ErrorCode BuildTextureAtlas(const Texture* const* pTextures, int iCount, Texture* pOutAtlas, AtlasEntry* pOutEntries, const AtlasSettings* pSettings)
+	{
+		if (pTextures == NULL || iCount <= 0 || pOutAtlas == NULL || pOutEntries == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		AtlasSettings oDefaultSettings;
+		const AtlasSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[oSettings.ePixelFormat];
+		if (oFormatInfos.iBlockWidth != 1 || oFormatInfos.iBlockHeight != 1)
+		{
+			return ErrorCode(1, "Atlas pixel format '%s' must be uncompressed", oFormatInfos.pName);
+		}
+
+		if (oSettings.iMaxSize <= 0 || oSettings.iMaxSize > Texture::c_iMaxSize || oSettings.iPadding < 0 || oSettings.iAlignment <= 0)
+		{
+			return ErrorCode(1, "Invalid atlas settings");
+		}
+
+		// Padding is rounded up to the alignment so textures start on aligned pixels too
+		const int iAlignment = oSettings.iAlignment;
+		const int iPadding = AlignUp(oSettings.iPadding, iAlignment);
+
+		Core::Array<AtlasRect> oRects;
+		if (oRects.resize(iCount, false) == false)
+		{
+			return ErrorCode(1, "Out of memory");
+		}
+
+		double fArea = 0.0;
+		int iMaxRectWidth = 1;
+		int iMaxRectHeight = 1;
+		for (int iTexture = 0; iTexture < iCount; ++iTexture)
+		{
+			const Texture* pTexture = pTextures[iTexture];
+			if (pTexture == NULL || pTexture->IsValid() == false)
+			{
+				return ErrorCode(1, "Invalid texture %d", iTexture);
+			}
+
+			PixelFormat::ConvertionFuncChain oChain;
+			int iChainLength;
+			int iAdditionalBits;
+			if (pTexture->GetPixelFormat() != oSettings.ePixelFormat
+				&& PixelFormat::GetConvertionChain(pTexture->GetPixelFormat(), oSettings.ePixelFormat, &oChain, &iChainLength, &iAdditionalBits) == false)
+			{
+				return ErrorCode(1, "Texture %d : convertion from '%s' to '%s' not implemented", iTexture, PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName, oFormatInfos.pName);
+			}
+
+			AtlasRect& oRect = oRects[iTexture];
+			oRect.iWidth = AlignUp(pTexture->GetWidth() + 2 * iPadding, iAlignment);
+			oRect.iHeight = AlignUp(pTexture->GetHeight() + 2 * iPadding, iAlignment);
+			fArea += (double)oRect.iWidth * oRect.iHeight;
+			iMaxRectWidth = Math::Max(iMaxRectWidth, oRect.iWidth);
+			iMaxRectHeight = Math::Max(iMaxRectHeight, oRect.iHeight);
+		}
+
+		if (iMaxRectWidth > oSettings.iMaxSize || iMaxRectHeight > oSettings.iMaxSize)
+		{
+			return ErrorCode(1, "A texture with its padding is larger than %d", oSettings.iMaxSize);
+		}
+
+		// Smallest power of two area holding the rects, grown on its smallest side until they are packed
+		int iWidth = Math::Min(NextPowerOfTwo(Math::Max((int)sqrt(fArea), iMaxRectWidth)), oSettings.iMaxSize);
+		int iHeight = Math::Min(NextPowerOfTwo(Math::Max((int)(fArea / iWidth), iMaxRectHeight)), oSettings.iMaxSize);
+		int iUsedHeight = 0;
+		while (PackAtlasRects(oRects.begin(), iCount, iWidth, iHeight, &iUsedHeight) == false)
+		{
+			if (iWidth >= oSettings.iMaxSize && iHeight >= oSettings.iMaxSize)
+			{
+				return ErrorCode(1, "Textures don't fit in a %dx%d atlas", oSettings.iMaxSize, oSettings.iMaxSize);
+			}
+
+			if ((iHeight < iWidth || iWidth >= oSettings.iMaxSize) && iHeight < oSettings.iMaxSize)
+				iHeight = Math::Min(iHeight * 2, oSettings.iMaxSize);
+			else
+				iWidth = Math::Min(iWidth * 2, oSettings.iMaxSize);
+		}
+
+		if (oSettings.bPowerOfTwo == false)
+		{
+			int iUsedWidth = 0;
+			for (int iTexture = 0; iTexture < iCount; ++iTexture)
+				iUsedWidth = Math::Max(iUsedWidth, oRects[iTexture].iX + oRects[iTexture].iWidth);
+			iWidth = iUsedWidth;
+			iHeight = iUsedHeight;
+		}
+
+		Texture oAtlas;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = oSettings.ePixelFormat;
+		oDesc.iWidth = iWidth;
+		oDesc.iHeight = iHeight;
+		ErrorCode oErr = oAtlas.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const Texture::TextureFaceData& oAtlasData = oAtlas.GetData().GetFaceData(0, 0);
+		const size_t iPixelSize = oFormatInfos.iBlockSize;
+
+		// Rects don't overlap, each job writes its own pixels and gutter
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iTexture = 0; iTexture < iCount; ++iTexture)
+		{
+			const Texture* pTexture = pTextures[iTexture];
+			const Texture::TextureFaceData& oSourceData = pTexture->GetData().GetFaceData(0, 0);
+			const AtlasRect& oRect = oRects[iTexture];
+			const int iX = oRect.iX + iPadding;
+			const int iY = oRect.iY + iPadding;
+			const int iTextureWidth = pTexture->GetWidth();
+			const int iTextureHeight = pTexture->GetHeight();
+
+			char* pDest = (char*)oAtlasData.pData + (size_t)iY * oAtlasData.iPitch + iX * iPixelSize;
+			if (pTexture->GetPixelFormat() == oSettings.ePixelFormat)
+			{
+				const size_t iRowSize = iTextureWidth * iPixelSize;
+				for (int iLine = 0; iLine < iTextureHeight; ++iLine)
+					memcpy(pDest + (size_t)iLine * oAtlasData.iPitch, (const char*)oSourceData.pData + (size_t)iLine * oSourceData.iPitch, iRowSize);
+			}
+			else
+			{
+				PixelFormat::ConvertionFuncChain oChain;
+				int iChainLength;
+				int iAdditionalBits;
+				PixelFormat::GetConvertionChain(pTexture->GetPixelFormat(), oSettings.ePixelFormat, &oChain, &iChainLength, &iAdditionalBits);
+				ConvertPixelFormatRegion(oSourceData.pData, oSourceData.iPitch, pTexture->GetPixelFormat(), pDest, oAtlasData.iPitch, oSettings.ePixelFormat, iTextureWidth, iTextureHeight, oChain, iChainLength);
+			}
+
+			FillGutter(oAtlasData, iPixelSize, iX, iY, iTextureWidth, iTextureHeight, iPadding);
+
+			AtlasEntry& oEntry = pOutEntries[iTexture];
+			oEntry.iX = iX;
+			oEntry.iY = iY;
+			oEntry.iWidth = iTextureWidth;
+			oEntry.iHeight = iTextureHeight;
+			oEntry.fU0 = (float)iX / iWidth;
+			oEntry.fV0 = (float)iY / iHeight;
+			oEntry.fU1 = (float)(iX + iTextureWidth) / iWidth;
+			oEntry.fV1 = (float)(iY + iTextureHeight) / iHeight;
+		}
+
+		if (oSettings.bMips)
+		{
+			return GenerateMips(&oAtlas, pOutAtlas, false, &oSettings.oMipSettings);
+		}
+
+		pOutAtlas->Swap(oAtlas);
+		return ErrorCode::Ok;
+	}
+}
+//namespace Graphics
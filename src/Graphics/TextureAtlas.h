@@ -0,0 +1,57 @@
+#ifndef __GRAPHICS_TEXTURE_ATLAS_H__
+#define __GRAPHICS_TEXTURE_ATLAS_H__
+
+#include "Core/ErrorCode.h"
+
+#include "Graphics/Texture.h"
+#include "Graphics/TextureUtils.h"
+
+namespace Graphics
+{
+	/* Atlas of many 2D textures
+	Rects are packed with a skyline bottom-left packer, tallest first. Each texture is surrounded by iPadding pixels
+	replicating its edges so filtering and the first mips don't bleed between neighbours, iPadding of 2^N protects N mips.
+	Rect sizes and positions are multiples of iAlignment, keeping rects on BC blocks and on texels of the first mips.
+	Textures are converted to ePixelFormat and blitted by row copies, then the mip chain is generated on the whole atlas.
+	*/
+	struct AtlasSettings
+	{
+		AtlasSettings();
+		PixelFormatEnum				ePixelFormat; // Uncompressed, compress the atlas afterwards for BC formats
+		int							iMaxSize; // Largest width and height
+		int							iPadding;
+		int							iAlignment;
+		bool						bPowerOfTwo; // Otherwise the height is cropped to the packed rects
+		bool						bMips;
+		MipSettings					oMipSettings;
+	};
+
+	struct AtlasRect
+	{
+		int							iWidth;
+		int							iHeight;
+		int							iX; // Output
+		int							iY; // Output
+	};
+
+	// Place rects in a iWidth x iHeight area, false when they don't all fit
+	bool							PackAtlasRects(AtlasRect* pRects, int iCount, int iWidth, int iHeight, int* pOutUsedHeight = NULL);
+
+	struct AtlasEntry
+	{
+		int							iX; // Texture pixels, without padding
+		int							iY;
+		int							iWidth;
+		int							iHeight;
+		float						fU0;
+		float						fV0;
+		float						fU1;
+		float						fV1;
+	};
+
+	// Mip 0 of the first face/layer of each texture, pOutEntries receives iCount entries in texture order
+	ErrorCode						BuildTextureAtlas(const Texture* const* pTextures, int iCount, Texture* pOutAtlas, AtlasEntry* pOutEntries, const AtlasSettings* pSettings = NULL);
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_TEXTURE_ATLAS_H__
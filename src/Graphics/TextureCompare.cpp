@@ -0,0 +1,489 @@
+#include "Graphics/TextureCompare.h"
+
+#include "Graphics/TextureUtils.h"
+
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
+#include <emmintrin.h> //SIMD
+#include <math.h> // sqrt/log10/HUGE_VAL
+#include <string.h> // memset
+
+namespace Graphics
+{
+	TextureComparison::TextureComparison()
+	{
+		iChannelCount = 0;
+		memset(oTotal, 0, sizeof(oTotal));
+	}
+
+	CompareSettings::CompareSettings()
+	{
+		bSSIM = true;
+	}
+
+	// Lines of a slice compared by each job, multiple of all block heights and of SSIM blocks
+	static const int c_iCompareBandHeight = 64;
+	// SSIM windows are 2x2 blocks of 4x4 pixels
+	static const int c_iSSIMBlockSize = 4;
+	static const int c_iSSIMBlockFloats = 5 * 4; // Sums of x, y, x^2, y^2 and xy for 4 channels
+	static const float c_fSSIMC1 = 0.01f * 0.01f;
+	static const float c_fSSIMC2 = 0.03f * 0.03f;
+
+	struct CompareDecoder
+	{
+		PixelFormatEnum				ePixelFormat;
+		PixelFormat::ConvertionFuncChain	oChain;
+		int							iChainLength; // 0 for RGBA32 float read in place
+	};
+
+	struct CompareJob
+	{
+		int							iSubresource;
+		int							iSlice;
+		int							iStartY;
+		int							iEndY;
+	};
+
+	struct ComparePartial
+	{
+		double						fSquaredError[4];
+		float						fMaxError[4];
+		double						fSSIM[4];
+		uint64_t					iWindowCount;
+		double						fImageSums[5][4]; // Sums of x, y, x^2, y^2 and xy for images smaller than a window
+	};
+
+	static bool GetCompareDecoder(PixelFormatEnum ePixelFormat, CompareDecoder* pOutDecoder)
+	{
+		pOutDecoder->ePixelFormat = ePixelFormat;
+		pOutDecoder->iChainLength = 0;
+		if (ePixelFormat == PixelFormatEnum::RGBA32_FLOAT)
+			return true;
+		int iAdditionalBits;
+		return PixelFormat::GetConvertionChain(ePixelFormat, PixelFormatEnum::RGBA32_FLOAT, &pOutDecoder->oChain, &pOutDecoder->iChainLength, &iAdditionalBits);
+	}
+
+	// Lines [iStartY, iEndY[ of a slice as RGBA float, decoded in ppWorking when the source is not read in place
+	static const char* GetBandLines(const CompareDecoder& oDecoder, const Texture::TextureFaceData& oFaceData, int iSlice, int iStartY, int iEndY, CORE_PTR_VOID* ppWorking, size_t* pOutPitch)
+	{
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[oDecoder.ePixelFormat];
+		const char* pSlice = (const char*)oFaceData.pData + (size_t)iSlice * oFaceData.iSlicePitch;
+		if (oDecoder.iChainLength == 0)
+		{
+			*pOutPitch = oFaceData.iPitch;
+			return pSlice + (size_t)iStartY * oFaceData.iPitch;
+		}
+
+		const size_t iLinePitch = (size_t)oFaceData.iWidth * 4 * sizeof(float);
+		// Decoded lines are padded to whole blocks
+		const int iBlockRowCount = (iEndY - iStartY + oFormatInfos.iBlockHeight - 1) / oFormatInfos.iBlockHeight;
+		*ppWorking = Core::Malloc(iLinePitch * iBlockRowCount * oFormatInfos.iBlockHeight);
+		if (*ppWorking == NULL)
+			return NULL;
+
+		ConvertPixelFormatRegion(
+			pSlice + (size_t)(iStartY / oFormatInfos.iBlockHeight) * oFaceData.iPitch, oFaceData.iPitch, oDecoder.ePixelFormat,
+			*ppWorking, iLinePitch, PixelFormatEnum::RGBA32_FLOAT,
+			oFaceData.iWidth, iEndY - iStartY,
+			oDecoder.oChain, oDecoder.iChainLength);
+		*pOutPitch = iLinePitch;
+		return (const char*)*ppWorking;
+	}
+
+	// Squared and max errors of a line, pHeatmap receives the largest error of the channels enabled in xChannelMask
+	static void CompareLine(const float* pReference, const float* pPixels, int iWidth, __m128 xChannelMask, float* pHeatmap, ComparePartial* pPartial)
+	{
+		const __m128 xAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 xMaxError = _mm_loadu_ps(pPartial->fMaxError);
+		__m128d xSquaredError0 = _mm_setzero_pd();
+		__m128d xSquaredError1 = _mm_setzero_pd();
+		for (int iX = 0; iX < iWidth; ++iX)
+		{
+			const __m128 xDiff = _mm_sub_ps(_mm_loadu_ps(pPixels + iX * 4), _mm_loadu_ps(pReference + iX * 4));
+			const __m128 xError = _mm_and_ps(xDiff, xAbsMask);
+			xMaxError = _mm_max_ps(xMaxError, xError);
+			const __m128d xDiff0 = _mm_cvtps_pd(xDiff);
+			const __m128d xDiff1 = _mm_cvtps_pd(_mm_movehl_ps(xDiff, xDiff));
+			xSquaredError0 = _mm_add_pd(xSquaredError0, _mm_mul_pd(xDiff0, xDiff0));
+			xSquaredError1 = _mm_add_pd(xSquaredError1, _mm_mul_pd(xDiff1, xDiff1));
+
+			if (pHeatmap != NULL)
+			{
+				__m128 xPixelMax = _mm_and_ps(xError, xChannelMask);
+				xPixelMax = _mm_max_ps(xPixelMax, _mm_shuffle_ps(xPixelMax, xPixelMax, _MM_SHUFFLE(1, 0, 3, 2)));
+				xPixelMax = _mm_max_ps(xPixelMax, _mm_shuffle_ps(xPixelMax, xPixelMax, _MM_SHUFFLE(2, 3, 0, 1)));
+				_mm_store_ss(pHeatmap + iX, xPixelMax);
+			}
+		}
+		_mm_storeu_ps(pPartial->fMaxError, xMaxError);
+		_mm_storeu_pd(pPartial->fSquaredError, _mm_add_pd(xSquaredError0, _mm_loadu_pd(pPartial->fSquaredError)));
+		_mm_storeu_pd(pPartial->fSquaredError + 2, _mm_add_pd(xSquaredError1, _mm_loadu_pd(pPartial->fSquaredError + 2)));
+	}
+
+	// Add a line of pixels to the sums of a line of 4x4 blocks
+	static void AccumulateSSIMBlocks(const float* pReference, const float* pPixels, int iBlockCount, float* pBlocks)
+	{
+		for (int iBlock = 0; iBlock < iBlockCount; ++iBlock)
+		{
+			float* pSums = pBlocks + (size_t)iBlock * c_iSSIMBlockFloats;
+			__m128 xSumX = _mm_loadu_ps(pSums);
+			__m128 xSumY = _mm_loadu_ps(pSums + 4);
+			__m128 xSumXX = _mm_loadu_ps(pSums + 8);
+			__m128 xSumYY = _mm_loadu_ps(pSums + 12);
+			__m128 xSumXY = _mm_loadu_ps(pSums + 16);
+			for (int iX = 0; iX < c_iSSIMBlockSize; ++iX)
+			{
+				const __m128 xX = _mm_loadu_ps(pReference + (iBlock * c_iSSIMBlockSize + iX) * 4);
+				const __m128 xY = _mm_loadu_ps(pPixels + (iBlock * c_iSSIMBlockSize + iX) * 4);
+				xSumX = _mm_add_ps(xSumX, xX);
+				xSumY = _mm_add_ps(xSumY, xY);
+				xSumXX = _mm_add_ps(xSumXX, _mm_mul_ps(xX, xX));
+				xSumYY = _mm_add_ps(xSumYY, _mm_mul_ps(xY, xY));
+				xSumXY = _mm_add_ps(xSumXY, _mm_mul_ps(xX, xY));
+			}
+			_mm_storeu_ps(pSums, xSumX);
+			_mm_storeu_ps(pSums + 4, xSumY);
+			_mm_storeu_ps(pSums + 8, xSumXX);
+			_mm_storeu_ps(pSums + 12, xSumYY);
+			_mm_storeu_ps(pSums + 16, xSumXY);
+		}
+	}
+
+	// SSIM of the 4 channels from sums of x, y, x^2, y^2 and xy over iCount pixels
+	static __m128 ComputeSSIM(__m128 xSumX, __m128 xSumY, __m128 xSumXX, __m128 xSumYY, __m128 xSumXY, float fInvCount)
+	{
+		const __m128 xInvCount = _mm_set1_ps(fInvCount);
+		const __m128 xTwo = _mm_set1_ps(2.f);
+		const __m128 xC1 = _mm_set1_ps(c_fSSIMC1);
+		const __m128 xC2 = _mm_set1_ps(c_fSSIMC2);
+		const __m128 xMeanX = _mm_mul_ps(xSumX, xInvCount);
+		const __m128 xMeanY = _mm_mul_ps(xSumY, xInvCount);
+		const __m128 xMeanXY = _mm_mul_ps(xMeanX, xMeanY);
+		const __m128 xMeanXX = _mm_mul_ps(xMeanX, xMeanX);
+		const __m128 xMeanYY = _mm_mul_ps(xMeanY, xMeanY);
+		const __m128 xVarianceX = _mm_sub_ps(_mm_mul_ps(xSumXX, xInvCount), xMeanXX);
+		const __m128 xVarianceY = _mm_sub_ps(_mm_mul_ps(xSumYY, xInvCount), xMeanYY);
+		const __m128 xCovariance = _mm_sub_ps(_mm_mul_ps(xSumXY, xInvCount), xMeanXY);
+		const __m128 xNumerator = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(xTwo, xMeanXY), xC1), _mm_add_ps(_mm_mul_ps(xTwo, xCovariance), xC2));
+		const __m128 xDenominator = _mm_mul_ps(_mm_add_ps(_mm_add_ps(xMeanXX, xMeanYY), xC1), _mm_add_ps(_mm_add_ps(xVarianceX, xVarianceY), xC2));
+		return _mm_div_ps(xNumerator, xDenominator);
+	}
+
+	// Windows whose top block row is in the band, block rows are summed first and each window adds 2x2 blocks
+	static void AccumulateSSIMWindows(const float* pBlocks, int iBlockCount, int iWindowRowCount, ComparePartial* pPartial)
+	{
+		__m128d xSSIM0 = _mm_setzero_pd();
+		__m128d xSSIM1 = _mm_setzero_pd();
+		const float fInvCount = 1.f / (4 * c_iSSIMBlockSize * c_iSSIMBlockSize);
+		for (int iRow = 0; iRow < iWindowRowCount; ++iRow)
+		{
+			const float* pTopBlocks = pBlocks + (size_t)iRow * iBlockCount * c_iSSIMBlockFloats;
+			const float* pBottomBlocks = pTopBlocks + (size_t)iBlockCount * c_iSSIMBlockFloats;
+			for (int iBlock = 0; iBlock + 1 < iBlockCount; ++iBlock)
+			{
+				__m128 xSums[5];
+				for (int iSum = 0; iSum < 5; ++iSum)
+				{
+					const size_t iOffset = (size_t)iBlock * c_iSSIMBlockFloats + iSum * 4;
+					xSums[iSum] = _mm_add_ps(
+						_mm_add_ps(_mm_loadu_ps(pTopBlocks + iOffset), _mm_loadu_ps(pTopBlocks + iOffset + c_iSSIMBlockFloats)),
+						_mm_add_ps(_mm_loadu_ps(pBottomBlocks + iOffset), _mm_loadu_ps(pBottomBlocks + iOffset + c_iSSIMBlockFloats)));
+				}
+				const __m128 xSSIM = ComputeSSIM(xSums[0], xSums[1], xSums[2], xSums[3], xSums[4], fInvCount);
+				xSSIM0 = _mm_add_pd(xSSIM0, _mm_cvtps_pd(xSSIM));
+				xSSIM1 = _mm_add_pd(xSSIM1, _mm_cvtps_pd(_mm_movehl_ps(xSSIM, xSSIM)));
+			}
+		}
+		_mm_storeu_pd(pPartial->fSSIM, _mm_add_pd(xSSIM0, _mm_loadu_pd(pPartial->fSSIM)));
+		_mm_storeu_pd(pPartial->fSSIM + 2, _mm_add_pd(xSSIM1, _mm_loadu_pd(pPartial->fSSIM + 2)));
+		pPartial->iWindowCount += (uint64_t)iWindowRowCount * (iBlockCount - 1);
+	}
+
+	static void AccumulateImageSums(const float* pReference, const float* pPixels, int iWidth, ComparePartial* pPartial)
+	{
+		for (int iX = 0; iX < iWidth; ++iX)
+		{
+			for (int iChannel = 0; iChannel < 4; ++iChannel)
+			{
+				const double fX = pReference[iX * 4 + iChannel];
+				const double fY = pPixels[iX * 4 + iChannel];
+				pPartial->fImageSums[0][iChannel] += fX;
+				pPartial->fImageSums[1][iChannel] += fY;
+				pPartial->fImageSums[2][iChannel] += fX * fX;
+				pPartial->fImageSums[3][iChannel] += fY * fY;
+				pPartial->fImageSums[4][iChannel] += fX * fY;
+			}
+		}
+	}
+
+	static bool IsSSIMWindowed(int iWidth, int iHeight)
+	{
+		return iWidth >= 2 * c_iSSIMBlockSize && iHeight >= 2 * c_iSSIMBlockSize;
+	}
+
+	static double GetPSNR(double fMSE)
+	{
+		return (fMSE > 0.0) ? -10.0 * log10(fMSE) : HUGE_VAL;
+	}
+
+	ErrorCode CompareTextures(const Texture* pReference, const Texture* pTexture, TextureComparison* pOutComparison, const CompareSettings* pSettings, Texture* pOutHeatmap)
+	{
+		if (pReference == NULL || pTexture == NULL || pOutComparison == NULL
+			|| pReference->IsValid() == false || pTexture->IsValid() == false)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (pReference->GetWidth() != pTexture->GetWidth()
+			|| pReference->GetHeight() != pTexture->GetHeight()
+			|| pReference->GetDepth() != pTexture->GetDepth()
+			|| pReference->GetFaceCount() != pTexture->GetFaceCount()
+			|| pReference->GetArraySize() != pTexture->GetArraySize())
+		{
+			return ErrorCode(1, "Textures don't have the same dimensions");
+		}
+
+		CompareSettings oDefaultSettings;
+		const CompareSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+
+		CompareDecoder oReferenceDecoder, oDecoder;
+		if (GetCompareDecoder(pReference->GetPixelFormat(), &oReferenceDecoder) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be decoded", PixelFormatEnumInfos[pReference->GetPixelFormat()].pName);
+		}
+		if (GetCompareDecoder(pTexture->GetPixelFormat(), &oDecoder) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be decoded", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+		}
+
+		const int iMipCount = Math::Min(pReference->GetMipCount(), pTexture->GetMipCount());
+		const int iFaceCount = pReference->GetFaceCount();
+		const int iArraySize = pReference->GetArraySize();
+		const int iSubresourceCount = iMipCount * iArraySize * iFaceCount;
+		const int iChannelCount = Math::Min(Math::Max(PixelFormatEnumInfos[pReference->GetPixelFormat()].iComponents, PixelFormatEnumInfos[pTexture->GetPixelFormat()].iComponents), 4);
+
+		Texture oHeatmap;
+		if (pOutHeatmap != NULL)
+		{
+			Texture::Desc oDesc;
+			oDesc.ePixelFormat = PixelFormatEnum::R32_FLOAT;
+			oDesc.iWidth = pReference->GetWidth();
+			oDesc.iHeight = pReference->GetHeight();
+			oDesc.iDepth = pReference->GetDepth();
+			oDesc.iMipCount = iMipCount;
+			oDesc.iFaceCount = iFaceCount;
+			oDesc.iArraySize = iArraySize;
+			ErrorCode oErr = oHeatmap.Create(oDesc);
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+		}
+
+		// Jobs of each subresource (mips, layers, faces) are consecutive
+		Core::Array<CompareJob> oJobs;
+		Core::Array<ComparePartial> oPartials;
+		size_t iJobCount = 0;
+		for (int iSubresource = 0; iSubresource < iSubresourceCount; ++iSubresource)
+		{
+			const Texture::TextureFaceData& oFaceData = pReference->GetData().GetFaceData(iSubresource / (iArraySize * iFaceCount), iSubresource % iFaceCount, (iSubresource / iFaceCount) % iArraySize);
+			iJobCount += (size_t)oFaceData.iDepth * ((oFaceData.iHeight + c_iCompareBandHeight - 1) / c_iCompareBandHeight);
+		}
+		if (oJobs.resize(iJobCount, false) == false || oPartials.resize(iJobCount, false) == false
+			|| pOutComparison->oSubresources.resize(iSubresourceCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+		size_t iJobIndex = 0;
+		for (int iSubresource = 0; iSubresource < iSubresourceCount; ++iSubresource)
+		{
+			const Texture::TextureFaceData& oFaceData = pReference->GetData().GetFaceData(iSubresource / (iArraySize * iFaceCount), iSubresource % iFaceCount, (iSubresource / iFaceCount) % iArraySize);
+			for (int iSlice = 0; iSlice < oFaceData.iDepth; ++iSlice)
+			{
+				for (int iStartY = 0; iStartY < oFaceData.iHeight; iStartY += c_iCompareBandHeight)
+				{
+					CompareJob& oJob = oJobs[iJobIndex++];
+					oJob.iSubresource = iSubresource;
+					oJob.iSlice = iSlice;
+					oJob.iStartY = iStartY;
+					oJob.iEndY = Math::Min(iStartY + c_iCompareBandHeight, oFaceData.iHeight);
+				}
+			}
+		}
+
+		const __m128 xChannelMask = _mm_castsi128_ps(_mm_set_epi32(iChannelCount > 3 ? -1 : 0, iChannelCount > 2 ? -1 : 0, iChannelCount > 1 ? -1 : 0, -1));
+
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < (int)iJobCount; ++iJob)
+		{
+			const CompareJob& oJob = oJobs[iJob];
+			ComparePartial& oPartial = oPartials[iJob];
+			memset(&oPartial, 0, sizeof(oPartial));
+
+			const int iMip = oJob.iSubresource / (iArraySize * iFaceCount);
+			const int iFace = oJob.iSubresource % iFaceCount;
+			const int iLayer = (oJob.iSubresource / iFaceCount) % iArraySize;
+			const Texture::TextureFaceData& oReferenceData = pReference->GetData().GetFaceData(iMip, iFace, iLayer);
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+			const int iWidth = oReferenceData.iWidth;
+			const int iHeight = oReferenceData.iHeight;
+
+			// SSIM windows starting in the band also read the next block row
+			const bool bWindowed = oSettings.bSSIM && IsSSIMWindowed(iWidth, iHeight);
+			const int iBlockCount = iWidth / c_iSSIMBlockSize;
+			const int iFirstBlockRow = oJob.iStartY / c_iSSIMBlockSize;
+			const int iWindowRowCount = bWindowed ? Math::Max(Math::Min(oJob.iEndY / c_iSSIMBlockSize, iHeight / c_iSSIMBlockSize - 1) - iFirstBlockRow, 0) : 0;
+			const int iDecodeEndY = Math::Max(oJob.iEndY, (iWindowRowCount > 0) ? (iFirstBlockRow + iWindowRowCount + 1) * c_iSSIMBlockSize : 0);
+
+			CORE_PTR_VOID pReferenceWorking = CORE_PTR_NULL;
+			CORE_PTR_VOID pWorking = CORE_PTR_NULL;
+			CORE_PTR_VOID pBlocks = CORE_PTR_NULL;
+			size_t iReferencePitch, iPitch;
+			const char* pReferenceLines = GetBandLines(oReferenceDecoder, oReferenceData, oJob.iSlice, oJob.iStartY, iDecodeEndY, &pReferenceWorking, &iReferencePitch);
+			const char* pLines = GetBandLines(oDecoder, oFaceData, oJob.iSlice, oJob.iStartY, iDecodeEndY, &pWorking, &iPitch);
+			if (iWindowRowCount > 0)
+			{
+				pBlocks = Core::Malloc((size_t)(iWindowRowCount + 1) * iBlockCount * c_iSSIMBlockFloats * sizeof(float));
+			}
+
+			if (pReferenceLines != NULL && pLines != NULL && (iWindowRowCount == 0 || pBlocks != NULL))
+			{
+				for (int iY = oJob.iStartY; iY < oJob.iEndY; ++iY)
+				{
+					const float* pReferenceLine = (const float*)(pReferenceLines + iReferencePitch * (iY - oJob.iStartY));
+					const float* pLine = (const float*)(pLines + iPitch * (iY - oJob.iStartY));
+					float* pHeatmap = NULL;
+					if (pOutHeatmap != NULL)
+					{
+						const Texture::TextureFaceData& oHeatmapData = oHeatmap.GetData().GetFaceData(iMip, iFace, iLayer);
+						pHeatmap = (float*)((char*)oHeatmapData.pData + oJob.iSlice * oHeatmapData.iSlicePitch + iY * oHeatmapData.iPitch);
+					}
+					CompareLine(pReferenceLine, pLine, iWidth, xChannelMask, pHeatmap, &oPartial);
+					if (oSettings.bSSIM && bWindowed == false)
+						AccumulateImageSums(pReferenceLine, pLine, iWidth, &oPartial);
+				}
+
+				if (iWindowRowCount > 0)
+				{
+					memset(pBlocks, 0, (size_t)(iWindowRowCount + 1) * iBlockCount * c_iSSIMBlockFloats * sizeof(float));
+					for (int iRow = 0; iRow <= iWindowRowCount; ++iRow)
+					{
+						for (int iLine = 0; iLine < c_iSSIMBlockSize; ++iLine)
+						{
+							const int iY = (iFirstBlockRow + iRow) * c_iSSIMBlockSize + iLine;
+							AccumulateSSIMBlocks(
+								(const float*)(pReferenceLines + iReferencePitch * (iY - oJob.iStartY)),
+								(const float*)(pLines + iPitch * (iY - oJob.iStartY)),
+								iBlockCount, (float*)pBlocks + (size_t)iRow * iBlockCount * c_iSSIMBlockFloats);
+						}
+					}
+					AccumulateSSIMWindows((const float*)pBlocks, iBlockCount, iWindowRowCount, &oPartial);
+				}
+			}
+			else
+			{
+				bError = true;
+			}
+
+			if (pReferenceWorking != NULL)
+				Core::Free(pReferenceWorking);
+			if (pWorking != NULL)
+				Core::Free(pWorking);
+			if (pBlocks != NULL)
+				Core::Free(pBlocks);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		// Reduction in job order
+		TextureComparison& oComparison = *pOutComparison;
+		oComparison.iChannelCount = iChannelCount;
+		double fTotalSquaredError[4] = { 0.0, 0.0, 0.0, 0.0 };
+		double fTotalSSIM[4] = { 0.0, 0.0, 0.0, 0.0 };
+		uint64_t iTotalPixelCount = 0;
+		uint64_t iTotalWindowCount = 0;
+		memset(oComparison.oTotal, 0, sizeof(oComparison.oTotal));
+		iJobIndex = 0;
+		for (int iSubresource = 0; iSubresource < iSubresourceCount; ++iSubresource)
+		{
+			SubresourceComparison& oSubresource = oComparison.oSubresources[iSubresource];
+			oSubresource.iMip = iSubresource / (iArraySize * iFaceCount);
+			oSubresource.iFace = iSubresource % iFaceCount;
+			oSubresource.iLayer = (iSubresource / iFaceCount) % iArraySize;
+			const Texture::TextureFaceData& oFaceData = pReference->GetData().GetFaceData(oSubresource.iMip, oSubresource.iFace, oSubresource.iLayer);
+			const uint64_t iPixelCount = (uint64_t)oFaceData.iWidth * oFaceData.iHeight * oFaceData.iDepth;
+
+			ComparePartial oSum;
+			memset(&oSum, 0, sizeof(oSum));
+			for (; iJobIndex < iJobCount && oJobs[iJobIndex].iSubresource == iSubresource; ++iJobIndex)
+			{
+				const ComparePartial& oPartial = oPartials[iJobIndex];
+				for (int iChannel = 0; iChannel < 4; ++iChannel)
+				{
+					oSum.fSquaredError[iChannel] += oPartial.fSquaredError[iChannel];
+					oSum.fMaxError[iChannel] = Math::Max(oSum.fMaxError[iChannel], oPartial.fMaxError[iChannel]);
+					oSum.fSSIM[iChannel] += oPartial.fSSIM[iChannel];
+					for (int iImageSum = 0; iImageSum < 5; ++iImageSum)
+						oSum.fImageSums[iImageSum][iChannel] += oPartial.fImageSums[iImageSum][iChannel];
+				}
+				oSum.iWindowCount += oPartial.iWindowCount;
+			}
+
+			// Images smaller than a window are a single window
+			if (oSettings.bSSIM && IsSSIMWindowed(oFaceData.iWidth, oFaceData.iHeight) == false)
+			{
+				__m128 xSums[5];
+				for (int iImageSum = 0; iImageSum < 5; ++iImageSum)
+				{
+					const double* pSums = oSum.fImageSums[iImageSum];
+					xSums[iImageSum] = _mm_set_ps((float)pSums[3], (float)pSums[2], (float)pSums[1], (float)pSums[0]);
+				}
+				float fSSIM[4];
+				_mm_storeu_ps(fSSIM, ComputeSSIM(xSums[0], xSums[1], xSums[2], xSums[3], xSums[4], 1.f / (float)iPixelCount));
+				for (int iChannel = 0; iChannel < 4; ++iChannel)
+					oSum.fSSIM[iChannel] = fSSIM[iChannel];
+				oSum.iWindowCount = 1;
+			}
+
+			for (int iChannel = 0; iChannel < 4; ++iChannel)
+			{
+				ChannelComparison& oChannel = oSubresource.oChannels[iChannel];
+				const double fMSE = oSum.fSquaredError[iChannel] / (double)iPixelCount;
+				oChannel.fRMSE = sqrt(fMSE);
+				oChannel.fPSNR = GetPSNR(fMSE);
+				oChannel.fMaxError = oSum.fMaxError[iChannel];
+				oChannel.fSSIM = (oSum.iWindowCount > 0) ? oSum.fSSIM[iChannel] / (double)oSum.iWindowCount : 0.0;
+
+				fTotalSquaredError[iChannel] += oSum.fSquaredError[iChannel];
+				fTotalSSIM[iChannel] += oSum.fSSIM[iChannel];
+				oComparison.oTotal[iChannel].fMaxError = Math::Max(oComparison.oTotal[iChannel].fMaxError, oChannel.fMaxError);
+			}
+			iTotalPixelCount += iPixelCount;
+			iTotalWindowCount += oSum.iWindowCount;
+		}
+
+		for (int iChannel = 0; iChannel < 4; ++iChannel)
+		{
+			ChannelComparison& oChannel = oComparison.oTotal[iChannel];
+			const double fMSE = fTotalSquaredError[iChannel] / (double)iTotalPixelCount;
+			oChannel.fRMSE = sqrt(fMSE);
+			oChannel.fPSNR = GetPSNR(fMSE);
+			oChannel.fSSIM = (iTotalWindowCount > 0) ? fTotalSSIM[iChannel] / (double)iTotalWindowCount : 0.0;
+		}
+
+		if (pOutHeatmap != NULL)
+		{
+			oHeatmap.Swap(*pOutHeatmap);
+		}
+
+		return ErrorCode::Ok;
+	}
+}
+//namespace Graphics
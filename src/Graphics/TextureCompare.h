@@ -0,0 +1,52 @@
+#ifndef __GRAPHICS_TEXTURE_COMPARE_H__
+#define __GRAPHICS_TEXTURE_COMPARE_H__
+
+#include "Core/Array.h"
+#include "Core/ErrorCode.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* Quality metrics between a reference texture and a texture of the same dimensions, pixel formats can differ
+	Both textures are decoded to RGBA float in bands by parallel jobs, partial sums are reduced in job order.
+	PSNR uses a peak value of 1 (normalized formats). SSIM is the mean of 8x8 windows placed every 4 pixels
+	(whole image for images smaller than a window), slices of volumes are compared separately.
+	*/
+	struct ChannelComparison
+	{
+		double						fRMSE;
+		double						fPSNR; // Infinite for identical channels
+		double						fSSIM;
+		float						fMaxError; // Largest absolute difference
+	};
+
+	struct SubresourceComparison
+	{
+		int							iMip;
+		int							iFace;
+		int							iLayer;
+		ChannelComparison			oChannels[4];
+	};
+
+	struct TextureComparison
+	{
+		TextureComparison();
+
+		int							iChannelCount; // Largest component count of both pixel formats
+		Core::Array<SubresourceComparison>	oSubresources; // Mips common to both textures of each layer and face
+		ChannelComparison			oTotal[4]; // Pixels of all subresources, SSIM windows of all subresources
+	};
+
+	struct CompareSettings
+	{
+		CompareSettings();
+		bool						bSSIM;
+	};
+
+	// pOutHeatmap receives a R32 float texture (common mips) with the largest absolute error of the compared channels of each pixel
+	ErrorCode						CompareTextures(const Texture* pReference, const Texture* pTexture, TextureComparison* pOutComparison, const CompareSettings* pSettings = NULL, Texture* pOutHeatmap = NULL);
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_TEXTURE_COMPARE_H__
@@ -0,0 +1,328 @@
+#include "Graphics/TextureFingerprint.h"
+
+#include "Graphics/TextureUtils.h"
+
+#include "Core/Hash.h"
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
+#include <math.h> // cos
+#include <algorithm> // sort/nth_element
+
+namespace Graphics
+{
+	static const int c_iPerceptualSize = 32;
+	static const int c_iPerceptualFrequencies = 8;
+
+	// Decode the block row band of a slice starting at line iY to RGBA 32 float lines of iWidth pixels, return its line count
+	static int DecodeBand(const Texture::TextureFaceData& oFaceData, int iSlice, int iY, PixelFormatEnum eFormat, const PixelFormat::ConvertionFuncChain& oChain, int iChainLength, float* pOutLines)
+	{
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[eFormat];
+		int iLineCount = Math::Min((int)oInfos.iBlockHeight, oFaceData.iHeight - iY);
+		const char* pSource = (const char*)oFaceData.pData + (size_t)iSlice * oFaceData.iSlicePitch + (size_t)(iY / oInfos.iBlockHeight) * oFaceData.iPitch;
+		ConvertPixelFormatRegion(pSource, oFaceData.iPitch, eFormat, pOutLines, (size_t)oFaceData.iWidth * 4 * sizeof(float), PixelFormatEnum::RGBA32_FLOAT, oFaceData.iWidth, iLineCount, oChain, iChainLength);
+		return iLineCount;
+	}
+
+	// Overlap of a pixel and a cell of the perceptual grid along one axis, in 1/32 pixel units
+	static int GetCellCoverage(int iPixel, int iCell, int iSize)
+	{
+		const int iStart = Math::Max(iPixel * c_iPerceptualSize, iCell * iSize);
+		const int iEnd = Math::Min((iPixel + 1) * c_iPerceptualSize, (iCell + 1) * iSize);
+		return Math::Max(iEnd - iStart, 0);
+	}
+
+	static uint64_t ComputePerceptualHash(const float* pLuminance)
+	{
+		const double c_fPi = 3.14159265358979323846;
+
+		// Separable DCT-II restricted to the lowest frequencies
+		double fCosines[c_iPerceptualFrequencies][c_iPerceptualSize];
+		for (int iFrequency = 0; iFrequency < c_iPerceptualFrequencies; ++iFrequency)
+		{
+			for (int iX = 0; iX < c_iPerceptualSize; ++iX)
+				fCosines[iFrequency][iX] = cos((2 * iX + 1) * iFrequency * c_fPi / (2 * c_iPerceptualSize));
+		}
+
+		double fRows[c_iPerceptualSize][c_iPerceptualFrequencies];
+		for (int iY = 0; iY < c_iPerceptualSize; ++iY)
+		{
+			for (int iU = 0; iU < c_iPerceptualFrequencies; ++iU)
+			{
+				double fSum = 0.0;
+				for (int iX = 0; iX < c_iPerceptualSize; ++iX)
+					fSum += pLuminance[iY * c_iPerceptualSize + iX] * fCosines[iU][iX];
+				fRows[iY][iU] = fSum;
+			}
+		}
+
+		double fCoefficients[c_iPerceptualFrequencies * c_iPerceptualFrequencies];
+		for (int iV = 0; iV < c_iPerceptualFrequencies; ++iV)
+		{
+			for (int iU = 0; iU < c_iPerceptualFrequencies; ++iU)
+			{
+				double fSum = 0.0;
+				for (int iY = 0; iY < c_iPerceptualSize; ++iY)
+					fSum += fRows[iY][iU] * fCosines[iV][iY];
+				fCoefficients[iV * c_iPerceptualFrequencies + iU] = fSum;
+			}
+		}
+
+		// Median of the AC coefficients, the DC bit stays 0
+		const int c_iACCount = c_iPerceptualFrequencies * c_iPerceptualFrequencies - 1;
+		double fAC[c_iACCount];
+		for (int iCoef = 0; iCoef < c_iACCount; ++iCoef)
+			fAC[iCoef] = fCoefficients[iCoef + 1];
+		std::nth_element(fAC, fAC + c_iACCount / 2, fAC + c_iACCount);
+		double fMedian = fAC[c_iACCount / 2];
+
+		uint64_t iHash = 0;
+		for (int iCoef = 1; iCoef < c_iPerceptualFrequencies * c_iPerceptualFrequencies; ++iCoef)
+		{
+			if (fCoefficients[iCoef] > fMedian)
+				iHash |= 1ULL << iCoef;
+		}
+		return iHash;
+	}
+
+	ErrorCode ComputeTextureFingerprint(const Texture* pTexture, TextureFingerprint* pOutFingerprint)
+	{
+		if (pTexture == NULL || pTexture->IsValid() == false || pOutFingerprint == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		// sRGB formats are hashed as stored
+		PixelFormatEnum eFormat = pTexture->GetPixelFormat();
+		if (PixelFormat::IsSRGB(eFormat))
+			eFormat = PixelFormat::GetLinearFormat(eFormat);
+
+		PixelFormat::ConvertionFuncChain oChain;
+		int iChainLength;
+		int iAdditionalBits;
+		if (PixelFormat::GetConvertionChain(eFormat, PixelFormatEnum::RGBA32_FLOAT, &oChain, &iChainLength, &iAdditionalBits) == false)
+		{
+			return ErrorCode(1, "Format convertion not implemented");
+		}
+
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[eFormat];
+		size_t iBandSize = (size_t)pTexture->GetWidth() * oInfos.iBlockHeight * 4 * sizeof(float);
+		CORE_PTR_VOID pBand = Core::Malloc(iBandSize);
+		if (pBand == NULL)
+		{
+			return ErrorCode(1, "Can't allocate decode band");
+		}
+		float* pLines = (float*)pBand;
+
+		// Exact hash
+		Core::Hasher64 oHasher;
+		int32_t pDims[5] = { pTexture->GetWidth(), pTexture->GetHeight(), pTexture->GetDepth(), pTexture->GetFaceCount(), pTexture->GetArraySize() };
+		oHasher.Update(pDims, sizeof(pDims));
+		for (int iLayer = 0; iLayer < pTexture->GetArraySize(); ++iLayer)
+		{
+			for (int iFace = 0; iFace < pTexture->GetFaceCount(); ++iFace)
+			{
+				const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(0, iFace, iLayer);
+				for (int iSlice = 0; iSlice < oFaceData.iDepth; ++iSlice)
+				{
+					for (int iY = 0; iY < oFaceData.iHeight; iY += oInfos.iBlockHeight)
+					{
+						int iLineCount = DecodeBand(oFaceData, iSlice, iY, eFormat, oChain, iChainLength, pLines);
+						oHasher.Update(pLines, (size_t)oFaceData.iWidth * iLineCount * 4 * sizeof(float));
+					}
+				}
+			}
+		}
+		pOutFingerprint->iExactHash = oHasher.Finalize();
+
+		// Perceptual hash, from the smallest mip of at least 32x32
+		int iMip = 0;
+		while ((iMip + 1) < pTexture->GetMipCount()
+			&& pTexture->GetData().GetFaceData(iMip + 1, 0).iWidth >= c_iPerceptualSize
+			&& pTexture->GetData().GetFaceData(iMip + 1, 0).iHeight >= c_iPerceptualSize)
+		{
+			++iMip;
+		}
+		const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, 0);
+
+		// Cells are weighted by pixel coverage, so averages of a mip match the averages of mip 0
+		// Bounds are in 1/32 pixel units: pixel i covers [32 * i, 32 * i + 32[, cell i covers [i * iSize, (i + 1) * iSize[
+		int iCellX[c_iPerceptualSize][2];
+		int iCellY[c_iPerceptualSize][2];
+		for (int iCell = 0; iCell < c_iPerceptualSize; ++iCell)
+		{
+			iCellX[iCell][0] = iCell * oFaceData.iWidth / c_iPerceptualSize;
+			iCellX[iCell][1] = ((iCell + 1) * oFaceData.iWidth + c_iPerceptualSize - 1) / c_iPerceptualSize;
+			iCellY[iCell][0] = iCell * oFaceData.iHeight / c_iPerceptualSize;
+			iCellY[iCell][1] = ((iCell + 1) * oFaceData.iHeight + c_iPerceptualSize - 1) / c_iPerceptualSize;
+		}
+
+		double fSums[c_iPerceptualSize * c_iPerceptualSize] = {};
+		for (int iY = 0; iY < oFaceData.iHeight; iY += oInfos.iBlockHeight)
+		{
+			int iLineCount = DecodeBand(oFaceData, 0, iY, eFormat, oChain, iChainLength, pLines);
+			for (int iLine = iY; iLine < iY + iLineCount; ++iLine)
+			{
+				// Luminance replaces the pixels at the start of the line
+				float* pLine = pLines + (size_t)(iLine - iY) * oFaceData.iWidth * 4;
+				for (int iX = 0; iX < oFaceData.iWidth; ++iX)
+					pLine[iX] = 0.299f * pLine[iX * 4 + 0] + 0.587f * pLine[iX * 4 + 1] + 0.114f * pLine[iX * 4 + 2];
+
+				double fColumns[c_iPerceptualSize];
+				for (int iCellColumn = 0; iCellColumn < c_iPerceptualSize; ++iCellColumn)
+				{
+					double fSum = 0.0;
+					for (int iX = iCellX[iCellColumn][0]; iX < iCellX[iCellColumn][1]; ++iX)
+						fSum += (double)pLine[iX] * GetCellCoverage(iX, iCellColumn, oFaceData.iWidth);
+					fColumns[iCellColumn] = fSum;
+				}
+
+				for (int iCellRow = 0; iCellRow < c_iPerceptualSize; ++iCellRow)
+				{
+					if (iLine < iCellY[iCellRow][0] || iLine >= iCellY[iCellRow][1])
+						continue;
+					const double fCoverageY = GetCellCoverage(iLine, iCellRow, oFaceData.iHeight);
+					for (int iCellColumn = 0; iCellColumn < c_iPerceptualSize; ++iCellColumn)
+						fSums[iCellRow * c_iPerceptualSize + iCellColumn] += fColumns[iCellColumn] * fCoverageY;
+				}
+			}
+		}
+		Core::Free(pBand);
+
+		// Coverages of a cell add up to its area, iWidth * iHeight in 1/32 pixel units
+		const double fCellArea = (double)oFaceData.iWidth * oFaceData.iHeight;
+		float fLuminance[c_iPerceptualSize * c_iPerceptualSize];
+		for (int iCell = 0; iCell < c_iPerceptualSize * c_iPerceptualSize; ++iCell)
+			fLuminance[iCell] = (float)(fSums[iCell] / fCellArea);
+		pOutFingerprint->iPerceptualHash = ComputePerceptualHash(fLuminance);
+
+		return ErrorCode::Ok;
+	}
+
+	int HammingDistance(uint64_t iHashA, uint64_t iHashB)
+	{
+		uint64_t iBits = iHashA ^ iHashB;
+		iBits = iBits - ((iBits >> 1) & 0x5555555555555555ULL);
+		iBits = (iBits & 0x3333333333333333ULL) + ((iBits >> 2) & 0x3333333333333333ULL);
+		iBits = (iBits + (iBits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return (int)((iBits * 0x0101010101010101ULL) >> 56);
+	}
+
+	struct BandEntry
+	{
+		uint64_t					iBand;
+		int							iIndex;
+
+		bool operator<(const BandEntry& oRight) const
+		{
+			return iBand < oRight.iBand || (iBand == oRight.iBand && iIndex < oRight.iIndex);
+		}
+	};
+
+	static int FindGroup(Core::Array<int>& oParents, int iIndex)
+	{
+		while (oParents[iIndex] != iIndex)
+		{
+			oParents[iIndex] = oParents[oParents[iIndex]];
+			iIndex = oParents[iIndex];
+		}
+		return iIndex;
+	}
+
+	// Union of hashes differing by at most iMaxDistance bits, multi-index hashing with iMaxDistance + 1 bands
+	static ErrorCode GroupHashes(const Core::Array<uint64_t>& oHashes, int iMaxDistance, Core::Array<int>* pOutGroups)
+	{
+		const int iCount = (int)oHashes.size();
+		Core::Array<int>& oParents = *pOutGroups;
+		Core::Array<BandEntry> oEntries;
+		if (oParents.resize(iCount, false) == false || oEntries.resize(iCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate groups");
+		}
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			oParents[iIndex] = iIndex;
+
+		const int iBandCount = Math::Min(iMaxDistance + 1, 64);
+		for (int iBand = 0; iBand < iBandCount; ++iBand)
+		{
+			int iFirstBit = iBand * 64 / iBandCount;
+			int iBitCount = (iBand + 1) * 64 / iBandCount - iFirstBit;
+			uint64_t iMask = (iBitCount == 64) ? ~0ULL : (((1ULL << iBitCount) - 1) << iFirstBit);
+			for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			{
+				oEntries[iIndex].iBand = oHashes[iIndex] & iMask;
+				oEntries[iIndex].iIndex = iIndex;
+			}
+			std::sort(oEntries.begin(), oEntries.end());
+
+			// Compare hashes of each run sharing this band
+			for (int iRunStart = 0; iRunStart < iCount; )
+			{
+				int iRunEnd = iRunStart + 1;
+				while (iRunEnd < iCount && oEntries[iRunEnd].iBand == oEntries[iRunStart].iBand)
+					++iRunEnd;
+
+				for (int iEntryA = iRunStart; iEntryA < iRunEnd; ++iEntryA)
+				{
+					int iIndexA = oEntries[iEntryA].iIndex;
+					for (int iEntryB = iEntryA + 1; iEntryB < iRunEnd; ++iEntryB)
+					{
+						int iIndexB = oEntries[iEntryB].iIndex;
+						int iGroupA = FindGroup(oParents, iIndexA);
+						int iGroupB = FindGroup(oParents, iIndexB);
+						if (iGroupA != iGroupB && HammingDistance(oHashes[iIndexA], oHashes[iIndexB]) <= iMaxDistance)
+						{
+							// Smallest index is the root
+							if (iGroupA < iGroupB)
+								oParents[iGroupB] = iGroupA;
+							else
+								oParents[iGroupA] = iGroupB;
+						}
+					}
+				}
+				iRunStart = iRunEnd;
+			}
+		}
+
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			oParents[iIndex] = FindGroup(oParents, iIndex);
+
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode GroupExactDuplicates(const TextureFingerprint* pFingerprints, int iCount, Core::Array<int>* pOutGroups)
+	{
+		if ((pFingerprints == NULL && iCount > 0) || iCount < 0 || pOutGroups == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		Core::Array<uint64_t> oHashes;
+		if (oHashes.resize(iCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate hashes");
+		}
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			oHashes[iIndex] = pFingerprints[iIndex].iExactHash;
+		return GroupHashes(oHashes, 0, pOutGroups);
+	}
+
+	ErrorCode GroupNearDuplicates(const TextureFingerprint* pFingerprints, int iCount, int iMaxDistance, Core::Array<int>* pOutGroups)
+	{
+		if ((pFingerprints == NULL && iCount > 0) || iCount < 0 || iMaxDistance < 0 || pOutGroups == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		Core::Array<uint64_t> oHashes;
+		if (oHashes.resize(iCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate hashes");
+		}
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+			oHashes[iIndex] = pFingerprints[iIndex].iPerceptualHash;
+		return GroupHashes(oHashes, iMaxDistance, pOutGroups);
+	}
+}
+//namespace Graphics
@@ -0,0 +1,39 @@
+#ifndef __GRAPHICS_TEXTURE_FINGERPRINT_H__
+#define __GRAPHICS_TEXTURE_FINGERPRINT_H__
+
+#include "Core/Array.h"
+#include "Core/ErrorCode.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* Exact and perceptual hashes for duplicate detection
+	The exact hash covers the dimensions and the mip 0 pixels of all faces/layers/slices decoded to RGBA 32 float, sRGB formats
+	read as their linear equivalent : the same image stored as PNG or uncompressed DDS, with or without mips, has the same hash.
+	The perceptual hash is a DCT hash : luminance of the first face averaged to 32x32, the 63 lowest AC frequencies of its DCT
+	compared to their median. It is read from the smallest mip of at least 32x32 when the texture has mips, recompressed or
+	resized copies are within a few bits. Textures are decoded by bands of block rows, memory stays independent of their size.
+	*/
+	struct TextureFingerprint
+	{
+		uint64_t					iExactHash;
+		uint64_t					iPerceptualHash;
+	};
+
+	ErrorCode						ComputeTextureFingerprint(const Texture* pTexture, TextureFingerprint* pOutFingerprint);
+
+	int								HammingDistance(uint64_t iHashA, uint64_t iHashB);
+
+	// pOutGroups receives for each fingerprint the smallest index of the fingerprints with the same exact hash
+	ErrorCode						GroupExactDuplicates(const TextureFingerprint* pFingerprints, int iCount, Core::Array<int>* pOutGroups);
+
+	/* Group fingerprints whose perceptual hashes differ by at most iMaxDistance bits, transitively
+	Uses multi-index hashing : hashes are split in iMaxDistance + 1 bands, two hashes within the distance have at least one
+	identical band, only hashes sharing a band are compared. pOutGroups receives for each fingerprint the smallest index of its group.
+	*/
+	ErrorCode						GroupNearDuplicates(const TextureFingerprint* pFingerprints, int iCount, int iMaxDistance, Core::Array<int>* pOutGroups);
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_TEXTURE_FINGERPRINT_H__
@@ -3,6 +3,10 @@
 #include "Graphics/DDS.h"
 #include "Graphics/TextureLoader.h"
 
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -18,9 +22,23 @@ namespace Graphics
 		}
 
 
-		ErrorCode TextureLoaderDDS(Core::Stream* pStream, Texture* pTexture)
+		DDSStreamReader::DDSStreamReader()
+			: m_pStream(NULL)
+			, m_iPitch(0)
+			, m_iNextSubresource(0)
+			, m_iNextRow(0)
+			, m_iRemainingPitch(0)
 		{
-			Texture::Desc oDesc;
+		}
+
+		ErrorCode DDSStreamReader::Begin(Core::Stream* pStream)
+		{
+			if (pStream == NULL || m_pStream != NULL)
+			{
+				return ErrorCode::InvalidArgument;
+			}
+
+			Texture::TextureData::Desc oDesc;
 			uint32_t iDDSMagic;
 			DDS_HEADER oDDSHeader;
 			DDS_HEADER_DXT10 oDDSHeaderDX10;
@@ -38,23 +56,6 @@ namespace Graphics
 				return ErrorCode(1, "Invalid DDS header");
 			}
 
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_CAPS) != 0)
-				printf("DDS_HEADER_FLAGS_CAPS\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_HEIGHT) != 0)
-				printf("DDS_HEADER_FLAGS_HEIGHT\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_WIDTH) != 0)
-				printf("DDS_HEADER_FLAGS_WIDTH\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_PITCH) != 0)
-				printf("DDS_HEADER_FLAGS_PITCH\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_PIXELFORMAT) != 0)
-				printf("DDS_HEADER_FLAGS_PIXELFORMAT\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_MIPMAPCOUNT) != 0)
-				printf("DDS_HEADER_FLAGS_MIPMAPCOUNT\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_LINEARSIZE) != 0)
-				printf("DDS_HEADER_FLAGS_LINEARSIZE\n");
-			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_DEPTH) != 0)
-				printf("DDS_HEADER_FLAGS_DEPTH\n");
-
 			char pFourCC[5] = "0000";
 			pFourCC[0] = oDDSHeader.oPixelFormat.iFourCC & 0xff;
 			pFourCC[1] = (oDDSHeader.oPixelFormat.iFourCC >> 8) & 0xff;
@@ -81,6 +82,11 @@ namespace Graphics
 
 			oDesc.iFaceCount = iCubemapFace > 0 ? iCubemapFace : 1;
 
+			if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_DEPTH) && (oDDSHeader.iCubemapFlags & DDS_FLAGS_VOLUME))
+			{
+				oDesc.iDepth = oDDSHeader.iDepth > 0 ? oDDSHeader.iDepth : 1;
+			}
+
 			if ((oDDSHeader.iHeaderFlags & DDS_FOURCC)
 				&& oDDSHeader.oPixelFormat.iFourCC == DDSPF_DX10.iFourCC
 				//&& memcmp(&oDDSHeader.oPixelFormat, &DDSPF_DX10, sizeof(DDS_PIXELFORMAT)) == 0
@@ -91,6 +97,16 @@ namespace Graphics
 					return ErrorCode(1, "Invalid DDS DX10 header");
 				}
 
+				if (oDDSHeaderDX10.oResourceDimension == D3D10_RESOURCE_DIMENSION_TEXTURE3D)
+				{
+					oDesc.iDepth = oDDSHeader.iDepth > 0 ? oDDSHeader.iDepth : 1;
+				}
+				else if (oDDSHeaderDX10.iMiscFlag & DDS_RESOURCE_MISC_TEXTURECUBE)
+				{
+					oDesc.iFaceCount = Texture::_E_FACE_COUNT;
+				}
+				oDesc.iArraySize = oDDSHeaderDX10.iArraySize > 0 ? oDDSHeaderDX10.iArraySize : 1;
+
 				if (   oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_R8_TYPELESS
 					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_R8_UNORM
 					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_R8_UINT)
@@ -103,6 +119,19 @@ namespace Graphics
 				{
 					oDesc.ePixelFormat = PixelFormatEnum::RGBA8_UNORM;
 				}
+				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::RGBA8_UNORM_SRGB;
+				}
+				else if (  oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_B8G8R8A8_TYPELESS
+						|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_B8G8R8A8_UNORM)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::BGRA8_UNORM;
+				}
+				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::BGRA8_UNORM_SRGB;
+				}
 				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_B5G6R5_UNORM)
 				{
 					oDesc.ePixelFormat = PixelFormatEnum::B5G6BR_UNORM;
@@ -146,23 +175,32 @@ namespace Graphics
 					oDesc.ePixelFormat = PixelFormatEnum::D16_UNORM;
 				}
 				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC1_TYPELESS
-					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC1_UNORM
-					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC1_UNORM_SRGB)
+					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC1_UNORM)
 				{
 					oDesc.ePixelFormat = PixelFormatEnum::BC1;
 				}
+				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC1_UNORM_SRGB)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::BC1_SRGB;
+				}
 				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC2_TYPELESS
-					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC2_UNORM
-					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC2_UNORM_SRGB)
+					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC2_UNORM)
 				{
 					oDesc.ePixelFormat = PixelFormatEnum::BC2;
 				}
+				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC2_UNORM_SRGB)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::BC2_SRGB;
+				}
 				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC3_TYPELESS
-					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC3_UNORM
-					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC3_UNORM_SRGB)
+					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC3_UNORM)
 				{
 					oDesc.ePixelFormat = PixelFormatEnum::BC3;
 				}
+				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC3_UNORM_SRGB)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::BC3_SRGB;
+				}
 				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC4_TYPELESS
 					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC4_UNORM
 					|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC4_SNORM)
@@ -182,11 +220,14 @@ namespace Graphics
 					oDesc.ePixelFormat = PixelFormatEnum::BC6H;
 				}
 				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC7_TYPELESS
-						|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC7_UNORM
-						|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC7_UNORM_SRGB)
+						|| oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC7_UNORM)
 				{
 					oDesc.ePixelFormat = PixelFormatEnum::BC7;
 				}
+				else if (oDDSHeaderDX10.oDxgiFormat == DXGI_FORMAT_BC7_UNORM_SRGB)
+				{
+					oDesc.ePixelFormat = PixelFormatEnum::BC7_SRGB;
+				}
 			}
 			else if (memcmp(&oDDSHeader.oPixelFormat, &DDSPF_A8R8G8B8, sizeof(DDS_PIXELFORMAT)) == 0)
 			{
@@ -326,84 +367,202 @@ namespace Graphics
 				return ErrorCode(1, "Not supported pixel format");
 			}
 
-			ErrorCode oErr = pTexture->Create(oDesc);
+			// Pitch is given for the top level, smaller mips are tightly packed
+			m_pStream = pStream;
+			m_oDesc = oDesc;
+			m_iPitch = (oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_PITCH) != 0 ? oDDSHeader.iPitchOrLinearSize : 0;
+			m_iNextSubresource = 0;
+			m_iNextRow = 0;
+			m_iRemainingPitch = m_iPitch;
+			return ErrorCode::Ok;
+		}
+
+		int DDSStreamReader::GetSubresourceCount() const
+		{
+			return m_oDesc.iArraySize * m_oDesc.iFaceCount * m_oDesc.iMipCount;
+		}
+
+		size_t DDSStreamReader::GetRowSize(int iMip) const
+		{
+			uint32_t iBlockCountX, iBlockCountY;
+			PixelFormat::GetBlockCount(m_oDesc.ePixelFormat, Math::Max(1, m_oDesc.iWidth >> iMip), Math::Max(1, m_oDesc.iHeight >> iMip), &iBlockCountX, &iBlockCountY);
+			return (size_t)iBlockCountX * PixelFormatEnumInfos[m_oDesc.ePixelFormat].iBlockSize;
+		}
+
+		int DDSStreamReader::GetRowCount(int iMip) const
+		{
+			uint32_t iBlockCountX, iBlockCountY;
+			PixelFormat::GetBlockCount(m_oDesc.ePixelFormat, Math::Max(1, m_oDesc.iWidth >> iMip), Math::Max(1, m_oDesc.iHeight >> iMip), &iBlockCountX, &iBlockCountY);
+			return (int)iBlockCountY * Math::Max(1, m_oDesc.iDepth >> iMip);
+		}
+
+		ErrorCode DDSStreamReader::ReadSubresourceRows(int iLayer, int iFace, int iMip, void* pRows, int iRowCount)
+		{
+			if (m_pStream == NULL || pRows == NULL || iRowCount <= 0)
+			{
+				return ErrorCode::InvalidArgument;
+			}
+
+			// DDS has no index, subresources are read in file order
+			int iExpected = m_iNextSubresource;
+			if (iExpected >= GetSubresourceCount()
+				|| iMip != iExpected % m_oDesc.iMipCount
+				|| iFace != (iExpected / m_oDesc.iMipCount) % m_oDesc.iFaceCount
+				|| iLayer != iExpected / (m_oDesc.iMipCount * m_oDesc.iFaceCount))
+			{
+				return ErrorCode(1, "Subresource read out of order");
+			}
+
+			const int iSubresourceRowCount = GetRowCount(iMip);
+			if (m_iNextRow + iRowCount > iSubresourceRowCount)
+			{
+				return ErrorCode(1, "Invalid row count");
+			}
+
+			const size_t iRowSize = GetRowSize(iMip);
+			if (iMip == 0 && m_iPitch > 0)
+			{
+				if (iRowSize > m_iPitch)
+				{
+					return ErrorCode(2, "Internal : Invalid pitch size");
+				}
+
+				for (int iLine = 0; iLine < iRowCount; ++iLine)
+				{
+					if (iRowSize > m_iRemainingPitch)
+					{
+						m_pStream->Seek(m_iRemainingPitch, Core::Stream::SeekModeEnum::OFFSET);
+						m_iRemainingPitch = m_iPitch;
+					}
+
+					if (m_pStream->Read((char*)pRows + iLine * iRowSize, iRowSize) != iRowSize)
+					{
+						return ErrorCode(1, "Incomplete file");
+					}
+					m_iRemainingPitch -= iRowSize;
+				}
+			}
+			else if (m_pStream->Read(pRows, iRowSize * iRowCount) != iRowSize * iRowCount)
+			{
+				return ErrorCode(1, "Incomplete file");
+			}
+
+			m_iNextRow += iRowCount;
+			if (m_iNextRow == iSubresourceRowCount)
+			{
+				++m_iNextSubresource;
+				m_iNextRow = 0;
+				m_iRemainingPitch = m_iPitch;
+			}
+			return ErrorCode::Ok;
+		}
+
+		ErrorCode TextureLoaderDDS(Core::Stream* pStream, Texture* pTexture)
+		{
+			DDSStreamReader oReader;
+			ErrorCode oErr = oReader.Begin(pStream);
 			if (oErr != ErrorCode::Ok)
 			{
 				return oErr;
 			}
 
-			const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oDesc.ePixelFormat];
+			const Texture::TextureData::Desc& oReaderDesc = oReader.GetDesc();
+			Texture::Desc oDesc;
+			static_cast<Texture::TextureData::Desc&>(oDesc) = oReaderDesc;
+			oErr = pTexture->Create(oDesc);
+			if (oErr != ErrorCode::Ok)
+			{
+				return oErr;
+			}
 
-			for (int iFace = 0; iFace < oDesc.iFaceCount; ++iFace)
+			// Data layout : for each layer, for each face, for each mip, all depth slices
+			for (int iSubresource = 0; iSubresource < oDesc.iArraySize * oDesc.iFaceCount; ++iSubresource)
 			{
+				int iLayer = iSubresource / oDesc.iFaceCount;
+				int iFace = iSubresource % oDesc.iFaceCount;
 				for (int iMip = 0; iMip < oDesc.iMipCount; ++iMip)
 				{
-					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace);
+					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+					if (oFaceData.iSize != oReader.GetRowSize(iMip) * oReader.GetRowCount(iMip))
+						return ErrorCode(2, "Internal : Invalid block size");
 
-					uint32_t iBlockCountX, iBlockCountY;
-					PixelFormat::GetBlockCount(oDesc.ePixelFormat, oFaceData.iWidth, oFaceData.iHeight, &iBlockCountX, &iBlockCountY);
+					oErr = oReader.ReadSubresourceRows(iLayer, iFace, iMip, oFaceData.pData, oReader.GetRowCount(iMip));
+					if (oErr != ErrorCode::Ok)
+					{
+						return oErr;
+					}
+				}
+			}
 
-					int iBlockCount = iBlockCountX * iBlockCountY;
+			return ErrorCode::Ok;
+		}
 
-					size_t iBlocksSize = iBlockCount * oInfos.iBlockSize;
+		ErrorCode LoadTiledDDS(Core::Stream* pStream, int iTileSize, size_t iMemoryBudget, TiledTexture* pOutTexture)
+		{
+			if (pOutTexture == NULL)
+			{
+				return ErrorCode::InvalidArgument;
+			}
 
-					void* pBlocks = oFaceData.pData;
+			DDSStreamReader oReader;
+			ErrorCode oErr = oReader.Begin(pStream);
+			if (oErr != ErrorCode::Ok)
+			{
+				return oErr;
+			}
 
-					if (oFaceData.iSize != iBlocksSize)
-						return ErrorCode(2, "Internal : Invalid block size");
+			const Texture::TextureData::Desc& oReaderDesc = oReader.GetDesc();
+			if (oReaderDesc.iDepth > 1 || oReaderDesc.iArraySize > 1)
+			{
+				return ErrorCode(1, "Array and volume textures are not supported by tiled textures");
+			}
 
-					size_t iRowSize = iBlockCountX * oInfos.iBlockSize;
+			TiledTexture::Desc oDesc;
+			static_cast<Texture::TextureData::Desc&>(oDesc) = oReaderDesc;
+			oDesc.iTileSize = iTileSize;
+			oDesc.iMemoryBudget = iMemoryBudget;
+			oErr = pOutTexture->Create(oDesc);
+			if (oErr != ErrorCode::Ok)
+			{
+				return oErr;
+			}
 
-					if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_PITCH) != 0)
-					{
-						size_t iPitchSize = oDDSHeader.iPitchOrLinearSize;
-						if (iRowSize > iPitchSize)
-						{
-							return ErrorCode(2, "Internal : Invalid pitch size");
-						}
+			// Block rows are read by bands of one tile, smaller when a band of the top mip doesn't fit in a quarter of the memory budget
+			const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oDesc.ePixelFormat];
+			const int iBandRowCount = (int)Math::Max<size_t>(Math::Min<size_t>(iTileSize / oInfos.iBlockHeight, iMemoryBudget / 4 / oReader.GetRowSize(0)), 1);
+			CORE_PTR_VOID pBand = Core::Malloc(oReader.GetRowSize(0) * iBandRowCount);
+			if (pBand == NULL)
+			{
+				pOutTexture->Destroy();
+				return ErrorCode(1, "Can't allocate band buffer");
+			}
 
-						size_t iDiff = iPitchSize - iRowSize;
-						size_t iRemainingPitch = iPitchSize;
-						for (int iLine = 0; iLine < iBlockCountY; ++iLine)
-						{
-							if (iRowSize > iRemainingPitch)
-							{
-								pStream->Seek(iRemainingPitch, Core::Stream::SeekModeEnum::OFFSET);
-								iRemainingPitch = iPitchSize;
-							}
-
-							{
-								if (pStream->Read((char*)pBlocks + iLine * iRowSize, iRowSize) != iRowSize)
-								{
-									return ErrorCode(1, "Incomplete file");
-								}
-								iRemainingPitch -= iRowSize;
-							}
-						}
-					}
-					else if ((oDDSHeader.iHeaderFlags & DDS_HEADER_FLAGS_LINEARSIZE) != 0)
-					{
-						/*size_t iLinearSize = oDDSHeader.iPitchOrLinearSize;
-						if (iMip == 0 && (iBlockCountY * oInfos.iBlockSize) != iLinearSize)
-						{
-							return false;
-						}*/
-						if (pStream->Read(pBlocks, iBlocksSize) != iBlocksSize)
-						{
-							return ErrorCode(1, "Incomplete file");
-						}
-					}
-					else
+			for (int iFace = 0; iFace < oDesc.iFaceCount && oErr == ErrorCode::Ok; ++iFace)
+			{
+				for (int iMip = 0; iMip < oDesc.iMipCount && oErr == ErrorCode::Ok; ++iMip)
+				{
+					const int iMipWidth = pOutTexture->GetMipWidth(iMip);
+					const int iMipHeight = pOutTexture->GetMipHeight(iMip);
+					const int iRowCount = oReader.GetRowCount(iMip);
+					for (int iRow = 0; iRow < iRowCount && oErr == ErrorCode::Ok; iRow += iBandRowCount)
 					{
-						if (pStream->Read(pBlocks, iBlocksSize) != iBlocksSize)
+						const int iCount = Math::Min(iBandRowCount, iRowCount - iRow);
+						const int iY = iRow * oInfos.iBlockHeight;
+						oErr = oReader.ReadSubresourceRows(0, iFace, iMip, pBand, iCount);
+						if (oErr == ErrorCode::Ok)
 						{
-							return ErrorCode(1, "Incomplete file");
+							oErr = pOutTexture->WriteRegion(iMip, iFace, 0, iY, iMipWidth, Math::Min(iCount * oInfos.iBlockHeight, iMipHeight - iY), pBand, oReader.GetRowSize(iMip));
 						}
 					}
 				}
 			}
 
-			return ErrorCode::Ok;
+			Core::Free(pBand);
+			if (oErr != ErrorCode::Ok)
+			{
+				pOutTexture->Destroy();
+			}
+			return oErr;
 		}
 	}
 	//namespace TextureLoader
@@ -1,14 +1,51 @@
 #ifndef __GRAPHICS_TEXTURE_LOADER_DDS_H__
 #define __GRAPHICS_TEXTURE_LOADER_DDS_H__
 
+#include "Core/ErrorCode.h"
+#include "Core/Stream.h"
+
+#include "Graphics/Texture.h"
+#include "Graphics/TiledTexture.h"
+
 namespace Graphics
 {
 	namespace TextureLoader
 	{
 		void RegisterLoaderDDS();
+
+		/* Streaming DDS reader
+		Header is read by Begin, then each subresource is read by rows of blocks,
+		in file order (layer > face > mip), so a file doesn't need to fit in memory.
+		*/
+		class DDSStreamReader
+		{
+		public:
+										DDSStreamReader();
+
+			ErrorCode					Begin(Core::Stream* pStream);
+			// Next iRowCount block rows of a subresource, rows of all depth slices follow each other
+			ErrorCode					ReadSubresourceRows(int iLayer, int iFace, int iMip, void* pRows, int iRowCount);
+
+			const Texture::TextureData::Desc&	GetDesc() const { return m_oDesc; }
+			int							GetSubresourceCount() const;
+			// Size of one block row of a mip
+			size_t						GetRowSize(int iMip) const;
+			// Block rows of one face/layer of a mip, including all depth slices
+			int							GetRowCount(int iMip) const;
+		protected:
+			Core::Stream*				m_pStream;
+			Texture::TextureData::Desc	m_oDesc;
+			size_t						m_iPitch; // Of the top level, 0 when not given
+			int							m_iNextSubresource;
+			int							m_iNextRow;
+			size_t						m_iRemainingPitch;
+		};
+
+		// Read a 2D or cubemap DDS in a tiled texture by bands of rows, only the tile cache is kept in memory
+		ErrorCode						LoadTiledDDS(Core::Stream* pStream, int iTileSize, size_t iMemoryBudget, TiledTexture* pOutTexture);
 	}
 	//namespace TextureLoader
 }
 //namespace Graphics
 
-#endif //__GRAPHICS_TEXTURE_LOADER_DDS_H__
\ No newline at end of file
+#endif //__GRAPHICS_TEXTURE_LOADER_DDS_H__
@@ -79,7 +79,7 @@ namespace Graphics
 						ePixelFormat = PixelFormatEnum::RGB8_UNORM;
 						break;
 					case KTX::PixelFormatEnum::GL_RGBA:
-						ePixelFormat = PixelFormatEnum::RGBA8_UNORM;
+						ePixelFormat = (oHeader.iGLInternalFormat == KTX::PixelFormatEnum::GL_SRGB8_ALPHA8) ? PixelFormatEnum::RGBA8_UNORM_SRGB : PixelFormatEnum::RGBA8_UNORM;
 						break;
 					default:
 						return ErrorCode(1, "KTX : GLFormat is not supported for this type");
@@ -135,26 +135,27 @@ namespace Graphics
 				case KTX::PixelFormatEnum::GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
 					ePixelFormat = PixelFormatEnum::BC3;
 					break;
+				case KTX::PixelFormatEnum::GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+					ePixelFormat = PixelFormatEnum::BC1_SRGB;
+					break;
+				case KTX::PixelFormatEnum::GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+					ePixelFormat = PixelFormatEnum::BC2_SRGB;
+					break;
+				case KTX::PixelFormatEnum::GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+					ePixelFormat = PixelFormatEnum::BC3_SRGB;
+					break;
 				default:
 					return ErrorCode(1, "KTX : GL Internal Format not supported");
 				}
 			}
 
-			if (oHeader.iNumberOfArrayElements > 1)
-			{
-				return ErrorCode(1, "KTX : Not supported Array texture");
-			}
-
-			if (oHeader.iPixelDepth > 1)
-			{
-				return ErrorCode(1, "KTX : Not supported 3D texture");
-			}
-
 			Texture::Desc oDesc;
 			oDesc.ePixelFormat = ePixelFormat;
 			oDesc.iWidth = oHeader.iPixelWidth > 0 ? oHeader.iPixelWidth : 1;
 			oDesc.iHeight = oHeader.iPixelHeight > 0 ? oHeader.iPixelHeight : 1;
+			oDesc.iDepth = oHeader.iPixelDepth > 0 ? oHeader.iPixelDepth : 1;
 			oDesc.iFaceCount = oHeader.iNumberOfFaces > 0 ? oHeader.iNumberOfFaces : 1;
+			oDesc.iArraySize = oHeader.iNumberOfArrayElements > 0 ? oHeader.iNumberOfArrayElements : 1;
 			oDesc.iMipCount = oHeader.iNumberOfMipmapLevels > 0 ? oHeader.iNumberOfMipmapLevels : 1;
 
 			ErrorCode oErr = pTexture->Create(oDesc);
@@ -203,35 +204,38 @@ namespace Graphics
 					return ErrorCode::Fail;
 				}
 
-				for (int iFace = 0; iFace < oDesc.iFaceCount; ++iFace)
+				for (int iLayer = 0; iLayer < oDesc.iArraySize; ++iLayer)
 				{
-					//TODO z_slice
+					for (int iFace = 0; iFace < oDesc.iFaceCount; ++iFace)
 					{
-						const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace);
+						const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+
+						uint32_t iBlockCountX, iBlockCountY;
+						PixelFormat::GetBlockCount(ePixelFormat, oFaceData.iWidth, oFaceData.iHeight, &iBlockCountX, &iBlockCountY);
 
-						int iBlock = 0;
-						for (int iY = 0; iY < oFaceData.iHeight; iY += oPixelFormatInfo.iBlockHeight )
+						size_t iRowSize = (size_t)iBlockCountX * oPixelFormatInfo.iBlockSize;
+						//End of line padding, rows are 4 bytes aligned
+						size_t iPadding = (4 - (iRowSize % 4)) % 4;
+
+						for (int iSlice = 0; iSlice < oFaceData.iDepth; ++iSlice)
 						{
-							for (int iX = 0; iX < oFaceData.iWidth; iX += oPixelFormatInfo.iBlockWidth)
+							for (uint32_t iRow = 0; iRow < iBlockCountY; ++iRow)
 							{
-								char* pBlock = (char*)oFaceData.pData + iBlock * oPixelFormatInfo.iBlockSize;
-								CORE_ASSERT(iBlock * oPixelFormatInfo.iBlockSize < oFaceData.iSize);
-								if (pStream->Read(pBlock, oPixelFormatInfo.iBlockSize) == false)
+								char* pRow = (char*)oFaceData.pData + iSlice * oFaceData.iSlicePitch + iRow * oFaceData.iPitch;
+								CORE_ASSERT((size_t)(iSlice * oFaceData.iSlicePitch + iRow * oFaceData.iPitch + iRowSize) <= oFaceData.iSize);
+								if (pStream->Read(pRow, iRowSize) != iRowSize)
 								{
 									return ErrorCode::Fail;
 								}
-								iBlock++;
-							}
 
-							//End of line padding
-							size_t iPadding = (oFaceData.iWidth * oPixelFormatInfo.iBlockWidth) % 4;
-							if (pStream->Seek(iPadding, Core::Stream::SeekModeEnum::OFFSET) == false)
-							{
-								return ErrorCode::Fail;
+								if (iPadding > 0 && pStream->Seek(iPadding, Core::Stream::SeekModeEnum::OFFSET) == false)
+								{
+									return ErrorCode::Fail;
+								}
 							}
 						}
+						// Cube padding is always 0 as rows are already 4 bytes aligned
 					}
-					//TODO cube padding[0-3]
 				}
 				//TODO mip padding[0-3]
 			}
@@ -0,0 +1,506 @@
+#include "Graphics/TextureStatistics.h"
+
+#include "Graphics/TextureUtils.h"
+
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
+#include <emmintrin.h> //SIMD
+#include <float.h> // FLT_MAX
+#include <string.h> // memset/memcpy
+
+#ifndef DEBUG
+#include <omp.h>
+#endif
+
+namespace Graphics
+{
+	TextureStatistics::TextureStatistics()
+	{
+		iChannelCount = 0;
+		iPixelCount = 0;
+		memset(oChannels, 0, sizeof(oChannels));
+		iHistogramBinCount = 0;
+	}
+
+	StatisticsSettings::StatisticsSettings()
+	{
+		iHistogramBinCount = 256;
+	}
+
+	// Lines of a slice analyzed by each job, multiple of all block heights
+	static const int c_iStatisticsBandHeight = 64;
+	static const int c_iMaxHistogramBinCount = 65536;
+
+	// Moments of a job are accumulated relative to a reference pixel to limit cancellation in the variance
+	struct StatisticsPartial
+	{
+		float						fMin[4];
+		float						fMax[4];
+		double						fReference[4];
+		double						fSum[4];
+		double						fSumSquares[4];
+		uint64_t					iPixelCount;
+		uint64_t					iNaNCount[4];
+		uint64_t					iInfCount[4];
+	};
+
+	struct StatisticsSource
+	{
+		const Texture::TextureFaceData*	pFaceData;
+		PixelFormatEnum				ePixelFormat;
+		PixelFormatEnum				eWorkingFormat;
+		const PixelFormat::ConvertionFuncChain*	pDecodeChain;
+		int							iDecodeChainLength;
+		int							iStride; // Floats per decoded pixel, 3 or 4
+		int							iBandCount; // Bands per slice
+	};
+
+	// Exponent bits all set for infinities and NaN, tested on bits to not depend on floating point compiler options
+	static bool IsFinite(float fValue)
+	{
+		uint32_t iBits;
+		memcpy(&iBits, &fValue, sizeof(iBits));
+		return (iBits & 0x7F800000) != 0x7F800000;
+	}
+
+	static bool IsNaN(float fValue)
+	{
+		uint32_t iBits;
+		memcpy(&iBits, &fValue, sizeof(iBits));
+		return (iBits & 0x7FFFFFFF) > 0x7F800000;
+	}
+
+	// Lines [*pOutStartY, *pOutEndY[ of a slice band, decoded in ppWorking when the source is not read in place
+	static const float* GetBandLines(const StatisticsSource& oSource, int iJob, CORE_PTR_VOID* ppWorking, int* pOutStartY, int* pOutEndY)
+	{
+		const Texture::TextureFaceData& oFaceData = *oSource.pFaceData;
+		const int iSlice = iJob / oSource.iBandCount;
+		const int iStartY = (iJob % oSource.iBandCount) * c_iStatisticsBandHeight;
+		const int iEndY = Math::Min(iStartY + c_iStatisticsBandHeight, oFaceData.iHeight);
+		*pOutStartY = iStartY;
+		*pOutEndY = iEndY;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[oSource.ePixelFormat];
+		const char* pSlice = (const char*)oFaceData.pData + (size_t)iSlice * oFaceData.iSlicePitch;
+		if (oSource.iDecodeChainLength == 0)
+		{
+			return (const float*)(pSlice + (size_t)iStartY * oFaceData.iPitch);
+		}
+
+		const size_t iLinePitch = (size_t)oFaceData.iWidth * oSource.iStride * sizeof(float);
+		// Decoded lines are padded to whole blocks
+		const int iBlockRowCount = (iEndY - iStartY + oFormatInfos.iBlockHeight - 1) / oFormatInfos.iBlockHeight;
+		*ppWorking = Core::Malloc(iLinePitch * iBlockRowCount * oFormatInfos.iBlockHeight);
+		if (*ppWorking == NULL)
+			return NULL;
+
+		ConvertPixelFormatRegion(
+			pSlice + (size_t)(iStartY / oFormatInfos.iBlockHeight) * oFaceData.iPitch, oFaceData.iPitch, oSource.ePixelFormat,
+			*ppWorking, iLinePitch, oSource.eWorkingFormat,
+			oFaceData.iWidth, iEndY - iStartY,
+			*oSource.pDecodeChain, oSource.iDecodeChainLength);
+		return (const float*)*ppWorking;
+	}
+
+	static void AccumulateMomentsScalar(const float* pPixels, int iStride, int iCount, StatisticsPartial* pPartial)
+	{
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+		{
+			const float* pPixel = pPixels + (size_t)iIndex * iStride;
+			for (int iChannel = 0; iChannel < iStride; ++iChannel)
+			{
+				const float fValue = pPixel[iChannel];
+				if (IsFinite(fValue))
+				{
+					pPartial->fMin[iChannel] = Math::Min(pPartial->fMin[iChannel], fValue);
+					pPartial->fMax[iChannel] = Math::Max(pPartial->fMax[iChannel], fValue);
+					const double fDelta = fValue - pPartial->fReference[iChannel];
+					pPartial->fSum[iChannel] += fDelta;
+					pPartial->fSumSquares[iChannel] += fDelta * fDelta;
+				}
+				else if (IsNaN(fValue))
+				{
+					++pPartial->iNaNCount[iChannel];
+				}
+				else
+				{
+					++pPartial->iInfCount[iChannel];
+				}
+			}
+		}
+	}
+
+	// RGBA float pixels, pixels containing a non finite component take the scalar path
+	static void AccumulateMomentsRGBA(const float* pPixels, int iCount, StatisticsPartial* pPartial)
+	{
+		const __m128i xExponentMask = _mm_set1_epi32(0x7F800000);
+		const __m128d xReference0 = _mm_loadu_pd(pPartial->fReference);
+		const __m128d xReference1 = _mm_loadu_pd(pPartial->fReference + 2);
+		__m128 xMin = _mm_loadu_ps(pPartial->fMin);
+		__m128 xMax = _mm_loadu_ps(pPartial->fMax);
+		__m128d xSum0 = _mm_setzero_pd();
+		__m128d xSum1 = _mm_setzero_pd();
+		__m128d xSumSquares0 = _mm_setzero_pd();
+		__m128d xSumSquares1 = _mm_setzero_pd();
+
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+		{
+			const __m128 xPixel = _mm_loadu_ps(pPixels + (size_t)iIndex * 4);
+			const __m128i xNonFinite = _mm_cmpeq_epi32(_mm_and_si128(_mm_castps_si128(xPixel), xExponentMask), xExponentMask);
+			if (_mm_movemask_epi8(xNonFinite) != 0)
+			{
+				AccumulateMomentsScalar(pPixels + (size_t)iIndex * 4, 4, 1, pPartial);
+				continue;
+			}
+
+			xMin = _mm_min_ps(xMin, xPixel);
+			xMax = _mm_max_ps(xMax, xPixel);
+			const __m128d xDelta0 = _mm_sub_pd(_mm_cvtps_pd(xPixel), xReference0);
+			const __m128d xDelta1 = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(xPixel, xPixel)), xReference1);
+			xSum0 = _mm_add_pd(xSum0, xDelta0);
+			xSum1 = _mm_add_pd(xSum1, xDelta1);
+			xSumSquares0 = _mm_add_pd(xSumSquares0, _mm_mul_pd(xDelta0, xDelta0));
+			xSumSquares1 = _mm_add_pd(xSumSquares1, _mm_mul_pd(xDelta1, xDelta1));
+		}
+
+		// Scalar path may have updated the partial
+		_mm_storeu_ps(pPartial->fMin, _mm_min_ps(xMin, _mm_loadu_ps(pPartial->fMin)));
+		_mm_storeu_ps(pPartial->fMax, _mm_max_ps(xMax, _mm_loadu_ps(pPartial->fMax)));
+		_mm_storeu_pd(pPartial->fSum, _mm_add_pd(xSum0, _mm_loadu_pd(pPartial->fSum)));
+		_mm_storeu_pd(pPartial->fSum + 2, _mm_add_pd(xSum1, _mm_loadu_pd(pPartial->fSum + 2)));
+		_mm_storeu_pd(pPartial->fSumSquares, _mm_add_pd(xSumSquares0, _mm_loadu_pd(pPartial->fSumSquares)));
+		_mm_storeu_pd(pPartial->fSumSquares + 2, _mm_add_pd(xSumSquares1, _mm_loadu_pd(pPartial->fSumSquares + 2)));
+	}
+
+	static void AccumulateHistogram(const float* pPixels, int iStride, int iCount, const float* pMin, const float* pScale, int iBinCount, uint64_t* pHistograms)
+	{
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+		{
+			const float* pPixel = pPixels + (size_t)iIndex * iStride;
+			for (int iChannel = 0; iChannel < iStride; ++iChannel)
+			{
+				const float fValue = pPixel[iChannel];
+				if (IsFinite(fValue) == false)
+					continue;
+				int iBin = (int)((fValue - pMin[iChannel]) * pScale[iChannel]);
+				iBin = iBin < 0 ? 0 : (iBin >= iBinCount ? iBinCount - 1 : iBin);
+				++pHistograms[(size_t)iChannel * iBinCount + iBin];
+			}
+		}
+	}
+
+	// RGBA float pixels, bins of the 4 channels are computed together, pixels containing a non finite component take the scalar path
+	static void AccumulateHistogramRGBA(const float* pPixels, int iCount, const float* pMin, const float* pScale, int iBinCount, uint64_t* pHistograms)
+	{
+		const __m128i xExponentMask = _mm_set1_epi32(0x7F800000);
+		const __m128 xMin = _mm_loadu_ps(pMin);
+		const __m128 xScale = _mm_loadu_ps(pScale);
+		const __m128 xLastBin = _mm_set1_ps((float)(iBinCount - 1));
+		const __m128i xChannelOffsets = _mm_set_epi32(3 * iBinCount, 2 * iBinCount, iBinCount, 0);
+		for (int iIndex = 0; iIndex < iCount; ++iIndex)
+		{
+			const __m128 xPixel = _mm_loadu_ps(pPixels + (size_t)iIndex * 4);
+			const __m128i xNonFinite = _mm_cmpeq_epi32(_mm_and_si128(_mm_castps_si128(xPixel), xExponentMask), xExponentMask);
+			if (_mm_movemask_epi8(xNonFinite) != 0)
+			{
+				AccumulateHistogram(pPixels + (size_t)iIndex * 4, 4, 1, pMin, pScale, iBinCount, pHistograms);
+				continue;
+			}
+
+			const __m128 xBin = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(xPixel, xMin), xScale), _mm_setzero_ps()), xLastBin);
+			const __m128i xIndices = _mm_add_epi32(_mm_cvttps_epi32(xBin), xChannelOffsets);
+			++pHistograms[_mm_cvtsi128_si32(xIndices)];
+			++pHistograms[_mm_cvtsi128_si32(_mm_shuffle_epi32(xIndices, _MM_SHUFFLE(1, 1, 1, 1)))];
+			++pHistograms[_mm_cvtsi128_si32(_mm_shuffle_epi32(xIndices, _MM_SHUFFLE(2, 2, 2, 2)))];
+			++pHistograms[_mm_cvtsi128_si32(_mm_shuffle_epi32(xIndices, _MM_SHUFFLE(3, 3, 3, 3)))];
+		}
+	}
+
+	ErrorCode ComputeTextureStatistics(const Texture* pTexture, int iMip, int iFace, int iLayer, TextureStatistics* pOutStatistics, const StatisticsSettings* pSettings)
+	{
+		if (pTexture == NULL || pOutStatistics == NULL || pTexture->IsValid() == false
+			|| iMip < 0 || iMip >= pTexture->GetMipCount()
+			|| iFace < 0 || iFace >= pTexture->GetFaceCount()
+			|| iLayer < 0 || iLayer >= pTexture->GetArraySize())
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		StatisticsSettings oDefaultSettings;
+		const StatisticsSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+		if (oSettings.iHistogramBinCount < 0 || oSettings.iHistogramBinCount > c_iMaxHistogramBinCount)
+		{
+			return ErrorCode(1, "Invalid histogram bin count");
+		}
+
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+
+		// Decode to RGBA or RGB float
+		PixelFormatEnum eWorkingFormat = PixelFormatEnum::RGBA32_FLOAT;
+		PixelFormat::ConvertionFuncChain oDecodeChain;
+		int iDecodeChainLength = 0;
+		int iAdditionalBits;
+		if (ePixelFormat != PixelFormatEnum::RGBA32_FLOAT && ePixelFormat != PixelFormatEnum::RGB32_FLOAT)
+		{
+			if (PixelFormat::GetConvertionChain(ePixelFormat, PixelFormatEnum::RGBA32_FLOAT, &oDecodeChain, &iDecodeChainLength, &iAdditionalBits) == false)
+			{
+				eWorkingFormat = PixelFormatEnum::RGB32_FLOAT;
+				if (PixelFormat::GetConvertionChain(ePixelFormat, PixelFormatEnum::RGB32_FLOAT, &oDecodeChain, &iDecodeChainLength, &iAdditionalBits) == false)
+				{
+					return ErrorCode(1, "'%s' Pixel format can't be decoded", PixelFormatEnumInfos[ePixelFormat].pName);
+				}
+			}
+		}
+		else
+		{
+			eWorkingFormat = ePixelFormat;
+		}
+
+		const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+		const int iWidth = oFaceData.iWidth;
+		const int iStride = PixelFormatEnumInfos[eWorkingFormat].iComponents;
+		const int iBandCount = (oFaceData.iHeight + c_iStatisticsBandHeight - 1) / c_iStatisticsBandHeight;
+		const int iJobCount = oFaceData.iDepth * iBandCount;
+		const StatisticsSource oSource = { &oFaceData, ePixelFormat, eWorkingFormat, &oDecodeChain, iDecodeChainLength, iStride, iBandCount };
+
+		Core::Array<StatisticsPartial> oPartials;
+		if (oPartials.resize(iJobCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		bool bError = false;
+
+		// First pass : moments
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			StatisticsPartial& oPartial = oPartials[iJob];
+			memset(&oPartial, 0, sizeof(oPartial));
+			for (int iChannel = 0; iChannel < 4; ++iChannel)
+			{
+				oPartial.fMin[iChannel] = FLT_MAX;
+				oPartial.fMax[iChannel] = -FLT_MAX;
+			}
+
+			CORE_PTR_VOID pWorking = CORE_PTR_NULL;
+			int iStartY, iEndY;
+			const float* pLines = GetBandLines(oSource, iJob, &pWorking, &iStartY, &iEndY);
+			if (pLines == NULL)
+			{
+				bError = true;
+				continue;
+			}
+
+			for (int iChannel = 0; iChannel < iStride; ++iChannel)
+				oPartial.fReference[iChannel] = IsFinite(pLines[iChannel]) ? pLines[iChannel] : 0.0;
+			oPartial.iPixelCount = (uint64_t)iWidth * (iEndY - iStartY);
+
+			for (int iY = iStartY; iY < iEndY; ++iY)
+			{
+				const float* pLine = (oSource.iDecodeChainLength > 0)
+					? pLines + (size_t)iWidth * iStride * (iY - iStartY)
+					: (const float*)((const char*)pLines + oFaceData.iPitch * (iY - iStartY));
+				if (iStride == 4)
+					AccumulateMomentsRGBA(pLine, iWidth, &oPartial);
+				else
+					AccumulateMomentsScalar(pLine, iStride, iWidth, &oPartial);
+			}
+
+			if (pWorking != NULL)
+				Core::Free(pWorking);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		// Partials are merged in job order (Chan et al. pairwise update) so results don't depend on threads
+		TextureStatistics& oStatistics = *pOutStatistics;
+		oStatistics.iChannelCount = Math::Min(PixelFormatEnumInfos[ePixelFormat].iComponents, 4);
+		oStatistics.iPixelCount = (uint64_t)iWidth * oFaceData.iHeight * oFaceData.iDepth;
+		for (int iChannel = 0; iChannel < 4; ++iChannel)
+		{
+			ChannelStatistics& oChannel = oStatistics.oChannels[iChannel];
+			memset(&oChannel, 0, sizeof(oChannel));
+			oChannel.fMin = FLT_MAX;
+			oChannel.fMax = -FLT_MAX;
+			double fM2 = 0.0;
+			for (int iJob = 0; iJob < iJobCount; ++iJob)
+			{
+				const StatisticsPartial& oPartial = oPartials[iJob];
+				oChannel.iNaNCount += oPartial.iNaNCount[iChannel];
+				oChannel.iInfCount += oPartial.iInfCount[iChannel];
+				const uint64_t iJobFiniteCount = oPartial.iPixelCount - oPartial.iNaNCount[iChannel] - oPartial.iInfCount[iChannel];
+				if (iChannel >= iStride || iJobFiniteCount == 0)
+					continue;
+
+				oChannel.fMin = Math::Min(oChannel.fMin, oPartial.fMin[iChannel]);
+				oChannel.fMax = Math::Max(oChannel.fMax, oPartial.fMax[iChannel]);
+				const double fJobMean = oPartial.fReference[iChannel] + oPartial.fSum[iChannel] / (double)iJobFiniteCount;
+				const double fJobM2 = Math::Max(oPartial.fSumSquares[iChannel] - oPartial.fSum[iChannel] * oPartial.fSum[iChannel] / (double)iJobFiniteCount, 0.0);
+				const uint64_t iTotalCount = oChannel.iFiniteCount + iJobFiniteCount;
+				const double fDelta = fJobMean - oChannel.fMean;
+				oChannel.fMean += fDelta * (double)iJobFiniteCount / (double)iTotalCount;
+				fM2 += fJobM2 + fDelta * fDelta * (double)oChannel.iFiniteCount * (double)iJobFiniteCount / (double)iTotalCount;
+				oChannel.iFiniteCount = iTotalCount;
+			}
+
+			if (oChannel.iFiniteCount > 0)
+			{
+				oChannel.fVariance = fM2 / (double)oChannel.iFiniteCount;
+			}
+			else
+			{
+				oChannel.fMin = 0.f;
+				oChannel.fMax = 0.f;
+			}
+		}
+
+		// Second pass : histograms of [min, max]
+		oStatistics.iHistogramBinCount = oSettings.iHistogramBinCount;
+		const size_t iHistogramSize = (size_t)oSettings.iHistogramBinCount * 4;
+		if (oStatistics.oHistograms.resize(iHistogramSize, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate histograms");
+		}
+		if (iHistogramSize == 0)
+		{
+			return ErrorCode::Ok;
+		}
+		memset(oStatistics.oHistograms.begin(), 0, iHistogramSize * sizeof(uint64_t));
+
+		float fMin[4];
+		float fScale[4];
+		for (int iChannel = 0; iChannel < 4; ++iChannel)
+		{
+			const ChannelStatistics& oChannel = oStatistics.oChannels[iChannel];
+			fMin[iChannel] = oChannel.fMin;
+			fScale[iChannel] = (oChannel.fMax > oChannel.fMin) ? (float)(oSettings.iHistogramBinCount / ((double)oChannel.fMax - oChannel.fMin)) : 0.f;
+		}
+
+#ifndef DEBUG
+		const int iThreadCount = omp_get_max_threads();
+#else
+		const int iThreadCount = 1;
+#endif
+		Core::Array<uint64_t> oThreadHistograms;
+		if (oThreadHistograms.resize(iHistogramSize * iThreadCount, false) == false)
+		{
+			return ErrorCode(1, "Can't allocate histograms");
+		}
+		memset(oThreadHistograms.begin(), 0, iHistogramSize * iThreadCount * sizeof(uint64_t));
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+#ifndef DEBUG
+			uint64_t* pHistograms = oThreadHistograms.begin() + iHistogramSize * omp_get_thread_num();
+#else
+			uint64_t* pHistograms = oThreadHistograms.begin();
+#endif
+			CORE_PTR_VOID pWorking = CORE_PTR_NULL;
+			int iStartY, iEndY;
+			const float* pLines = GetBandLines(oSource, iJob, &pWorking, &iStartY, &iEndY);
+			if (pLines == NULL)
+			{
+				bError = true;
+				continue;
+			}
+
+			for (int iY = iStartY; iY < iEndY; ++iY)
+			{
+				const float* pLine = (oSource.iDecodeChainLength > 0)
+					? pLines + (size_t)iWidth * iStride * (iY - iStartY)
+					: (const float*)((const char*)pLines + oFaceData.iPitch * (iY - iStartY));
+				if (iStride == 4)
+					AccumulateHistogramRGBA(pLine, iWidth, fMin, fScale, oSettings.iHistogramBinCount, pHistograms);
+				else
+					AccumulateHistogram(pLine, iStride, iWidth, fMin, fScale, oSettings.iHistogramBinCount, pHistograms);
+			}
+
+			if (pWorking != NULL)
+				Core::Free(pWorking);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffers");
+		}
+
+		for (int iThread = 0; iThread < iThreadCount; ++iThread)
+		{
+			const uint64_t* pHistograms = oThreadHistograms.begin() + iHistogramSize * iThread;
+			for (size_t iBin = 0; iBin < iHistogramSize; ++iBin)
+				oStatistics.oHistograms[iBin] += pHistograms[iBin];
+		}
+
+		return ErrorCode::Ok;
+	}
+
+	StatisticsCache::StatisticsCache()
+	{
+		m_iUseCounter = 0;
+		Clear();
+	}
+
+	ErrorCode StatisticsCache::Get(const Texture* pTexture, int iMip, int iFace, int iLayer, const TextureStatistics** ppOutStatistics, const StatisticsSettings* pSettings)
+	{
+		if (pTexture == NULL || ppOutStatistics == NULL || pTexture->IsValid() == false
+			|| iMip < 0 || iMip >= pTexture->GetMipCount()
+			|| iFace < 0 || iFace >= pTexture->GetFaceCount()
+			|| iLayer < 0 || iLayer >= pTexture->GetArraySize())
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		StatisticsSettings oDefaultSettings;
+		const StatisticsSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+		const uint64_t iRevision = pTexture->GetRevision(iMip, iFace, iLayer);
+
+		// Hit, or least recently used entry
+		int iEntry = 0;
+		for (int iIndex = 0; iIndex < c_iMaxEntries; ++iIndex)
+		{
+			const Entry& oEntry = m_oEntries[iIndex];
+			if (oEntry.iRevision == iRevision && oEntry.oStatistics.iHistogramBinCount == oSettings.iHistogramBinCount)
+			{
+				m_oEntries[iIndex].iLastUse = ++m_iUseCounter;
+				*ppOutStatistics = &oEntry.oStatistics;
+				return ErrorCode::Ok;
+			}
+			if (oEntry.iLastUse < m_oEntries[iEntry].iLastUse)
+				iEntry = iIndex;
+		}
+
+		Entry& oEntry = m_oEntries[iEntry];
+		ErrorCode oErr = ComputeTextureStatistics(pTexture, iMip, iFace, iLayer, &oEntry.oStatistics, &oSettings);
+		if (oErr != ErrorCode::Ok)
+		{
+			oEntry.iRevision = 0;
+			oEntry.iLastUse = 0;
+			return oErr;
+		}
+		oEntry.iRevision = iRevision;
+		oEntry.iLastUse = ++m_iUseCounter;
+		*ppOutStatistics = &oEntry.oStatistics;
+		return ErrorCode::Ok;
+	}
+
+	void StatisticsCache::Clear()
+	{
+		for (int iIndex = 0; iIndex < c_iMaxEntries; ++iIndex)
+		{
+			m_oEntries[iIndex].iRevision = 0;
+			m_oEntries[iIndex].iLastUse = 0;
+		}
+	}
+}
+//namespace Graphics
@@ -0,0 +1,71 @@
+#ifndef __GRAPHICS_TEXTURE_STATISTICS_H__
+#define __GRAPHICS_TEXTURE_STATISTICS_H__
+
+#include "Core/Array.h"
+#include "Core/ErrorCode.h"
+
+#include "Graphics/Texture.h"
+
+namespace Graphics
+{
+	/* Per-channel statistics of a texture subresource (all slices of volumes)
+	Any decodable format is decoded to float in bands, sRGB formats give linear values, RGBA32 float is read in place.
+	Min, max, mean and variance only use finite values, NaN and infinities are counted apart.
+	Histograms cover [fMin, fMax] of each channel and are filled by a second pass in per-thread accumulators.
+	*/
+	struct ChannelStatistics
+	{
+		float						fMin;
+		float						fMax;
+		double						fMean;
+		double						fVariance; // Population variance
+		uint64_t					iFiniteCount;
+		uint64_t					iNaNCount;
+		uint64_t					iInfCount;
+	};
+
+	struct TextureStatistics
+	{
+		TextureStatistics();
+		const uint64_t*				GetHistogram(int iChannel) const { return oHistograms.begin() + (size_t)iChannel * iHistogramBinCount; }
+
+		int							iChannelCount; // Components of the pixel format
+		uint64_t					iPixelCount;
+		ChannelStatistics			oChannels[4];
+		int							iHistogramBinCount;
+		Core::Array<uint64_t>		oHistograms; // iHistogramBinCount bins for each of the 4 channels
+	};
+
+	struct StatisticsSettings
+	{
+		StatisticsSettings();
+		int							iHistogramBinCount; // 0 to skip the histogram pass
+	};
+
+	ErrorCode						ComputeTextureStatistics(const Texture* pTexture, int iMip, int iFace, int iLayer, TextureStatistics* pOutStatistics, const StatisticsSettings* pSettings = NULL);
+
+	// Statistics of the last analyzed subresources, keyed by subresource revision so modified data is analyzed again
+	class StatisticsCache
+	{
+	public:
+		static const int			c_iMaxEntries = 8;
+
+		StatisticsCache();
+
+		ErrorCode					Get(const Texture* pTexture, int iMip, int iFace, int iLayer, const TextureStatistics** ppOutStatistics, const StatisticsSettings* pSettings = NULL);
+		void						Clear();
+	protected:
+		struct Entry
+		{
+			uint64_t				iRevision; // 0 for an unused entry
+			uint64_t				iLastUse;
+			TextureStatistics		oStatistics;
+		};
+
+		Entry						m_oEntries[c_iMaxEntries];
+		uint64_t					m_iUseCounter;
+	};
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_TEXTURE_STATISTICS_H__
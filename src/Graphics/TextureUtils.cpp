@@ -1,5 +1,12 @@
 #include "Graphics/TextureUtils.h"
 
+#include "Graphics/TiledTexture.h"
+#include "Graphics/MipReduction.h"
+#include "Graphics/Resampling.h"
+#include "Graphics/CubemapSampling.h"
+#include "Graphics/BlockCompression.h"
+#include "Graphics/PixelFormatConverters.h"
+
 #include "Core/Assert.h"
 #include "Core/FileStream.h"
 #include "Core/StringUtils.h"
@@ -9,6 +16,7 @@
 #include <string.h> //memcpy/memset
 #include <emmintrin.h> //SIMD
 #include <math.h> // sqrt/cos/sin/..
+#include <chrono> // steady_clock
 
 #include "stb_image_resize.h"
 
@@ -159,175 +167,256 @@ namespace Graphics
 		return false;
 	}
 
-	ErrorCode ConvertTextureToCubemap(const Graphics::Texture& oTexture, Graphics::Texture* pOutCubemap)
+	void ConvertPixelFormatRegion(const void* pSource, size_t iSourcePitch, PixelFormatEnum eSourcePixelFormat, void* pDest, size_t iDestPitch, PixelFormatEnum eDestPixelFormat, int iWidth, int iHeight, const PixelFormat::ConvertionFuncChain& oConvertionFuncChain, int iConvertionChainLength)
 	{
-		if (pOutCubemap == NULL)
+		const PixelFormatInfos& oSrcPFInfos = PixelFormatEnumInfos[eSourcePixelFormat];
+		const PixelFormatInfos& oDstPFInfos = PixelFormatEnumInfos[eDestPixelFormat];
+
+		if (iConvertionChainLength == 0)
 		{
-			return ErrorCode(1, "Out cubemap texture argument is null");
+			// Same format, copy block rows
+			CORE_ASSERT(eSourcePixelFormat == eDestPixelFormat);
+			uint32_t iBlockX, iBlockY;
+			PixelFormat::GetBlockCount(eSourcePixelFormat, iWidth, iHeight, &iBlockX, &iBlockY);
+			for (uint32_t iBlockRow = 0; iBlockRow < iBlockY; ++iBlockRow)
+			{
+				memcpy((char*)pDest + iBlockRow * iDestPitch, (const char*)pSource + iBlockRow * iSourcePitch, (size_t)iBlockX * oSrcPFInfos.iBlockSize);
+			}
+			return;
 		}
 
-		int iSourceWidth = oTexture.GetWidth();
-		int iSourceHeight = oTexture.GetHeight();
-
-		ECubemapFormat eCubemapFormat;
-		int iFaceSize;
+		uint32_t iSrcBlockX;
+		uint32_t iSrcBlockY;
+		PixelFormat::GetBlockCount(eSourcePixelFormat, iWidth, iHeight, &iSrcBlockX, &iSrcBlockY);
 
-		if (oTexture.GetFaceCount() != 1)
-		{
-			return ErrorCode(1, "Source texture need to have only one face data when bDataIsCubemap is true");
-		}
+		uint32_t iDstBlockX;
+		uint32_t iDstBlockY;
+		PixelFormat::GetBlockCount(eDestPixelFormat, iWidth, iHeight, &iDstBlockX, &iDstBlockY);
 
-		if (DetermineCubemapFormatFromImageSize(iSourceWidth, iSourceHeight, &eCubemapFormat, &iFaceSize) == false)
-		{
-			return ErrorCode(1, "Source is not a valid cubemap format");
-		}
+		// Convertion functions expect pitches in pixels
+		uint32_t iSrcPixelPitch = (uint32_t)(iSourcePitch / oSrcPFInfos.iBlockSize * oSrcPFInfos.iBlockWidth);
+		uint32_t iDstPixelPitch = (uint32_t)(iDestPitch / oDstPFInfos.iBlockSize * oDstPFInfos.iBlockWidth);
+		size_t iSourceSize = iSourcePitch * iSrcBlockY;
+		size_t iDestSize = iDestPitch * iDstBlockY;
 
-		Texture::Desc oDesc;
-		oDesc.ePixelFormat = oTexture.GetPixelFormat();
-		oDesc.iWidth = oDesc.iHeight = iFaceSize;
-		oDesc.iFaceCount = 6;
-		oDesc.iMipCount = oTexture.GetMipCount();
+		uint32_t iMipWidth = Math::Min(iSrcBlockX * oSrcPFInfos.iBlockWidth, iDstBlockX * oDstPFInfos.iBlockWidth);
+		uint32_t iMipHeight = Math::Min(iSrcBlockY * oSrcPFInfos.iBlockHeight, iDstBlockY * oDstPFInfos.iBlockHeight);
+		uint32_t iPaddingX = Math::Max(oSrcPFInfos.iBlockWidth , oDstPFInfos.iBlockWidth);
+		uint32_t iPaddingY = Math::Max(oSrcPFInfos.iBlockHeight, oDstPFInfos.iBlockHeight);
 
-		size_t iBits = PixelFormat::BitPerPixel(oTexture.GetPixelFormat());
-		for (int iMip = 0, iMipCount = oTexture.GetMipCount(); iMip < iMipCount; ++iMip)
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+		for (int iY = 0; iY < (int)iMipHeight; iY += iPaddingY)
 		{
-			int iCubeMapSourceWidthMinusOne = iSourceWidth - 1;
-			int iCubeMapSourceHeighthMinusOne = iSourceHeight - 1;
-			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+			for (int iX = 0; iX < (int)iMipWidth; iX += iPaddingX)
 			{
-				const Texture::TextureFaceData& oFaceData = pOutCubemap->GetData().GetFaceData(iMip, iFace);
-
-				if (eCubemapFormat != E_CUBEMAPFORMAT_LATLONG)
+				PixelFormat::ConvertionTemporaryData oConvertionTempData[2];
+				PixelFormat::ConvertionTemporaryData oSourceStage;
+				PixelFormat::ConvertionTemporaryData oDestStage;
+				void* pSourceData = (char*)pSource + (size_t)(iY / oSrcPFInfos.iBlockHeight) * iSourcePitch + (size_t)(iX / oSrcPFInfos.iBlockWidth * oSrcPFInfos.iBlockSize);
+				void* pNewData = (char*)pDest + (size_t)(iY / oDstPFInfos.iBlockHeight) * iDestPitch + (size_t)(iX / oDstPFInfos.iBlockWidth * oDstPFInfos.iBlockSize);
+
+				int iTW = Math::Min(iPaddingX, iMipWidth - iX);
+				int iTH = Math::Min(iPaddingY, iMipHeight - iY);
+
+				// Partial tile (image smaller than a block): block convertion functions
+				// read/write full blocks, stage uncompressed side in a padded buffer
+				bool bPartial = iTW < (int)iPaddingX || iTH < (int)iPaddingY;
+				bool bStageSource = bPartial && (oSrcPFInfos.iBlockWidth < iPaddingX || oSrcPFInfos.iBlockHeight < iPaddingY);
+				bool bStageDest = bPartial && (oDstPFInfos.iBlockWidth < iPaddingX || oDstPFInfos.iBlockHeight < iPaddingY);
+				if (bStageSource)
 				{
-					int iX, iY;
-					if (GetCubemapFacePos(iSourceWidth, iSourceHeight, eCubemapFormat, (Texture::EFace)iFace, &iX, &iY) == false)
-					{
-						CORE_ASSERT(false);
-					}
-					for (int iLine = 0; iLine < iFaceSize; ++iLine)
+					// Replicate edge pixels
+					for (int iTY = 0; iTY < (int)iPaddingY; ++iTY)
 					{
-						char* pSource = (char*)oTexture.GetData().GetFaceData(iMip, 0).pData + (iX + (iY + iLine) * iSourceWidth) * iBits / 8;
-						char* pDest = (char*)oFaceData.pData + iLine * iFaceSize * iBits / 8;
-						memcpy(pDest, pSource, iFaceSize * iBits / 8);
+						for (int iTX = 0; iTX < (int)iPaddingX; ++iTX)
+						{
+							const char* pPixel = (const char*)pSourceData + (size_t)Math::Min(iTY, iTH - 1) * iSourcePitch + (size_t)Math::Min(iTX, iTW - 1) * oSrcPFInfos.iBlockSize;
+							memcpy(oSourceStage + (size_t)(iTY * iPaddingX + iTX) * oSrcPFInfos.iBlockSize, pPixel, oSrcPFInfos.iBlockSize);
+						}
 					}
+					pSourceData = oSourceStage;
 				}
-				else
+				if (bPartial)
+				{
+					iTW = iPaddingX;
+					iTH = iPaddingY;
+				}
+
+				PixelFormatEnum eCurrentFormat = eSourcePixelFormat;
+				uint32_t iCurrentBits = PixelFormat::BitPerPixel(eCurrentFormat);
+				uint32_t iCurrentPaddingX, iCurrentPaddingY;
+
+				iCurrentPaddingX = PixelFormatEnumInfos[eCurrentFormat].iBlockWidth;
+				iCurrentPaddingY = PixelFormatEnumInfos[eCurrentFormat].iBlockHeight;
+
+				for (int iChain = 0; iChain < iConvertionChainLength; ++iChain)
 				{
-					const float c_fPi = 3.14159265358979323846f;
-					const float c_fInvPi = 0.31830988618379067153f;
-					const float c_f2Pi = 6.28318530717958647692f;
+					bool bFirst = iChain == 0 && !bStageSource;
+					bool bLast = iChain == (iConvertionChainLength - 1) && !bStageDest;
+					void* pInputData = (iChain == 0) ? pSourceData : ((iChain % 2 == 0) ? &oConvertionTempData[0] : &oConvertionTempData[1]);
+					size_t iInputSize = bFirst ? (iSourceSize - size_t((char*)pSourceData - (char*)pSource)) : sizeof(PixelFormat::ConvertionTemporaryData);
+					void* pOutputData = (iChain == (iConvertionChainLength - 1)) ? (bStageDest ? oDestStage : pNewData) : ((iChain % 2 == 0) ? &oConvertionTempData[1] : &oConvertionTempData[0]);
+					size_t iOutputSize = bLast ? (iDestSize - size_t((char*)pNewData - (char*)pDest)) : sizeof(PixelFormat::ConvertionTemporaryData);
 
-					const float c_fFaceUvVectors[6][3][4] = // Last value is useless but necessary for sse loading
+					uint32_t iInputPitch = bFirst ? iSrcPixelPitch : iPaddingX;
+					uint32_t iOutputPitch = bLast ? iDstPixelPitch : iPaddingX;
+
+					PixelFormat::ConvertionFuncInfo oFunc = oConvertionFuncChain[iChain];
+
+					uint32_t iNextBits = PixelFormat::BitPerPixel(oFunc.eFormat);
+
+					uint32_t iNextPaddingX, iNextPaddingY;
+					iNextPaddingX = PixelFormatEnumInfos[oFunc.eFormat].iBlockWidth;
+					iNextPaddingY = PixelFormatEnumInfos[oFunc.eFormat].iBlockHeight;
+
+					uint32_t iFuncPaddingX = Math::Max(iCurrentPaddingX, iNextPaddingX);
+					uint32_t iFuncPaddingY = Math::Max(iCurrentPaddingY, iNextPaddingY);
+
+					for (int iTY = 0; iTY < iTH; iTY += iFuncPaddingY)
 					{
-						{ // +x
-							{ 0.0f,  0.0f, -1.0f, 0.f },
-							{ 0.0f, -1.0f,  0.0f, 0.f },
-							{ 1.0f,  0.0f,  0.0f, 0.f }
-						},
-						{ // -x
-							{ 0.0f,  0.0f,  1.0f, 0.f },
-							{ 0.0f, -1.0f,  0.0f, 0.f },
-							{ -1.0f, 0.0f,  0.0f, 0.f }
-						},
-						{ // +y
-							{ 1.0f,  0.0f,  0.0f, 0.f },
-							{ 0.0f,  0.0f,  1.0f, 0.f },
-							{ 0.0f,  1.0f,  0.0f, 0.f }
-						},
-						{ // -y
-							{ 1.0f,  0.0f,  0.0f, 0.f },
-							{ 0.0f,  0.0f, -1.0f, 0.f },
-							{ 0.0f, -1.0f,  0.0f, 0.f }
-						},
-						{ // +z
-							{ 1.0f,  0.0f,  0.0f, 0.f },
-							{ 0.0f, -1.0f,  0.0f, 0.f },
-							{ 0.0f,  0.0f,  1.0f, 0.f }
-						},
-						{ // -z
-							{ -1.0f, 0.0f,  0.0f, 0.f },
-							{ 0.0f, -1.0f,  0.0f, 0.f },
-							{ 0.0f,  0.0f, -1.0f, 0.f }
+						for (int iTX = 0; iTX < iTW; iTX += iFuncPaddingX)
+						{
+							void* pTempInput = (char*)pInputData + (size_t)(iTY * iInputPitch + iTX) * iCurrentBits / 8;
+							void* pTempOutput = (char*)pOutputData + (size_t)(iTY * iOutputPitch + iTX) * iNextBits / 8;
+
+							CORE_ASSERT(pTempInput >= pInputData && pTempInput <= ((char*)pInputData + iInputSize ));
+							CORE_ASSERT(pTempOutput >= pOutputData && pTempOutput <= ((char*)pOutputData + iOutputSize));
+							oFunc.pFunc(pTempInput, pTempOutput, iInputPitch, iOutputPitch);
 						}
-					};
+					}
+
+					eCurrentFormat = oFunc.eFormat;
+					iCurrentBits = iNextBits;
+					iCurrentPaddingX = iNextPaddingX;
+					iCurrentPaddingY = iNextPaddingY;
+				}
+
+				if (bStageDest)
+				{
+					int iValidWidth = Math::Min(iPaddingX, iMipWidth - iX);
+					int iValidHeight = Math::Min(iPaddingY, iMipHeight - iY);
+					for (int iTY = 0; iTY < iValidHeight; ++iTY)
+					{
+						memcpy((char*)pNewData + (size_t)iTY * iDestPitch, oDestStage + (size_t)iTY * iPaddingX * oDstPFInfos.iBlockSize, (size_t)iValidWidth * oDstPFInfos.iBlockSize);
+					}
+				}
+			}
+		}
+	}
+
+	static const int c_iInPlaceBandHeight = 8;
+	static const size_t c_iInPlaceBufferSize = 16 * 1024;
+
+	// Uncompressed formats of the same pixel size, the texture layout doesn't change
+	static bool IsConvertibleInPlace(PixelFormatEnum eSourcePixelFormat, PixelFormatEnum eDestPixelFormat)
+	{
+		const PixelFormatInfos& oSrcPFInfos = PixelFormatEnumInfos[eSourcePixelFormat];
+		const PixelFormatInfos& oDstPFInfos = PixelFormatEnumInfos[eDestPixelFormat];
+		return oSrcPFInfos.iBlockWidth == 1 && oSrcPFInfos.iBlockHeight == 1
+			&& oDstPFInfos.iBlockWidth == 1 && oDstPFInfos.iBlockHeight == 1
+			&& oSrcPFInfos.iBlockSize == oDstPFInfos.iBlockSize;
+	}
+
+	// Chains made of RGBA8/BGRA8 swizzles and UNorm/sRGB reinterpretations, returns if red and blue are swapped
+	static bool IsRedBlueSwapChain(const PixelFormat::ConvertionFuncChain& oConvertionFuncChain, int iConvertionChainLength, bool* pOutSwap)
+	{
+		bool bSwap = false;
+		for (int iChain = 0; iChain < iConvertionChainLength; ++iChain)
+		{
+			PixelFormat::ConvertionFunc pFunc = oConvertionFuncChain[iChain].pFunc;
+			if (pFunc == PixelFormat::Converters::Convert_BGRA8_To_RGBA8 || pFunc == PixelFormat::Converters::Convert_RGBA8_To_BGRA8)
+				bSwap = !bSwap;
+			else if (pFunc != PixelFormat::Converters::Convert_Raw32)
+				return false;
+		}
+		*pOutSwap = bSwap;
+		return true;
+	}
+
+	// Each pixel is read before being written
+	static void SwapRedBlue(uint32_t* pPixels, int iCount)
+	{
+		const __m128i vRedBlueMask = _mm_set1_epi32(0x00FF00FF);
+		int iPixel = 0;
+		for (; iPixel + 4 <= iCount; iPixel += 4)
+		{
+			__m128i vPixels = _mm_loadu_si128((const __m128i*)(pPixels + iPixel));
+			__m128i vRedBlue = _mm_and_si128(vPixels, vRedBlueMask);
+			__m128i vGreenAlpha = _mm_andnot_si128(vRedBlueMask, vPixels);
+			__m128i vSwapped = _mm_or_si128(_mm_srli_epi32(vRedBlue, 16), _mm_slli_epi32(vRedBlue, 16));
+			_mm_storeu_si128((__m128i*)(pPixels + iPixel), _mm_or_si128(vSwapped, vGreenAlpha));
+		}
+		for (; iPixel < iCount; ++iPixel)
+		{
+			uint32_t iValue = pPixels[iPixel];
+			pPixels[iPixel] = (iValue & 0xFF00FF00) | ((iValue >> 16) & 0xFF) | ((iValue & 0xFF) << 16);
+		}
+	}
+
+	// Same size formats are converted by bands of rows without a second texture, halving peak memory
+	// Swizzles use a vector kernel on the texture data, other chains convert columns of a band to a stack buffer then copy them back
+	static ErrorCode ConvertPixelFormatInPlace(Texture* pTexture, PixelFormatEnum eWantedPixelFormat, const PixelFormat::ConvertionFuncChain& oConvertionFuncChain, int iConvertionChainLength)
+	{
+		const PixelFormatEnum eSourcePixelFormat = pTexture->GetPixelFormat();
+		const size_t iPixelSize = PixelFormatEnumInfos[eSourcePixelFormat].iBlockSize;
+
+		bool bSwapRedBlue = false;
+		const bool bSwizzle = IsRedBlueSwapChain(oConvertionFuncChain, iConvertionChainLength, &bSwapRedBlue);
+
+		if (bSwizzle == false || bSwapRedBlue)
+		{
+			for (int iMipIndex = 0, iMipCount = pTexture->GetMipCount(); iMipIndex < iMipCount; ++iMipIndex)
+			{
+				const Texture::TextureFaceData& oMipData = pTexture->GetData().GetFaceData(iMipIndex, 0);
+				const int iFaceCount = pTexture->GetFaceCount();
+				const int iSliceCount = oMipData.iDepth;
+				const int iBandCount = (oMipData.iHeight + c_iInPlaceBandHeight - 1) / c_iInPlaceBandHeight;
+				const int iJobCount = pTexture->GetArraySize() * iFaceCount * iSliceCount * iBandCount;
 
-					const float fInverseFaceSize = 1.f / (iFaceSize - 1);
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+				for (int iJob = 0; iJob < iJobCount; ++iJob)
+				{
+					int iBand = iJob % iBandCount;
+					int iSlice = (iJob / iBandCount) % iSliceCount;
+					int iFaceIndex = (iJob / (iBandCount * iSliceCount)) % iFaceCount;
+					int iLayerIndex = iJob / (iBandCount * iSliceCount * iFaceCount);
 
-					__m128 xFaceVec0 = _mm_loadu_ps(c_fFaceUvVectors[iFace][0]);
-					__m128 xFaceVec1 = _mm_loadu_ps(c_fFaceUvVectors[iFace][1]);
-					__m128 xFaceVec2 = _mm_loadu_ps(c_fFaceUvVectors[iFace][2]);
+					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMipIndex, iFaceIndex, iLayerIndex);
+					const int iY = iBand * c_iInPlaceBandHeight;
+					const int iLineCount = Math::Min(c_iInPlaceBandHeight, oFaceData.iHeight - iY);
+					char* pBand = (char*)oFaceData.pData + (size_t)iSlice * oFaceData.iSlicePitch + (size_t)iY * oFaceData.iPitch;
 
-					#pragma omp parallel for
-					for (int iY = 0; iY < iFaceSize; ++iY)
+					if (bSwizzle)
 					{
-						float fV = 2.f * fInverseFaceSize * iY - 1.f;
-						__m128 xV = _mm_set1_ps(fV);
+						for (int iLine = 0; iLine < iLineCount; ++iLine)
+							SwapRedBlue((uint32_t*)(pBand + (size_t)iLine * oFaceData.iPitch), oFaceData.iWidth);
+						continue;
+					}
 
-						#pragma omp parallel for
-						for (int iX = 0; iX < iFaceSize; ++iX)
-						{
-							float fU = 2.f * fInverseFaceSize * iX - 1.f;
-							__m128 xU = _mm_set1_ps(fU);
-
-							__m128 xVec0 = _mm_mul_ps(xFaceVec0, xU);
-							__m128 xVec1 = _mm_mul_ps(xFaceVec1, xU);
-							__m128 xVec2 = _mm_add_ps(xVec0, xVec1);
-							__m128 xVecF = _mm_add_ps(xVec2, xFaceVec1);
-
-							__m128 xVecFSqr = _mm_mul_ps(xVecF, xVecF);
-							//__m128 xVecFSqr1 = _mm_shuffle_ps(xVecFSqr, xVecFSqr, _MM_SHUFFLE(0, 0, 0, 0));
-							//__m128 xVecFSqr2 = _mm_shuffle_ps(xVecFSqr, xVecFSqr, _MM_SHUFFLE(1, 1, 1, 0));
-							//__m128 xVecFSqr3 = _mm_shuffle_ps(xVecFSqr, xVecFSqr, _MM_SHUFFLE(2, 2, 2, 0));
-							//__m128 xLen = _mm_sqrt_ps()
-							float fVecfSqr[4];
-							_mm_storeu_ps(fVecfSqr, xVecFSqr);
-							xVecFSqr = _mm_set1_ps(fVecfSqr[0] + fVecfSqr[1] + fVecfSqr[2]);
-							xVecFSqr = _mm_rsqrt_ps(xVecFSqr);
-							xVecFSqr = _mm_mul_ps(xVecFSqr, xVecF);
-							float fVec[4];
-							_mm_storeu_ps(fVec, xVecFSqr);
-
-							const float fPhi = atan2f(fVec[0], fVec[2]);
-							const float fTheta = acosf(fVec[1]);
-
-							float fUV[2];
-							fUV[0] = ((c_fPi + fPhi) / c_fPi) * 0.5f;
-							fUV[1] = fTheta * c_fInvPi;
-
-							float fSrcX = fUV[0] * iCubeMapSourceWidthMinusOne;
-							float fSrcY = fUV[1] * iCubeMapSourceHeighthMinusOne;
-
-							//Bilinear
-							int iX0 = (int)floor(fSrcX);
-							int iX1 = fmin(iX0 + 1, iCubeMapSourceWidthMinusOne);
-							int iY0 = (int)floor(fSrcY);
-							int iY1 = fmin(iY0 + 1, iCubeMapSourceHeighthMinusOne);
-
-							/*char* pSource = (char*)oDesc.pData[iMip][0] (iX + iY * iSourceWidth) * iBits / 8;
-
-							const float* pSrcPixel00 = pSource + oDesc.iComponentCount * (iX0 + iY0 * iSourceWidth);
-							const float* pSrcPixel01 = pSource + oDesc.iComponentCount * (iX0 + iY1 * iSourceWidth);
-							const float* pSrcPixel10 = pSource + oDesc.iComponentCount * (iX1 + iY0 * iSourceWidth);
-							const float* pSrcPixel11 = pSource + oDesc.iComponentCount * (iX1 + iY1 * iSourceWidth);
-
-							float fTX = fSrcX - iX0;
-							float fTY = fSrcY - iY0;
-
-							float fMinusTX = 1.f - fTX;
-							float fMinusTY = 1.f - fTY;
-
-							pDstPixel[0] = pSrcPixel00[0] * fMinusTX * fMinusTY + pSrcPixel01[0] * fMinusTX * fTY + pSrcPixel10[0] * fTX * fMinusTY + pSrcPixel11[0] * fTX * fTY;
-							pDstPixel[1] = pSrcPixel00[1] * fMinusTX * fMinusTY + pSrcPixel01[1] * fMinusTX * fTY + pSrcPixel10[1] * fTX * fMinusTY + pSrcPixel11[1] * fTX * fTY;
-							pDstPixel[2] = pSrcPixel00[2] * fMinusTX * fMinusTY + pSrcPixel01[2] * fMinusTX * fTY + pSrcPixel10[2] * fTX * fMinusTY + pSrcPixel11[2] * fTX * fTY;
-							pDstPixel[3] = pSrcPixel00[3] * fMinusTX * fMinusTY + pSrcPixel01[3] * fMinusTX * fTY + pSrcPixel10[3] * fTX * fMinusTY + pSrcPixel11[3] * fTX * fTY;
-							*/
-						}
+					// Columns of the band small enough for the stack buffer
+					uint8_t pLines[c_iInPlaceBufferSize];
+					const int iColumnCount = (int)(c_iInPlaceBufferSize / (iPixelSize * iLineCount));
+					for (int iX = 0; iX < oFaceData.iWidth; iX += iColumnCount)
+					{
+						const int iWidth = Math::Min(iColumnCount, oFaceData.iWidth - iX);
+						const size_t iLineSize = (size_t)iWidth * iPixelSize;
+						char* pColumns = pBand + (size_t)iX * iPixelSize;
+						ConvertPixelFormatRegion(pColumns, oFaceData.iPitch, eSourcePixelFormat, pLines, iLineSize, eWantedPixelFormat, iWidth, iLineCount, oConvertionFuncChain, iConvertionChainLength);
+						for (int iLine = 0; iLine < iLineCount; ++iLine)
+							memcpy(pColumns + (size_t)iLine * oFaceData.iPitch, pLines + iLine * iLineSize, iLineSize);
 					}
 				}
 			}
 		}
 
-		return ErrorCode::Fail;
+		return pTexture->ReinterpretPixelFormat(eWantedPixelFormat);
 	}
 
 	ErrorCode ConvertPixelFormat(const Texture* pTexture, Texture* pOutTexture, PixelFormatEnum eWantedPixelFormat)
@@ -337,6 +426,12 @@ namespace Graphics
 			return ErrorCode(1, "Invalid argument");
 		}
 
+		if (eWantedPixelFormat != pTexture->GetPixelFormat() && PixelFormat::IsCompressed(eWantedPixelFormat))
+		{
+			// Fast encode, blocks with a large error are encoded again at max quality
+			return CompressTexture(pTexture, pOutTexture, eWantedPixelFormat);
+		}
+
 		if (eWantedPixelFormat != pTexture->GetPixelFormat() )
 		{
 			PixelFormat::ConvertionFuncChain oConvertionFuncChain;
@@ -347,110 +442,49 @@ namespace Graphics
 				return ErrorCode(1, "Format convertion not implemented");
 			}
 
+			if (pOutTexture == pTexture && IsConvertibleInPlace(pTexture->GetPixelFormat(), eWantedPixelFormat))
+			{
+				return ConvertPixelFormatInPlace(pOutTexture, eWantedPixelFormat, oConvertionFuncChain, iConvertionChainLength);
+			}
+
 			Texture oNewTexture;
 			Texture::Desc oNewDesc;
 			oNewDesc.ePixelFormat = eWantedPixelFormat;
 			oNewDesc.iWidth = pTexture->GetWidth();
 			oNewDesc.iHeight = pTexture->GetHeight();
+			oNewDesc.iDepth = pTexture->GetDepth();
 			oNewDesc.iFaceCount = pTexture->GetFaceCount();
+			oNewDesc.iArraySize = pTexture->GetArraySize();
 			oNewDesc.iMipCount = pTexture->GetMipCount();
 			if (oNewTexture.Create(oNewDesc) != ErrorCode::Ok)
 			{
 				return ErrorCode(1, "Can't create new Texture");
 			}
 
-			size_t iTotalSize = 0;
 			for (int iMipIndex = 0, iMipCount = pTexture->GetMipCount(); iMipIndex < iMipCount; ++iMipIndex)
 			{
-				for (int iFaceIndex = 0, iFaceCount = oNewDesc.iFaceCount; iFaceIndex < iFaceCount; ++iFaceIndex)
-				{
-					const Texture::TextureFaceData& oNewFaceData = oNewTexture.GetData().GetFaceData(iMipIndex, iFaceIndex);
-					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMipIndex, iFaceIndex);
-
-					int iSourceBits = PixelFormat::BitPerPixel(pTexture->GetPixelFormat());
-					int iDestBits = PixelFormat::BitPerPixel(eWantedPixelFormat);
+				const int iFaceCount = oNewDesc.iFaceCount;
+				const int iSliceCount = pTexture->GetData().GetFaceData(iMipIndex, 0).iDepth;
+				const int iJobCount = oNewDesc.iArraySize * iFaceCount * iSliceCount;
 
-					const PixelFormatInfos& oSrcPFInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
-					const PixelFormatInfos& oDstPFInfos = PixelFormatEnumInfos[eWantedPixelFormat];
-
-					uint32_t iSrcMipBlockX;
-					uint32_t iSrcMipBlockY;
-					PixelFormat::GetBlockCount(pTexture->GetPixelFormat(), oFaceData.iWidth, oFaceData.iHeight, &iSrcMipBlockX, &iSrcMipBlockY);
-
-					uint32_t iDstMipBlockX;
-					uint32_t iDstMipBlockY;
-					PixelFormat::GetBlockCount(eWantedPixelFormat, oNewFaceData.iWidth, oNewFaceData.iHeight, &iDstMipBlockX, &iDstMipBlockY);
-
-					uint32_t iMipWidth = Math::Min(iSrcMipBlockX * oSrcPFInfos.iBlockWidth, iDstMipBlockX * oDstPFInfos.iBlockWidth);
-					uint32_t iMipHeight = Math::Min(iSrcMipBlockY * oSrcPFInfos.iBlockHeight, iDstMipBlockY * oDstPFInfos.iBlockHeight);
-					uint32_t iPaddingX = Math::Max(oSrcPFInfos.iBlockWidth , oDstPFInfos.iBlockWidth);
-					uint32_t iPaddingY = Math::Max(oSrcPFInfos.iBlockHeight, oDstPFInfos.iBlockHeight);
-
-#ifndef DEBUG
-#pragma omp parallel for
-#endif
-					for (int iY = 0; iY < iMipHeight; iY += iPaddingY)
-					{
+				// Parallelize across layers/faces/slices, a single image is parallelized by ConvertPixelFormatRegion
 #ifndef DEBUG
-#pragma omp parallel for
+#pragma omp parallel for if(iJobCount > 1)
 #endif
-						for (int iX = 0; iX < iMipWidth; iX += iPaddingX)
-						{
-							PixelFormat::ConvertionTemporaryData oConvertionTempData[2];
-							void* pSourceData = (char*)oFaceData.pData + (size_t)(iY / oSrcPFInfos.iBlockHeight * iSrcMipBlockX * oSrcPFInfos.iBlockSize + iX / oSrcPFInfos.iBlockWidth * oSrcPFInfos.iBlockSize);
-							void* pNewData = (char*)oNewFaceData.pData + (size_t)(iY / oDstPFInfos.iBlockHeight * iDstMipBlockX * oDstPFInfos.iBlockSize + iX / oDstPFInfos.iBlockWidth * oDstPFInfos.iBlockSize);
-
-							PixelFormatEnum eCurrentFormat = pTexture->GetPixelFormat();
-							uint32_t iCurrentBits = PixelFormat::BitPerPixel(eCurrentFormat);
-							uint32_t iCurrentPaddingX, iCurrentPaddingY;
-
-							iCurrentPaddingX = PixelFormatEnumInfos[eCurrentFormat].iBlockWidth;
-							iCurrentPaddingY = PixelFormatEnumInfos[eCurrentFormat].iBlockHeight;
-
-							for (int iChain = 0; iChain < iConvertionChainLength; ++iChain)
-							{
-								void* pInputData = (iChain == 0) ? pSourceData : ((iChain % 2 == 0) ? &oConvertionTempData[0] : &oConvertionTempData[1]);
-								size_t iInputSize = (iChain == 0) ? (oFaceData.iSize - size_t((char*)pSourceData - (char*)oFaceData.pData)) : sizeof(PixelFormat::ConvertionTemporaryData);
-								void* pOutputData = (iChain == (iConvertionChainLength - 1)) ? pNewData : ((iChain % 2 == 0) ? &oConvertionTempData[1] : &oConvertionTempData[0]);
-								size_t iOutputSize = (iChain == (iConvertionChainLength - 1)) ? ( oNewFaceData.iSize - size_t((char*)pNewData - (char*)oNewFaceData.pData )) : sizeof(PixelFormat::ConvertionTemporaryData);
-
-								uint32_t iInputPitch = (iChain == 0) ? (iSrcMipBlockX * oSrcPFInfos.iBlockWidth) : iPaddingX;
-								uint32_t iOutputPitch = (iChain == (iConvertionChainLength - 1)) ? (iDstMipBlockX * oDstPFInfos.iBlockWidth) : iPaddingX;
-
-								PixelFormat::ConvertionFuncInfo oFunc = oConvertionFuncChain[iChain];
-
-								uint32_t iNextBits = PixelFormat::BitPerPixel(oFunc.eFormat);
-
-								uint32_t iNextPaddingX, iNextPaddingY;
-								iNextPaddingX = PixelFormatEnumInfos[oFunc.eFormat].iBlockWidth;
-								iNextPaddingY = PixelFormatEnumInfos[oFunc.eFormat].iBlockHeight;
-
-								uint32_t iFuncPaddingX = Math::Max(iCurrentPaddingX, iNextPaddingX);
-								uint32_t iFuncPaddingY = Math::Max(iCurrentPaddingY, iNextPaddingY);
-
-								int iTW = Math::Min(iPaddingX, iMipWidth - iX);
-								int iTH = Math::Min(iPaddingY, iMipHeight - iY);
-
-								for (int iTY = 0; iTY < iTH; iTY += iFuncPaddingY)
-								{
-									for (int iTX = 0; iTX < iTW; iTX += iFuncPaddingX)
-									{
-										void* pTempInput = (char*)pInputData + (size_t)(iTY * iInputPitch + iTX) * iCurrentBits / 8;
-										void* pTempOutput = (char*)pOutputData + (size_t)(iTY * iOutputPitch + iTX) * iNextBits / 8;
-
-										CORE_ASSERT(pTempInput >= pInputData && pTempInput <= ((char*)pInputData + iInputSize ));
-										CORE_ASSERT(pTempOutput >= pOutputData && pTempOutput <= ((char*)pOutputData + iOutputSize));
-										oFunc.pFunc(pTempInput, pTempOutput, iInputPitch, iOutputPitch);
-									}
-								}
-
-								eCurrentFormat = oFunc.eFormat;
-								iCurrentBits = iNextBits;
-								iCurrentPaddingX = iNextPaddingX;
-								iCurrentPaddingY = iNextPaddingY;
-							}
-						}
-					}
+				for (int iJob = 0; iJob < iJobCount; ++iJob)
+				{
+					int iSlice = iJob % iSliceCount;
+					int iFaceIndex = (iJob / iSliceCount) % iFaceCount;
+					int iLayerIndex = iJob / (iSliceCount * iFaceCount);
+
+					const Texture::TextureFaceData& oNewFaceData = oNewTexture.GetData().GetFaceData(iMipIndex, iFaceIndex, iLayerIndex);
+					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMipIndex, iFaceIndex, iLayerIndex);
+
+					ConvertPixelFormatRegion(
+						(const char*)oFaceData.pData + iSlice * oFaceData.iSlicePitch, oFaceData.iPitch, pTexture->GetPixelFormat(),
+						(char*)oNewFaceData.pData + iSlice * oNewFaceData.iSlicePitch, oNewFaceData.iPitch, eWantedPixelFormat,
+						oFaceData.iWidth, oFaceData.iHeight,
+						oConvertionFuncChain, iConvertionChainLength);
 				}
 			}
 			pOutTexture->Swap(oNewTexture);
@@ -459,7 +493,8 @@ namespace Graphics
 		return ErrorCode(1, "Same format");
 	}
 
-	bool IsPixelFormatResizable(PixelFormatEnum ePixelFormat)
+	// Formats filtered directly by ResizeImage/MipReduction/BoxFilter
+	static bool IsPixelFormatFilterable(PixelFormatEnum ePixelFormat)
 	{
 		switch (ePixelFormat)
 		{
@@ -469,6 +504,8 @@ namespace Graphics
 		case PixelFormatEnum::BGR8_UNORM:
 		case PixelFormatEnum::RGBA8_UNORM:
 		case PixelFormatEnum::BGRA8_UNORM:
+		case PixelFormatEnum::RGBA8_UNORM_SRGB:
+		case PixelFormatEnum::BGRA8_UNORM_SRGB:
 		case PixelFormatEnum::RGB32_FLOAT:
 		case PixelFormatEnum::RGBA32_FLOAT:
 			return true;
@@ -477,152 +514,2805 @@ namespace Graphics
 		}
 	}
 
-	ErrorCode ResizeTexture(const Texture* pTexture, Texture* pOutTexture, int iNewWidth, int iNewHeight)
+	// Other formats are decoded to a float working format, filtered and encoded back
+	struct FilteringChains
 	{
-		if (pTexture == NULL || pOutTexture == NULL || iNewWidth <= 0 || iNewHeight <= 0)
-		{
-			return ErrorCode(1, "Invalid argument");
-		}
-
-		if (IsPixelFormatResizable(pTexture->GetPixelFormat()) == false)
+		PixelFormatEnum						eWorkingFormat;
+		PixelFormat::ConvertionFuncChain	oDecodeChain;
+		int									iDecodeChainLength;
+		PixelFormat::ConvertionFuncChain	oEncodeChain;
+		int									iEncodeChainLength;
+	};
+
+	static bool GetFilteringChains(PixelFormatEnum ePixelFormat, bool bFourComponents, FilteringChains* pOutChains)
+	{
+		const PixelFormatEnum c_pWorkingFormats[2] = { PixelFormatEnum::RGB32_FLOAT, PixelFormatEnum::RGBA32_FLOAT };
+		int iAdditionalBits;
+		for (int iIndex = (bFourComponents || PixelFormatEnumInfos[ePixelFormat].iComponents == 4) ? 1 : 0; iIndex < 2; ++iIndex)
 		{
-			return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+			if (ePixelFormat == c_pWorkingFormats[iIndex])
+			{
+				pOutChains->eWorkingFormat = ePixelFormat;
+				pOutChains->iDecodeChainLength = 0;
+				pOutChains->iEncodeChainLength = 0;
+				return true;
+			}
+			if (PixelFormat::GetConvertionChain(ePixelFormat, c_pWorkingFormats[iIndex], &pOutChains->oDecodeChain, &pOutChains->iDecodeChainLength, &iAdditionalBits)
+				&& PixelFormat::GetConvertionChain(c_pWorkingFormats[iIndex], ePixelFormat, &pOutChains->oEncodeChain, &pOutChains->iEncodeChainLength, &iAdditionalBits))
+			{
+				pOutChains->eWorkingFormat = c_pWorkingFormats[iIndex];
+				return true;
+			}
 		}
+		return false;
+	}
 
-		Texture oTemp;
-		Texture::Desc oDesc;
-		oDesc.ePixelFormat = pTexture->GetPixelFormat();
-		oDesc.iWidth = iNewWidth;
-		oDesc.iHeight = iNewHeight;
-		oDesc.iMipCount = 1;
-		oDesc.iFaceCount = pTexture->GetFaceCount();
-		ErrorCode oErr = oTemp.Create(oDesc);
-		if (oErr != ErrorCode::Ok)
-			return oErr;
+	bool IsPixelFormatResizable(PixelFormatEnum ePixelFormat)
+	{
+		if (IsPixelFormatFilterable(ePixelFormat))
+			return true;
 
-		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+		FilteringChains oChains;
+		return GetFilteringChains(ePixelFormat, false, &oChains);
+	}
 
-		for (int iFace = 0; iFace < pTexture->GetFaceCount(); ++iFace)
+	static bool ResizeImage(const PixelFormatInfos& oFormatInfos, const void* pSource, int iSourceWidth, int iSourceHeight, size_t iSourcePitch, void* pDest, int iDestWidth, int iDestHeight, size_t iDestPitch)
+	{
+		if (oFormatInfos.eEncoding == ComponentEncodingEnum::UNORM)
+		{
+			return stbir_resize_uint8(
+				(const unsigned char*)pSource, iSourceWidth, iSourceHeight, (int)iSourcePitch,
+				(unsigned char*)pDest, iDestWidth, iDestHeight, (int)iDestPitch,
+				oFormatInfos.iComponents
+			) != 0;
+		}
+		else if (oFormatInfos.eEncoding == ComponentEncodingEnum::SRGB)
 		{
-			int iRes;
-			const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(0, iFace);
-			const Texture::TextureFaceData& oDstFaceData = oTemp.GetData().GetFaceData(0, iFace);
+			return stbir_resize_uint8_srgb(
+				(const unsigned char*)pSource, iSourceWidth, iSourceHeight, (int)iSourcePitch,
+				(unsigned char*)pDest, iDestWidth, iDestHeight, (int)iDestPitch,
+				oFormatInfos.iComponents, oFormatInfos.iComponents == 4 ? 3 : STBIR_ALPHA_CHANNEL_NONE, 0
+			) != 0;
+		}
+		else if (oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT)
+		{
+			return stbir_resize_float(
+				(const float*)pSource, iSourceWidth, iSourceHeight, (int)iSourcePitch,
+				(float*)pDest, iDestWidth, iDestHeight, (int)iDestPitch,
+				oFormatInfos.iComponents
+			) != 0;
+		}
+		return false;
+	}
 
-			if (oFormatInfos.eEncoding == ComponentEncodingEnum::UNORM)
+	// 2x2x2 box filter, pSource1 is the next depth slice (same as pSource0 for 2D images)
+	template<typename T, typename TAccum>
+	static void BoxFilter(const T* pSource0, const T* pSource1, size_t iSourcePitch, int iSourceWidth, int iSourceHeight, T* pDest, size_t iDestPitch, int iDestWidth, int iDestHeight, int iComponents)
+	{
+		for (int iY = 0; iY < iDestHeight; ++iY)
+		{
+			int iY0 = Math::Min(iY * 2, iSourceHeight - 1);
+			int iY1 = Math::Min(iY * 2 + 1, iSourceHeight - 1);
+			const T* pLine00 = (const T*)((const char*)pSource0 + iY0 * iSourcePitch);
+			const T* pLine01 = (const T*)((const char*)pSource0 + iY1 * iSourcePitch);
+			const T* pLine10 = (const T*)((const char*)pSource1 + iY0 * iSourcePitch);
+			const T* pLine11 = (const T*)((const char*)pSource1 + iY1 * iSourcePitch);
+			T* pDestLine = (T*)((char*)pDest + iY * iDestPitch);
+			for (int iX = 0; iX < iDestWidth; ++iX)
 			{
-				iRes = stbir_resize_uint8(
-					(unsigned char*)oSrcFaceData.pData, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch,
-					(unsigned char*)oDstFaceData.pData, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch,
-					oFormatInfos.iComponents
-				);
+				int iX0 = Math::Min(iX * 2, iSourceWidth - 1) * iComponents;
+				int iX1 = Math::Min(iX * 2 + 1, iSourceWidth - 1) * iComponents;
+				for (int iC = 0; iC < iComponents; ++iC)
+				{
+					TAccum fSum = (TAccum)pLine00[iX0 + iC] + (TAccum)pLine00[iX1 + iC] + (TAccum)pLine01[iX0 + iC] + (TAccum)pLine01[iX1 + iC]
+						+ (TAccum)pLine10[iX0 + iC] + (TAccum)pLine10[iX1 + iC] + (TAccum)pLine11[iX0 + iC] + (TAccum)pLine11[iX1 + iC];
+					// Round to nearest for integer types
+					pDestLine[iX * iComponents + iC] = (T)((fSum + (TAccum)(4 * (sizeof(T) == 1))) / (TAccum)8);
+				}
 			}
-			else if (oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT)
+		}
+	}
+
+	// 2x2x2 box filter in linear space for RGBA/BGRA sRGB, alpha is not converted
+	static void BoxFilterSRGB(const uint8_t* pSource0, const uint8_t* pSource1, size_t iSourcePitch, int iSourceWidth, int iSourceHeight, uint8_t* pDest, size_t iDestPitch, int iDestWidth, int iDestHeight)
+	{
+		const float* pToLinear = PixelFormat::Converters::GetSRGBToLinearTable();
+		for (int iY = 0; iY < iDestHeight; ++iY)
+		{
+			int iY0 = Math::Min(iY * 2, iSourceHeight - 1);
+			int iY1 = Math::Min(iY * 2 + 1, iSourceHeight - 1);
+			const uint8_t* pLines[4] = {
+				pSource0 + iY0 * iSourcePitch,
+				pSource0 + iY1 * iSourcePitch,
+				pSource1 + iY0 * iSourcePitch,
+				pSource1 + iY1 * iSourcePitch
+			};
+			uint8_t* pDestLine = pDest + iY * iDestPitch;
+			for (int iX = 0; iX < iDestWidth; ++iX)
 			{
-				iRes = stbir_resize_float(
-					(float*)oSrcFaceData.pData, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch,
-					(float*)oDstFaceData.pData, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch,
-					oFormatInfos.iComponents
-				);
+				int iX0 = Math::Min(iX * 2, iSourceWidth - 1) * 4;
+				int iX1 = Math::Min(iX * 2 + 1, iSourceWidth - 1) * 4;
+				for (int iC = 0; iC < 3; ++iC)
+				{
+					float fSum = 0.f;
+					for (int iLine = 0; iLine < 4; ++iLine)
+						fSum += pToLinear[pLines[iLine][iX0 + iC]] + pToLinear[pLines[iLine][iX1 + iC]];
+					PixelFormat::Converters::LinearToSRGB(fSum / 8.f, &pDestLine[iX * 4 + iC]);
+				}
+				uint32_t iAlphaSum = 0;
+				for (int iLine = 0; iLine < 4; ++iLine)
+					iAlphaSum += pLines[iLine][iX0 + 3] + pLines[iLine][iX1 + 3];
+				pDestLine[iX * 4 + 3] = (uint8_t)((iAlphaSum + 4) / 8);
 			}
-			else
+		}
+	}
+
+	static void BoxFilter(const PixelFormatInfos& oFormatInfos, const void* pSource0, const void* pSource1, size_t iSourcePitch, int iSourceWidth, int iSourceHeight, void* pDest, size_t iDestPitch, int iDestWidth, int iDestHeight)
+	{
+		if (oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT)
+		{
+			BoxFilter<float, float>((const float*)pSource0, (const float*)pSource1, iSourcePitch, iSourceWidth, iSourceHeight,
+				(float*)pDest, iDestPitch, iDestWidth, iDestHeight, oFormatInfos.iComponents);
+		}
+		else if (oFormatInfos.eEncoding == ComponentEncodingEnum::SRGB)
+		{
+			BoxFilterSRGB((const uint8_t*)pSource0, (const uint8_t*)pSource1, iSourcePitch, iSourceWidth, iSourceHeight,
+				(uint8_t*)pDest, iDestPitch, iDestWidth, iDestHeight);
+		}
+		else
+		{
+			BoxFilter<uint8_t, uint32_t>((const uint8_t*)pSource0, (const uint8_t*)pSource1, iSourcePitch, iSourceWidth, iSourceHeight,
+				(uint8_t*)pDest, iDestPitch, iDestWidth, iDestHeight, oFormatInfos.iComponents);
+		}
+	}
+
+	// Rows of the working format buffers processed per job, multiple of all block heights
+	static const int c_iDecodeEncodeBandHeight = 32;
+
+	// Image read by ResampleBand, decoded to RGBA32F when pChains is not NULL
+	struct ResampleSource
+	{
+		const void*					pData;
+		size_t						iPitch;
+		PixelFormatEnum				ePixelFormat;
+		int							iWidth;
+		int							iHeight;
+		const FilteringChains*		pChains;
+		bool						bDecodeNormals;
+		bool						bNormalUNorm;
+		bool						bNormalReconstructZ;
+		// Cubemap face padded by iBorder texels : pData is the RGBA32F face read in place, pBorders its borders (see CubemapSampling::FillFaceBorders)
+		// Weights index the padded face
+		const float*				pBorders;
+		int							iBorder;
+	};
+
+	// Horizontal pass of the used lines of a padded cubemap face, face lines are read in place
+	// Only destination pixels whose taps reach the borders read a line assembled from the borders and the face columns they use
+	static bool ResamplePaddedFaceLines(const ResampleSource& oSource, const int* pLineSlots, float* pFilteredLines, size_t iLinePitch, int iStartX, int iEndX, const Resampling::AxisWeights& oWeightsX)
+	{
+		const int iFaceSize = oSource.iWidth;
+		const int iBorder = oSource.iBorder;
+		const int iPaddedSize = iFaceSize + 2 * iBorder;
+		const int iTapCount = oWeightsX.iTapCount;
+		const int* pIndices = oWeightsX.oIndices.begin();
+
+		// Taps indices increase with the destination pixel, pixels [iInnerStartX, iInnerEndX[ only read the face
+		int iInnerStartX = iStartX;
+		while (iInnerStartX < iEndX && pIndices[(size_t)iInnerStartX * iTapCount] < iBorder)
+			++iInnerStartX;
+		int iInnerEndX = iEndX;
+		while (iInnerEndX > iInnerStartX && pIndices[(size_t)iInnerEndX * iTapCount - 1] >= iBorder + iFaceSize)
+			--iInnerEndX;
+		const bool bEdges = iInnerStartX > iStartX || iInnerEndX < iEndX;
+
+		// Face columns [iBorder, iLeftEndX[ and [iRightStartX, iBorder + iFaceSize[ read by the edge pixels
+		int iLeftEndX = iBorder;
+		if (iInnerStartX > iStartX)
+			iLeftEndX = Math::Min(Math::Max(pIndices[(size_t)iInnerStartX * iTapCount - 1] + 1, iBorder), iBorder + iFaceSize);
+		int iRightStartX = iBorder + iFaceSize;
+		if (iInnerEndX < iEndX)
+			iRightStartX = Math::Max(Math::Min(pIndices[(size_t)iInnerEndX * iTapCount], iRightStartX), iBorder);
+		iLeftEndX = Math::Min(iLeftEndX, iRightStartX);
+
+		Core::Array<float> oEdgeLine;
+		if (bEdges && oEdgeLine.resize((size_t)iPaddedSize * 4, false) == false)
+			return false;
+
+		for (int iLine = 0; iLine < iPaddedSize; ++iLine)
+		{
+			if (pLineSlots[iLine] < 0)
+				continue;
+
+			float* pFiltered = pFilteredLines + iLinePitch * pLineSlots[iLine];
+			const float* pBordersLine = CubemapSampling::GetFaceBordersLine(oSource.pBorders, iFaceSize, iBorder, iLine);
+			if (iLine < iBorder || iLine >= iBorder + iFaceSize)
 			{
-				return ErrorCode::NotImplemented;
+				Resampling::ResampleLine(pBordersLine, pFiltered, iStartX, iEndX, oWeightsX);
+				continue;
 			}
 
-			if (iRes == 0)
+			const float* pFaceLine = (const float*)((const char*)oSource.pData + (size_t)(iLine - iBorder) * oSource.iPitch);
+			Resampling::ResampleLine(pFaceLine, pFiltered + (size_t)(iInnerStartX - iStartX) * 4, iInnerStartX, iInnerEndX, oWeightsX, iBorder);
+			if (bEdges)
 			{
-				return ErrorCode(2, "Internal error");
+				float* pEdgeLine = oEdgeLine.begin();
+				memcpy(pEdgeLine, pBordersLine, (size_t)iBorder * 4 * sizeof(float));
+				memcpy(pEdgeLine + (size_t)iBorder * 4, pFaceLine, (size_t)(iLeftEndX - iBorder) * 4 * sizeof(float));
+				memcpy(pEdgeLine + (size_t)iRightStartX * 4, pFaceLine + (size_t)(iRightStartX - iBorder) * 4, (size_t)(iBorder + iFaceSize - iRightStartX) * 4 * sizeof(float));
+				memcpy(pEdgeLine + (size_t)(iBorder + iFaceSize) * 4, pBordersLine + (size_t)iBorder * 4, (size_t)iBorder * 4 * sizeof(float));
+				Resampling::ResampleLine(pEdgeLine, pFiltered, iStartX, iInnerStartX, oWeightsX);
+				Resampling::ResampleLine(pEdgeLine, pFiltered + (size_t)(iInnerEndX - iStartX) * 4, iInnerEndX, iEndX, oWeightsX);
 			}
 		}
-
-		oTemp.Swap(*pOutTexture);
-
-		return ErrorCode::Ok;
+		return true;
 	}
 
-	ErrorCode GenerateMips(const Texture* pTexture, Texture* pOutTexture, bool bOnlyMissingMips)
+	// Resample destination pixels [iStartX, iEndX[ x [iStartY, iEndY[ to RGBA32F, pDest points to pixel (iStartX, iStartY).
+	// Source lines used by the band are decoded by runs and filtered horizontally once, then blended vertically.
+	// Only source columns used by the band are decoded.
+	static bool ResampleBand(const ResampleSource& oSource, float* pDest, size_t iDestPitch, int iStartX, int iEndX, int iStartY, int iEndY, const Resampling::AxisWeights& oWeightsX, const Resampling::AxisWeights& oWeightsY)
 	{
-		if (pTexture == NULL || pOutTexture == NULL)
+		const bool bDecode = oSource.pChains != NULL && oSource.pChains->iDecodeChainLength > 0;
+		CORE_ASSERT(bDecode || oSource.ePixelFormat == PixelFormatEnum::RGBA32_FLOAT);
+		CORE_ASSERT(oSource.pBorders == NULL || (bDecode == false && oSource.bDecodeNormals == false));
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[oSource.ePixelFormat];
+		const int iBlockWidth = oFormatInfos.iBlockWidth;
+		const int iBlockHeight = oFormatInfos.iBlockHeight;
+		const int iTapCountY = oWeightsY.iTapCount;
+		const int iDestWidth = iEndX - iStartX;
+		const size_t iLinePitch = (size_t)iDestWidth * 4;
+
+		// Source columns read by all taps, including null weights, aligned on blocks
+		int iSourceStartX = oSource.iWidth;
+		int iSourceEndX = 0;
+		for (int iTap = iStartX * oWeightsX.iTapCount; iTap < iEndX * oWeightsX.iTapCount; ++iTap)
 		{
-			return ErrorCode(1, "Invalid argument");
+			iSourceStartX = Math::Min(iSourceStartX, oWeightsX.oIndices[iTap]);
+			iSourceEndX = Math::Max(iSourceEndX, oWeightsX.oIndices[iTap] + 1);
+		}
+		iSourceStartX -= iSourceStartX % iBlockWidth;
+		iSourceEndX = Math::Min(iSourceEndX + (iBlockWidth - iSourceEndX % iBlockWidth) % iBlockWidth, oSource.iWidth);
+		const int iSourceWidth = iSourceEndX - iSourceStartX;
+
+		// Slot of each used source line in the horizontally filtered lines buffer
+		const int iLineCount = oSource.iHeight + 2 * oSource.iBorder;
+		Core::Array<int> oLineSlots;
+		Core::Array<const float*> oLines;
+		if (oLineSlots.resize(iLineCount, false) == false || oLines.resize(iTapCountY, false) == false)
+			return false;
+		for (int iLine = 0; iLine < iLineCount; ++iLine)
+			oLineSlots[iLine] = -1;
+		int iSlotCount = 0;
+		for (int iTap = iStartY * iTapCountY; iTap < iEndY * iTapCountY; ++iTap)
+		{
+			int iLine = oWeightsY.oIndices[iTap];
+			if (oLineSlots[iLine] < 0)
+				oLineSlots[iLine] = iSlotCount++;
 		}
 
-		if (IsPixelFormatResizable(pTexture->GetPixelFormat()) == false)
+		CORE_PTR_VOID pFiltered = Core::Malloc(iLinePitch * iSlotCount * sizeof(float));
+		if (pFiltered == NULL)
+			return false;
+		float* pFilteredLines = (float*)pFiltered;
+
+		bool bResult = true;
+		if (oSource.pBorders != NULL)
+			bResult = ResamplePaddedFaceLines(oSource, oLineSlots.begin(), pFilteredLines, iLinePitch, iStartX, iEndX, oWeightsX);
+		const bool bCopy = bDecode || oSource.bDecodeNormals;
+		for (int iLine = 0; iLine < oSource.iHeight && bResult && oSource.pBorders == NULL; )
 		{
-			return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+			if (oLineSlots[iLine] < 0)
+			{
+				++iLine;
+				continue;
+			}
+
+			// Run of used lines, starting on a block row
+			int iRunEnd = iLine;
+			while (iRunEnd < oSource.iHeight && oLineSlots[iRunEnd] >= 0)
+				++iRunEnd;
+			int iRunStart = iLine - iLine % iBlockHeight;
+
+			CORE_PTR_VOID pDecoded = CORE_PTR_NULL;
+			const float* pRun = NULL;
+			size_t iRunPitch = oSource.iPitch;
+			if (bCopy)
+			{
+				iRunPitch = (size_t)oSource.iWidth * 4 * sizeof(float);
+				pDecoded = Core::Malloc(iRunPitch * (iRunEnd - iRunStart));
+				if (pDecoded == NULL)
+				{
+					bResult = false;
+					break;
+				}
+				// Decoded lines keep the source layout, unused columns are not initialized
+				char* pDecodedColumns = (char*)pDecoded + (size_t)iSourceStartX * 4 * sizeof(float);
+				if (bDecode)
+				{
+					ConvertPixelFormatRegion(
+						(const char*)oSource.pData + (size_t)(iRunStart / iBlockHeight) * oSource.iPitch + (size_t)(iSourceStartX / iBlockWidth) * oFormatInfos.iBlockSize, oSource.iPitch, oSource.ePixelFormat,
+						pDecodedColumns, iRunPitch, PixelFormatEnum::RGBA32_FLOAT,
+						iSourceWidth, iRunEnd - iRunStart,
+						oSource.pChains->oDecodeChain, oSource.pChains->iDecodeChainLength);
+				}
+				else
+				{
+					for (int iRunLine = iRunStart; iRunLine < iRunEnd; ++iRunLine)
+						memcpy(pDecodedColumns + (size_t)(iRunLine - iRunStart) * iRunPitch, (const char*)oSource.pData + (size_t)iRunLine * oSource.iPitch + (size_t)iSourceStartX * 4 * sizeof(float), (size_t)iSourceWidth * 4 * sizeof(float));
+				}
+				if (oSource.bDecodeNormals)
+				{
+					for (int iRunLine = iRunStart; iRunLine < iRunEnd; ++iRunLine)
+						MipReduction::DecodeNormals((float*)(pDecodedColumns + (size_t)(iRunLine - iRunStart) * iRunPitch), (size_t)iSourceWidth, oSource.bNormalUNorm, oSource.bNormalReconstructZ);
+				}
+				pRun = (const float*)pDecoded;
+			}
+			else
+			{
+				pRun = (const float*)((const char*)oSource.pData + (size_t)iRunStart * oSource.iPitch);
+			}
+
+			for (int iRunLine = iLine; iRunLine < iRunEnd; ++iRunLine)
+			{
+				Resampling::ResampleLine((const float*)((const char*)pRun + (size_t)(iRunLine - iRunStart) * iRunPitch), pFilteredLines + iLinePitch * oLineSlots[iRunLine], iStartX, iEndX, oWeightsX);
+			}
+
+			if (pDecoded != NULL)
+				Core::Free(pDecoded);
+			iLine = iRunEnd;
 		}
 
-		int iSize = Math::Max(pTexture->GetWidth(), pTexture->GetHeight());
-		int iMipCount = 1;
-		while (iSize > 1)
+		if (bResult)
 		{
-			++iMipCount;
-			iSize = iSize >> 1;
+			for (int iY = iStartY; iY < iEndY; ++iY)
+			{
+				for (int iTap = 0; iTap < iTapCountY; ++iTap)
+					oLines[iTap] = pFilteredLines + iLinePitch * oLineSlots[oWeightsY.oIndices[iY * iTapCountY + iTap]];
+				Resampling::BlendLines(oLines.begin(), &oWeightsY.oWeights[iY * iTapCountY], iTapCountY, (float*)((char*)pDest + (size_t)(iY - iStartY) * iDestPitch), iDestWidth);
+			}
 		}
 
+		Core::Free(pFiltered);
+		return bResult;
+	}
+
+	// Resize a non filterable format band by band: source rows needed by a band are decoded,
+	// resized in the working format and encoded back, the whole image is never decoded at once
+	static ErrorCode ResizeTextureDecodeEncode(const Texture* pTexture, Texture* pOutTexture, int iNewWidth, int iNewHeight, const FilteringChains& oChains)
+	{
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+		const PixelFormatInfos& oWorkingInfos = PixelFormatEnumInfos[oChains.eWorkingFormat];
+		const int iWorkingPixelSize = oWorkingInfos.iBitsPerPixel / 8;
+
 		Texture oTemp;
 		Texture::Desc oDesc;
-		oDesc.ePixelFormat = pTexture->GetPixelFormat();
-		oDesc.iWidth = pTexture->GetWidth();
-		oDesc.iHeight = pTexture->GetHeight();
-		oDesc.iMipCount = iMipCount;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = iNewWidth;
+		oDesc.iHeight = iNewHeight;
+		oDesc.iDepth = pTexture->GetDepth();
+		oDesc.iMipCount = 1;
 		oDesc.iFaceCount = pTexture->GetFaceCount();
+		oDesc.iArraySize = pTexture->GetArraySize();
 		ErrorCode oErr = oTemp.Create(oDesc);
 		if (oErr != ErrorCode::Ok)
 			return oErr;
 
-		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+		const int iSourceWidth = pTexture->GetWidth();
+		const int iSourceHeight = pTexture->GetHeight();
+		const float fScaleY = iSourceHeight / (float)iNewHeight;
+		// Source lines decoded around each band so filter kernel see the same neighbours as a full resize
+		const int iMarginY = (int)ceilf(2.f * Math::Max(fScaleY, 1.f)) + 1;
+		const int iBlockHeight = oFormatInfos.iBlockHeight;
 
-		int iStartMip = bOnlyMissingMips;
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iSliceCount = pTexture->GetDepth();
+		const int iBandCount = (iNewHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+		const int iJobCount = pTexture->GetArraySize() * iFaceCount * iSliceCount * iBandCount;
+		bool bError = false;
 
-		for (int iFace = 0; iFace < pTexture->GetFaceCount(); ++iFace)
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
 		{
-			for (int iMip = 0; iMip < iMipCount; ++iMip)
+			int iBand = iJob % iBandCount;
+			int iSlice = (iJob / iBandCount) % iSliceCount;
+			int iFace = (iJob / (iBandCount * iSliceCount)) % iFaceCount;
+			int iLayer = iJob / (iBandCount * iSliceCount * iFaceCount);
+
+			const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(0, iFace, iLayer);
+			const Texture::TextureFaceData& oDstFaceData = oTemp.GetData().GetFaceData(0, iFace, iLayer);
+
+			int iDstY0 = iBand * c_iDecodeEncodeBandHeight;
+			int iDstY1 = Math::Min(iDstY0 + c_iDecodeEncodeBandHeight, iNewHeight);
+			float fSrcY0 = iDstY0 * fScaleY;
+			float fSrcY1 = iDstY1 * fScaleY;
+
+			// Decoded lines start on a block row
+			int iSrcY0 = Math::Max((int)floorf(fSrcY0) - iMarginY, 0);
+			int iSrcY1 = Math::Min((int)ceilf(fSrcY1) + iMarginY, iSourceHeight);
+			iSrcY0 -= iSrcY0 % iBlockHeight;
+			int iSrcH = iSrcY1 - iSrcY0;
+
+			size_t iSrcPitch = (size_t)iSourceWidth * iWorkingPixelSize;
+			size_t iDstPitch = (size_t)iNewWidth * iWorkingPixelSize;
+			CORE_PTR_VOID pSource = Core::Malloc(iSrcPitch * iSrcH);
+			CORE_PTR_VOID pDest = Core::Malloc(iDstPitch * (iDstY1 - iDstY0));
+
+			int iRes = 0;
+			if (pSource != NULL && pDest != NULL)
 			{
-				const Texture::TextureFaceData& oDstFaceData = oTemp.GetData().GetFaceData(iMip, iFace);
-
-				if (iMip == 0 || (bOnlyMissingMips && iMip < pTexture->GetMipCount()))
+				ConvertPixelFormatRegion(
+					(const char*)oSrcFaceData.pData + iSlice * oSrcFaceData.iSlicePitch + (size_t)(iSrcY0 / iBlockHeight) * oSrcFaceData.iPitch, oSrcFaceData.iPitch, ePixelFormat,
+					pSource, iSrcPitch, oChains.eWorkingFormat,
+					iSourceWidth, iSrcH,
+					oChains.oDecodeChain, oChains.iDecodeChainLength);
+
+				iRes = stbir_resize_region(
+					pSource, iSourceWidth, iSrcH, (int)iSrcPitch,
+					pDest, iNewWidth, iDstY1 - iDstY0, (int)iDstPitch,
+					STBIR_TYPE_FLOAT, oWorkingInfos.iComponents, STBIR_ALPHA_CHANNEL_NONE, 0,
+					STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT,
+					STBIR_COLORSPACE_LINEAR, NULL,
+					0.f, (fSrcY0 - iSrcY0) / iSrcH,
+					1.f, (fSrcY1 - iSrcY0) / iSrcH);
+
+				if (iRes != 0)
 				{
-					const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(iMip, iFace);
-					Core::MemCpy(oDstFaceData.pData, oSrcFaceData.pData, oSrcFaceData.iSize);
+					ConvertPixelFormatRegion(
+						pDest, iDstPitch, oChains.eWorkingFormat,
+						(char*)oDstFaceData.pData + iSlice * oDstFaceData.iSlicePitch + (size_t)(iDstY0 / iBlockHeight) * oDstFaceData.iPitch, oDstFaceData.iPitch, ePixelFormat,
+						iNewWidth, iDstY1 - iDstY0,
+						oChains.oEncodeChain, oChains.iEncodeChainLength);
 				}
-				else
-				{
-					const Texture::TextureFaceData& oSrcFaceData = oTemp.GetData().GetFaceData(iMip - 1, iFace);
-
-					int iRes;
+			}
 
-					if (oFormatInfos.eEncoding == ComponentEncodingEnum::UNORM)
+			if (iRes == 0)
+				bError = true;
+			if (pSource != NULL)
+				Core::Free(pSource);
+			if (pDest != NULL)
+				Core::Free(pDest);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(2, "Internal error");
+		}
+
+		oTemp.Swap(*pOutTexture);
+
+		return ErrorCode::Ok;
+	}
+
+	// Cube-aware filtering reads a single square cubemap (or array of cubemaps) through padded faces
+	static bool IsCubemapFilterable(const Texture* pTexture)
+	{
+		return pTexture->GetFaceCount() == Texture::_E_FACE_COUNT && pTexture->GetWidth() == pTexture->GetHeight() && pTexture->IsVolume() == false;
+	}
+
+	// Borders of iCubeCount * 6 RGBA32F faces padded by iBorder texels, read from the adjacent faces
+	static bool FillCubemapBorders(const float* const* pFaces, size_t iFacePitch, int iCubeCount, int iFaceSize, int iBorder, float* pOutBorders)
+	{
+		const size_t iFaceBordersFloatCount = CubemapSampling::GetFaceBordersFloatCount(iFaceSize, iBorder);
+		bool bError = false;
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+		for (int iCube = 0; iCube < iCubeCount; ++iCube)
+		{
+			if (CubemapSampling::FillFaceBorders(pFaces + Texture::_E_FACE_COUNT * iCube, iFacePitch, iFaceSize, iBorder, pOutBorders + iFaceBordersFloatCount * Texture::_E_FACE_COUNT * iCube) == false)
+				bError = true;
+		}
+		return bError == false;
+	}
+
+	// Resize with a selected filter/edge mode, each band of destination lines is resampled to RGBA32F and encoded back
+	static ErrorCode ResizeTextureResample(const Texture* pTexture, Texture* pOutTexture, int iNewWidth, int iNewHeight, ResampleFilterEnum eFilter, EdgeModeEnum eEdgeMode, const FilteringChains& oChains)
+	{
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+		const int iBlockHeight = PixelFormatEnumInfos[ePixelFormat].iBlockHeight;
+
+		Texture oTemp;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = iNewWidth;
+		oDesc.iHeight = iNewHeight;
+		oDesc.iDepth = pTexture->GetDepth();
+		oDesc.iMipCount = 1;
+		oDesc.iFaceCount = pTexture->GetFaceCount();
+		oDesc.iArraySize = pTexture->GetArraySize();
+		ErrorCode oErr = oTemp.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const int iFaceCount = pTexture->GetFaceCount();
+
+		// Cubemap faces are read as padded faces whose borders come from the adjacent faces, filter taps never test edges
+		// RGBA32F faces are read in place, other formats are decoded once
+		const bool bCubemap = eEdgeMode == EdgeModeEnum::CUBEMAP;
+		const int iSourceSize = pTexture->GetWidth();
+		const int iBorder = bCubemap ? Math::Min(Resampling::GetSourceBorder(eFilter, iSourceSize, iNewWidth), iSourceSize) : 0;
+		const bool bDecodeFaces = bCubemap && oChains.iDecodeChainLength > 0;
+		const size_t iFacePitch = bDecodeFaces ? (size_t)iSourceSize * 4 * sizeof(float) : pTexture->GetData().GetFaceData(0, 0).iPitch;
+		const size_t iFaceBordersFloatCount = CubemapSampling::GetFaceBordersFloatCount(iSourceSize, iBorder);
+		Core::Array<const float*> oFaces;
+		CORE_PTR_VOID pDecodedFaces = CORE_PTR_NULL;
+		CORE_PTR_VOID pBorders = CORE_PTR_NULL;
+		if (bCubemap)
+		{
+			const int iImageCount = pTexture->GetArraySize() * iFaceCount;
+			pBorders = Core::Malloc(iFaceBordersFloatCount * sizeof(float) * iImageCount);
+			if (bDecodeFaces)
+				pDecodedFaces = Core::Malloc(iFacePitch * iSourceSize * iImageCount);
+			if (pBorders == NULL || (bDecodeFaces && pDecodedFaces == NULL) || oFaces.resize(iImageCount, false) == false)
+			{
+				if (pBorders != NULL)
+					Core::Free(pBorders);
+				if (pDecodedFaces != NULL)
+					Core::Free(pDecodedFaces);
+				return ErrorCode(1, "Can't allocate working buffer");
+			}
+
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+			for (int iImage = 0; iImage < iImageCount; ++iImage)
+			{
+				const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(0, iImage % iFaceCount, iImage / iFaceCount);
+				if (bDecodeFaces)
+				{
+					float* pFace = (float*)((char*)pDecodedFaces + iFacePitch * iSourceSize * iImage);
+					ConvertPixelFormatRegion(
+						oSrcFaceData.pData, oSrcFaceData.iPitch, ePixelFormat,
+						pFace, iFacePitch, PixelFormatEnum::RGBA32_FLOAT,
+						iSourceSize, iSourceSize,
+						oChains.oDecodeChain, oChains.iDecodeChainLength);
+					oFaces[iImage] = pFace;
+				}
+				else
+				{
+					oFaces[iImage] = (const float*)oSrcFaceData.pData;
+				}
+			}
+
+			if (FillCubemapBorders(oFaces.begin(), iFacePitch, pTexture->GetArraySize(), iSourceSize, iBorder, (float*)pBorders) == false)
+			{
+				Core::Free(pBorders);
+				if (pDecodedFaces != NULL)
+					Core::Free(pDecodedFaces);
+				return ErrorCode(1, "Can't allocate working buffer");
+			}
+		}
+
+		Resampling::AxisWeights oWeightsX, oWeightsY;
+		if (Resampling::ComputeAxisWeights(eFilter, eEdgeMode, pTexture->GetWidth(), iNewWidth, &oWeightsX, iBorder) == false
+			|| Resampling::ComputeAxisWeights(eFilter, eEdgeMode, pTexture->GetHeight(), iNewHeight, &oWeightsY, iBorder) == false)
+		{
+			if (pBorders != NULL)
+				Core::Free(pBorders);
+			if (pDecodedFaces != NULL)
+				Core::Free(pDecodedFaces);
+			return ErrorCode(1, "Can't allocate filter weights");
+		}
+
+		const int iSliceCount = pTexture->GetDepth();
+		const int iBandCount = (iNewHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+		const int iJobCount = pTexture->GetArraySize() * iFaceCount * iSliceCount * iBandCount;
+		const size_t iBandPitch = (size_t)iNewWidth * 4 * sizeof(float);
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			int iBand = iJob % iBandCount;
+			int iSlice = (iJob / iBandCount) % iSliceCount;
+			int iFace = (iJob / (iBandCount * iSliceCount)) % iFaceCount;
+			int iLayer = iJob / (iBandCount * iSliceCount * iFaceCount);
+
+			const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(0, iFace, iLayer);
+			const Texture::TextureFaceData& oDstFaceData = oTemp.GetData().GetFaceData(0, iFace, iLayer);
+
+			int iStartY = iBand * c_iDecodeEncodeBandHeight;
+			int iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, iNewHeight);
+
+			CORE_PTR_VOID pBand = Core::Malloc(iBandPitch * (iEndY - iStartY));
+			ResampleSource oSource = { (const char*)oSrcFaceData.pData + iSlice * oSrcFaceData.iSlicePitch, oSrcFaceData.iPitch, ePixelFormat, oSrcFaceData.iWidth, oSrcFaceData.iHeight, &oChains, false, false, false, NULL, 0 };
+			if (bCubemap)
+			{
+				const int iImage = iLayer * iFaceCount + iFace;
+				ResampleSource oPaddedSource = { oFaces[iImage], iFacePitch, PixelFormatEnum::RGBA32_FLOAT, iSourceSize, iSourceSize, NULL, false, false, false, (const float*)pBorders + iFaceBordersFloatCount * iImage, iBorder };
+				oSource = oPaddedSource;
+			}
+			if (pBand != NULL && ResampleBand(oSource, (float*)pBand, iBandPitch, 0, iNewWidth, iStartY, iEndY, oWeightsX, oWeightsY))
+			{
+				ConvertPixelFormatRegion(
+					pBand, iBandPitch, oChains.eWorkingFormat,
+					(char*)oDstFaceData.pData + iSlice * oDstFaceData.iSlicePitch + (size_t)(iStartY / iBlockHeight) * oDstFaceData.iPitch, oDstFaceData.iPitch, ePixelFormat,
+					iNewWidth, iEndY - iStartY,
+					oChains.oEncodeChain, oChains.iEncodeChainLength);
+			}
+			else
+			{
+				bError = true;
+			}
+			if (pBand != NULL)
+				Core::Free(pBand);
+		}
+
+		if (pBorders != NULL)
+			Core::Free(pBorders);
+		if (pDecodedFaces != NULL)
+			Core::Free(pDecodedFaces);
+
+		if (bError)
+		{
+			return ErrorCode(2, "Internal error");
+		}
+
+		oTemp.Swap(*pOutTexture);
+
+		return ErrorCode::Ok;
+	}
+
+	MipSettings::MipSettings()
+	{
+		bNormalMap = false;
+		bNormalMapStoreLength = false;
+		bPreserveAlphaCoverage = false;
+		fAlphaCoverageReference = 0.5f;
+		eFilter = ResampleFilterEnum::DEFAULT;
+		eEdgeMode = EdgeModeEnum::CLAMP;
+	}
+
+	// Box filter (default) uses the exact mip reduction, other filters use the separable resampler
+	static bool IsMipResampled(const MipSettings& oSettings)
+	{
+		return oSettings.eFilter != ResampleFilterEnum::DEFAULT && oSettings.eFilter != ResampleFilterEnum::BOX;
+	}
+
+	// Alpha test coverage ratio of mip 0 of each layer/face, non filterable formats are decoded band by band (pChains not NULL)
+	static bool ComputeAlphaCoverages(const Texture* pTexture, float fAlphaReference, const FilteringChains* pChains, Core::Array<float>* pOutCoverages)
+	{
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iImageCount = pTexture->GetArraySize() * iFaceCount;
+		const Texture::TextureFaceData& oInfos = pTexture->GetData().GetFaceData(0, 0);
+		// Volume slices are contiguous, counted as lines
+		const int iHeight = oInfos.iHeight * oInfos.iDepth;
+		const int iBandCount = (pChains != NULL) ? (iHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight : 1;
+		const int iJobCount = iImageCount * iBandCount;
+
+		Core::Array<size_t> oCounts;
+		if (oCounts.resize(iJobCount, false) == false || pOutCoverages->resize(iImageCount, false) == false)
+			return false;
+
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			int iBand = iJob % iBandCount;
+			int iImage = iJob / iBandCount;
+			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(0, iImage % iFaceCount, iImage / iFaceCount);
+			oCounts[iJob] = 0;
+			if (pChains == NULL)
+			{
+				oCounts[iJob] = MipReduction::CountAlphaCoverage(oFormatInfos, oFaceData.pData, oFaceData.iWidth, iHeight, oFaceData.iPitch, fAlphaReference, 1.f);
+			}
+			else
+			{
+				const PixelFormatInfos& oWorkingInfos = PixelFormatEnumInfos[pChains->eWorkingFormat];
+				int iStartY = iBand * c_iDecodeEncodeBandHeight;
+				int iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, iHeight);
+				size_t iBandPitch = (size_t)oFaceData.iWidth * (oWorkingInfos.iBitsPerPixel / 8);
+				CORE_PTR_VOID pBand = Core::Malloc(iBandPitch * (iEndY - iStartY));
+				if (pBand == NULL)
+				{
+					bError = true;
+					continue;
+				}
+				ConvertPixelFormatRegion(
+					(const char*)oFaceData.pData + (size_t)(iStartY / oFormatInfos.iBlockHeight) * oFaceData.iPitch, oFaceData.iPitch, ePixelFormat,
+					pBand, iBandPitch, pChains->eWorkingFormat,
+					oFaceData.iWidth, iEndY - iStartY,
+					pChains->oDecodeChain, pChains->iDecodeChainLength);
+				oCounts[iJob] = MipReduction::CountAlphaCoverage(oWorkingInfos, pBand, oFaceData.iWidth, iEndY - iStartY, iBandPitch, fAlphaReference, 1.f);
+				Core::Free(pBand);
+			}
+		}
+
+		for (int iImage = 0; iImage < iImageCount; ++iImage)
+		{
+			size_t iCount = 0;
+			for (int iBand = 0; iBand < iBandCount; ++iBand)
+				iCount += oCounts[iImage * iBandCount + iBand];
+			(*pOutCoverages)[iImage] = (float)(iCount / ((double)oInfos.iWidth * iHeight));
+		}
+		return bError == false;
+	}
+
+	// Mips of a non filterable format, of a normal map or using a resampling filter: the level following the last kept level
+	// is filtered from decoded bands, then levels stay in the working format and only two of them are resident.
+	// A level is encoded back to its native format in the same jobs list as the filtering of the next one.
+	// With pEncodeRects (one rect per level and image), pTexture has a full chain and is updated in place: the whole chain is still
+	// filtered from mip 0 but only the rects are encoded, other pixels are kept.
+	static ErrorCode GenerateMipsDecodeEncode(const Texture* pTexture, Texture* pOutTexture, bool bOnlyMissingMips, int iMipCount, const FilteringChains& oChains, const MipSettings& oSettings, const Texture::DirtyRect* pEncodeRects)
+	{
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+
+		if (pTexture->GetDepth() > 1)
+		{
+			if (oSettings.bNormalMap)
+			{
+				return ErrorCode(1, "Normal map mips not supported for volume textures");
+			}
+			if (IsMipResampled(oSettings))
+			{
+				return ErrorCode(1, "'%s' filter not supported for volume textures", ResampleFilterEnumStrings[oSettings.eFilter]);
+			}
+
+			// Volumes are filtered across slices, convert the whole texture
+			Texture oWorking;
+			ErrorCode oErr = ConvertPixelFormat(pTexture, &oWorking, oChains.eWorkingFormat);
+			if (oErr == ErrorCode::Ok)
+				oErr = GenerateMips(&oWorking, &oWorking, bOnlyMissingMips, &oSettings);
+			if (oErr == ErrorCode::Ok)
+				oErr = ConvertPixelFormat(&oWorking, pOutTexture, ePixelFormat);
+			return oErr;
+		}
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+		const PixelFormatInfos& oWorkingInfos = PixelFormatEnumInfos[oChains.eWorkingFormat];
+		const int iWorkingPixelSize = oWorkingInfos.iBitsPerPixel / 8;
+		const int iBlockWidth = oFormatInfos.iBlockWidth;
+		const int iBlockHeight = oFormatInfos.iBlockHeight;
+
+		// Normal maps are decoded to vectors, filtered unnormalized (keeping the length lost by averaging) and renormalized on encoding
+		const bool bNormalUNorm = oFormatInfos.eEncoding != ComponentEncodingEnum::FLOAT;
+		const bool bNormalReconstructZ = oFormatInfos.iComponents == 2;
+		const bool bNormalStoreLength = oSettings.bNormalMapStoreLength && oFormatInfos.iComponents == 4;
+		const bool bAlphaCoverage = oSettings.bPreserveAlphaCoverage && bNormalStoreLength == false && oFormatInfos.iComponents == 4 && MipReduction::IsAlphaCoverageSupported(oWorkingInfos);
+		const bool bResample = IsMipResampled(oSettings);
+		CORE_ASSERT(bResample == false || oChains.eWorkingFormat == PixelFormatEnum::RGBA32_FLOAT);
+		// Box reduction of even sizes never crosses face edges, only resampling filters read the adjacent faces
+		const bool bCubemap = bResample && oSettings.eEdgeMode == EdgeModeEnum::CUBEMAP;
+		const int iCubeCount = pTexture->GetArraySize();
+
+		CORE_ASSERT(pEncodeRects == NULL || (pOutTexture == pTexture && bOnlyMissingMips == false && pTexture->GetMipCount() == iMipCount));
+
+		Texture oTemp;
+		if (pEncodeRects == NULL)
+		{
+			Texture::Desc oDesc;
+			oDesc.ePixelFormat = ePixelFormat;
+			oDesc.iWidth = pTexture->GetWidth();
+			oDesc.iHeight = pTexture->GetHeight();
+			oDesc.iDepth = 1;
+			oDesc.iMipCount = iMipCount;
+			oDesc.iFaceCount = pTexture->GetFaceCount();
+			oDesc.iArraySize = pTexture->GetArraySize();
+			ErrorCode oErr = oTemp.Create(oDesc);
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+		}
+		// Levels written by the encoding
+		Texture& oLevels = (pEncodeRects != NULL) ? *pOutTexture : oTemp;
+
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iImageCount = pTexture->GetArraySize() * iFaceCount;
+		const int iCopyMipCount = bOnlyMissingMips ? Math::Min(pTexture->GetMipCount(), iMipCount) : 1;
+
+		// Kept levels are copied without re-encoding
+		for (int iMip = 0; iMip < iCopyMipCount && pEncodeRects == NULL; ++iMip)
+		{
+			for (int iImage = 0; iImage < iImageCount; ++iImage)
+			{
+				const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(iMip, iImage % iFaceCount, iImage / iFaceCount);
+				const Texture::TextureFaceData& oDstFaceData = oLevels.GetData().GetFaceData(iMip, iImage % iFaceCount, iImage / iFaceCount);
+				memcpy(oDstFaceData.pData, oSrcFaceData.pData, oSrcFaceData.iSlicePitch);
+			}
+		}
+
+		if (iCopyMipCount < iMipCount)
+		{
+			// Working format levels, all images of a level are stored one after the other
+			const int iFirstMip = iCopyMipCount;
+			const Texture::TextureFaceData& oFirstFaceData = oLevels.GetData().GetFaceData(iFirstMip, 0);
+			const size_t iFirstLevelSize = (size_t)oFirstFaceData.iWidth * oFirstFaceData.iHeight * iWorkingPixelSize * iImageCount;
+			const size_t iSecondLevelSize = (iFirstMip + 1 < iMipCount) ? (size_t)Math::Max(oFirstFaceData.iWidth / 2, 1) * Math::Max(oFirstFaceData.iHeight / 2, 1) * iWorkingPixelSize * iImageCount : 0;
+			// Last level needs no next level, keep a valid allocation to simplify the swaps
+			CORE_PTR_VOID pCurrentLevel = Core::Malloc(iFirstLevelSize);
+			CORE_PTR_VOID pNextLevel = Core::Malloc(Math::Max(iSecondLevelSize, (size_t)iWorkingPixelSize));
+			if (pCurrentLevel == NULL || pNextLevel == NULL)
+			{
+				if (pCurrentLevel != NULL)
+					Core::Free(pCurrentLevel);
+				if (pNextLevel != NULL)
+					Core::Free(pNextLevel);
+				return ErrorCode(1, "Can't allocate working buffers");
+			}
+
+			// Cubemaps : filtered levels are read in place as padded faces, only their borders are stored, one allocation sized for the largest level
+			// RGBA32F last kept level is read in place too, other formats are decoded once
+			CORE_PTR_VOID pBorders = CORE_PTR_NULL;
+			CORE_PTR_VOID pDecodedFaces = CORE_PTR_NULL;
+			Core::Array<const float*> oFaces;
+			const bool bDecodeFaces = bCubemap && (oChains.iDecodeChainLength > 0 || oSettings.bNormalMap);
+			if (bCubemap)
+			{
+				size_t iMaxBordersFloatCount = 0;
+				for (int iMip = iFirstMip - 1; iMip + 1 < iMipCount; ++iMip)
+				{
+					const int iSize = oLevels.GetData().GetFaceData(iMip, 0).iWidth;
+					const int iBorder = Math::Min(Resampling::GetSourceBorder(oSettings.eFilter, iSize, Math::Max(iSize / 2, 1)), iSize);
+					iMaxBordersFloatCount = Math::Max(iMaxBordersFloatCount, CubemapSampling::GetFaceBordersFloatCount(iSize, iBorder));
+				}
+				const int iSize = oLevels.GetData().GetFaceData(iFirstMip - 1, 0).iWidth;
+				pBorders = Core::Malloc(iMaxBordersFloatCount * sizeof(float) * iImageCount);
+				if (bDecodeFaces)
+					pDecodedFaces = Core::Malloc((size_t)iSize * iSize * 4 * sizeof(float) * iImageCount);
+				if (pBorders == NULL || (bDecodeFaces && pDecodedFaces == NULL) || oFaces.resize(iImageCount, false) == false)
+				{
+					if (pBorders != NULL)
+						Core::Free(pBorders);
+					if (pDecodedFaces != NULL)
+						Core::Free(pDecodedFaces);
+					Core::Free(pCurrentLevel);
+					Core::Free(pNextLevel);
+					return ErrorCode(1, "Can't allocate working buffers");
+				}
+			}
+
+			bool bError = false;
+
+			Core::Array<float> oCoverages;
+			Core::Array<float> oAlphaScales;
+			if (bAlphaCoverage)
+			{
+				if (ComputeAlphaCoverages(pTexture, oSettings.fAlphaCoverageReference, &oChains, &oCoverages) == false || oAlphaScales.resize(iImageCount, false) == false)
+					bError = true;
+			}
+
+			// First generated level, reduced from decoded bands of the last kept level
+			{
+				const Texture::TextureFaceData& oSrcInfos = oLevels.GetData().GetFaceData(iFirstMip - 1, 0);
+				const int iSrcWidth = oSrcInfos.iWidth;
+				const int iSrcHeight = oSrcInfos.iHeight;
+				const int iDstWidth = oFirstFaceData.iWidth;
+				const int iDstHeight = oFirstFaceData.iHeight;
+				const size_t iSrcPitch = (size_t)iSrcWidth * iWorkingPixelSize;
+				const size_t iDstPitch = (size_t)iDstWidth * iWorkingPixelSize;
+				const int iBandCount = (iDstHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+				const int iJobCount = iImageCount * iBandCount;
+
+				// Cubemaps : borders of the whole level, decoded faces when the level isn't RGBA32F
+				const int iBorder = bCubemap ? Math::Min(Resampling::GetSourceBorder(oSettings.eFilter, iSrcWidth, iDstWidth), iSrcWidth) : 0;
+				const size_t iFaceBordersFloatCount = CubemapSampling::GetFaceBordersFloatCount(iSrcWidth, iBorder);
+				const size_t iFacePitch = bDecodeFaces ? iSrcPitch : oSrcInfos.iPitch;
+				if (bCubemap && bError == false)
+				{
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+					for (int iImage = 0; iImage < iImageCount; ++iImage)
+					{
+						const Texture::TextureFaceData& oSrcFaceData = oLevels.GetData().GetFaceData(iFirstMip - 1, iImage % iFaceCount, iImage / iFaceCount);
+						if (bDecodeFaces == false)
+						{
+							oFaces[iImage] = (const float*)oSrcFaceData.pData;
+							continue;
+						}
+						float* pFace = (float*)((char*)pDecodedFaces + iFacePitch * iSrcHeight * iImage);
+						ConvertPixelFormatRegion(
+							oSrcFaceData.pData, oSrcFaceData.iPitch, ePixelFormat,
+							pFace, iFacePitch, PixelFormatEnum::RGBA32_FLOAT,
+							iSrcWidth, iSrcHeight,
+							oChains.oDecodeChain, oChains.iDecodeChainLength);
+						if (oSettings.bNormalMap)
+							MipReduction::DecodeNormals(pFace, (size_t)iSrcWidth * iSrcHeight, bNormalUNorm, bNormalReconstructZ);
+						oFaces[iImage] = pFace;
+					}
+					if (FillCubemapBorders(oFaces.begin(), iFacePitch, iCubeCount, iSrcWidth, iBorder, (float*)pBorders) == false)
+						bError = true;
+				}
+
+				Resampling::AxisWeights oWeightsX, oWeightsY;
+				if (bResample && (Resampling::ComputeAxisWeights(oSettings.eFilter, oSettings.eEdgeMode, iSrcWidth, iDstWidth, &oWeightsX, iBorder) == false
+					|| Resampling::ComputeAxisWeights(oSettings.eFilter, oSettings.eEdgeMode, iSrcHeight, iDstHeight, &oWeightsY, iBorder) == false))
+				{
+					bError = true;
+				}
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+				for (int iJob = 0; iJob < iJobCount; ++iJob)
+				{
+					int iBand = iJob % iBandCount;
+					int iImage = iJob / iBandCount;
+					const Texture::TextureFaceData& oSrcFaceData = oLevels.GetData().GetFaceData(iFirstMip - 1, iImage % iFaceCount, iImage / iFaceCount);
+
+					int iDstY0 = iBand * c_iDecodeEncodeBandHeight;
+					int iDstY1 = Math::Min(iDstY0 + c_iDecodeEncodeBandHeight, iDstHeight);
+					float* pDstBand = (float*)((char*)pCurrentLevel + (size_t)iImage * iDstPitch * iDstHeight + (size_t)iDstY0 * iDstPitch);
+
+					if (bResample)
 					{
-						iRes = stbir_resize_uint8(
-							(unsigned char*)oSrcFaceData.pData, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch,
-							(unsigned char*)oDstFaceData.pData, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch,
-							oFormatInfos.iComponents
-						);
+						ResampleSource oSource = { oSrcFaceData.pData, oSrcFaceData.iPitch, ePixelFormat, iSrcWidth, iSrcHeight, &oChains, oSettings.bNormalMap, bNormalUNorm, bNormalReconstructZ, NULL, 0 };
+						if (bCubemap)
+						{
+							ResampleSource oPaddedSource = { oFaces[iImage], iFacePitch, PixelFormatEnum::RGBA32_FLOAT, iSrcWidth, iSrcHeight, NULL, false, false, false, (const float*)pBorders + iFaceBordersFloatCount * iImage, iBorder };
+							oSource = oPaddedSource;
+						}
+						if (bError || ResampleBand(oSource, pDstBand, iDstPitch, 0, iDstWidth, iDstY0, iDstY1, oWeightsX, oWeightsY) == false)
+							bError = true;
+						continue;
 					}
-					else if (oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT)
+
+					// Odd sizes use 3 source lines per destination line
+					int iSrcY0 = (iSrcHeight > 1) ? iDstY0 * 2 : 0;
+					int iSrcY1 = (iSrcHeight > 1) ? Math::Min(iDstY1 * 2 + 1, iSrcHeight) : 1;
+					iSrcY0 -= iSrcY0 % iBlockHeight;
+
+					CORE_PTR_VOID pSource = Core::Malloc(iSrcPitch * (iSrcY1 - iSrcY0));
+					if (pSource == NULL)
 					{
-						iRes = stbir_resize_float(
-							(float*)oSrcFaceData.pData, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch,
-							(float*)oDstFaceData.pData, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch,
-							oFormatInfos.iComponents
-						);
+						bError = true;
+						continue;
 					}
-					else
+
+					ConvertPixelFormatRegion(
+						(const char*)oSrcFaceData.pData + (size_t)(iSrcY0 / iBlockHeight) * oSrcFaceData.iPitch, oSrcFaceData.iPitch, ePixelFormat,
+						pSource, iSrcPitch, oChains.eWorkingFormat,
+						iSrcWidth, iSrcY1 - iSrcY0,
+						oChains.oDecodeChain, oChains.iDecodeChainLength);
+
+					if (oSettings.bNormalMap)
+					{
+						MipReduction::DecodeNormals((float*)pSource, (size_t)iSrcWidth * (iSrcY1 - iSrcY0), bNormalUNorm, bNormalReconstructZ);
+					}
+
+					if (MipReduction::Reduce(oWorkingInfos,
+						pSource, iSrcWidth, iSrcHeight, iSrcPitch, iSrcY0,
+						(char*)pCurrentLevel + (size_t)iImage * iDstPitch * iDstHeight, iDstWidth, iDstHeight, iDstPitch,
+						iDstY0, iDstY1) == false)
+					{
+						bError = true;
+					}
+
+					Core::Free(pSource);
+				}
+			}
+
+			for (int iMip = iFirstMip; iMip < iMipCount && bError == false; ++iMip)
+			{
+				const Texture::TextureFaceData& oCurrentInfos = oLevels.GetData().GetFaceData(iMip, 0);
+				const int iWidth = oCurrentInfos.iWidth;
+				const int iHeight = oCurrentInfos.iHeight;
+				const size_t iPitch = (size_t)iWidth * iWorkingPixelSize;
+				const int iNextWidth = Math::Max(iWidth / 2, 1);
+				const int iNextHeight = Math::Max(iHeight / 2, 1);
+				const size_t iNextPitch = (size_t)iNextWidth * iWorkingPixelSize;
+
+				const int iFilterBandCount = (iNextHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+				const int iFilterJobCount = (iMip + 1 < iMipCount) ? iImageCount * iFilterBandCount : 0;
+				const int iEncodeBandCount = (iHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+				const int iEncodeJobCount = iImageCount * iEncodeBandCount;
+
+				const int iBorder = (bCubemap && iFilterJobCount > 0) ? Math::Min(Resampling::GetSourceBorder(oSettings.eFilter, iWidth, iNextWidth), iWidth) : 0;
+				const size_t iFaceBordersFloatCount = CubemapSampling::GetFaceBordersFloatCount(iWidth, iBorder);
+				if (bCubemap && iFilterJobCount > 0)
+				{
+					for (int iImage = 0; iImage < iImageCount; ++iImage)
+						oFaces[iImage] = (const float*)((const char*)pCurrentLevel + (size_t)iImage * iPitch * iHeight);
+					if (FillCubemapBorders(oFaces.begin(), iPitch, iCubeCount, iWidth, iBorder, (float*)pBorders) == false)
+					{
+						bError = true;
+						break;
+					}
+				}
+
+				Resampling::AxisWeights oWeightsX, oWeightsY;
+				if (bResample && iFilterJobCount > 0 && (Resampling::ComputeAxisWeights(oSettings.eFilter, oSettings.eEdgeMode, iWidth, iNextWidth, &oWeightsX, iBorder) == false
+					|| Resampling::ComputeAxisWeights(oSettings.eFilter, oSettings.eEdgeMode, iHeight, iNextHeight, &oWeightsY, iBorder) == false))
+				{
+					bError = true;
+					break;
+				}
+
+				if (bAlphaCoverage)
+				{
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+					for (int iImage = 0; iImage < iImageCount; ++iImage)
 					{
-						return ErrorCode::NotImplemented;
+						oAlphaScales[iImage] = MipReduction::FindAlphaCoverageScale(oWorkingInfos, (const char*)pCurrentLevel + (size_t)iImage * iPitch * iHeight, iWidth, iHeight, iPitch, oSettings.fAlphaCoverageReference, oCoverages[iImage]);
 					}
+				}
 
-					if (iRes == 0)
+				// Filtering of next level and encoding of current level only read the current level
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+				for (int iJob = 0; iJob < iFilterJobCount + iEncodeJobCount; ++iJob)
+				{
+					if (iJob < iFilterJobCount)
+					{
+						int iBand = iJob % iFilterBandCount;
+						int iImage = iJob / iFilterBandCount;
+						int iStartY = iBand * c_iDecodeEncodeBandHeight;
+						int iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, iNextHeight);
+						if (bCubemap)
+						{
+							ResampleSource oSource = { oFaces[iImage], iPitch, PixelFormatEnum::RGBA32_FLOAT, iWidth, iHeight, NULL, false, false, false, (const float*)pBorders + iFaceBordersFloatCount * iImage, iBorder };
+							if (ResampleBand(oSource, (float*)((char*)pNextLevel + (size_t)iImage * iNextPitch * iNextHeight + (size_t)iStartY * iNextPitch), iNextPitch, 0, iNextWidth, iStartY, iEndY, oWeightsX, oWeightsY) == false)
+								bError = true;
+						}
+						else if (bResample)
+						{
+							ResampleSource oSource = { (const char*)pCurrentLevel + (size_t)iImage * iPitch * iHeight, iPitch, oChains.eWorkingFormat, iWidth, iHeight, NULL, false, false, false, NULL, 0 };
+							if (ResampleBand(oSource, (float*)((char*)pNextLevel + (size_t)iImage * iNextPitch * iNextHeight + (size_t)iStartY * iNextPitch), iNextPitch, 0, iNextWidth, iStartY, iEndY, oWeightsX, oWeightsY) == false)
+								bError = true;
+						}
+						else if (MipReduction::Reduce(oWorkingInfos,
+							(const char*)pCurrentLevel + (size_t)iImage * iPitch * iHeight, iWidth, iHeight, iPitch, 0,
+							(char*)pNextLevel + (size_t)iImage * iNextPitch * iNextHeight, iNextWidth, iNextHeight, iNextPitch,
+							iStartY, iEndY) == false)
+						{
+							bError = true;
+						}
+					}
+					else
 					{
-						return ErrorCode(2, "Internal error");
+						int iBand = (iJob - iFilterJobCount) % iEncodeBandCount;
+						int iImage = (iJob - iFilterJobCount) / iEncodeBandCount;
+						int iStartY = iBand * c_iDecodeEncodeBandHeight;
+						int iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, iHeight);
+						int iStartX = 0;
+						int iEndX = iWidth;
+						if (pEncodeRects != NULL)
+						{
+							// Rects are aligned on blocks
+							const Texture::DirtyRect& oRect = pEncodeRects[(size_t)iMip * iImageCount + iImage];
+							iStartX = oRect.iLeft;
+							iEndX = oRect.iRight;
+							iStartY = Math::Max(iStartY, oRect.iTop);
+							iEndY = Math::Min(iEndY, oRect.iBottom);
+							if (iEndX <= iStartX || iEndY <= iStartY)
+								continue;
+						}
+						const Texture::TextureFaceData& oDstFaceData = oLevels.GetData().GetFaceData(iMip, iImage % iFaceCount, iImage / iFaceCount);
+						const char* pBand = (const char*)pCurrentLevel + (size_t)iImage * iPitch * iHeight + (size_t)iStartY * iPitch;
+						CORE_PTR_VOID pBandCopy = CORE_PTR_NULL;
+						if (oSettings.bNormalMap || bAlphaCoverage)
+						{
+							// Current level is still read by the filtering of the next level, modify a copy
+							pBandCopy = Core::Malloc(iPitch * (iEndY - iStartY));
+							if (pBandCopy == NULL)
+							{
+								bError = true;
+								continue;
+							}
+							memcpy(pBandCopy, pBand, iPitch * (iEndY - iStartY));
+							if (oSettings.bNormalMap)
+								MipReduction::EncodeNormals((float*)pBandCopy, (size_t)iWidth * (iEndY - iStartY), bNormalUNorm, bNormalStoreLength);
+							if (bAlphaCoverage)
+								MipReduction::ScaleAlpha(oWorkingInfos, pBandCopy, iWidth, iEndY - iStartY, iPitch, oAlphaScales[iImage]);
+							pBand = (const char*)pBandCopy;
+						}
+						ConvertPixelFormatRegion(
+							pBand + (size_t)iStartX * iWorkingPixelSize, iPitch, oChains.eWorkingFormat,
+							(char*)oDstFaceData.pData + (size_t)(iStartY / iBlockHeight) * oDstFaceData.iPitch + (size_t)(iStartX / iBlockWidth) * oFormatInfos.iBlockSize, oDstFaceData.iPitch, ePixelFormat,
+							iEndX - iStartX, iEndY - iStartY,
+							oChains.oEncodeChain, oChains.iEncodeChainLength);
+						if (pBandCopy != NULL)
+							Core::Free(pBandCopy);
 					}
 				}
+
+				CORE_PTR_VOID pSwap = pCurrentLevel;
+				pCurrentLevel = pNextLevel;
+				pNextLevel = pSwap;
+			}
+
+			if (pCurrentLevel != NULL)
+				Core::Free(pCurrentLevel);
+			if (pNextLevel != NULL)
+				Core::Free(pNextLevel);
+			if (pBorders != NULL)
+				Core::Free(pBorders);
+			if (pDecodedFaces != NULL)
+				Core::Free(pDecodedFaces);
+
+			if (bError)
+			{
+				return ErrorCode(2, "Internal error");
 			}
 		}
 
-		oTemp.Swap(*pOutTexture);
+		if (pEncodeRects == NULL)
+			oTemp.Swap(*pOutTexture);
+
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ResizeTexture(const Texture* pTexture, Texture* pOutTexture, int iNewWidth, int iNewHeight, ResampleFilterEnum eFilter, EdgeModeEnum eEdgeMode)
+	{
+		if (pTexture == NULL || pOutTexture == NULL || iNewWidth <= 0 || iNewHeight <= 0)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (eEdgeMode == EdgeModeEnum::CUBEMAP && (IsCubemapFilterable(pTexture) == false || iNewWidth != iNewHeight))
+		{
+			return ErrorCode(1, "Cubemap edge mode needs square cubemap faces");
+		}
+
+		if (eFilter != ResampleFilterEnum::DEFAULT || eEdgeMode != EdgeModeEnum::CLAMP)
+		{
+			FilteringChains oChains;
+			if (GetFilteringChains(pTexture->GetPixelFormat(), true, &oChains) == false)
+			{
+				return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+			}
+			// Default filter of stb_image_resize for downsampling
+			return ResizeTextureResample(pTexture, pOutTexture, iNewWidth, iNewHeight, (eFilter == ResampleFilterEnum::DEFAULT) ? ResampleFilterEnum::MITCHELL : eFilter, eEdgeMode, oChains);
+		}
+
+		if (IsPixelFormatFilterable(pTexture->GetPixelFormat()) == false)
+		{
+			FilteringChains oChains;
+			if (GetFilteringChains(pTexture->GetPixelFormat(), false, &oChains) == false)
+			{
+				return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+			}
+			return ResizeTextureDecodeEncode(pTexture, pOutTexture, iNewWidth, iNewHeight, oChains);
+		}
 
+		Texture oTemp;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = pTexture->GetPixelFormat();
+		oDesc.iWidth = iNewWidth;
+		oDesc.iHeight = iNewHeight;
+		oDesc.iDepth = pTexture->GetDepth();
+		oDesc.iMipCount = 1;
+		oDesc.iFaceCount = pTexture->GetFaceCount();
+		oDesc.iArraySize = pTexture->GetArraySize();
+		ErrorCode oErr = oTemp.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iSliceCount = pTexture->GetDepth();
+		const int iJobCount = pTexture->GetArraySize() * iFaceCount * iSliceCount;
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			int iSlice = iJob % iSliceCount;
+			int iFace = (iJob / iSliceCount) % iFaceCount;
+			int iLayer = iJob / (iSliceCount * iFaceCount);
+
+			const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(0, iFace, iLayer);
+			const Texture::TextureFaceData& oDstFaceData = oTemp.GetData().GetFaceData(0, iFace, iLayer);
+
+			if (ResizeImage(oFormatInfos,
+				(const char*)oSrcFaceData.pData + iSlice * oSrcFaceData.iSlicePitch, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch,
+				(char*)oDstFaceData.pData + iSlice * oDstFaceData.iSlicePitch, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch) == false)
+			{
+				bError = true;
+			}
+		}
+
+		if (bError)
+		{
+			return ErrorCode(2, "Internal error");
+		}
+
+		oTemp.Swap(*pOutTexture);
+
+		return ErrorCode::Ok;
+	}
+
+	TextureView::TextureView()
+		: pTexture(NULL)
+		, iMip(0)
+		, iFace(0)
+		, iLayer(0)
+		, iX(0)
+		, iY(0)
+		, iWidth(0)
+		, iHeight(0)
+	{
+	}
+
+	TextureView::TextureView(const Texture* pTexture, int iMip, int iFace, int iLayer)
+		: pTexture(pTexture)
+		, iMip(iMip)
+		, iFace(iFace)
+		, iLayer(iLayer)
+		, iX(0)
+		, iY(0)
+		, iWidth(0)
+		, iHeight(0)
+	{
+		if (pTexture != NULL && pTexture->IsValid() && iMip >= 0 && iMip < pTexture->GetMipCount())
+		{
+			iWidth = Math::Max(pTexture->GetWidth() >> iMip, 1);
+			iHeight = Math::Max(pTexture->GetHeight() >> iMip, 1);
+		}
+	}
+
+	bool SnapTextureView(const TextureView& oView, TextureView* pOutView)
+	{
+		const Texture* pTexture = oView.pTexture;
+		if (pTexture == NULL || pTexture->IsValid() == false
+			|| oView.iMip < 0 || oView.iMip >= pTexture->GetMipCount()
+			|| oView.iFace < 0 || oView.iFace >= pTexture->GetFaceCount()
+			|| oView.iLayer < 0 || oView.iLayer >= pTexture->GetArraySize())
+		{
+			return false;
+		}
+
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+		const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(oView.iMip, oView.iFace, oView.iLayer);
+
+		int iLeft = Math::Max(oView.iX, 0) / oInfos.iBlockWidth * oInfos.iBlockWidth;
+		int iTop = Math::Max(oView.iY, 0) / oInfos.iBlockHeight * oInfos.iBlockHeight;
+		int iRight = Math::Min((oView.iX + oView.iWidth + oInfos.iBlockWidth - 1) / oInfos.iBlockWidth * oInfos.iBlockWidth, oFaceData.iWidth);
+		int iBottom = Math::Min((oView.iY + oView.iHeight + oInfos.iBlockHeight - 1) / oInfos.iBlockHeight * oInfos.iBlockHeight, oFaceData.iHeight);
+		if (oView.iWidth <= 0 || oView.iHeight <= 0 || iRight <= iLeft || iBottom <= iTop)
+		{
+			return false;
+		}
+
+		*pOutView = oView;
+		pOutView->iX = iLeft;
+		pOutView->iY = iTop;
+		pOutView->iWidth = iRight - iLeft;
+		pOutView->iHeight = iBottom - iTop;
+		return true;
+	}
+
+	// First block of the view in a slice of its subresource, oView is snapped
+	static const char* GetTextureViewData(const TextureView& oView, int iSlice, size_t* pOutPitch)
+	{
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oView.pTexture->GetPixelFormat()];
+		const Texture::TextureFaceData& oFaceData = oView.pTexture->GetData().GetFaceData(oView.iMip, oView.iFace, oView.iLayer);
+		*pOutPitch = oFaceData.iPitch;
+		return (const char*)oFaceData.pData + (size_t)iSlice * oFaceData.iSlicePitch
+			+ (size_t)(oView.iY / oInfos.iBlockHeight) * oFaceData.iPitch + (size_t)(oView.iX / oInfos.iBlockWidth) * oInfos.iBlockSize;
+	}
+
+	static ErrorCode CreateTextureViewTexture(const TextureView& oView, PixelFormatEnum ePixelFormat, Texture* pOutTexture)
+	{
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = oView.iWidth;
+		oDesc.iHeight = oView.iHeight;
+		oDesc.iDepth = oView.pTexture->GetData().GetFaceData(oView.iMip, oView.iFace, oView.iLayer).iDepth;
+		return pOutTexture->Create(oDesc);
+	}
+
+	ErrorCode CopyTextureView(const TextureView& oView, Texture* pOutTexture)
+	{
+		TextureView oSnappedView;
+		if (pOutTexture == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (SnapTextureView(oView, &oSnappedView) == false)
+		{
+			return ErrorCode(1, "Invalid or empty texture view");
+		}
+
+		// pOutTexture can be the viewed texture
+		Texture oNewTexture;
+		ErrorCode oErr = CreateTextureViewTexture(oSnappedView, oView.pTexture->GetPixelFormat(), &oNewTexture);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const Texture::TextureFaceData& oNewFaceData = oNewTexture.GetData().GetFaceData(0, 0);
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oView.pTexture->GetPixelFormat()];
+		const int iBlockRowCount = (oSnappedView.iHeight + oInfos.iBlockHeight - 1) / oInfos.iBlockHeight;
+		const size_t iBlockRowSize = (size_t)(oSnappedView.iWidth + oInfos.iBlockWidth - 1) / oInfos.iBlockWidth * oInfos.iBlockSize;
+		for (int iSlice = 0; iSlice < oNewFaceData.iDepth; ++iSlice)
+		{
+			size_t iPitch;
+			const char* pSource = GetTextureViewData(oSnappedView, iSlice, &iPitch);
+			char* pDest = (char*)oNewFaceData.pData + (size_t)iSlice * oNewFaceData.iSlicePitch;
+			for (int iBlockRow = 0; iBlockRow < iBlockRowCount; ++iBlockRow)
+				memcpy(pDest + (size_t)iBlockRow * oNewFaceData.iPitch, pSource + (size_t)iBlockRow * iPitch, iBlockRowSize);
+		}
+
+		pOutTexture->Swap(oNewTexture);
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ConvertPixelFormat(const TextureView& oView, Texture* pOutTexture, PixelFormatEnum eWantedPixelFormat)
+	{
+		TextureView oSnappedView;
+		if (pOutTexture == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (SnapTextureView(oView, &oSnappedView) == false)
+		{
+			return ErrorCode(1, "Invalid or empty texture view");
+		}
+
+		const PixelFormatEnum eSourcePixelFormat = oView.pTexture->GetPixelFormat();
+		if (eWantedPixelFormat == eSourcePixelFormat)
+		{
+			return CopyTextureView(oSnappedView, pOutTexture);
+		}
+
+		if (PixelFormat::IsCompressed(eWantedPixelFormat))
+		{
+			Texture oRegion;
+			ErrorCode oErr = CopyTextureView(oSnappedView, &oRegion);
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+			return CompressTexture(&oRegion, pOutTexture, eWantedPixelFormat);
+		}
+
+		PixelFormat::ConvertionFuncChain oConvertionFuncChain;
+		int iConvertionChainLength;
+		int iAdditionalBits;
+		if (PixelFormat::GetConvertionChain(eSourcePixelFormat, eWantedPixelFormat, &oConvertionFuncChain, &iConvertionChainLength, &iAdditionalBits) == false)
+		{
+			return ErrorCode(1, "Format convertion not implemented");
+		}
+
+		Texture oNewTexture;
+		ErrorCode oErr = CreateTextureViewTexture(oSnappedView, eWantedPixelFormat, &oNewTexture);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const Texture::TextureFaceData& oNewFaceData = oNewTexture.GetData().GetFaceData(0, 0);
+		for (int iSlice = 0; iSlice < oNewFaceData.iDepth; ++iSlice)
+		{
+			size_t iPitch;
+			const char* pSource = GetTextureViewData(oSnappedView, iSlice, &iPitch);
+			ConvertPixelFormatRegion(
+				pSource, iPitch, eSourcePixelFormat,
+				(char*)oNewFaceData.pData + (size_t)iSlice * oNewFaceData.iSlicePitch, oNewFaceData.iPitch, eWantedPixelFormat,
+				oSnappedView.iWidth, oSnappedView.iHeight,
+				oConvertionFuncChain, iConvertionChainLength);
+		}
+
+		pOutTexture->Swap(oNewTexture);
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ResizeTexture(const TextureView& oView, Texture* pOutTexture, int iNewWidth, int iNewHeight, ResampleFilterEnum eFilter, EdgeModeEnum eEdgeMode)
+	{
+		// Resamplers read whole images, the region is copied first
+		Texture oRegion;
+		ErrorCode oErr = CopyTextureView(oView, &oRegion);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+		return ResizeTexture(&oRegion, pOutTexture, iNewWidth, iNewHeight, eFilter, eEdgeMode);
+	}
+
+	static int GetFullMipCount(const Texture* pTexture)
+	{
+		int iSize = Math::Max(Math::Max(pTexture->GetWidth(), pTexture->GetHeight()), pTexture->GetDepth());
+		int iMipCount = 1;
+		while (iSize > 1)
+		{
+			++iMipCount;
+			iSize = iSize >> 1;
+		}
+		return iMipCount;
+	}
+
+	ErrorCode GenerateMips(const Texture* pTexture, Texture* pOutTexture, bool bOnlyMissingMips, const MipSettings* pSettings)
+	{
+		if (pTexture == NULL || pOutTexture == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (IsPixelFormatResizable(pTexture->GetPixelFormat()) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+		}
+
+		const int iMipCount = GetFullMipCount(pTexture);
+
+		MipSettings oDefaultSettings;
+		const MipSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+
+		if (oSettings.bNormalMap && PixelFormatEnumInfos[pTexture->GetPixelFormat()].iComponents < 2)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't store normals", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+		}
+
+		if (oSettings.eEdgeMode == EdgeModeEnum::CUBEMAP && IsCubemapFilterable(pTexture) == false)
+		{
+			return ErrorCode(1, "Cubemap edge mode needs square cubemap faces");
+		}
+
+		if (oSettings.bNormalMap || IsMipResampled(oSettings) || IsPixelFormatFilterable(pTexture->GetPixelFormat()) == false)
+		{
+			FilteringChains oChains;
+			if (GetFilteringChains(pTexture->GetPixelFormat(), oSettings.bNormalMap || IsMipResampled(oSettings), &oChains) == false)
+			{
+				return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+			}
+			return GenerateMipsDecodeEncode(pTexture, pOutTexture, bOnlyMissingMips, iMipCount, oChains, oSettings, NULL);
+		}
+
+		Texture oTemp;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = pTexture->GetPixelFormat();
+		oDesc.iWidth = pTexture->GetWidth();
+		oDesc.iHeight = pTexture->GetHeight();
+		oDesc.iDepth = pTexture->GetDepth();
+		oDesc.iMipCount = iMipCount;
+		oDesc.iFaceCount = pTexture->GetFaceCount();
+		oDesc.iArraySize = pTexture->GetArraySize();
+		ErrorCode oErr = oTemp.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iLayerCount = pTexture->GetArraySize() * iFaceCount;
+		bool bError = false;
+
+		// 2D levels are split in bands of lines so a single face still spread across threads
+		const bool bVolume = pTexture->GetDepth() > 1;
+		const int c_iMipBandHeight = 64;
+
+		for (int iMip = 0; iMip < iMipCount && bError == false; ++iMip)
+		{
+			const Texture::TextureFaceData& oMipFaceData = oTemp.GetData().GetFaceData(iMip, 0);
+			const int iSliceCount = oMipFaceData.iDepth;
+			const int iBandCount = bVolume ? 1 : (oMipFaceData.iHeight + c_iMipBandHeight - 1) / c_iMipBandHeight;
+			const int iJobCount = iLayerCount * iSliceCount * iBandCount;
+
+			// Each mip depends on the previous one, parallelize across layers/faces/slices/bands
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iJob = 0; iJob < iJobCount; ++iJob)
+			{
+				int iBand = iJob % iBandCount;
+				int iSlice = (iJob / iBandCount) % iSliceCount;
+				int iFace = (iJob / (iBandCount * iSliceCount)) % iFaceCount;
+				int iLayer = iJob / (iBandCount * iSliceCount * iFaceCount);
+
+				const Texture::TextureFaceData& oDstFaceData = oTemp.GetData().GetFaceData(iMip, iFace, iLayer);
+				char* pDstSlice = (char*)oDstFaceData.pData + iSlice * oDstFaceData.iSlicePitch;
+				const int iStartY = bVolume ? 0 : iBand * c_iMipBandHeight;
+				const int iEndY = bVolume ? oDstFaceData.iHeight : Math::Min(iStartY + c_iMipBandHeight, oDstFaceData.iHeight);
+
+				if (iMip == 0 || (bOnlyMissingMips && iMip < pTexture->GetMipCount()))
+				{
+					const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+					const size_t iBegin = (size_t)iStartY * oSrcFaceData.iPitch;
+					const size_t iEnd = (iEndY == oSrcFaceData.iHeight) ? oSrcFaceData.iSlicePitch : (size_t)iEndY * oSrcFaceData.iPitch;
+					memcpy(pDstSlice + iBegin, (const char*)oSrcFaceData.pData + iSlice * oSrcFaceData.iSlicePitch + iBegin, iEnd - iBegin);
+				}
+				else
+				{
+					const Texture::TextureFaceData& oSrcFaceData = oTemp.GetData().GetFaceData(iMip - 1, iFace, iLayer);
+
+					if (bVolume)
+					{
+						// Volume : 3D box filter
+						const char* pSrcSlice0 = (const char*)oSrcFaceData.pData + Math::Min(iSlice * 2, oSrcFaceData.iDepth - 1) * oSrcFaceData.iSlicePitch;
+						const char* pSrcSlice1 = (const char*)oSrcFaceData.pData + Math::Min(iSlice * 2 + 1, oSrcFaceData.iDepth - 1) * oSrcFaceData.iSlicePitch;
+						BoxFilter(oFormatInfos, pSrcSlice0, pSrcSlice1, oSrcFaceData.iPitch, oSrcFaceData.iWidth, oSrcFaceData.iHeight,
+							pDstSlice, oDstFaceData.iPitch, oDstFaceData.iWidth, oDstFaceData.iHeight);
+					}
+					else if (MipReduction::Reduce(oFormatInfos,
+						oSrcFaceData.pData, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch, 0,
+						pDstSlice, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch,
+						iStartY, iEndY) == false)
+					{
+						// Arbitrary ratio or unsupported format, whole level is resized by first band
+						if (iBand == 0 && ResizeImage(oFormatInfos,
+							oSrcFaceData.pData, oSrcFaceData.iWidth, oSrcFaceData.iHeight, oSrcFaceData.iPitch,
+							pDstSlice, oDstFaceData.iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch) == false)
+						{
+							bError = true;
+						}
+					}
+				}
+			}
+		}
+
+		const int iFirstGeneratedMip = bOnlyMissingMips ? pTexture->GetMipCount() : 1;
+		if (bError == false && oSettings.bPreserveAlphaCoverage && MipReduction::IsAlphaCoverageSupported(oFormatInfos) && iFirstGeneratedMip < iMipCount)
+		{
+			// Generated levels are filtered from unscaled levels, each one is scaled independently
+			Core::Array<float> oCoverages;
+			if (ComputeAlphaCoverages(pTexture, oSettings.fAlphaCoverageReference, NULL, &oCoverages) == false)
+			{
+				return ErrorCode(2, "Internal error");
+			}
+
+			const int iJobCount = iLayerCount * (iMipCount - iFirstGeneratedMip);
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iJob = 0; iJob < iJobCount; ++iJob)
+			{
+				int iImage = iJob % iLayerCount;
+				int iMip = iFirstGeneratedMip + iJob / iLayerCount;
+				const Texture::TextureFaceData& oFaceData = oTemp.GetData().GetFaceData(iMip, iImage % iFaceCount, iImage / iFaceCount);
+				// Volume slices are contiguous, processed as lines
+				const int iHeight = oFaceData.iHeight * oFaceData.iDepth;
+				float fScale = MipReduction::FindAlphaCoverageScale(oFormatInfos, oFaceData.pData, oFaceData.iWidth, iHeight, oFaceData.iPitch, oSettings.fAlphaCoverageReference, oCoverages[iImage]);
+				MipReduction::ScaleAlpha(oFormatInfos, oFaceData.pData, oFaceData.iWidth, iHeight, oFaceData.iPitch, fScale);
+			}
+		}
+
+		if (bError)
+		{
+			return ErrorCode(2, "Internal error");
+		}
+
+		oTemp.Swap(*pOutTexture);
+
+		return ErrorCode::Ok;
+	}
+
+	// Destination range of a mip level whose footprint overlaps source range [iStart, iEnd[, pWeights is NULL for the box reduction
+	static void GetMipFootprint(const Resampling::AxisWeights* pWeights, int iSourceSize, int iDestSize, int iStart, int iEnd, int* pOutStart, int* pOutEnd)
+	{
+		if (pWeights == NULL)
+		{
+			// Destination pixel d covers source pixels [2d, 2d + 1], [2d, 2d + 2] for odd sizes (polyphase)
+			const int iLastTap = (iSourceSize > 1 && (iSourceSize & 1)) ? 2 : 1;
+			const int iFirst = iStart - iLastTap;
+			*pOutStart = iFirst <= 0 ? 0 : (iFirst + 1) / 2;
+			*pOutEnd = Math::Min((iEnd - 1) / 2 + 1, iDestSize);
+			return;
+		}
+
+		// Filter taps may wrap around edges, test all of them
+		const int iTapCount = pWeights->iTapCount;
+		*pOutStart = iDestSize;
+		*pOutEnd = 0;
+		for (int iDest = 0; iDest < iDestSize; ++iDest)
+		{
+			for (int iTap = 0; iTap < iTapCount; ++iTap)
+			{
+				const int iIndex = pWeights->oIndices[(size_t)iDest * iTapCount + iTap];
+				if (iIndex >= iStart && iIndex < iEnd)
+				{
+					*pOutStart = Math::Min(*pOutStart, iDest);
+					*pOutEnd = iDest + 1;
+					break;
+				}
+			}
+		}
+	}
+
+	struct DirtyMipJob
+	{
+		int							iImage;
+		int							iStartY;
+		int							iEndY;
+	};
+
+	ErrorCode GenerateDirtyMips(Texture* pTexture, const MipSettings* pSettings)
+	{
+		if (pTexture == NULL)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		const PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
+		if (IsPixelFormatResizable(ePixelFormat) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[ePixelFormat].pName);
+		}
+
+		MipSettings oDefaultSettings;
+		const MipSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+
+		if (oSettings.bNormalMap && oFormatInfos.iComponents < 2)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't store normals", oFormatInfos.pName);
+		}
+
+		if (pTexture->HasDirtyRects() == false)
+		{
+			return ErrorCode::Ok;
+		}
+
+		const int iMipCount = GetFullMipCount(pTexture);
+
+		// Box reduction of filterable formats is done in place on the footprint.
+		// Other cases are filtered like GenerateMips, the whole chain in the working format from mip 0, and only the footprint is encoded:
+		// filtering previous encoded levels would accumulate their quantization and seam against untouched regions.
+		const bool bResample = IsMipResampled(oSettings);
+		const bool bNative = oSettings.bNormalMap == false && bResample == false && IsPixelFormatFilterable(ePixelFormat);
+
+		// Incomplete chains, volumes, settings depending on whole levels, filters reading adjacent faces
+		// and formats resized without the mip reduction are fully regenerated
+		if (pTexture->GetMipCount() != iMipCount
+			|| pTexture->IsVolume()
+			|| oSettings.bPreserveAlphaCoverage
+			|| (oSettings.bNormalMap && oSettings.bNormalMapStoreLength)
+			|| (oSettings.eEdgeMode == EdgeModeEnum::CUBEMAP && bResample)
+			|| (bNative && MipReduction::IsPixelFormatSupported(oFormatInfos) == false))
+		{
+			ErrorCode oErr = GenerateMips(pTexture, pTexture, false, &oSettings);
+			if (oErr == ErrorCode::Ok)
+				pTexture->ClearDirtyRects();
+			return oErr;
+		}
+
+		FilteringChains oChains;
+		if (bNative == false && GetFilteringChains(ePixelFormat, oSettings.bNormalMap || bResample, &oChains) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be resized", oFormatInfos.pName);
+		}
+		const int iBlockWidth = oFormatInfos.iBlockWidth;
+		const int iBlockHeight = oFormatInfos.iBlockHeight;
+
+		const int iFaceCount = pTexture->GetFaceCount();
+		const int iImageCount = pTexture->GetArraySize() * iFaceCount;
+
+		// Region of each image to read in current level and to write in next level, and encoded rects of all levels
+		Core::Array<Texture::DirtyRect> oSourceRects;
+		Core::Array<Texture::DirtyRect> oDestRects;
+		Core::Array<Texture::DirtyRect> oEncodeRects;
+		Core::Array<DirtyMipJob> oJobs;
+		if (oSourceRects.resize(iImageCount, false) == false || oDestRects.resize(iImageCount, false) == false
+			|| (bNative == false && oEncodeRects.resize((size_t)iMipCount * iImageCount, false) == false))
+		{
+			return ErrorCode(1, "Can't allocate dirty rects");
+		}
+		for (int iImage = 0; iImage < iImageCount; ++iImage)
+		{
+			oSourceRects[iImage] = pTexture->GetDirtyRect(0, iImage % iFaceCount, iImage / iFaceCount);
+		}
+		for (size_t iRect = 0; iRect < oEncodeRects.size(); ++iRect)
+		{
+			oEncodeRects[iRect] = Texture::DirtyRect();
+		}
+
+		bool bError = false;
+		Resampling::AxisWeights oWeightsX, oWeightsY;
+		for (int iMip = 0; iMip + 1 < iMipCount && bError == false; ++iMip)
+		{
+			const Texture::TextureFaceData& oSrcLevel = pTexture->GetData().GetFaceData(iMip, 0);
+			const Texture::TextureFaceData& oDstLevel = pTexture->GetData().GetFaceData(iMip + 1, 0);
+			if (bResample
+				&& (Resampling::ComputeAxisWeights(oSettings.eFilter, oSettings.eEdgeMode, oSrcLevel.iWidth, oDstLevel.iWidth, &oWeightsX) == false
+				|| Resampling::ComputeAxisWeights(oSettings.eFilter, oSettings.eEdgeMode, oSrcLevel.iHeight, oDstLevel.iHeight, &oWeightsY) == false))
+			{
+				bError = true;
+				break;
+			}
+
+			size_t iJobCount = 0;
+			for (int iImage = 0; iImage < iImageCount; ++iImage)
+			{
+				Texture::DirtyRect& oDestRect = oDestRects[iImage];
+				oDestRect = Texture::DirtyRect();
+				const Texture::DirtyRect& oSourceRect = oSourceRects[iImage];
+				if (oSourceRect.IsEmpty())
+					continue;
+
+				GetMipFootprint(bResample ? &oWeightsX : NULL, oSrcLevel.iWidth, oDstLevel.iWidth, oSourceRect.iLeft, oSourceRect.iRight, &oDestRect.iLeft, &oDestRect.iRight);
+				GetMipFootprint(bResample ? &oWeightsY : NULL, oSrcLevel.iHeight, oDstLevel.iHeight, oSourceRect.iTop, oSourceRect.iBottom, &oDestRect.iTop, &oDestRect.iBottom);
+
+				// Whole blocks are re-encoded
+				oDestRect.iLeft -= oDestRect.iLeft % iBlockWidth;
+				oDestRect.iTop -= oDestRect.iTop % iBlockHeight;
+				oDestRect.iRight = Math::Min(oDestRect.iRight + (iBlockWidth - oDestRect.iRight % iBlockWidth) % iBlockWidth, oDstLevel.iWidth);
+				oDestRect.iBottom = Math::Min(oDestRect.iBottom + (iBlockHeight - oDestRect.iBottom % iBlockHeight) % iBlockHeight, oDstLevel.iHeight);
+
+				// Reduction of odd widths can't start on any column
+				if (bNative && oSrcLevel.iWidth > 1 && (oSrcLevel.iWidth & 1))
+				{
+					oDestRect.iLeft = 0;
+					oDestRect.iRight = oDstLevel.iWidth;
+				}
+
+				if (bNative && oDestRect.IsEmpty() == false)
+					iJobCount += (oDestRect.iBottom - oDestRect.iTop + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+			}
+
+			if (oJobs.resize(iJobCount, false) == false)
+			{
+				bError = true;
+				break;
+			}
+			size_t iJob = 0;
+			for (int iImage = 0; iImage < iImageCount && bNative; ++iImage)
+			{
+				const Texture::DirtyRect& oDestRect = oDestRects[iImage];
+				if (oDestRect.IsEmpty())
+					continue;
+				for (int iStartY = oDestRect.iTop; iStartY < oDestRect.iBottom; iStartY += c_iDecodeEncodeBandHeight)
+				{
+					DirtyMipJob& oJob = oJobs[iJob++];
+					oJob.iImage = iImage;
+					oJob.iStartY = iStartY;
+					oJob.iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, oDestRect.iBottom);
+				}
+			}
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iJobIndex = 0; iJobIndex < (int)iJobCount; ++iJobIndex)
+			{
+				const DirtyMipJob& oJob = oJobs[iJobIndex];
+				const Texture::DirtyRect& oDestRect = oDestRects[oJob.iImage];
+				const Texture::TextureFaceData& oSrcFaceData = pTexture->GetData().GetFaceData(iMip, oJob.iImage % iFaceCount, oJob.iImage / iFaceCount);
+				const Texture::TextureFaceData& oDstFaceData = pTexture->GetData().GetFaceData(iMip + 1, oJob.iImage % iFaceCount, oJob.iImage / iFaceCount);
+				const int iWidth = oDestRect.iRight - oDestRect.iLeft;
+
+				// Columns of a 2:1 reduction are independent, reduce the sub-image
+				const bool bFullWidth = iWidth == oDstFaceData.iWidth;
+				if (MipReduction::Reduce(oFormatInfos,
+					(const char*)oSrcFaceData.pData + (size_t)oDestRect.iLeft * 2 * oFormatInfos.iBlockSize, bFullWidth ? oSrcFaceData.iWidth : iWidth * 2, oSrcFaceData.iHeight, oSrcFaceData.iPitch, 0,
+					(char*)oDstFaceData.pData + (size_t)oDestRect.iLeft * oFormatInfos.iBlockSize, iWidth, oDstFaceData.iHeight, oDstFaceData.iPitch,
+					oJob.iStartY, oJob.iEndY) == false)
+				{
+					bError = true;
+				}
+			}
+
+			// Regions marked on the next level are propagated with the updated ones, updated regions are marked to change the level revisions
+			for (int iImage = 0; iImage < iImageCount; ++iImage)
+			{
+				const Texture::DirtyRect& oDestRect = oDestRects[iImage];
+				if (oDestRect.IsEmpty() == false)
+					pTexture->MarkDirty(iMip + 1, iImage % iFaceCount, iImage / iFaceCount, oDestRect.iLeft, oDestRect.iTop, oDestRect.iRight - oDestRect.iLeft, oDestRect.iBottom - oDestRect.iTop);
+
+				const Texture::DirtyRect& oMarkedRect = pTexture->GetDirtyRect(iMip + 1, iImage % iFaceCount, iImage / iFaceCount);
+				oSourceRects[iImage] = oDestRects[iImage];
+				oSourceRects[iImage].Merge(oMarkedRect.iLeft, oMarkedRect.iTop, oMarkedRect.iRight, oMarkedRect.iBottom);
+
+				if (bNative == false && oSourceRects[iImage].IsEmpty() == false)
+				{
+					// Chain is filtered from mip 0, regions marked on the next level are regenerated too, whole blocks are encoded
+					Texture::DirtyRect& oEncodeRect = oEncodeRects[(size_t)(iMip + 1) * iImageCount + iImage];
+					oEncodeRect = oSourceRects[iImage];
+					oEncodeRect.iLeft -= oEncodeRect.iLeft % iBlockWidth;
+					oEncodeRect.iTop -= oEncodeRect.iTop % iBlockHeight;
+					oEncodeRect.iRight = Math::Min(oEncodeRect.iRight + (iBlockWidth - oEncodeRect.iRight % iBlockWidth) % iBlockWidth, oDstLevel.iWidth);
+					oEncodeRect.iBottom = Math::Min(oEncodeRect.iBottom + (iBlockHeight - oEncodeRect.iBottom % iBlockHeight) % iBlockHeight, oDstLevel.iHeight);
+				}
+			}
+		}
+
+		if (bError)
+		{
+			return ErrorCode(2, "Internal error");
+		}
+
+		if (bNative == false)
+		{
+			ErrorCode oErr = GenerateMipsDecodeEncode(pTexture, pTexture, false, iMipCount, oChains, oSettings, oEncodeRects.begin());
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+		}
+
+		pTexture->ClearDirtyRects();
+
+		return ErrorCode::Ok;
+	}
+
+	// Project each mip of a LatLong texture on the faces of a RGBA32F cubemap, lines of faces are processed by parallel jobs
+	static ErrorCode ProjectLatLongToCubemap(const Texture& oTexture, int iFaceSize, int iMipCount, const FilteringChains& oChains, Texture* pOutCubemap)
+	{
+		const PixelFormatEnum ePixelFormat = oTexture.GetPixelFormat();
+
+		Texture oCubemap;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = oDesc.iHeight = iFaceSize;
+		oDesc.iFaceCount = Texture::_E_FACE_COUNT;
+		oDesc.iMipCount = iMipCount;
+		ErrorCode oErr = oCubemap.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+		const int iBlockHeight = oFormatInfos.iBlockHeight;
+		bool bError = false;
+
+		for (int iMip = 0; iMip < iMipCount && bError == false; ++iMip)
+		{
+			const Texture::TextureFaceData& oSrcFaceData = oTexture.GetData().GetFaceData(iMip, 0);
+			const int iSourceWidth = oSrcFaceData.iWidth;
+			const int iSourceHeight = oSrcFaceData.iHeight;
+
+			// Whole source level is decoded, any line can be sampled by any face
+			CORE_PTR_VOID pDecoded = CORE_PTR_NULL;
+			const float* pSource = (const float*)oSrcFaceData.pData;
+			if (oChains.iDecodeChainLength > 0)
+			{
+				pDecoded = Core::Malloc((size_t)iSourceWidth * iSourceHeight * 4 * sizeof(float));
+				if (pDecoded == NULL)
+					return ErrorCode(1, "Can't allocate working buffer");
+				ConvertPixelFormatRegion(
+					oSrcFaceData.pData, oSrcFaceData.iPitch, ePixelFormat,
+					pDecoded, (size_t)iSourceWidth * 4 * sizeof(float), PixelFormatEnum::RGBA32_FLOAT,
+					iSourceWidth, iSourceHeight,
+					oChains.oDecodeChain, oChains.iDecodeChainLength);
+				pSource = (const float*)pDecoded;
+			}
+
+			const int iMipFaceSize = oCubemap.GetData().GetFaceData(iMip, 0).iWidth;
+			const int iBandCount = (iMipFaceSize + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+			const int iJobCount = Texture::_E_FACE_COUNT * iBandCount;
+			const size_t iBandPitch = (size_t)iMipFaceSize * 4 * sizeof(float);
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iJob = 0; iJob < iJobCount; ++iJob)
+			{
+				const int iFace = iJob / iBandCount;
+				const int iStartY = (iJob % iBandCount) * c_iDecodeEncodeBandHeight;
+				const int iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, iMipFaceSize);
+
+				// Band of RGBA pixels followed by X, Y, Z, U and V lines
+				CORE_PTR_VOID pWorking = Core::Malloc(iBandPitch * (iEndY - iStartY) + (size_t)iMipFaceSize * 5 * sizeof(float));
+				if (pWorking == NULL)
+				{
+					bError = true;
+					continue;
+				}
+				float* pBand = (float*)pWorking;
+				float* pX = pBand + (size_t)iMipFaceSize * 4 * (iEndY - iStartY);
+				float* pY = pX + iMipFaceSize;
+				float* pZ = pY + iMipFaceSize;
+				float* pU = pZ + iMipFaceSize;
+				float* pV = pU + iMipFaceSize;
+
+				for (int iY = iStartY; iY < iEndY; ++iY)
+				{
+					CubemapSampling::GetFaceDirections((Texture::EFace)iFace, iMipFaceSize, iY, pX, pY, pZ);
+					CubemapSampling::DirectionsToLatLong(pX, pY, pZ, iMipFaceSize, pU, pV);
+					CubemapSampling::SampleBilinear(pSource, iSourceWidth, iSourceHeight, pU, pV, iMipFaceSize, pBand + (size_t)(iY - iStartY) * iMipFaceSize * 4);
+				}
+
+				const Texture::TextureFaceData& oDstFaceData = oCubemap.GetData().GetFaceData(iMip, iFace);
+				ConvertPixelFormatRegion(
+					pBand, iBandPitch, PixelFormatEnum::RGBA32_FLOAT,
+					(char*)oDstFaceData.pData + (size_t)(iStartY / iBlockHeight) * oDstFaceData.iPitch, oDstFaceData.iPitch, ePixelFormat,
+					iMipFaceSize, iEndY - iStartY,
+					oChains.oEncodeChain, oChains.iEncodeChainLength);
+
+				Core::Free(pWorking);
+			}
+
+			if (pDecoded != NULL)
+				Core::Free(pDecoded);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffer");
+		}
+
+		oCubemap.Swap(*pOutCubemap);
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ConvertTextureToCubemap(const Graphics::Texture& oTexture, Graphics::Texture* pOutCubemap)
+	{
+		if (pOutCubemap == NULL)
+		{
+			return ErrorCode(1, "Out cubemap texture argument is null");
+		}
+
+		int iSourceWidth = oTexture.GetWidth();
+		int iSourceHeight = oTexture.GetHeight();
+
+		ECubemapFormat eCubemapFormat;
+		int iFaceSize;
+
+		if (oTexture.GetFaceCount() != 1)
+		{
+			return ErrorCode(1, "Source texture need to have only one face data when bDataIsCubemap is true");
+		}
+
+		if (oTexture.IsArray() || oTexture.IsVolume())
+		{
+			return ErrorCode(1, "Source texture can't be an array or a volume");
+		}
+
+		if (DetermineCubemapFormatFromImageSize(iSourceWidth, iSourceHeight, &eCubemapFormat, &iFaceSize) == false)
+		{
+			return ErrorCode(1, "Source is not a valid cubemap format");
+		}
+
+		const PixelFormatEnum ePixelFormat = oTexture.GetPixelFormat();
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+
+		// Source levels whose faces are still whole, levels of the cubemap face size chain
+		int iMipCount = 1;
+		while (iMipCount < oTexture.GetMipCount() && (iFaceSize >> iMipCount) > 0)
+			++iMipCount;
+
+		if (eCubemapFormat == E_CUBEMAPFORMAT_LATLONG)
+		{
+			FilteringChains oChains;
+			if (GetFilteringChains(ePixelFormat, true, &oChains) == false)
+			{
+				return ErrorCode(1, "'%s' Pixel format can't be projected", oFormatInfos.pName);
+			}
+			return ProjectLatLongToCubemap(oTexture, iFaceSize, iMipCount, oChains, pOutCubemap);
+		}
+
+		// Faces are copied by blocks, stop at the first level where faces don't start on a block
+		for (int iMip = 0; iMip < iMipCount; ++iMip)
+		{
+			const int iMipFaceSize = iFaceSize >> iMip;
+			if ((iMipFaceSize % oFormatInfos.iBlockWidth) != 0 || (iMipFaceSize % oFormatInfos.iBlockHeight) != 0)
+			{
+				if (iMip == 0)
+					return ErrorCode(1, "Cubemap face size is not a multiple of '%s' block size", oFormatInfos.pName);
+				iMipCount = iMip;
+				break;
+			}
+		}
+
+		Texture oCubemap;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = oDesc.iHeight = iFaceSize;
+		oDesc.iFaceCount = Texture::_E_FACE_COUNT;
+		oDesc.iMipCount = iMipCount;
+		ErrorCode oErr = oCubemap.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		for (int iMip = 0; iMip < iMipCount; ++iMip)
+		{
+			const Texture::TextureFaceData& oSrcFaceData = oTexture.GetData().GetFaceData(iMip, 0);
+			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+			{
+				const Texture::TextureFaceData& oFaceData = oCubemap.GetData().GetFaceData(iMip, iFace);
+
+				int iX, iY;
+				if (GetCubemapFacePos(oSrcFaceData.iWidth, oSrcFaceData.iHeight, eCubemapFormat, (Texture::EFace)iFace, &iX, &iY) == false)
+				{
+					CORE_ASSERT(false);
+				}
+
+				const int iBlockRowCount = oFaceData.iHeight / oFormatInfos.iBlockHeight;
+				const size_t iRowSize = (size_t)(oFaceData.iWidth / oFormatInfos.iBlockWidth) * oFormatInfos.iBlockSize;
+				for (int iBlockRow = 0; iBlockRow < iBlockRowCount; ++iBlockRow)
+				{
+					const char* pSource = (const char*)oSrcFaceData.pData + (size_t)(iY / oFormatInfos.iBlockHeight + iBlockRow) * oSrcFaceData.iPitch + (size_t)(iX / oFormatInfos.iBlockWidth) * oFormatInfos.iBlockSize;
+					char* pDest = (char*)oFaceData.pData + (size_t)iBlockRow * oFaceData.iPitch;
+					memcpy(pDest, pSource, iRowSize);
+				}
+			}
+		}
+
+		oCubemap.Swap(*pOutCubemap);
+		return ErrorCode::Ok;
+	}
+
+	// Resample each mip of a cubemap in a LatLong texture, lines of the LatLong texture are processed by parallel jobs
+	static ErrorCode ProjectCubemapToLatLong(const Texture& oCubemap, int iMipCount, const FilteringChains& oChains, Texture* pOutTexture)
+	{
+		const PixelFormatEnum ePixelFormat = oCubemap.GetPixelFormat();
+
+		Texture oLatLong;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = oCubemap.GetWidth() * 4;
+		oDesc.iHeight = oCubemap.GetWidth() * 2;
+		oDesc.iMipCount = iMipCount;
+		ErrorCode oErr = oLatLong.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const int iBlockHeight = PixelFormatEnumInfos[ePixelFormat].iBlockHeight;
+		bool bError = false;
+
+		for (int iMip = 0; iMip < iMipCount && bError == false; ++iMip)
+		{
+			const int iFaceSize = oCubemap.GetData().GetFaceData(iMip, 0).iWidth;
+			const size_t iFaceFloatCount = (size_t)iFaceSize * iFaceSize * 4;
+
+			// All faces are decoded, any direction can be sampled by any line
+			CORE_PTR_VOID pDecoded = CORE_PTR_NULL;
+			const float* pFaces[Texture::_E_FACE_COUNT];
+			if (oChains.iDecodeChainLength > 0)
+			{
+				pDecoded = Core::Malloc(iFaceFloatCount * Texture::_E_FACE_COUNT * sizeof(float));
+				if (pDecoded == NULL)
+					return ErrorCode(1, "Can't allocate working buffer");
+			}
+			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+			{
+				const Texture::TextureFaceData& oFaceData = oCubemap.GetData().GetFaceData(iMip, iFace);
+				if (pDecoded != NULL)
+				{
+					float* pFace = (float*)pDecoded + iFaceFloatCount * iFace;
+					ConvertPixelFormatRegion(
+						oFaceData.pData, oFaceData.iPitch, ePixelFormat,
+						pFace, (size_t)iFaceSize * 4 * sizeof(float), PixelFormatEnum::RGBA32_FLOAT,
+						iFaceSize, iFaceSize,
+						oChains.oDecodeChain, oChains.iDecodeChainLength);
+					pFaces[iFace] = pFace;
+				}
+				else
+				{
+					pFaces[iFace] = (const float*)oFaceData.pData;
+				}
+			}
+
+			const Texture::TextureFaceData& oDstFaceData = oLatLong.GetData().GetFaceData(iMip, 0);
+			const int iWidth = oDstFaceData.iWidth;
+			const int iHeight = oDstFaceData.iHeight;
+			Core::Array<float> oSinLongitudes, oCosLongitudes;
+			if (CubemapSampling::ComputeLongitudes(iWidth, &oSinLongitudes, &oCosLongitudes) == false)
+			{
+				bError = true;
+			}
+
+			const int iJobCount = bError ? 0 : (iHeight + c_iDecodeEncodeBandHeight - 1) / c_iDecodeEncodeBandHeight;
+			const size_t iBandPitch = (size_t)iWidth * 4 * sizeof(float);
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iJob = 0; iJob < iJobCount; ++iJob)
+			{
+				const int iStartY = iJob * c_iDecodeEncodeBandHeight;
+				const int iEndY = Math::Min(iStartY + c_iDecodeEncodeBandHeight, iHeight);
+
+				// Band of RGBA pixels followed by X, Y, Z, U, V and face lines
+				CORE_PTR_VOID pWorking = Core::Malloc(iBandPitch * (iEndY - iStartY) + (size_t)iWidth * 6 * sizeof(float));
+				if (pWorking == NULL)
+				{
+					bError = true;
+					continue;
+				}
+				float* pBand = (float*)pWorking;
+				float* pX = pBand + (size_t)iWidth * 4 * (iEndY - iStartY);
+				float* pY = pX + iWidth;
+				float* pZ = pY + iWidth;
+				float* pU = pZ + iWidth;
+				float* pV = pU + iWidth;
+				int* pFacesIndex = (int*)(pV + iWidth);
+
+				for (int iY = iStartY; iY < iEndY; ++iY)
+				{
+					CubemapSampling::GetLatLongDirections(oSinLongitudes.begin(), oCosLongitudes.begin(), iWidth, iHeight, iY, pX, pY, pZ);
+					CubemapSampling::DirectionsToFaces(pX, pY, pZ, iWidth, pFacesIndex, pU, pV);
+					CubemapSampling::SampleFacesBilinear(pFaces, iFaceSize, pFacesIndex, pU, pV, iWidth, pBand + (size_t)(iY - iStartY) * iWidth * 4);
+				}
+
+				ConvertPixelFormatRegion(
+					pBand, iBandPitch, PixelFormatEnum::RGBA32_FLOAT,
+					(char*)oDstFaceData.pData + (size_t)(iStartY / iBlockHeight) * oDstFaceData.iPitch, oDstFaceData.iPitch, ePixelFormat,
+					iWidth, iEndY - iStartY,
+					oChains.oEncodeChain, oChains.iEncodeChainLength);
+
+				Core::Free(pWorking);
+			}
+
+			if (pDecoded != NULL)
+				Core::Free(pDecoded);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffer");
+		}
+
+		oLatLong.Swap(*pOutTexture);
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ConvertCubemapToTexture(const Graphics::Texture& oCubemap, ECubemapFormat eFormat, Graphics::Texture* pOutTexture)
+	{
+		if (pOutTexture == NULL)
+		{
+			return ErrorCode(1, "Out texture argument is null");
+		}
+
+		if (oCubemap.GetFaceCount() != Texture::_E_FACE_COUNT || oCubemap.IsArray())
+		{
+			return ErrorCode(1, "Source texture need to be a single cubemap");
+		}
+
+		if (eFormat == E_CUBEMAPFORMAT_NONE || eFormat >= _E_CUBEMAPFORMAT_COUNT)
+		{
+			return ErrorCode(1, "Invalid cubemap format");
+		}
+
+		const PixelFormatEnum ePixelFormat = oCubemap.GetPixelFormat();
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+		const int iFaceSize = oCubemap.GetWidth();
+		int iMipCount = oCubemap.GetMipCount();
+
+		if (eFormat == E_CUBEMAPFORMAT_LATLONG)
+		{
+			FilteringChains oChains;
+			if (GetFilteringChains(ePixelFormat, true, &oChains) == false)
+			{
+				return ErrorCode(1, "'%s' Pixel format can't be projected", oFormatInfos.pName);
+			}
+			return ProjectCubemapToLatLong(oCubemap, iMipCount, oChains, pOutTexture);
+		}
+
+		// Faces are copied by blocks, stop at the first level where faces don't fill whole blocks
+		for (int iMip = 0; iMip < iMipCount; ++iMip)
+		{
+			const int iMipFaceSize = Math::Max(iFaceSize >> iMip, 1);
+			if ((iMipFaceSize % oFormatInfos.iBlockWidth) != 0 || (iMipFaceSize % oFormatInfos.iBlockHeight) != 0)
+			{
+				if (iMip == 0)
+					return ErrorCode(1, "Cubemap face size is not a multiple of '%s' block size", oFormatInfos.pName);
+				iMipCount = iMip;
+				break;
+			}
+		}
+
+		Texture oTexture;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iMipCount = iMipCount;
+		switch (eFormat)
+		{
+		case E_CUBEMAPFORMAT_STRIP_VERTICAL:
+			oDesc.iWidth = iFaceSize;
+			oDesc.iHeight = iFaceSize * 6;
+			break;
+		case E_CUBEMAPFORMAT_STRIP_HORIZONTAL:
+			oDesc.iWidth = iFaceSize * 6;
+			oDesc.iHeight = iFaceSize;
+			break;
+		case E_CUBEMAPFORMAT_CROSS_VERTICAL:
+			oDesc.iWidth = iFaceSize * 3;
+			oDesc.iHeight = iFaceSize * 4;
+			break;
+		default:
+			oDesc.iWidth = iFaceSize * 4;
+			oDesc.iHeight = iFaceSize * 3;
+			break;
+		}
+		ErrorCode oErr = oTexture.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		// Unused cells of crosses stay black
+		for (int iMip = 0; iMip < iMipCount; ++iMip)
+		{
+			const Texture::TextureFaceData& oDstFaceData = oTexture.GetData().GetFaceData(iMip, 0);
+			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+			{
+				const Texture::TextureFaceData& oFaceData = oCubemap.GetData().GetFaceData(iMip, iFace);
+
+				int iX, iY;
+				if (GetCubemapFacePos(oDstFaceData.iWidth, oDstFaceData.iHeight, eFormat, (Texture::EFace)iFace, &iX, &iY) == false)
+				{
+					CORE_ASSERT(false);
+				}
+
+				const int iBlockRowCount = oFaceData.iHeight / oFormatInfos.iBlockHeight;
+				const size_t iRowSize = (size_t)(oFaceData.iWidth / oFormatInfos.iBlockWidth) * oFormatInfos.iBlockSize;
+				for (int iBlockRow = 0; iBlockRow < iBlockRowCount; ++iBlockRow)
+				{
+					const char* pSource = (const char*)oFaceData.pData + (size_t)iBlockRow * oFaceData.iPitch;
+					char* pDest = (char*)oDstFaceData.pData + (size_t)(iY / oFormatInfos.iBlockHeight + iBlockRow) * oDstFaceData.iPitch + (size_t)(iX / oFormatInfos.iBlockWidth) * oFormatInfos.iBlockSize;
+					memcpy(pDest, pSource, iRowSize);
+				}
+			}
+		}
+
+		oTexture.Swap(*pOutTexture);
+		return ErrorCode::Ok;
+	}
+
+	SpecularFilterSettings::SpecularFilterSettings()
+	{
+		iSampleCount = 64;
+		iMipCount = 0;
+	}
+
+	struct SpecularSample
+	{
+		float						fDirection[3]; // Tangent space, the lobe axis is +Z
+		float						fWeight; // N.L
+		float						fLod; // Source level, fractional
+	};
+
+	struct SpecularJob
+	{
+		int							iMip;
+		int							iFace;
+		int							iStartY;
+		int							iEndY;
+	};
+
+	static const int c_iSpecularBandHeight = 8;
+
+	// Van der Corput radical inverse in base 2
+	static double RadicalInverse(unsigned int iBits)
+	{
+		iBits = (iBits << 16u) | (iBits >> 16u);
+		iBits = ((iBits & 0x55555555u) << 1u) | ((iBits & 0xAAAAAAAAu) >> 1u);
+		iBits = ((iBits & 0x33333333u) << 2u) | ((iBits & 0xCCCCCCCCu) >> 2u);
+		iBits = ((iBits & 0x0F0F0F0Fu) << 4u) | ((iBits & 0xF0F0F0F0u) >> 4u);
+		iBits = ((iBits & 0x00FF00FFu) << 8u) | ((iBits & 0xFF00FF00u) >> 8u);
+		return iBits * 2.3283064365386963e-10;
+	}
+
+	// GGX importance samples of a Hammersley set, light directions are reflected around half vectors with V = N
+	// Source level of each sample matches the solid angle covered by the sample (GPU Gems 3, chapter 20)
+	static bool ComputeSpecularSamples(float fRoughness, int iSampleCount, int iSourceFaceSize, int iSourceMipCount, Core::Array<SpecularSample>* pOutSamples, int* pOutCount, float* pOutTotalWeight)
+	{
+		if (pOutSamples->resize(iSampleCount, false) == false)
+			return false;
+
+		const double c_fPi = 3.14159265358979323846;
+		const double fAlpha = (double)fRoughness * fRoughness;
+		const double fAlpha2 = fAlpha * fAlpha;
+		const double fTexelSolidAngle = 4.0 * c_fPi / (6.0 * iSourceFaceSize * iSourceFaceSize);
+
+		int iCount = 0;
+		double fTotalWeight = 0.0;
+		for (int iSample = 0; iSample < iSampleCount; ++iSample)
+		{
+			const double fPhi = 2.0 * c_fPi * iSample / iSampleCount;
+			const double fE = RadicalInverse((unsigned int)iSample);
+			const double fCosTheta = sqrt((1.0 - fE) / (1.0 + (fAlpha2 - 1.0) * fE));
+			const double fSinTheta = sqrt(Math::Max(1.0 - fCosTheta * fCosTheta, 0.0));
+
+			const double fNdotL = 2.0 * fCosTheta * fCosTheta - 1.0;
+			if (fNdotL <= 0.0)
+				continue;
+
+			// pdf(L) = D(H) * N.H / (4 * V.H), N.H = V.H when V = N
+			const double fDenominator = fCosTheta * fCosTheta * (fAlpha2 - 1.0) + 1.0;
+			const double fPdf = fAlpha2 / (4.0 * c_fPi * fDenominator * fDenominator);
+			const double fSampleSolidAngle = 1.0 / (iSampleCount * fPdf);
+			const double fLod = 0.5 * log(fSampleSolidAngle / fTexelSolidAngle) / log(2.0) + 1.0;
+
+			SpecularSample& oSample = (*pOutSamples)[iCount++];
+			oSample.fDirection[0] = (float)(2.0 * fCosTheta * fSinTheta * cos(fPhi));
+			oSample.fDirection[1] = (float)(2.0 * fCosTheta * fSinTheta * sin(fPhi));
+			oSample.fDirection[2] = (float)fNdotL;
+			oSample.fWeight = (float)fNdotL;
+			oSample.fLod = (float)Math::Clamp(fLod, 0.0, (double)(iSourceMipCount - 1));
+			fTotalWeight += fNdotL;
+		}
+
+		*pOutCount = iCount;
+		*pOutTotalWeight = (float)fTotalWeight;
+		return true;
+	}
+
+	ErrorCode PrefilterSpecularCubemap(const Graphics::Texture& oCubemap, Graphics::Texture* pOutCubemap, const SpecularFilterSettings* pSettings, double* pOutTexelsPerSecond)
+	{
+		if (pOutCubemap == NULL)
+		{
+			return ErrorCode(1, "Out texture argument is null");
+		}
+
+		if (oCubemap.GetFaceCount() != Texture::_E_FACE_COUNT || oCubemap.IsArray() || oCubemap.GetWidth() != oCubemap.GetHeight())
+		{
+			return ErrorCode(1, "Source texture need to be a single cubemap");
+		}
+
+		SpecularFilterSettings oDefaultSettings;
+		const SpecularFilterSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+		if (oSettings.iSampleCount < 1)
+		{
+			return ErrorCode(1, "Invalid sample count");
+		}
+
+		const std::chrono::steady_clock::time_point oStartTime = std::chrono::steady_clock::now();
+
+		// RGBA float source with a full mip chain
+		Texture oSource;
+		const Texture* pSource = &oCubemap;
+		if (oCubemap.GetPixelFormat() != PixelFormatEnum::RGBA32_FLOAT)
+		{
+			ErrorCode oErr = ConvertPixelFormat(&oCubemap, &oSource, PixelFormatEnum::RGBA32_FLOAT);
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+			pSource = &oSource;
+		}
+		const int iFullMipCount = GetFullMipCount(pSource);
+		if (pSource->GetMipCount() < iFullMipCount)
+		{
+			ErrorCode oErr = GenerateMips(pSource, &oSource, true);
+			if (oErr != ErrorCode::Ok)
+				return oErr;
+			pSource = &oSource;
+		}
+
+		const float* pSourceFaces[Texture::c_iMaxMip][Texture::_E_FACE_COUNT];
+		for (int iMip = 0; iMip < iFullMipCount; ++iMip)
+		{
+			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+				pSourceFaces[iMip][iFace] = (const float*)pSource->GetData().GetFaceData(iMip, iFace).pData;
+		}
+
+		const int iFaceSize = pSource->GetWidth();
+		const int iMipCount = (oSettings.iMipCount > 0) ? Math::Min(oSettings.iMipCount, iFullMipCount) : iFullMipCount;
+
+		Texture oPrefiltered;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = PixelFormatEnum::RGBA32_FLOAT;
+		oDesc.iWidth = iFaceSize;
+		oDesc.iHeight = iFaceSize;
+		oDesc.iFaceCount = Texture::_E_FACE_COUNT;
+		oDesc.iMipCount = iMipCount;
+		ErrorCode oErr = oPrefiltered.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		// Level 0 is a perfect mirror
+		for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+		{
+			const Texture::TextureFaceData& oSourceFaceData = pSource->GetData().GetFaceData(0, iFace);
+			memcpy(oPrefiltered.GetData().GetFaceData(0, iFace).pData, oSourceFaceData.pData, oSourceFaceData.iSize);
+		}
+
+		// Samples of each level, jobs cover mips, faces and bands of lines
+		Core::Array<SpecularSample> oSamples[Texture::c_iMaxMip];
+		int iSampleCounts[Texture::c_iMaxMip] = { 0 };
+		float fTotalWeights[Texture::c_iMaxMip] = { 0.f };
+		Core::Array<SpecularJob> oJobs;
+		int iJobCount = 0;
+		size_t iTexelCount = (size_t)iFaceSize * iFaceSize * Texture::_E_FACE_COUNT;
+		for (int iMip = 1; iMip < iMipCount; ++iMip)
+		{
+			const float fRoughness = (float)iMip / (float)(iMipCount - 1);
+			if (ComputeSpecularSamples(fRoughness, oSettings.iSampleCount, iFaceSize, iFullMipCount, &oSamples[iMip], &iSampleCounts[iMip], &fTotalWeights[iMip]) == false)
+			{
+				return ErrorCode(1, "Can't allocate working buffer");
+			}
+
+			const int iMipSize = oPrefiltered.GetData().GetFaceData(iMip, 0).iWidth;
+			const int iBandCount = (iMipSize + c_iSpecularBandHeight - 1) / c_iSpecularBandHeight;
+			if (oJobs.resize(iJobCount + iBandCount * Texture::_E_FACE_COUNT, true) == false)
+			{
+				return ErrorCode(1, "Can't allocate working buffer");
+			}
+			for (int iFace = 0; iFace < Texture::_E_FACE_COUNT; ++iFace)
+			{
+				for (int iBand = 0; iBand < iBandCount; ++iBand)
+				{
+					SpecularJob& oJob = oJobs[iJobCount++];
+					oJob.iMip = iMip;
+					oJob.iFace = iFace;
+					oJob.iStartY = iBand * c_iSpecularBandHeight;
+					oJob.iEndY = Math::Min(oJob.iStartY + c_iSpecularBandHeight, iMipSize);
+				}
+			}
+			iTexelCount += (size_t)iMipSize * iMipSize * Texture::_E_FACE_COUNT;
+		}
+
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iJob = 0; iJob < iJobCount; ++iJob)
+		{
+			const SpecularJob& oJob = oJobs[iJob];
+			const Texture::TextureFaceData& oDstFaceData = oPrefiltered.GetData().GetFaceData(oJob.iMip, oJob.iFace);
+			const int iWidth = oDstFaceData.iWidth;
+
+			// Per texel : normal, frame, sample direction, U, V, face, two fetches and the accumulated color
+			CORE_PTR_VOID pWorking = Core::Malloc((size_t)iWidth * 30 * sizeof(float));
+			if (pWorking == NULL)
+			{
+				bError = true;
+				continue;
+			}
+			float* pNormalX = (float*)pWorking;
+			float* pNormalY = pNormalX + iWidth;
+			float* pNormalZ = pNormalY + iWidth;
+			CubemapSampling::LineFrames oFrames;
+			for (int iAxis = 0; iAxis < 3; ++iAxis)
+			{
+				for (int iComponent = 0; iComponent < 3; ++iComponent)
+					oFrames.pAxes[iAxis][iComponent] = pNormalZ + iWidth * (1 + iAxis * 3 + iComponent);
+			}
+			float* pX = pNormalZ + iWidth * 10;
+			float* pY = pX + iWidth;
+			float* pZ = pY + iWidth;
+			float* pU = pZ + iWidth;
+			float* pV = pU + iWidth;
+			int* pFacesIndex = (int*)(pV + iWidth);
+			float* pPixels0 = (float*)(pFacesIndex + iWidth);
+			float* pPixels1 = pPixels0 + (size_t)iWidth * 4;
+			float* pAccumulation = pPixels1 + (size_t)iWidth * 4;
+
+			const SpecularSample* pSamples = oSamples[oJob.iMip].begin();
+			const int iSampleCount = iSampleCounts[oJob.iMip];
+			const __m128 xInvTotalWeight = _mm_set1_ps(1.f / fTotalWeights[oJob.iMip]);
+
+			for (int iY = oJob.iStartY; iY < oJob.iEndY; ++iY)
+			{
+				CubemapSampling::GetFaceDirections((Texture::EFace)oJob.iFace, iWidth, iY, pNormalX, pNormalY, pNormalZ);
+				CubemapSampling::GetLineFrames(pNormalX, pNormalY, pNormalZ, iWidth, oFrames);
+				memset(pAccumulation, 0, (size_t)iWidth * 4 * sizeof(float));
+
+				for (int iSample = 0; iSample < iSampleCount; ++iSample)
+				{
+					const SpecularSample& oSample = pSamples[iSample];
+					CubemapSampling::TransformFromFrames(oFrames, iWidth, oSample.fDirection[0], oSample.fDirection[1], oSample.fDirection[2], pX, pY, pZ);
+					CubemapSampling::DirectionsToFaces(pX, pY, pZ, iWidth, pFacesIndex, pU, pV);
+
+					// Trilinear fetch
+					const int iLevel0 = (int)oSample.fLod;
+					const int iLevel1 = Math::Min(iLevel0 + 1, iFullMipCount - 1);
+					const float fBlend = oSample.fLod - (float)iLevel0;
+					CubemapSampling::SampleFacesBilinear(pSourceFaces[iLevel0], Math::Max(iFaceSize >> iLevel0, 1), pFacesIndex, pU, pV, iWidth, pPixels0);
+					__m128 xWeight0 = _mm_set1_ps(oSample.fWeight * (1.f - fBlend));
+					if (fBlend > 0.f && iLevel1 != iLevel0)
+					{
+						CubemapSampling::SampleFacesBilinear(pSourceFaces[iLevel1], Math::Max(iFaceSize >> iLevel1, 1), pFacesIndex, pU, pV, iWidth, pPixels1);
+						const __m128 xWeight1 = _mm_set1_ps(oSample.fWeight * fBlend);
+						for (int iX = 0; iX < iWidth; ++iX)
+						{
+							const __m128 xSum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pPixels0 + iX * 4), xWeight0), _mm_mul_ps(_mm_loadu_ps(pPixels1 + iX * 4), xWeight1));
+							_mm_storeu_ps(pAccumulation + iX * 4, _mm_add_ps(_mm_loadu_ps(pAccumulation + iX * 4), xSum));
+						}
+					}
+					else
+					{
+						xWeight0 = _mm_set1_ps(oSample.fWeight);
+						for (int iX = 0; iX < iWidth; ++iX)
+						{
+							_mm_storeu_ps(pAccumulation + iX * 4, _mm_add_ps(_mm_loadu_ps(pAccumulation + iX * 4), _mm_mul_ps(_mm_loadu_ps(pPixels0 + iX * 4), xWeight0)));
+						}
+					}
+				}
+
+				float* pDest = (float*)((char*)oDstFaceData.pData + (size_t)iY * oDstFaceData.iPitch);
+				for (int iX = 0; iX < iWidth; ++iX)
+				{
+					_mm_storeu_ps(pDest + iX * 4, _mm_mul_ps(_mm_loadu_ps(pAccumulation + iX * 4), xInvTotalWeight));
+				}
+			}
+
+			Core::Free(pWorking);
+		}
+
+		if (bError)
+		{
+			return ErrorCode(1, "Can't allocate working buffer");
+		}
+
+		if (pOutTexelsPerSecond != NULL)
+		{
+			const double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - oStartTime).count();
+			*pOutTexelsPerSecond = (fSeconds > 0.0) ? (double)iTexelCount / fSeconds : 0.0;
+		}
+
+		oPrefiltered.Swap(*pOutCubemap);
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ConvertPixelFormat(TiledTexture* pTexture, TiledTexture* pOutTexture, PixelFormatEnum eWantedPixelFormat)
+	{
+		if (pTexture == NULL || pOutTexture == NULL || pTexture == pOutTexture || pTexture->IsValid() == false)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (eWantedPixelFormat == pTexture->GetPixelFormat())
+		{
+			return ErrorCode(1, "Same format");
+		}
+
+		PixelFormat::ConvertionFuncChain oConvertionFuncChain;
+		int iConvertionChainLength;
+		int iAdditionalBits;
+		if (PixelFormat::GetConvertionChain(pTexture->GetPixelFormat(), eWantedPixelFormat, &oConvertionFuncChain, &iConvertionChainLength, &iAdditionalBits) == false)
+		{
+			return ErrorCode(1, "Format convertion not implemented");
+		}
+
+		TiledTexture::Desc oNewDesc;
+		oNewDesc.ePixelFormat = eWantedPixelFormat;
+		oNewDesc.iWidth = pTexture->GetWidth();
+		oNewDesc.iHeight = pTexture->GetHeight();
+		oNewDesc.iFaceCount = pTexture->GetFaceCount();
+		oNewDesc.iMipCount = pTexture->GetMipCount();
+		oNewDesc.iTileSize = pTexture->GetTileSize();
+		oNewDesc.iMemoryBudget = pTexture->GetMemoryBudget();
+		ErrorCode oErr = pOutTexture->Create(oNewDesc);
+		if (oErr != ErrorCode::Ok)
+		{
+			return oErr;
+		}
+
+		const int iTileSize = pTexture->GetTileSize();
+		bool bError = false;
+		for (int iMip = 0, iMipCount = pTexture->GetMipCount(); iMip < iMipCount; ++iMip)
+		{
+			const int iTileCountX = pTexture->GetTileCountX(iMip);
+			const int iTileCountY = pTexture->GetTileCountY(iMip);
+			const int iTileCount = iTileCountX * iTileCountY * pTexture->GetFaceCount();
+			const int iMipWidth = pTexture->GetMipWidth(iMip);
+			const int iMipHeight = pTexture->GetMipHeight(iMip);
+
+			// Source and destination tiles cover the same pixels, each tile is independent
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iTile = 0; iTile < iTileCount; ++iTile)
+			{
+				int iFace = iTile / (iTileCountX * iTileCountY);
+				int iTileX = iTile % iTileCountX;
+				int iTileY = (iTile / iTileCountX) % iTileCountY;
+
+				void* pSource = pTexture->LockTile(iMip, iFace, iTileX, iTileY, TiledTexture::LockModeEnum::READ);
+				void* pDest = pOutTexture->LockTile(iMip, iFace, iTileX, iTileY, TiledTexture::LockModeEnum::WRITE_DISCARD);
+				if (pSource != NULL && pDest != NULL)
+				{
+					ConvertPixelFormatRegion(
+						pSource, pTexture->GetTilePitch(), pTexture->GetPixelFormat(),
+						pDest, pOutTexture->GetTilePitch(), eWantedPixelFormat,
+						Math::Min(iTileSize, iMipWidth - iTileX * iTileSize), Math::Min(iTileSize, iMipHeight - iTileY * iTileSize),
+						oConvertionFuncChain, iConvertionChainLength);
+				}
+				else
+				{
+					bError = true;
+				}
+				if (pSource != NULL)
+					pTexture->UnlockTile(iMip, iFace, iTileX, iTileY);
+				if (pDest != NULL)
+					pOutTexture->UnlockTile(iMip, iFace, iTileX, iTileY);
+			}
+		}
+
+		if (bError)
+		{
+			pOutTexture->Destroy();
+			return ErrorCode(1, "Can't access tiles");
+		}
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode ResizeTexture(TiledTexture* pTexture, TiledTexture* pOutTexture, int iNewWidth, int iNewHeight)
+	{
+		if (pTexture == NULL || pOutTexture == NULL || pTexture == pOutTexture || pTexture->IsValid() == false || iNewWidth <= 0 || iNewHeight <= 0)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (IsPixelFormatFilterable(pTexture->GetPixelFormat()) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+		}
+
+		TiledTexture::Desc oDesc;
+		oDesc.ePixelFormat = pTexture->GetPixelFormat();
+		oDesc.iWidth = iNewWidth;
+		oDesc.iHeight = iNewHeight;
+		oDesc.iMipCount = 1;
+		oDesc.iFaceCount = pTexture->GetFaceCount();
+		oDesc.iTileSize = pTexture->GetTileSize();
+		oDesc.iMemoryBudget = pTexture->GetMemoryBudget();
+		ErrorCode oErr = pOutTexture->Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+		const int iPixelSize = oFormatInfos.iBitsPerPixel / 8;
+		const bool bSRGB = oFormatInfos.eEncoding == ComponentEncodingEnum::SRGB;
+		const int iTileSize = pOutTexture->GetTileSize();
+		const int iSourceWidth = pTexture->GetWidth();
+		const int iSourceHeight = pTexture->GetHeight();
+		const float fScaleX = iSourceWidth / (float)iNewWidth;
+		const float fScaleY = iSourceHeight / (float)iNewHeight;
+		// Source pixels read around each tile so filter kernel see the same neighbours as a full resize
+		const int iMarginX = (int)ceilf(2.f * Math::Max(fScaleX, 1.f)) + 1;
+		const int iMarginY = (int)ceilf(2.f * Math::Max(fScaleY, 1.f)) + 1;
+
+		const int iTileCountX = pOutTexture->GetTileCountX(0);
+		const int iTileCountY = pOutTexture->GetTileCountY(0);
+		const int iTileCount = iTileCountX * iTileCountY * pOutTexture->GetFaceCount();
+		bool bError = false;
+
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int iTile = 0; iTile < iTileCount; ++iTile)
+		{
+			int iFace = iTile / (iTileCountX * iTileCountY);
+			int iTileX = iTile % iTileCountX;
+			int iTileY = (iTile / iTileCountX) % iTileCountY;
+
+			int iDstX0 = iTileX * iTileSize;
+			int iDstY0 = iTileY * iTileSize;
+			int iDstX1 = Math::Min(iDstX0 + iTileSize, iNewWidth);
+			int iDstY1 = Math::Min(iDstY0 + iTileSize, iNewHeight);
+
+			float fSrcX0 = iDstX0 * fScaleX;
+			float fSrcY0 = iDstY0 * fScaleY;
+			float fSrcX1 = iDstX1 * fScaleX;
+			float fSrcY1 = iDstY1 * fScaleY;
+
+			int iSrcX0 = Math::Max((int)floorf(fSrcX0) - iMarginX, 0);
+			int iSrcY0 = Math::Max((int)floorf(fSrcY0) - iMarginY, 0);
+			int iSrcX1 = Math::Min((int)ceilf(fSrcX1) + iMarginX, iSourceWidth);
+			int iSrcY1 = Math::Min((int)ceilf(fSrcY1) + iMarginY, iSourceHeight);
+			int iSrcW = iSrcX1 - iSrcX0;
+			int iSrcH = iSrcY1 - iSrcY0;
+
+			size_t iSrcPitch = (size_t)iSrcW * iPixelSize;
+			CORE_PTR_VOID pFootprint = Core::Malloc(iSrcPitch * iSrcH);
+			void* pDest = pOutTexture->LockTile(0, iFace, iTileX, iTileY, TiledTexture::LockModeEnum::WRITE_DISCARD);
+
+			int iRes = 0;
+			if (pFootprint != NULL && pDest != NULL
+				&& pTexture->ReadRegion(0, iFace, iSrcX0, iSrcY0, iSrcW, iSrcH, pFootprint, iSrcPitch) == ErrorCode::Ok)
+			{
+				iRes = stbir_resize_region(
+					pFootprint, iSrcW, iSrcH, (int)iSrcPitch,
+					pDest, iDstX1 - iDstX0, iDstY1 - iDstY0, (int)pOutTexture->GetTilePitch(),
+					oFormatInfos.eEncoding == ComponentEncodingEnum::FLOAT ? STBIR_TYPE_FLOAT : STBIR_TYPE_UINT8,
+					oFormatInfos.iComponents, bSRGB && oFormatInfos.iComponents == 4 ? 3 : STBIR_ALPHA_CHANNEL_NONE, 0,
+					STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT,
+					bSRGB ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR, NULL,
+					(fSrcX0 - iSrcX0) / iSrcW, (fSrcY0 - iSrcY0) / iSrcH,
+					(fSrcX1 - iSrcX0) / iSrcW, (fSrcY1 - iSrcY0) / iSrcH);
+			}
+
+			if (iRes == 0)
+				bError = true;
+			if (pDest != NULL)
+				pOutTexture->UnlockTile(0, iFace, iTileX, iTileY);
+			if (pFootprint != NULL)
+				Core::Free(pFootprint);
+		}
+
+		if (bError)
+		{
+			pOutTexture->Destroy();
+			return ErrorCode(2, "Internal error");
+		}
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode GenerateMips(TiledTexture* pTexture, TiledTexture* pOutTexture, bool bOnlyMissingMips)
+	{
+		if (pTexture == NULL || pOutTexture == NULL || pTexture == pOutTexture || pTexture->IsValid() == false)
+		{
+			return ErrorCode(1, "Invalid argument");
+		}
+
+		if (IsPixelFormatFilterable(pTexture->GetPixelFormat()) == false)
+		{
+			return ErrorCode(1, "'%s' Pixel format can't be resized", PixelFormatEnumInfos[pTexture->GetPixelFormat()].pName);
+		}
+
+		int iSize = Math::Max(pTexture->GetWidth(), pTexture->GetHeight());
+		int iMipCount = 1;
+		while (iSize > 1)
+		{
+			++iMipCount;
+			iSize = iSize >> 1;
+		}
+
+		TiledTexture::Desc oDesc;
+		oDesc.ePixelFormat = pTexture->GetPixelFormat();
+		oDesc.iWidth = pTexture->GetWidth();
+		oDesc.iHeight = pTexture->GetHeight();
+		oDesc.iMipCount = iMipCount;
+		oDesc.iFaceCount = pTexture->GetFaceCount();
+		oDesc.iTileSize = pTexture->GetTileSize();
+		oDesc.iMemoryBudget = pTexture->GetMemoryBudget();
+		ErrorCode oErr = pOutTexture->Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[pTexture->GetPixelFormat()];
+		const int iPixelSize = oFormatInfos.iBitsPerPixel / 8;
+		const int iTileSize = pOutTexture->GetTileSize();
+		const int iCopyMipCount = bOnlyMissingMips ? pTexture->GetMipCount() : 1;
+		bool bError = false;
+
+		for (int iMip = 0; iMip < iMipCount && bError == false; ++iMip)
+		{
+			const int iTileCountX = pOutTexture->GetTileCountX(iMip);
+			const int iTileCountY = pOutTexture->GetTileCountY(iMip);
+			const int iTileCount = iTileCountX * iTileCountY * pOutTexture->GetFaceCount();
+			const int iMipWidth = pOutTexture->GetMipWidth(iMip);
+			const int iMipHeight = pOutTexture->GetMipHeight(iMip);
+
+			// Each destination tile only depends on the footprint of its pixels in the previous mip
+#ifndef DEBUG
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int iTile = 0; iTile < iTileCount; ++iTile)
+			{
+				int iFace = iTile / (iTileCountX * iTileCountY);
+				int iTileX = iTile % iTileCountX;
+				int iTileY = (iTile / iTileCountX) % iTileCountY;
+				int iTileWidth = Math::Min(iTileSize, iMipWidth - iTileX * iTileSize);
+				int iTileHeight = Math::Min(iTileSize, iMipHeight - iTileY * iTileSize);
+
+				void* pDest = pOutTexture->LockTile(iMip, iFace, iTileX, iTileY, TiledTexture::LockModeEnum::WRITE_DISCARD);
+				if (pDest == NULL)
+				{
+					bError = true;
+					continue;
+				}
+
+				if (iMip < iCopyMipCount)
+				{
+					if (pTexture->ReadRegion(iMip, iFace, iTileX * iTileSize, iTileY * iTileSize, iTileWidth, iTileHeight, pDest, pOutTexture->GetTilePitch()) != ErrorCode::Ok)
+						bError = true;
+				}
+				else
+				{
+					// Same reduction as in memory mips, 3 taps polyphase filter for odd sizes
+					const int iSrcMipWidth = pOutTexture->GetMipWidth(iMip - 1);
+					const int iSrcMipHeight = pOutTexture->GetMipHeight(iMip - 1);
+					const int iDstX = iTileX * iTileSize;
+					const int iDstY = iTileY * iTileSize;
+					int iSrcX0, iSrcX1, iSrcY0, iSrcY1;
+					MipReduction::GetSourceRange(iSrcMipWidth, iMipWidth, iDstX, iDstX + iTileWidth, &iSrcX0, &iSrcX1);
+					MipReduction::GetSourceRange(iSrcMipHeight, iMipHeight, iDstY, iDstY + iTileHeight, &iSrcY0, &iSrcY1);
+					const int iSrcW = iSrcX1 - iSrcX0;
+					const int iSrcH = iSrcY1 - iSrcY0;
+					size_t iSrcPitch = (size_t)iSrcW * iPixelSize;
+
+					CORE_PTR_VOID pSource = Core::Malloc(iSrcPitch * iSrcH);
+					if (pSource == NULL
+						|| pOutTexture->ReadRegion(iMip - 1, iFace, iSrcX0, iSrcY0, iSrcW, iSrcH, pSource, iSrcPitch) != ErrorCode::Ok
+						|| MipReduction::ReduceRegion(oFormatInfos,
+							pSource, iSrcMipWidth, iSrcMipHeight, iSrcPitch, iSrcX0, iSrcY0,
+							pDest, iMipWidth, iMipHeight, pOutTexture->GetTilePitch(),
+							iDstX, iDstY, iDstX + iTileWidth, iDstY + iTileHeight) == false)
+					{
+						bError = true;
+					}
+					if (pSource != NULL)
+						Core::Free(pSource);
+				}
+
+				pOutTexture->UnlockTile(iMip, iFace, iTileX, iTileY);
+			}
+		}
+
+		if (bError)
+		{
+			pOutTexture->Destroy();
+			return ErrorCode(1, "Can't access tiles");
+		}
 		return ErrorCode::Ok;
 	}
-}
\ No newline at end of file
+}
@@ -2,9 +2,12 @@
 #define __GRAPHICS_TEXTURE_UTILS_H__
 
 #include "Graphics/Texture.h"
+#include "Graphics/Resampling.h"
 
 namespace Graphics
 {
+	class TiledTexture;
+
 	enum ECubemapFormat
 	{
 		E_CUBEMAPFORMAT_NONE = 0,
@@ -18,16 +21,79 @@ namespace Graphics
 	};
 	extern const char* const ECubemapFormat_string[_E_CUBEMAPFORMAT_COUNT];
 
+	// Convert a rectangle of pixels between two buffers, pitches are in bytes
+	void			ConvertPixelFormatRegion(const void* pSource, size_t iSourcePitch, PixelFormatEnum eSourcePixelFormat, void* pDest, size_t iDestPitch, PixelFormatEnum eDestPixelFormat, int iWidth, int iHeight, const PixelFormat::ConvertionFuncChain& oConvertionFuncChain, int iConvertionChainLength);
 	ErrorCode		ConvertPixelFormat(const Texture* pTexture, Texture* pOutTexture, PixelFormatEnum eWantedPixelFormat);
 
+	struct MipSettings
+	{
+		MipSettings();
+		bool						bNormalMap; // Filter XYZ as vectors and renormalize each level, two channels formats rebuild Z
+		bool						bNormalMapStoreLength; // Store filtered normal length (Toksvig factor) in alpha, four channels formats only
+		bool						bPreserveAlphaCoverage; // Scale alpha of each generated mip to keep the alpha test coverage of mip 0
+		float						fAlphaCoverageReference; // Alpha test threshold used for coverage
+		ResampleFilterEnum			eFilter; // Filters other than box are not supported for volume textures
+		EdgeModeEnum				eEdgeMode;
+	};
+
 	bool			IsPixelFormatResizable(PixelFormatEnum ePixelFormat);
-	ErrorCode		ResizeTexture(const Texture* pTexture, Texture* pOutTexture, int iNewWidth, int iNewHeight);
-	ErrorCode		GenerateMips(const Texture* pTexture, Texture* pOutTexture, bool bOnlyMissingMips);
+	ErrorCode		ResizeTexture(const Texture* pTexture, Texture* pOutTexture, int iNewWidth, int iNewHeight, ResampleFilterEnum eFilter = ResampleFilterEnum::DEFAULT, EdgeModeEnum eEdgeMode = EdgeModeEnum::CLAMP);
+	ErrorCode		GenerateMips(const Texture* pTexture, Texture* pOutTexture, bool bOnlyMissingMips, const MipSettings* pSettings = NULL);
+	// Update in place the footprint of the dirty rects of each level in the lower levels, and clear the dirty rects
+	// Updated regions are equal to the same regions of GenerateMips: formats filtered in a working format (not natively filterable,
+	// normal maps, resampling filters) filter the whole chain from mip 0 and only encode the footprints, regions marked on lower levels included
+	// Incomplete mip chains, volumes, alpha coverage and normal length are fully regenerated
+	ErrorCode		GenerateDirtyMips(Texture* pTexture, const MipSettings* pSettings = NULL);
+
+	/* Rectangle of one subresource, all depth slices of volumes
+	Views are snapped outward to the blocks of compressed formats and clamped to the mip, so operations on a view
+	only read the block rows of the region and cost time proportional to the region, not to the texture.
+	*/
+	struct TextureView
+	{
+		TextureView();
+		// Whole mip
+		explicit TextureView(const Texture* pTexture, int iMip = 0, int iFace = 0, int iLayer = 0);
+		const Texture*				pTexture;
+		int							iMip;
+		int							iFace;
+		int							iLayer;
+		int							iX;
+		int							iY;
+		int							iWidth;
+		int							iHeight;
+	};
+
+	// False when the subresource doesn't exist or the snapped rectangle is empty
+	bool			SnapTextureView(const TextureView& oView, TextureView* pOutView);
+	// Single mip texture of the snapped view in the same pixel format
+	ErrorCode		CopyTextureView(const TextureView& oView, Texture* pOutTexture);
+	// Same pixel format gives a copy, uncompressed formats are converted straight from the view
+	ErrorCode		ConvertPixelFormat(const TextureView& oView, Texture* pOutTexture, PixelFormatEnum eWantedPixelFormat);
+	ErrorCode		ResizeTexture(const TextureView& oView, Texture* pOutTexture, int iNewWidth, int iNewHeight, ResampleFilterEnum eFilter = ResampleFilterEnum::DEFAULT, EdgeModeEnum eEdgeMode = EdgeModeEnum::CLAMP);
+
+	// Out-of-core versions, processed tile by tile, pOutTexture is created with the same tile size and memory budget
+	ErrorCode		ConvertPixelFormat(TiledTexture* pTexture, TiledTexture* pOutTexture, PixelFormatEnum eWantedPixelFormat);
+	ErrorCode		ResizeTexture(TiledTexture* pTexture, TiledTexture* pOutTexture, int iNewWidth, int iNewHeight);
+	ErrorCode		GenerateMips(TiledTexture* pTexture, TiledTexture* pOutTexture, bool bOnlyMissingMips);
 
 	bool			DetermineCubemapFormatFromImageSize(int iWidth, int iHeight, ECubemapFormat* pOutFormat, int* pOutFaceSize);
 	bool			GetCubemapFacePos(int iWidth, int iHeight, ECubemapFormat eFormat, Texture::EFace eFace, int* pOutX, int* pOutY);
 
 	ErrorCode		ConvertTextureToCubemap(const Graphics::Texture& oTexture, Graphics::Texture* pOutCubemap);
+	// Flatten the faces of a cubemap, LatLong is resampled with a width of 4 faces, other layouts are block copies
+	ErrorCode		ConvertCubemapToTexture(const Graphics::Texture& oCubemap, ECubemapFormat eFormat, Graphics::Texture* pOutTexture);
+
+	struct SpecularFilterSettings
+	{
+		SpecularFilterSettings();
+		int							iSampleCount; // GGX importance samples per texel
+		int							iMipCount; // Output levels, roughness of level i is i / (iMipCount - 1), 0 for a full chain
+	};
+
+	// Split-sum radiance prefiltering, each mip of the RGBA32 float output cubemap is the source convolved with a GGX lobe (N = V = R)
+	// Samples are fetched from the source mip matching their solid angle, pOutTexelsPerSecond receives the filtering throughput
+	ErrorCode		PrefilterSpecularCubemap(const Graphics::Texture& oCubemap, Graphics::Texture* pOutCubemap, const SpecularFilterSettings* pSettings = NULL, double* pOutTexelsPerSecond = NULL);
 }
 
 #endif //__GRAPHICS_TEXTURE_UTILS_H__
\ No newline at end of file
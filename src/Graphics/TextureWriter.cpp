@@ -7,6 +7,14 @@ namespace Graphics
 {
 	static Core::Array<TextureWriterInfo>	s_oTextureWriters;
 
+	WriterSettings::WriterSettings()
+	{
+		iQuality = 100;
+		eTargetPixelFormat = PixelFormatEnum::_NONE;
+		eEXRCompression = EXR::CompressionEnum::ZIP;
+		eCubemapFormat = E_CUBEMAPFORMAT_CROSS_HORIZONTAL;
+	}
+
 	void RegisterTextureWriter(const char* pName, const char* pExts, TextureWriterFunc pWriter, TextureWriterSupportedFunc pWriterTester)
 	{
 		TextureWriterInfo oInfo;
@@ -23,18 +31,27 @@ namespace Graphics
 		{
 			if (pUseWriter == NULL)
 			{
-				for (Core::Array<TextureWriterInfo>::iterator it = s_oTextureWriters.begin(), itEnd = s_oTextureWriters.end(); it != itEnd; ++it)
-				{
-					if (Core::StringUtils::Wildcard(it->pExt, pFilename))
-					{
-						pUseWriter = &*it;
-						break;
-					}
-				}
+				pUseWriter = FindTextureWriter(pFilename);
 			}
 
 			if (pUseWriter != NULL)
 			{
+				// Single face writers get a flattened cubemap
+				WriterSettings oDefaultSettings;
+				const WriterSettings& oSettings = (pSettings != NULL) ? *pSettings : oDefaultSettings;
+				if (pUseWriter->pTester != NULL
+					&& oSettings.eCubemapFormat != E_CUBEMAPFORMAT_NONE
+					&& pTexture->GetFaceCount() == Texture::_E_FACE_COUNT
+					&& pTexture->IsArray() == false
+					&& pUseWriter->pTester(pTexture) != E_SUPPORTED_WRITER_FULL)
+				{
+					Texture oFlattened;
+					ErrorCode oErr = ConvertCubemapToTexture(*pTexture, oSettings.eCubemapFormat, &oFlattened);
+					if (oErr != ErrorCode::Ok)
+						return oErr;
+					return SaveToStream(&oFlattened, pSettings, pStream, pFilename, pUseWriter);
+				}
+
 				if (pUseWriter->pTester != NULL && pUseWriter->pTester(pTexture) == E_SUPPORTED_WRITER_FALSE)
 					return ErrorCode(1, "Texture not supported by writer");
 
@@ -79,9 +96,30 @@ namespace Graphics
 		return ErrorCode(1, "Invalid arguments");
 	}
 
+	ErrorCode SaveToFile(const TextureView& oView, const WriterSettings* pSettings, const char* pFilename, const TextureWriterInfo* pUseWriter)
+	{
+		Texture oRegion;
+		ErrorCode oErr = CopyTextureView(oView, &oRegion);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+		return SaveToFile(&oRegion, pSettings, pFilename, pUseWriter);
+	}
+
 	void GetTextureWriters(const TextureWriterInfo** pOutWriters, int* pOutCount)
 	{
 		*pOutWriters = s_oTextureWriters.begin();
 		*pOutCount = (int)s_oTextureWriters.size();
 	}
+
+	const TextureWriterInfo* FindTextureWriter(const char* pFilename)
+	{
+		for (Core::Array<TextureWriterInfo>::iterator it = s_oTextureWriters.begin(), itEnd = s_oTextureWriters.end(); it != itEnd; ++it)
+		{
+			if (Core::StringUtils::Wildcard(it->pExt, pFilename))
+			{
+				return &*it;
+			}
+		}
+		return NULL;
+	}
 }
\ No newline at end of file
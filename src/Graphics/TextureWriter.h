@@ -2,12 +2,18 @@
 #define __GRAPHICS_TEXTURE_WRITER_H__
 
 #include "Graphics/Texture.h"
+#include "Graphics/TextureUtils.h"
+#include "Graphics/EXR.h"
 
 namespace Graphics
 {
 	struct WriterSettings
 	{
+		WriterSettings();
 		unsigned char							iQuality; // 0-100
+		PixelFormatEnum							eTargetPixelFormat; // _NONE to keep texture pixel format, only used by writers supporting it
+		EXR::CompressionEnum					eEXRCompression;
+		ECubemapFormat							eCubemapFormat; // Layout of cubemaps given to writers not supporting faces, NONE to write the first face only
 	};
 
 	enum ESupportedWriter
@@ -32,7 +38,11 @@ namespace Graphics
 
 	ErrorCode						SaveToStream(Texture* pTexture, const WriterSettings* pSettings, Core::Stream* pStream, const char* pFilename, const TextureWriterInfo* pUseWriter = NULL);
 	ErrorCode						SaveToFile(Texture* pTexture, const WriterSettings* pSettings, const char* pFilename, const TextureWriterInfo* pUseWriter = NULL);
+	// Single mip texture of the view, only the region is copied
+	ErrorCode						SaveToFile(const TextureView& oView, const WriterSettings* pSettings, const char* pFilename, const TextureWriterInfo* pUseWriter = NULL);
 	void							GetTextureWriters(const TextureWriterInfo** pOutWriters, int* pOutCount);
+	// Writer used by SaveToFile for the extension of pFilename, NULL when no writer supports it
+	const TextureWriterInfo*		FindTextureWriter(const char* pFilename);
 }
 //namspace Graphics
 
@@ -3,6 +3,9 @@
 #include "Graphics/TextureWriter.h"
 
 #include "Graphics/DDS.h"
+#include "Graphics/TextureUtils.h"
+
+#include "Core/Memory.h"
 
 #include "Math/Math.h"
 
@@ -19,13 +22,26 @@ namespace Graphics
 		}
 
 
-		ESupportedWriter TextureWriterSupportedDDS(Texture* pTexture)
+		DDSStreamWriter::DDSStreamWriter()
+			: m_pStream(NULL)
+			, m_iNextSubresource(0)
+			, m_iSubresourceWritten(0)
 		{
-			return E_SUPPORTED_WRITER_FULL;
 		}
 
-		bool TextureWriterDDS(Texture* pTexture, const WriterSettings* pSettings, Core::Stream* pStream)
+		DDSStreamWriter::~DDSStreamWriter()
 		{
+			CORE_ASSERT(m_pStream == NULL, "DDSStreamWriter::End not called");
+		}
+
+		ErrorCode DDSStreamWriter::Begin(const Texture::TextureData::Desc& oDesc, Core::Stream* pStream)
+		{
+			if (pStream == NULL || m_pStream != NULL || oDesc.iWidth <= 0 || oDesc.iHeight <= 0 || oDesc.iDepth <= 0
+				|| oDesc.iMipCount <= 0 || oDesc.iArraySize <= 0)
+			{
+				return ErrorCode::InvalidArgument;
+			}
+
 			uint32_t iDDSMagic = DDS_MAGIC;
 			DDS_HEADER oDDSHeader;
 			DDS_HEADER_DXT10 oDDSHeaderDX10;
@@ -43,26 +59,35 @@ namespace Graphics
 
 			oDDSHeader.iSurfaceFlags |= DDS_SURFACE_FLAGS_TEXTURE;
 
-			if (pTexture->GetMipCount() > 1)
+			if (oDesc.iMipCount > 1)
 			{
 				oDDSHeader.iHeaderFlags |= DDS_HEADER_FLAGS_MIPMAPCOUNT;
 				oDDSHeader.iSurfaceFlags |= DDS_SURFACE_FLAGS_MIPMAP;
 			}
 
-			oDDSHeader.iWidth = pTexture->GetWidth();
-			oDDSHeader.iHeight = pTexture->GetHeight();
-			oDDSHeader.iMipMapCount = pTexture->GetMipCount();
-			if (pTexture->GetFaceCount() == 6)
+			oDDSHeader.iWidth = oDesc.iWidth;
+			oDDSHeader.iHeight = oDesc.iHeight;
+			oDDSHeader.iMipMapCount = oDesc.iMipCount;
+			if (oDesc.iFaceCount == 6)
 			{
 				oDDSHeader.iCubemapFlags = DDS_CUBEMAP_ALLFACES;
+				oDDSHeader.iSurfaceFlags |= DDS_SURFACE_FLAGS_CUBEMAP;
 			}
-			else if (pTexture->GetFaceCount() != 1)
+			else if (oDesc.iFaceCount != 1)
 			{
 				CORE_ASSERT(false, "Not supported");
-				return false;
+				return ErrorCode(1, "Texture not supported by DDS writer");
+			}
+
+			if ((oDesc.iDepth > 1))
+			{
+				oDDSHeader.iHeaderFlags |= DDS_HEADER_FLAGS_DEPTH;
+				oDDSHeader.iCubemapFlags |= DDS_FLAGS_VOLUME;
+				oDDSHeader.iSurfaceFlags |= DDS_SURFACE_FLAGS_CUBEMAP; // DDSCAPS_COMPLEX
+				oDDSHeader.iDepth = oDesc.iDepth;
 			}
 
-			switch (pTexture->GetPixelFormat())
+			switch (oDesc.ePixelFormat)
 			{
 			case PixelFormatEnum::RGB8_UNORM:
 				memcpy(&oDDSHeader.oPixelFormat, &DDSPF_R8G8B8, sizeof(DDS_PIXELFORMAT));
@@ -137,56 +162,414 @@ namespace Graphics
 				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC7_TYPELESS;
 				break;
 
+			case PixelFormatEnum::RGBA8_UNORM_SRGB:
+				bHasDX10Header = true;
+				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+				break;
+			case PixelFormatEnum::BGRA8_UNORM_SRGB:
+				bHasDX10Header = true;
+				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+				break;
+			case PixelFormatEnum::BC1_SRGB:
+				bHasDX10Header = true;
+				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC1_UNORM_SRGB;
+				break;
+			case PixelFormatEnum::BC2_SRGB:
+				bHasDX10Header = true;
+				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC2_UNORM_SRGB;
+				break;
+			case PixelFormatEnum::BC3_SRGB:
+				bHasDX10Header = true;
+				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC3_UNORM_SRGB;
+				break;
+			case PixelFormatEnum::BC7_SRGB:
+				bHasDX10Header = true;
+				oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC7_UNORM_SRGB;
+				break;
+
 			default:
 				CORE_ASSERT(false, "Not supported");
-				return false;
+				return ErrorCode(1, "Texture not supported by DDS writer");
 			}
 
-			if (PixelFormat::IsCompressed(pTexture->GetPixelFormat()))
+			if (PixelFormat::IsCompressed(oDesc.ePixelFormat))
 			{
 				oDDSHeader.iHeaderFlags |= DDS_HEADER_FLAGS_PITCH;
-				oDDSHeader.iPitchOrLinearSize = PixelFormat::GetPitch(pTexture->GetPixelFormat(), pTexture->GetWidth());
+				oDDSHeader.iPitchOrLinearSize = PixelFormat::GetPitch(oDesc.ePixelFormat, oDesc.iWidth);
 			}
 			else
 			{
 				oDDSHeader.iHeaderFlags |= DDS_HEADER_FLAGS_PITCH;
-				oDDSHeader.iPitchOrLinearSize = PixelFormat::GetPitch(pTexture->GetPixelFormat(), pTexture->GetWidth());
+				oDDSHeader.iPitchOrLinearSize = PixelFormat::GetPitch(oDesc.ePixelFormat, oDesc.iWidth);
+			}
+
+			// Array textures can only be described by the DX10 header
+			if ((oDesc.iArraySize > 1) && bHasDX10Header == false)
+			{
+				bHasDX10Header = true;
+				switch (oDesc.ePixelFormat)
+				{
+				case PixelFormatEnum::RGBA8_UNORM:
+					oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+					break;
+				case PixelFormatEnum::B5G6BR_UNORM:
+					oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_B5G6R5_UNORM;
+					break;
+				case PixelFormatEnum::BC1:
+					oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC1_UNORM;
+					break;
+				case PixelFormatEnum::BC2:
+					oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC2_UNORM;
+					break;
+				case PixelFormatEnum::BC3:
+					oDDSHeaderDX10.oDxgiFormat = DXGI_FORMAT_BC3_UNORM;
+					break;
+				default:
+					CORE_ASSERT(false, "Not supported pixel format for array texture");
+					return ErrorCode(1, "Texture not supported by DDS writer");
+				}
 			}
 
 			if (bHasDX10Header)
 			{
 				oDDSHeader.iHeaderFlags |= DDS_FOURCC;
 				memcpy(&oDDSHeader.oPixelFormat, &DDSPF_DX10, sizeof(DDS_PIXELFORMAT));
+
+				oDDSHeaderDX10.oResourceDimension = (oDesc.iDepth > 1) ? D3D10_RESOURCE_DIMENSION_TEXTURE3D : D3D10_RESOURCE_DIMENSION_TEXTURE2D;
+				oDDSHeaderDX10.iMiscFlag = (oDesc.iFaceCount == 6) ? DDS_RESOURCE_MISC_TEXTURECUBE : 0;
+				oDDSHeaderDX10.iArraySize = oDesc.iArraySize;
 			}
 
-			if (pStream->Write(&iDDSMagic, sizeof(iDDSMagic)) != sizeof(iDDSMagic))
-				return false;
+			if (pStream->Write(&iDDSMagic, sizeof(iDDSMagic)) != sizeof(iDDSMagic)
+				|| pStream->Write(&oDDSHeader, sizeof(oDDSHeader)) != sizeof(oDDSHeader)
+				|| (bHasDX10Header && pStream->Write(&oDDSHeaderDX10, sizeof(oDDSHeaderDX10)) != sizeof(oDDSHeaderDX10)))
+			{
+				return ErrorCode(1, "Can't write DDS header");
+			}
 
-			if (pStream->Write(&oDDSHeader, sizeof(oDDSHeader)) != sizeof(oDDSHeader))
-				return false;
+			m_pStream = pStream;
+			m_oDesc = oDesc;
+			m_iNextSubresource = 0;
+			m_iSubresourceWritten = 0;
+			return ErrorCode::Ok;
+		}
 
-			if (bHasDX10Header)
+
+		int DDSStreamWriter::GetSubresourceCount() const
+		{
+			return m_oDesc.iArraySize * m_oDesc.iFaceCount * m_oDesc.iMipCount;
+		}
+
+		size_t DDSStreamWriter::GetSubresourceSize(int iMip) const
+		{
+			uint32_t iMipWidth = Math::Max(1, m_oDesc.iWidth >> iMip);
+			uint32_t iMipHeight = Math::Max(1, m_oDesc.iHeight >> iMip);
+			uint32_t iMipDepth = Math::Max(1, m_oDesc.iDepth >> iMip);
+
+			uint32_t iBlockCountX, iBlockCountY;
+			PixelFormat::GetBlockCount(m_oDesc.ePixelFormat, iMipWidth, iMipHeight, &iBlockCountX, &iBlockCountY);
+			return (size_t)iBlockCountX * iBlockCountY * PixelFormatEnumInfos[m_oDesc.ePixelFormat].iBlockSize * iMipDepth;
+		}
+
+		size_t DDSStreamWriter::GetRowSize(int iMip) const
+		{
+			uint32_t iBlockCountX, iBlockCountY;
+			PixelFormat::GetBlockCount(m_oDesc.ePixelFormat, Math::Max(1, m_oDesc.iWidth >> iMip), Math::Max(1, m_oDesc.iHeight >> iMip), &iBlockCountX, &iBlockCountY);
+			return (size_t)iBlockCountX * PixelFormatEnumInfos[m_oDesc.ePixelFormat].iBlockSize;
+		}
+
+		ErrorCode DDSStreamWriter::WriteSubresource(int iLayer, int iFace, int iMip, const void* pData, size_t iSize)
+		{
+			if (m_iSubresourceWritten != 0 || (m_pStream != NULL && iSize != GetSubresourceSize(iMip)))
 			{
-				if (pStream->Write(&oDDSHeaderDX10, sizeof(oDDSHeaderDX10)) != sizeof(oDDSHeaderDX10))
-					return false;
+				return ErrorCode(1, "Invalid subresource size");
 			}
+			return WriteSubresourceRows(iLayer, iFace, iMip, pData, iSize);
+		}
 
-			uint32_t iBPP = PixelFormat::BitPerPixel(pTexture->GetPixelFormat());
-			for (int iFace = 0; iFace < pTexture->GetFaceCount(); ++iFace)
+		ErrorCode DDSStreamWriter::WriteSubresourceRows(int iLayer, int iFace, int iMip, const void* pRows, size_t iSize)
+		{
+			if (m_pStream == NULL || pRows == NULL)
 			{
-				for (int iMip = 0; iMip < pTexture->GetMipCount(); ++iMip)
+				return ErrorCode::InvalidArgument;
+			}
+
+			// DDS has no index, subresources have to come in file order
+			int iExpected = m_iNextSubresource;
+			if (iExpected >= GetSubresourceCount()
+				|| iMip != iExpected % m_oDesc.iMipCount
+				|| iFace != (iExpected / m_oDesc.iMipCount) % m_oDesc.iFaceCount
+				|| iLayer != iExpected / (m_oDesc.iMipCount * m_oDesc.iFaceCount))
+			{
+				return ErrorCode(1, "Subresource written out of order");
+			}
+
+			const size_t iSubresourceSize = GetSubresourceSize(iMip);
+			if (iSize == 0 || (iSize % GetRowSize(iMip)) != 0 || m_iSubresourceWritten + iSize > iSubresourceSize)
+			{
+				return ErrorCode(1, "Invalid subresource size");
+			}
+
+			if (m_pStream->Write((void*)pRows, iSize) != iSize)
+			{
+				return ErrorCode(1, "Can't write subresource");
+			}
+
+			m_iSubresourceWritten += iSize;
+			if (m_iSubresourceWritten == iSubresourceSize)
+			{
+				++m_iNextSubresource;
+				m_iSubresourceWritten = 0;
+			}
+			return ErrorCode::Ok;
+		}
+
+		ErrorCode DDSStreamWriter::End()
+		{
+			if (m_pStream == NULL)
+			{
+				return ErrorCode::InvalidArgument;
+			}
+
+			bool bComplete = m_iNextSubresource == GetSubresourceCount();
+			m_pStream = NULL;
+			m_iNextSubresource = 0;
+			m_iSubresourceWritten = 0;
+			if (bComplete == false)
+			{
+				return ErrorCode(1, "Missing subresources");
+			}
+			return ErrorCode::Ok;
+		}
+
+		ErrorCode WriteDDSConverted(const Texture* pTexture, PixelFormatEnum ePixelFormat, Core::Stream* pStream)
+		{
+			if (pTexture == NULL || pTexture->IsValid() == false || pStream == NULL)
+			{
+				return ErrorCode::InvalidArgument;
+			}
+
+			PixelFormatEnum eSourcePixelFormat = pTexture->GetPixelFormat();
+			PixelFormat::ConvertionFuncChain oConvertionFuncChain;
+			int iConvertionChainLength = 0;
+			int iAdditionalBits;
+			if (ePixelFormat != eSourcePixelFormat
+				&& PixelFormat::GetConvertionChain(eSourcePixelFormat, ePixelFormat, &oConvertionFuncChain, &iConvertionChainLength, &iAdditionalBits) == false)
+			{
+				return ErrorCode(1, "Format convertion not implemented");
+			}
+
+			Texture::TextureData::Desc oDesc;
+			oDesc.ePixelFormat = ePixelFormat;
+			oDesc.iWidth = pTexture->GetWidth();
+			oDesc.iHeight = pTexture->GetHeight();
+			oDesc.iDepth = pTexture->GetDepth();
+			oDesc.iFaceCount = pTexture->GetFaceCount();
+			oDesc.iArraySize = pTexture->GetArraySize();
+			oDesc.iMipCount = pTexture->GetMipCount();
+
+			DDSStreamWriter oWriter;
+			ErrorCode oErr = oWriter.Begin(oDesc, pStream);
+			if (oErr != ErrorCode::Ok)
+			{
+				return oErr;
+			}
+
+			// Double buffering: subresource N is written while subresource N+1 is encoded
+			CORE_PTR_VOID pBuffers[2];
+			pBuffers[0] = Core::Malloc(oWriter.GetSubresourceSize(0));
+			pBuffers[1] = Core::Malloc(oWriter.GetSubresourceSize(0));
+			if (pBuffers[0] == NULL || pBuffers[1] == NULL)
+			{
+				Core::Free(pBuffers[0]);
+				Core::Free(pBuffers[1]);
+				oWriter.End() == ErrorCode::Ok;
+				return ErrorCode(1, "Out of memory");
+			}
+
+			const PixelFormatInfos& oSrcInfos = PixelFormatEnumInfos[eSourcePixelFormat];
+			const PixelFormatInfos& oDstInfos = PixelFormatEnumInfos[ePixelFormat];
+			const int iRowHeight = Math::Max(oSrcInfos.iBlockHeight, oDstInfos.iBlockHeight);
+			const int iSubresourceCount = oWriter.GetSubresourceCount();
+
+			int iPendingLayer = 0, iPendingFace = 0, iPendingMip = 0;
+			size_t iPendingSize = 0;
+			bool bWriteError = false;
+			for (int iSubresource = 0; iSubresource <= iSubresourceCount && bWriteError == false; ++iSubresource)
+			{
+				const bool bEncode = iSubresource < iSubresourceCount;
+				const int iMip = bEncode ? iSubresource % oDesc.iMipCount : 0;
+				const int iFace = bEncode ? (iSubresource / oDesc.iMipCount) % oDesc.iFaceCount : 0;
+				const int iLayer = bEncode ? iSubresource / (oDesc.iMipCount * oDesc.iFaceCount) : 0;
+				const bool bWrite = iSubresource > 0;
+
+				const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+				char* pDest = (char*)(void*)pBuffers[iSubresource % 2];
+				const void* pPending = (void*)pBuffers[(iSubresource + 1) % 2];
+				size_t iDestPitch = PixelFormat::GetPitch(ePixelFormat, oFaceData.iWidth);
+				uint32_t iDestBlockX, iDestBlockY;
+				PixelFormat::GetBlockCount(ePixelFormat, oFaceData.iWidth, oFaceData.iHeight, &iDestBlockX, &iDestBlockY);
+				size_t iDestSlicePitch = iDestPitch * iDestBlockY;
+				const int iRowCount = (oFaceData.iHeight + iRowHeight - 1) / iRowHeight;
+				const int iJobCount = bEncode ? iRowCount * oFaceData.iDepth : 0;
+
+#ifndef DEBUG
+#pragma omp parallel
+#endif
 				{
-					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace);
-					uint32_t iPadMipWidth = oFaceData.iWidth;
-					uint32_t iPadMipHeight = oFaceData.iHeight;
+					// One thread writes previous subresource then joins the encoding
+#ifndef DEBUG
+#pragma omp single nowait
+#endif
+					{
+						if (bWrite && oWriter.WriteSubresource(iPendingLayer, iPendingFace, iPendingMip, pPending, iPendingSize) != ErrorCode::Ok)
+						{
+							bWriteError = true;
+						}
+					}
+
+#ifndef DEBUG
+#pragma omp for schedule(dynamic)
+#endif
+					for (int iJob = 0; iJob < iJobCount; ++iJob)
+					{
+						int iSlice = iJob / iRowCount;
+						int iY = (iJob % iRowCount) * iRowHeight;
+						const char* pSourceRow = (const char*)oFaceData.pData + iSlice * oFaceData.iSlicePitch + (size_t)(iY / oSrcInfos.iBlockHeight) * oFaceData.iPitch;
+						char* pDestRow = pDest + iSlice * iDestSlicePitch + (size_t)(iY / oDstInfos.iBlockHeight) * iDestPitch;
+						if (iConvertionChainLength > 0)
+						{
+							ConvertPixelFormatRegion(
+								pSourceRow, oFaceData.iPitch, eSourcePixelFormat,
+								pDestRow, iDestPitch, ePixelFormat,
+								oFaceData.iWidth, Math::Min(iRowHeight, oFaceData.iHeight - iY),
+								oConvertionFuncChain, iConvertionChainLength);
+						}
+						else
+						{
+							memcpy(pDestRow, pSourceRow, iDestPitch);
+						}
+					}
+				}
+
+				iPendingLayer = iLayer;
+				iPendingFace = iFace;
+				iPendingMip = iMip;
+				iPendingSize = iDestSlicePitch * oFaceData.iDepth;
+			}
 
-					if (pStream->Write(oFaceData.pData, oFaceData.iSize) != oFaceData.iSize)
+			Core::Free(pBuffers[0]);
+			Core::Free(pBuffers[1]);
+
+			if (bWriteError)
+			{
+				oWriter.End() == ErrorCode::Ok;
+				return ErrorCode(1, "Can't write subresource");
+			}
+			return oWriter.End();
+		}
+
+		ErrorCode WriteTiledDDS(TiledTexture* pTexture, Core::Stream* pStream)
+		{
+			if (pTexture == NULL || pTexture->IsValid() == false || pStream == NULL)
+			{
+				return ErrorCode::InvalidArgument;
+			}
+
+			Texture::TextureData::Desc oDesc;
+			oDesc.ePixelFormat = pTexture->GetPixelFormat();
+			oDesc.iWidth = pTexture->GetWidth();
+			oDesc.iHeight = pTexture->GetHeight();
+			oDesc.iFaceCount = pTexture->GetFaceCount();
+			oDesc.iMipCount = pTexture->GetMipCount();
+
+			DDSStreamWriter oWriter;
+			ErrorCode oErr = oWriter.Begin(oDesc, pStream);
+			if (oErr != ErrorCode::Ok)
+			{
+				return oErr;
+			}
+
+			// Block rows are written by bands of one tile, smaller when a band of the top mip doesn't fit in a quarter of the memory budget
+			const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oDesc.ePixelFormat];
+			const int iBandRowCount = (int)Math::Max<size_t>(Math::Min<size_t>(pTexture->GetTileSize() / oInfos.iBlockHeight, pTexture->GetMemoryBudget() / 4 / oWriter.GetRowSize(0)), 1);
+			CORE_PTR_VOID pBand = Core::Malloc(oWriter.GetRowSize(0) * iBandRowCount);
+			if (pBand == NULL)
+			{
+				oWriter.End() == ErrorCode::Ok;
+				return ErrorCode(1, "Can't allocate band buffer");
+			}
+
+			for (int iFace = 0; iFace < oDesc.iFaceCount && oErr == ErrorCode::Ok; ++iFace)
+			{
+				for (int iMip = 0; iMip < oDesc.iMipCount && oErr == ErrorCode::Ok; ++iMip)
+				{
+					const int iMipWidth = pTexture->GetMipWidth(iMip);
+					const int iMipHeight = pTexture->GetMipHeight(iMip);
+					const int iRowCount = (iMipHeight + oInfos.iBlockHeight - 1) / oInfos.iBlockHeight;
+					for (int iRow = 0; iRow < iRowCount && oErr == ErrorCode::Ok; iRow += iBandRowCount)
+					{
+						const int iCount = Math::Min(iBandRowCount, iRowCount - iRow);
+						const int iY = iRow * oInfos.iBlockHeight;
+						oErr = pTexture->ReadRegion(iMip, iFace, 0, iY, iMipWidth, Math::Min(iCount * oInfos.iBlockHeight, iMipHeight - iY), pBand, oWriter.GetRowSize(iMip));
+						if (oErr == ErrorCode::Ok)
+						{
+							oErr = oWriter.WriteSubresourceRows(0, iFace, iMip, pBand, oWriter.GetRowSize(iMip) * iCount);
+						}
+					}
+				}
+			}
+
+			Core::Free(pBand);
+			if (oErr != ErrorCode::Ok)
+			{
+				oWriter.End() == ErrorCode::Ok;
+				return oErr;
+			}
+			return oWriter.End();
+		}
+
+		ESupportedWriter TextureWriterSupportedDDS(Texture* pTexture)
+		{
+			return E_SUPPORTED_WRITER_FULL;
+		}
+
+		bool TextureWriterDDS(Texture* pTexture, const WriterSettings* pSettings, Core::Stream* pStream)
+		{
+			if (pSettings != NULL && pSettings->eTargetPixelFormat != PixelFormatEnum::_NONE && pSettings->eTargetPixelFormat != pTexture->GetPixelFormat())
+			{
+				return WriteDDSConverted(pTexture, pSettings->eTargetPixelFormat, pStream) == ErrorCode::Ok;
+			}
+
+			Texture::TextureData::Desc oDesc;
+			oDesc.ePixelFormat = pTexture->GetPixelFormat();
+			oDesc.iWidth = pTexture->GetWidth();
+			oDesc.iHeight = pTexture->GetHeight();
+			oDesc.iDepth = pTexture->GetDepth();
+			oDesc.iFaceCount = pTexture->GetFaceCount();
+			oDesc.iArraySize = pTexture->GetArraySize();
+			oDesc.iMipCount = pTexture->GetMipCount();
+
+			DDSStreamWriter oWriter;
+			if (oWriter.Begin(oDesc, pStream) != ErrorCode::Ok)
+				return false;
+
+			for (int iSubresource = 0; iSubresource < pTexture->GetArraySize() * pTexture->GetFaceCount(); ++iSubresource)
+			{
+				int iLayer = iSubresource / pTexture->GetFaceCount();
+				int iFace = iSubresource % pTexture->GetFaceCount();
+				for (int iMip = 0; iMip < pTexture->GetMipCount(); ++iMip)
+				{
+					const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(iMip, iFace, iLayer);
+					if (oWriter.WriteSubresource(iLayer, iFace, iMip, oFaceData.pData, oFaceData.iSize) != ErrorCode::Ok)
+					{
+						oWriter.End() == ErrorCode::Ok;
 						return false;
+					}
 				}
 			}
 
-			//CORE_ASSERT(false);
-			return true;
+			return oWriter.End() == ErrorCode::Ok;
 		}
 	}
 	//namespace TextureLoader
@@ -1,14 +1,56 @@
 #ifndef __GRAPHICS_TEXTURE_WRITER_DDS_H__
 #define __GRAPHICS_TEXTURE_WRITER_DDS_H__
 
+#include "Core/ErrorCode.h"
+#include "Core/Stream.h"
+
+#include "Graphics/Texture.h"
+#include "Graphics/TiledTexture.h"
+
 namespace Graphics
 {
 	namespace TextureWriter
 	{
 		void RegisterWriterDDS();
+
+		/* Streaming DDS writer
+		Header is written by Begin, then each subresource is appended as soon as
+		it is available, in file order (layer > face > mip).
+		*/
+		class DDSStreamWriter
+		{
+		public:
+										DDSStreamWriter();
+										~DDSStreamWriter();
+
+			ErrorCode					Begin(const Texture::TextureData::Desc& oDesc, Core::Stream* pStream);
+			ErrorCode					WriteSubresource(int iLayer, int iFace, int iMip, const void* pData, size_t iSize);
+			// Next block rows of a subresource, iSize need to be a multiple of GetRowSize(iMip)
+			ErrorCode					WriteSubresourceRows(int iLayer, int iFace, int iMip, const void* pRows, size_t iSize);
+			ErrorCode					End();
+
+			bool						IsStarted() const { return m_pStream != NULL; }
+			int							GetSubresourceCount() const;
+			// Size of one face/layer of a mip, including all depth slices
+			size_t						GetSubresourceSize(int iMip) const;
+			// Size of one block row of a mip
+			size_t						GetRowSize(int iMip) const;
+		protected:
+			Core::Stream*				m_pStream;
+			Texture::TextureData::Desc	m_oDesc;
+			int							m_iNextSubresource;
+			size_t						m_iSubresourceWritten; // Bytes of the next subresource already written
+		};
+
+		// Convert and write subresources one by one, encoding overlaps with writing
+		// and only two converted subresources are in memory at once
+		ErrorCode						WriteDDSConverted(const Texture* pTexture, PixelFormatEnum ePixelFormat, Core::Stream* pStream);
+
+		// Write a tiled texture by bands of rows, only the tile cache is kept in memory
+		ErrorCode						WriteTiledDDS(TiledTexture* pTexture, Core::Stream* pStream);
 	}
 	//namespace TextureLoader
 }
 //namespace Graphics
 
-#endif //__GRAPHICS_TEXTURE_WRITER_DDS_H__
\ No newline at end of file
+#endif //__GRAPHICS_TEXTURE_WRITER_DDS_H__
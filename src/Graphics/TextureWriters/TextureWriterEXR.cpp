@@ -3,7 +3,12 @@
 #include "Graphics/TextureWriter.h"
 #include "Graphics/TextureUtils.h"
 
-#include "tinyexr.h"
+#include "Graphics/EXR.h"
+
+#include "Math/Math.h"
+
+#include <emmintrin.h> //SIMD
+#include <string.h> //memcpy/strlen
 
 namespace Graphics
 {
@@ -17,34 +22,52 @@ namespace Graphics
 			RegisterTextureWriter("OpenEXR", "*.exr\0", TextureWriterEXR, TextureWriterSupportedEXR);
 		}
 
+		// Pixel format written for a texture pixel format, float formats are written as is, others are converted to 32 bits float
+		static PixelFormatEnum GetEXRPixelFormat(PixelFormatEnum ePixelFormat)
+		{
+			switch (ePixelFormat)
+			{
+			case PixelFormatEnum::R32_FLOAT:
+			case PixelFormatEnum::RG32_FLOAT:
+			case PixelFormatEnum::RGB16_FLOAT:
+			case PixelFormatEnum::RGBA16_FLOAT:
+			case PixelFormatEnum::RGB32_FLOAT:
+			case PixelFormatEnum::RGBA32_FLOAT:
+				return ePixelFormat;
+			default:
+				break;
+			}
+
+			switch (PixelFormatEnumInfos[ePixelFormat].iComponents)
+			{
+			case 1:
+				return PixelFormatEnum::R32_FLOAT;
+			case 2:
+				return PixelFormatEnum::RG32_FLOAT;
+			case 3:
+				return PixelFormatEnum::RGB32_FLOAT;
+			case 4:
+				return PixelFormatEnum::RGBA32_FLOAT;
+			default:
+				return PixelFormatEnum::_NONE;
+			}
+		}
+
 		ESupportedWriter TextureWriterSupportedEXR(Texture* pTexture)
 		{
-			if (pTexture->GetMipCount() != 1 || pTexture->GetFaceCount() != 1)
+			if (pTexture->GetMipCount() != 1 || pTexture->GetFaceCount() != 1 || pTexture->IsArray() || pTexture->IsVolume())
 			{
 				return E_SUPPORTED_WRITER_PARTIAL;
 			}
 
-			PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
-			int iComp = PixelFormatEnumInfos[ePixelFormat].iComponents;
-
-			if( ePixelFormat != PixelFormatEnum::RGB16_FLOAT
-				&& ePixelFormat != PixelFormatEnum::RGBA16_FLOAT
-				&& ePixelFormat != PixelFormatEnum::RGBA32_FLOAT
-				&& ePixelFormat != PixelFormatEnum::RGBA32_FLOAT )
+			PixelFormatEnum ePixelFormat = GetEXRPixelFormat(pTexture->GetPixelFormat());
+			if (ePixelFormat == PixelFormatEnum::_NONE)
 			{
-				if (iComp == 3)
-				{
-					ePixelFormat = PixelFormatEnum::RGB32_FLOAT;
-				}
-				else if (iComp == 4)
-				{
-					ePixelFormat = PixelFormatEnum::RGBA32_FLOAT;
-				}
-				else
-				{
-					return E_SUPPORTED_WRITER_FALSE;
-				}
+				return E_SUPPORTED_WRITER_FALSE;
+			}
 
+			if (ePixelFormat != pTexture->GetPixelFormat())
+			{
 				PixelFormat::ConvertionFuncChain oConvertionFuncChain;
 				int iConvertionChainLength;
 				int iAdditionalBits;
@@ -58,100 +81,289 @@ namespace Graphics
 			return E_SUPPORTED_WRITER_FULL;
 		}
 
-		bool TextureWriterEXR(Texture* pTexture, const WriterSettings* /*pSettings*/, Core::Stream* pStream)
+		// Lines of pixels converted/compressed by each parallel job
+		static const int c_iEXRJobMinLineCount = 16;
+
+		static void WriteEXRAttribute(Core::Array<unsigned char>* pOut, const char* pName, const char* pType, const void* pData, uint32_t iSize)
 		{
-			Texture oNewTexture;
+			size_t iNameLen = strlen(pName) + 1;
+			size_t iTypeLen = strlen(pType) + 1;
+			size_t iOffset = pOut->size();
+			pOut->resize(iOffset + iNameLen + iTypeLen + sizeof(uint32_t) + iSize);
+			unsigned char* pDest = &(*pOut)[iOffset];
+			memcpy(pDest, pName, iNameLen);
+			pDest += iNameLen;
+			memcpy(pDest, pType, iTypeLen);
+			pDest += iTypeLen;
+			memcpy(pDest, &iSize, sizeof(uint32_t));
+			pDest += sizeof(uint32_t);
+			memcpy(pDest, pData, iSize);
+		}
 
-			PixelFormatEnum ePixelFormat = pTexture->GetPixelFormat();
-			const int iComp = PixelFormatEnumInfos[ePixelFormat].iComponents;
+		/* Deinterleave a line of pixels to EXR channel planes
+		EXR channels are sorted by name (A, B, G, R), so plane N is the component (iComp - 1 - N)
+		*/
+		static void PlanarizeLine32(const float* pIn, int iWidth, int iComp, float* pOut)
+		{
+			int iX = 0;
+			if (iComp == 4)
+			{
+				float* pA = pOut;
+				float* pB = pOut + iWidth;
+				float* pG = pOut + iWidth * 2;
+				float* pR = pOut + iWidth * 3;
+				for (; iX + 4 <= iWidth; iX += 4)
+				{
+					__m128 xP0 = _mm_loadu_ps(pIn + iX * 4);
+					__m128 xP1 = _mm_loadu_ps(pIn + iX * 4 + 4);
+					__m128 xP2 = _mm_loadu_ps(pIn + iX * 4 + 8);
+					__m128 xP3 = _mm_loadu_ps(pIn + iX * 4 + 12);
+					_MM_TRANSPOSE4_PS(xP0, xP1, xP2, xP3);
+					_mm_storeu_ps(pR + iX, xP0);
+					_mm_storeu_ps(pG + iX, xP1);
+					_mm_storeu_ps(pB + iX, xP2);
+					_mm_storeu_ps(pA + iX, xP3);
+				}
+			}
 
-			if (ePixelFormat != PixelFormatEnum::RGB16_FLOAT
-				&& ePixelFormat != PixelFormatEnum::RGBA16_FLOAT
-				&& ePixelFormat != PixelFormatEnum::RGBA32_FLOAT
-				&& ePixelFormat != PixelFormatEnum::RGBA32_FLOAT )
+			for (int iPlane = 0; iPlane < iComp; ++iPlane)
 			{
-				if (iComp == 3)
+				const float* pSource = pIn + (iComp - 1 - iPlane);
+				float* pDest = pOut + iPlane * iWidth;
+				for (int iPX = iX; iPX < iWidth; ++iPX)
 				{
-					ePixelFormat = PixelFormatEnum::RGB32_FLOAT;
+					pDest[iPX] = pSource[iPX * iComp];
 				}
-				else if (iComp == 4)
+			}
+		}
+
+		static void PlanarizeLine16(const uint16_t* pIn, int iWidth, int iComp, uint16_t* pOut)
+		{
+			int iX = 0;
+			if (iComp == 4)
+			{
+				uint16_t* pA = pOut;
+				uint16_t* pB = pOut + iWidth;
+				uint16_t* pG = pOut + iWidth * 2;
+				uint16_t* pR = pOut + iWidth * 3;
+				for (; iX + 4 <= iWidth; iX += 4)
 				{
-					ePixelFormat = PixelFormatEnum::RGBA32_FLOAT;
+					__m128i xP01 = _mm_loadu_si128((const __m128i*)(pIn + iX * 4)); // r0 g0 b0 a0 r1 g1 b1 a1
+					__m128i xP23 = _mm_loadu_si128((const __m128i*)(pIn + iX * 4 + 8)); // r2 g2 b2 a2 r3 g3 b3 a3
+					__m128i xT0 = _mm_unpacklo_epi16(xP01, xP23); // r0 r2 g0 g2 b0 b2 a0 a2
+					__m128i xT1 = _mm_unpackhi_epi16(xP01, xP23); // r1 r3 g1 g3 b1 b3 a1 a3
+					__m128i xRG = _mm_unpacklo_epi16(xT0, xT1); // r0 r1 r2 r3 g0 g1 g2 g3
+					__m128i xBA = _mm_unpackhi_epi16(xT0, xT1); // b0 b1 b2 b3 a0 a1 a2 a3
+					_mm_storel_epi64((__m128i*)(pR + iX), xRG);
+					_mm_storel_epi64((__m128i*)(pG + iX), _mm_unpackhi_epi64(xRG, xRG));
+					_mm_storel_epi64((__m128i*)(pB + iX), xBA);
+					_mm_storel_epi64((__m128i*)(pA + iX), _mm_unpackhi_epi64(xBA, xBA));
 				}
-				else
+			}
+
+			for (int iPlane = 0; iPlane < iComp; ++iPlane)
+			{
+				const uint16_t* pSource = pIn + (iComp - 1 - iPlane);
+				uint16_t* pDest = pOut + iPlane * iWidth;
+				for (int iPX = iX; iPX < iWidth; ++iPX)
 				{
-					return false;
+					pDest[iPX] = pSource[iPX * iComp];
 				}
+			}
+		}
 
-				if (ConvertPixelFormat(pTexture, &oNewTexture, ePixelFormat) != ErrorCode::Ok)
+		bool TextureWriterEXR(Texture* pTexture, const WriterSettings* pSettings, Core::Stream* pStream)
+		{
+			const PixelFormatEnum eSourcePixelFormat = pTexture->GetPixelFormat();
+			PixelFormatEnum ePixelFormat = eSourcePixelFormat;
+			const int iComp = PixelFormatEnumInfos[ePixelFormat].iComponents;
+
+			// Other formats are converted by blocks of lines while writing, no full size copy of the texture
+			PixelFormat::ConvertionFuncChain oConvertionFuncChain;
+			int iConvertionChainLength = 0;
+			ePixelFormat = GetEXRPixelFormat(eSourcePixelFormat);
+			if (ePixelFormat == PixelFormatEnum::_NONE)
+			{
+				return false;
+			}
+			if (ePixelFormat != eSourcePixelFormat)
+			{
+				int iAdditionalBits;
+				if (PixelFormat::GetConvertionChain(eSourcePixelFormat, ePixelFormat, &oConvertionFuncChain, &iConvertionChainLength, &iAdditionalBits) == false)
 				{
 					return false;
 				}
-				pTexture = &oNewTexture;
 			}
 
 			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(0, 0);
+			const int iWidth = oFaceData.iWidth;
+			const int iHeight = oFaceData.iHeight;
+
+			const bool bHalf = (ePixelFormat == PixelFormatEnum::RGB16_FLOAT) || (ePixelFormat == PixelFormatEnum::RGBA16_FLOAT);
+			const EXR::PixelTypeEnum ePixelType = bHalf ? EXR::PixelTypeEnum::HALF : EXR::PixelTypeEnum::FLOAT;
+			const size_t iChannelSize = bHalf ? 2 : 4;
+			const size_t iLineSize = (size_t)iWidth * iComp * iChannelSize;
+			const EXR::CompressionEnum eCompression = (pSettings != NULL) ? pSettings->eEXRCompression : EXR::CompressionEnum::ZIP;
+			const int iBlockLineCount = EXR::GetScanlineBlockSize(eCompression);
+			const int iBlockCount = (iHeight + iBlockLineCount - 1) / iBlockLineCount;
+
+			// Header
+			Core::Array<unsigned char> oHeader;
+			{
+				uint32_t pMagic[2] = { EXR::c_iMagic, EXR::c_iVersion };
+				oHeader.resize(sizeof(pMagic));
+				memcpy(&oHeader[0], pMagic, sizeof(pMagic));
+
+				// Channels have to be sorted by name, one and two components formats are R and (G, R)
+				const char* const c_pChannelNames[4] = { "A", "B", "G", "R" };
+				unsigned char pChannels[4 * 18 + 1];
+				unsigned char* pChannel = pChannels;
+				for (int iChannel = 4 - iComp; iChannel < 4; ++iChannel)
+				{
+					int32_t pChannelInfo[4] = { (int32_t)ePixelType, 0, 1, 1 }; // pixel type, pLinear + reserved, xSampling, ySampling
+					*pChannel++ = (unsigned char)c_pChannelNames[iChannel][0];
+					*pChannel++ = 0;
+					memcpy(pChannel, pChannelInfo, sizeof(pChannelInfo));
+					pChannel += sizeof(pChannelInfo);
+				}
+				*pChannel++ = 0;
+				WriteEXRAttribute(&oHeader, "channels", "chlist", pChannels, (uint32_t)(pChannel - pChannels));
+
+				unsigned char iCompression = (unsigned char)eCompression;
+				WriteEXRAttribute(&oHeader, "compression", "compression", &iCompression, 1);
+
+				int32_t pWindow[4] = { 0, 0, iWidth - 1, iHeight - 1 };
+				WriteEXRAttribute(&oHeader, "dataWindow", "box2i", pWindow, sizeof(pWindow));
+				WriteEXRAttribute(&oHeader, "displayWindow", "box2i", pWindow, sizeof(pWindow));
+
+				unsigned char iLineOrder = 0; // Increasing Y
+				WriteEXRAttribute(&oHeader, "lineOrder", "lineOrder", &iLineOrder, 1);
 
-			bool bHalf = (ePixelFormat == PixelFormatEnum::RGB16_FLOAT) || (ePixelFormat == PixelFormatEnum::RGBA16_FLOAT);
-			EXRHeader header;
-			InitEXRHeader(&header);
+				float fPixelAspectRatio = 1.f;
+				WriteEXRAttribute(&oHeader, "pixelAspectRatio", "float", &fPixelAspectRatio, sizeof(float));
 
-			header.num_channels = iComp;
+				float pScreenWindowCenter[2] = { 0.f, 0.f };
+				WriteEXRAttribute(&oHeader, "screenWindowCenter", "v2f", pScreenWindowCenter, sizeof(pScreenWindowCenter));
 
-			EXRChannelInfo oChannelsInfos[4];
-			strncpy(oChannelsInfos[0].name, "B", 255); oChannelsInfos[0].name[strlen("B")] = '\0';
-			strncpy(oChannelsInfos[1].name, "G", 255); oChannelsInfos[1].name[strlen("G")] = '\0';
-			strncpy(oChannelsInfos[2].name, "R", 255); oChannelsInfos[2].name[strlen("R")] = '\0';
-			strncpy(oChannelsInfos[3].name, "A", 255); oChannelsInfos[3].name[strlen("A")] = '\0';
-			header.channels = oChannelsInfos;
+				float fScreenWindowWidth = 1.f;
+				WriteEXRAttribute(&oHeader, "screenWindowWidth", "float", &fScreenWindowWidth, sizeof(float));
 
-			int iPixelTypesFloat[4] = { TINYEXR_PIXELTYPE_FLOAT, TINYEXR_PIXELTYPE_FLOAT, TINYEXR_PIXELTYPE_FLOAT, TINYEXR_PIXELTYPE_FLOAT };
-			int iPixelTypesHalf[4] = { TINYEXR_PIXELTYPE_HALF, TINYEXR_PIXELTYPE_HALF, TINYEXR_PIXELTYPE_HALF, TINYEXR_PIXELTYPE_HALF };
+				oHeader.push_back(0);
+			}
 
-			header.pixel_types = bHalf ? iPixelTypesHalf : iPixelTypesFloat;
-			header.requested_pixel_types = bHalf ? iPixelTypesHalf : iPixelTypesFloat;
+			// Offset table is written once all blocks are compressed
+			const size_t iStartPos = pStream->Tell();
+			Core::Array<uint64_t> oOffsets;
+			if (oOffsets.resize(iBlockCount) == false)
+				return false;
+			memset(&oOffsets[0], 0, sizeof(uint64_t) * iBlockCount);
 
-			EXRImage image;
-			InitEXRImage(&image);
+			if (pStream->Write(&oHeader[0], oHeader.size()) != oHeader.size()
+				|| pStream->Write(&oOffsets[0], sizeof(uint64_t) * iBlockCount) != sizeof(uint64_t) * iBlockCount)
+			{
+				return false;
+			}
 
-			image.num_channels = iComp;
-			image.width = oFaceData.iWidth;
-			image.height = oFaceData.iHeight;
+			// Each job handles a group of scanline blocks, aligned on pixel format block height for convertion
+			const int iJobLineCount = Math::Max(iBlockLineCount, c_iEXRJobMinLineCount);
+			const int iJobCount = (iHeight + iJobLineCount - 1) / iJobLineCount;
+			const size_t iSourceLinePitch = oFaceData.iPitch / PixelFormatEnumInfos[eSourcePixelFormat].iBlockHeight;
+			uint64_t iOffset = oHeader.size() + sizeof(uint64_t) * iBlockCount;
+			bool bError = false;
 
-			const int iRGBAtoBGRA[4] = { 2, 1, 0, 3 };
-			Core::Array<unsigned char> oChannels[4];
-			unsigned char* pChannelsPtrs[4];
-			int iChannelSize = bHalf ? 2 : 4;
-			for (int i= 0; i < iComp; ++i)
+			// Jobs are converted/planarized/compressed in parallel and written in order as soon as they are ready
+#ifndef DEBUG
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+			for (int iJob = 0; iJob < iJobCount; ++iJob)
 			{
-				oChannels[i].resize( image.width * image.height * iChannelSize );
-				pChannelsPtrs[i] = oChannels[i].begin();
-				for( int iY = 0; iY < image.height; ++iY )
+				const int iJobStartY = iJob * iJobLineCount;
+				const int iJobLines = Math::Min(iJobLineCount, iHeight - iJobStartY);
+
+				Core::Array<unsigned char> oConverted;
+				Core::Array<unsigned char> oPlanar;
+				Core::Array<unsigned char> oOutput;
+				Core::Array<uint32_t> oBlockSizes;
+
+				bool bJobOk = bError == false
+					&& oPlanar.resize(iLineSize * iBlockLineCount, false)
+					&& oBlockSizes.resize((iJobLines + iBlockLineCount - 1) / iBlockLineCount, false);
+
+				const unsigned char* pLines = (const unsigned char*)oFaceData.pData + iJobStartY * iSourceLinePitch;
+				if (bJobOk && iConvertionChainLength > 0)
 				{
-					for( int iX = 0; iX < image.width; ++iX )
+					bJobOk = oConverted.resize(iLineSize * iJobLines, false);
+					if (bJobOk)
 					{
-						unsigned char* pDest = pChannelsPtrs[i] + (iY * image.width + iX) * iChannelSize;
-						unsigned char* pSource = ( (unsigned char*)oFaceData.pData ) + ((iY * image.width + iX) * iComp + iRGBAtoBGRA[i]) * iChannelSize;
-						memcpy( pDest, pSource, iChannelSize );
+						ConvertPixelFormatRegion(
+							pLines, oFaceData.iPitch, eSourcePixelFormat,
+							&oConverted[0], iLineSize, ePixelFormat,
+							iWidth, iJobLines,
+							oConvertionFuncChain, iConvertionChainLength);
+						pLines = &oConverted[0];
 					}
 				}
-			}
+				const size_t iLinePitch = (iConvertionChainLength > 0) ? iLineSize : oFaceData.iPitch;
 
-			image.images = pChannelsPtrs;
+				for (int iBlock = 0; bJobOk && iBlock < (int)oBlockSizes.size(); ++iBlock)
+				{
+					const int iBlockStartY = iBlock * iBlockLineCount;
+					const int iBlockLines = Math::Min(iBlockLineCount, iJobLines - iBlockStartY);
+					for (int iLine = 0; iLine < iBlockLines; ++iLine)
+					{
+						const void* pLine = pLines + (iBlockStartY + iLine) * iLinePitch;
+						void* pPlanarLine = &oPlanar[iLine * iLineSize];
+						if (bHalf)
+							PlanarizeLine16((const uint16_t*)pLine, iWidth, iComp, (uint16_t*)pPlanarLine);
+						else
+							PlanarizeLine32((const float*)pLine, iWidth, iComp, (float*)pPlanarLine);
+					}
 
-			unsigned char* pMemory = NULL;
-			const char* pErr = NULL;
-			size_t iMemSize = SaveEXRImageToMemory(&image, &header, &pMemory, &pErr);
-			if( iMemSize == 0 )
-				return false;
+					// Block header: first line and data size
+					size_t iBlockOffset = oOutput.size();
+					int32_t iFirstLine = iJobStartY + iBlockStartY;
+					bJobOk = oOutput.resize(iBlockOffset + 8)
+						&& EXR::CompressBlock(eCompression, ePixelType, iComp, iWidth, iBlockLines, &oPlanar[0], iLineSize * iBlockLines, &oOutput);
+					if (bJobOk)
+					{
+						uint32_t iDataSize = (uint32_t)(oOutput.size() - iBlockOffset - 8);
+						memcpy(&oOutput[iBlockOffset], &iFirstLine, sizeof(int32_t));
+						memcpy(&oOutput[iBlockOffset + 4], &iDataSize, sizeof(uint32_t));
+						oBlockSizes[iBlock] = iDataSize + 8;
+					}
+				}
+
+#ifndef DEBUG
+#pragma omp ordered
+#endif
+				{
+					if (bJobOk == false)
+					{
+						bError = true;
+					}
+					else if (bError == false)
+					{
+						const int iFirstBlock = iJobStartY / iBlockLineCount;
+						for (int iBlock = 0; iBlock < (int)oBlockSizes.size(); ++iBlock)
+						{
+							oOffsets[iFirstBlock + iBlock] = iOffset;
+							iOffset += oBlockSizes[iBlock];
+						}
 
-			bool bOk = true;
-			if( pStream->Write( pMemory, iMemSize ) != iMemSize )
-				bOk = false;
+						if (pStream->Write(&oOutput[0], oOutput.size()) != oOutput.size())
+						{
+							bError = true;
+						}
+					}
+				}
+			}
 
-			free(pMemory);
+			if (bError)
+				return false;
 
-			return bOk;
+			return pStream->Seek(iStartPos + oHeader.size(), Core::Stream::SeekModeEnum::BEGIN)
+				&& pStream->Write(&oOffsets[0], sizeof(uint64_t) * iBlockCount) == sizeof(uint64_t) * iBlockCount
+				&& pStream->Seek(0, Core::Stream::SeekModeEnum::END);
 		}
 	}
 	//namespace TextureLoader
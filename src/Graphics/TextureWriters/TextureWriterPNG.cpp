@@ -3,7 +3,11 @@
 #include "Graphics/TextureWriter.h"
 #include "Graphics/TextureUtils.h"
 
-#include "stb_image_write.h"
+#include "Core/Deflate.h"
+
+#include "Math/Math.h"
+
+#include <stdlib.h> // abs
 
 namespace Graphics
 {
@@ -19,7 +23,7 @@ namespace Graphics
 
 		ESupportedWriter TextureWriterSupportedPNG(Texture* pTexture)
 		{
-			if (pTexture->GetMipCount() != 1 || pTexture->GetFaceCount() != 1)
+			if (pTexture->GetMipCount() != 1 || pTexture->GetFaceCount() != 1 || pTexture->IsArray() || pTexture->IsVolume())
 			{
 				return E_SUPPORTED_WRITER_PARTIAL;
 			}
@@ -56,10 +60,237 @@ namespace Graphics
 			return E_SUPPORTED_WRITER_FULL;
 		}
 
-		void WriteToStream(void* pContext, void* pData, int iSize)
+		// Uncompressed bytes per independently deflated chunk
+		static const size_t c_iPNGDeflateChunkSize = 256 * 1024;
+
+		enum EPNGFilter
+		{
+			E_PNG_FILTER_NONE,
+			E_PNG_FILTER_SUB,
+			E_PNG_FILTER_UP,
+			E_PNG_FILTER_AVERAGE,
+			E_PNG_FILTER_PAETH,
+			_E_PNG_FILTER_COUNT
+		};
+
+		static void WriteBigEndian32(unsigned char* pOut, uint32_t iValue)
+		{
+			pOut[0] = (unsigned char)(iValue >> 24);
+			pOut[1] = (unsigned char)(iValue >> 16);
+			pOut[2] = (unsigned char)(iValue >> 8);
+			pOut[3] = (unsigned char)iValue;
+		}
+
+		static uint32_t PNGChunkCrc(const char* pType, const void* pData, size_t iSize)
+		{
+			return Core::Deflate::Crc32(Core::Deflate::Crc32(0, pType, 4), pData, iSize);
+		}
+
+		static bool WritePNGChunk(Core::Stream* pStream, const char* pType, const void* pData, uint32_t iSize, uint32_t iCrc)
+		{
+			unsigned char pHeader[8];
+			unsigned char pFooter[4];
+			WriteBigEndian32(pHeader, iSize);
+			memcpy(pHeader + 4, pType, 4);
+			WriteBigEndian32(pFooter, iCrc);
+			return pStream->Write(pHeader, 8) == 8
+				&& (iSize == 0 || pStream->Write((void*)pData, iSize) == iSize)
+				&& pStream->Write(pFooter, 4) == 4;
+		}
+
+		static inline int PaethPredictor(int iA, int iB, int iC)
+		{
+			int iP = iA + iB - iC;
+			int iPA = abs(iP - iA);
+			int iPB = abs(iP - iB);
+			int iPC = abs(iP - iC);
+			if (iPA <= iPB && iPA <= iPC)
+				return iA;
+			if (iPB <= iPC)
+				return iB;
+			return iC;
+		}
+
+		// pOut receives the filter type byte followed by iRowSize filtered bytes
+		static void FilterPNGRow(EPNGFilter eFilter, const unsigned char* pRow, const unsigned char* pPrevRow, int iRowSize, int iBpp, unsigned char* pOut)
 		{
-			Core::Stream* pStream = (Core::Stream*)pContext;
-			CORE_VERIFY(pStream->Write(pData, iSize) == iSize);
+			*pOut++ = (unsigned char)eFilter;
+			switch (eFilter)
+			{
+			case E_PNG_FILTER_NONE:
+				memcpy(pOut, pRow, iRowSize);
+				break;
+			case E_PNG_FILTER_SUB:
+				for (int i = 0; i < iRowSize; ++i)
+					pOut[i] = (unsigned char)(pRow[i] - ((i >= iBpp) ? pRow[i - iBpp] : 0));
+				break;
+			case E_PNG_FILTER_UP:
+				for (int i = 0; i < iRowSize; ++i)
+					pOut[i] = (unsigned char)(pRow[i] - ((pPrevRow != NULL) ? pPrevRow[i] : 0));
+				break;
+			case E_PNG_FILTER_AVERAGE:
+				for (int i = 0; i < iRowSize; ++i)
+				{
+					int iLeft = (i >= iBpp) ? pRow[i - iBpp] : 0;
+					int iUp = (pPrevRow != NULL) ? pPrevRow[i] : 0;
+					pOut[i] = (unsigned char)(pRow[i] - ((iLeft + iUp) >> 1));
+				}
+				break;
+			case E_PNG_FILTER_PAETH:
+				for (int i = 0; i < iRowSize; ++i)
+				{
+					int iLeft = (i >= iBpp) ? pRow[i - iBpp] : 0;
+					int iUp = (pPrevRow != NULL) ? pPrevRow[i] : 0;
+					int iUpLeft = (i >= iBpp && pPrevRow != NULL) ? pPrevRow[i - iBpp] : 0;
+					pOut[i] = (unsigned char)(pRow[i] - PaethPredictor(iLeft, iUp, iUpLeft));
+				}
+				break;
+			default:
+				CORE_ASSERT(false);
+			}
+		}
+
+		// Keep the filter with the minimum sum of absolute differences (libpng heuristic)
+		// pTemp needs iRowSize + 1 bytes
+		static void FilterPNGRowAdaptive(const unsigned char* pRow, const unsigned char* pPrevRow, int iRowSize, int iBpp, unsigned char* pOut, unsigned char* pTemp)
+		{
+			uint64_t iBestScore = (uint64_t)-1;
+			for (int iFilter = 0; iFilter < _E_PNG_FILTER_COUNT; ++iFilter)
+			{
+				FilterPNGRow((EPNGFilter)iFilter, pRow, pPrevRow, iRowSize, iBpp, pTemp);
+
+				uint64_t iScore = 0;
+				for (int i = 1; i <= iRowSize; ++i)
+					iScore += (uint64_t)abs((int)(signed char)pTemp[i]);
+
+				if (iScore < iBestScore)
+				{
+					iBestScore = iScore;
+					memcpy(pOut, pTemp, iRowSize + 1);
+				}
+			}
+		}
+
+		static int GetPNGCompressionLevel(const WriterSettings* pSettings)
+		{
+			if (pSettings == NULL)
+				return Core::Deflate::c_iDefaultLevel;
+			// Quality is used as compression effort, 100 is zlib best compression level
+			return Math::Min(9, ((int)pSettings->iQuality * 9 + 50) / 100);
+		}
+
+		static bool WritePNG(const Texture::TextureFaceData& oFaceData, int iComp, int iLevel, Core::Stream* pStream)
+		{
+			static const unsigned char c_pSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			if (pStream->Write((void*)c_pSignature, sizeof(c_pSignature)) != sizeof(c_pSignature))
+				return false;
+
+			unsigned char pIHDR[13];
+			WriteBigEndian32(pIHDR, (uint32_t)oFaceData.iWidth);
+			WriteBigEndian32(pIHDR + 4, (uint32_t)oFaceData.iHeight);
+			pIHDR[8] = 8; // Bit depth
+			pIHDR[9] = (iComp == 4) ? 6 : 2; // Color type RGBA / RGB
+			pIHDR[10] = 0; // Compression method
+			pIHDR[11] = 0; // Filter method
+			pIHDR[12] = 0; // No interlace
+			if (WritePNGChunk(pStream, "IHDR", pIHDR, sizeof(pIHDR), PNGChunkCrc("IHDR", pIHDR, sizeof(pIHDR))) == false)
+				return false;
+
+			const int iRowSize = oFaceData.iWidth * iComp;
+			const size_t iFilteredRowSize = (size_t)iRowSize + 1;
+			const int iRowsPerChunk = (int)Math::Max((size_t)1, c_iPNGDeflateChunkSize / iFilteredRowSize);
+			const int iChunkCount = (oFaceData.iHeight + iRowsPerChunk - 1) / iRowsPerChunk;
+
+			// zlib header, FLEVEL is informative only
+			const unsigned char pZlibHeader[2] = { 0x78, (unsigned char)((iLevel <= 1) ? 0x01 : ((iLevel <= 5) ? 0x5E : ((iLevel == 6) ? 0x9C : 0xDA))) };
+
+			uint32_t iAdler = 1;
+			bool bError = false;
+
+			// Row chunks are filtered and deflated in parallel as independent sync flushed deflate streams (as pigz),
+			// each one is written in order as its own IDAT chunk as soon as previous ones are written
+#ifndef DEBUG
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+			for (int iChunk = 0; iChunk < iChunkCount; ++iChunk)
+			{
+				const int iStartRow = iChunk * iRowsPerChunk;
+				const int iRowCount = Math::Min(iRowsPerChunk, oFaceData.iHeight - iStartRow);
+				const size_t iFilteredSize = iFilteredRowSize * iRowCount;
+				const bool bLastChunk = iChunk == (iChunkCount - 1);
+
+				Core::Array<unsigned char> oFiltered;
+				Core::Array<unsigned char> oCompressed;
+				uint32_t iChunkAdler = 1;
+				uint32_t iCrc = 0;
+
+				// Filtered rows followed by a temporary row for the filter heuristic
+				bool bChunkOk = bError == false && oFiltered.resize(iFilteredSize + iFilteredRowSize, false);
+				if (bChunkOk)
+				{
+					unsigned char* pTemp = &oFiltered[iFilteredSize];
+					for (int iRow = 0; iRow < iRowCount; ++iRow)
+					{
+						const unsigned char* pRow = (const unsigned char*)oFaceData.pData + (size_t)(iStartRow + iRow) * oFaceData.iPitch;
+						const unsigned char* pPrevRow = (iStartRow + iRow > 0) ? pRow - oFaceData.iPitch : NULL;
+						unsigned char* pOut = &oFiltered[iFilteredRowSize * iRow];
+						if (iLevel == 0)
+							FilterPNGRow(E_PNG_FILTER_NONE, pRow, pPrevRow, iRowSize, iComp, pOut);
+						else
+							FilterPNGRowAdaptive(pRow, pPrevRow, iRowSize, iComp, pOut, pTemp);
+					}
+
+					iChunkAdler = Core::Deflate::Adler32(1, &oFiltered[0], iFilteredSize);
+
+					if (iChunk == 0)
+					{
+						bChunkOk = oCompressed.resize(sizeof(pZlibHeader));
+						if (bChunkOk)
+							memcpy(&oCompressed[0], pZlibHeader, sizeof(pZlibHeader));
+					}
+					bChunkOk = bChunkOk && Core::Deflate::Compress(&oFiltered[0], iFilteredSize, iLevel, bLastChunk, &oCompressed) && oCompressed.size() > 0;
+					if (bChunkOk)
+						iCrc = PNGChunkCrc("IDAT", &oCompressed[0], oCompressed.size());
+				}
+
+#ifndef DEBUG
+#pragma omp ordered
+#endif
+				{
+					if (bChunkOk == false)
+					{
+						bError = true;
+					}
+					else if (bError == false)
+					{
+						iAdler = (iChunk == 0) ? iChunkAdler : Core::Deflate::Adler32Combine(iAdler, iChunkAdler, iFilteredSize);
+						if (bLastChunk)
+						{
+							// zlib footer
+							size_t iOffset = oCompressed.size();
+							if (oCompressed.resize(iOffset + 4))
+							{
+								WriteBigEndian32(&oCompressed[iOffset], iAdler);
+								iCrc = Core::Deflate::Crc32(iCrc, &oCompressed[iOffset], 4);
+							}
+							else
+							{
+								bError = true;
+							}
+						}
+
+						if (bError == false && WritePNGChunk(pStream, "IDAT", &oCompressed[0], (uint32_t)oCompressed.size(), iCrc) == false)
+						{
+							bError = true;
+						}
+					}
+				}
+			}
+
+			if (bError)
+				return false;
+
+			return WritePNGChunk(pStream, "IEND", NULL, 0, PNGChunkCrc("IEND", NULL, 0));
 		}
 
 		bool TextureWriterPNG(Texture* pTexture, const WriterSettings* pSettings, Core::Stream* pStream)
@@ -93,11 +324,7 @@ namespace Graphics
 			}
 
 			const Texture::TextureFaceData& oFaceData = pTexture->GetData().GetFaceData(0, 0);
-			if (stbi_write_png_to_func(WriteToStream, pStream, pTexture->GetWidth(), pTexture->GetHeight(), iComp, (void*)oFaceData.pData, 0) == 1)
-			{
-				return true;
-			}
-			return false;
+			return WritePNG(oFaceData, iComp, GetPNGCompressionLevel(pSettings), pStream);
 		}
 	}
 	//namespace TextureLoader
@@ -0,0 +1,606 @@
+#include "Graphics/TiledTexture.h"
+
+#include "Core/Assert.h"
+#include "Core/Memory.h"
+
+#include "Math/Math.h"
+
+#include <stdio.h> //tmpfile/fread/fwrite/fclose
+#include <string.h> //memcpy/memset
+
+namespace Graphics
+{
+	////////////////////////////////////////////////////////////////
+	// TiledTexture::Desc
+	////////////////////////////////////////////////////////////////
+
+	TiledTexture::Desc::Desc()
+	{
+		iTileSize = c_iDefaultTileSize;
+		iMemoryBudget = c_iDefaultMemoryBudget;
+	}
+
+	////////////////////////////////////////////////////////////////
+	// TiledTexture
+	////////////////////////////////////////////////////////////////
+
+	TiledTexture::TiledTexture()
+		: m_iWidth(0)
+		, m_iHeight(0)
+		, m_ePixelFormat(PixelFormatEnum::_NONE)
+		, m_iFaceCount(0)
+		, m_iMipCount(0)
+		, m_iTileSize(0)
+		, m_iTileDataSize(0)
+		, m_iTilePitch(0)
+		, m_iMemoryBudget(0)
+		, m_iMaxSlotCount(0)
+		, m_iSlotHead(-1)
+		, m_iSlotTail(-1)
+	{
+		omp_init_lock(&m_oLock);
+	}
+
+	TiledTexture::~TiledTexture()
+	{
+		Destroy();
+		omp_destroy_lock(&m_oLock);
+	}
+
+	ErrorCode TiledTexture::Create(Desc& oDesc)
+	{
+		if (!(oDesc.ePixelFormat != PixelFormatEnum::_NONE
+			&& oDesc.iWidth > 0 && oDesc.iWidth <= c_iMaxSize
+			&& oDesc.iHeight > 0 && oDesc.iHeight <= c_iMaxSize
+			&& oDesc.iMipCount > 0 && oDesc.iMipCount <= c_iMaxMip
+			&& oDesc.iFaceCount > 0 && oDesc.iFaceCount <= Texture::_E_FACE_COUNT))
+		{
+			return ErrorCode(1, "Invalid desc");
+		}
+
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[oDesc.ePixelFormat];
+		if (oDesc.iTileSize <= 0 || (oDesc.iTileSize % oInfos.iBlockWidth) != 0 || (oDesc.iTileSize % oInfos.iBlockHeight) != 0)
+		{
+			return ErrorCode(1, "Tile size need to be a multiple of block size");
+		}
+
+		Destroy();
+
+		m_iWidth = oDesc.iWidth;
+		m_iHeight = oDesc.iHeight;
+		m_ePixelFormat = oDesc.ePixelFormat;
+		m_iFaceCount = oDesc.iFaceCount;
+		m_iMipCount = oDesc.iMipCount;
+		m_iTileSize = oDesc.iTileSize;
+		m_iTilePitch = (size_t)(m_iTileSize / oInfos.iBlockWidth) * oInfos.iBlockSize;
+		m_iTileDataSize = m_iTilePitch * (m_iTileSize / oInfos.iBlockHeight);
+		m_iMemoryBudget = oDesc.iMemoryBudget;
+
+		size_t iTileCount = 0;
+		for (int iMip = 0; iMip < m_iMipCount; ++iMip)
+		{
+			m_iMipFirstTile[iMip] = iTileCount;
+			iTileCount += (size_t)GetTileCountX(iMip) * GetTileCountY(iMip) * m_iFaceCount;
+		}
+
+		if (m_oTiles.resize(iTileCount, false) == false)
+		{
+			Destroy();
+			return ErrorCode(1, "Can't alloc tile table");
+		}
+		for (size_t iTile = 0; iTile < iTileCount; ++iTile)
+		{
+			m_oTiles[iTile].iSlot = -1;
+			m_oTiles[iTile].iStoringSlot = -1;
+			m_oTiles[iTile].bOnDisk = false;
+		}
+
+#ifndef DEBUG
+		const int iThreadCount = omp_get_max_threads();
+#else
+		const int iThreadCount = 1;
+#endif
+
+		// Each worker can lock a source and a destination tile at the same time
+		int iMinSlotCount = iThreadCount * 2 + 2;
+		size_t iBudgetSlotCount = m_iMemoryBudget / m_iTileDataSize;
+		m_iMaxSlotCount = (int)Math::Min<size_t>(Math::Max<size_t>(iBudgetSlotCount, iMinSlotCount), iTileCount);
+		if (m_oSlots.reserve(m_iMaxSlotCount) == false)
+		{
+			Destroy();
+			return ErrorCode(1, "Can't alloc tile cache");
+		}
+
+		// Temporary files are removed by the system when closed
+		const int iScratchFileCount = (int)Math::Min<size_t>(iThreadCount, iTileCount);
+		if (m_oScratchFiles.reserve(iScratchFileCount) == false)
+		{
+			Destroy();
+			return ErrorCode(1, "Can't alloc scratch files");
+		}
+		for (int iFile = 0; iFile < iScratchFileCount; ++iFile)
+		{
+			ScratchFile oFile;
+			oFile.pFile = tmpfile();
+			if (oFile.pFile == NULL)
+			{
+				Destroy();
+				return ErrorCode(1, "Can't create scratch file");
+			}
+			m_oScratchFiles.push_back(oFile);
+			omp_init_lock(&m_oScratchFiles[iFile].oLock);
+		}
+
+		return ErrorCode::Ok;
+	}
+
+	void TiledTexture::Destroy()
+	{
+		for (size_t iSlot = 0; iSlot < m_oSlots.size(); ++iSlot)
+		{
+			CORE_ASSERT(m_oSlots[iSlot].iLockCount == 0);
+			Core::Free(m_oSlots[iSlot].pData);
+			omp_destroy_lock(&m_oSlots[iSlot].oIOLock);
+		}
+		m_oSlots.clear();
+		m_oTiles.clear();
+		m_iMaxSlotCount = 0;
+		m_iSlotHead = -1;
+		m_iSlotTail = -1;
+
+		for (size_t iFile = 0; iFile < m_oScratchFiles.size(); ++iFile)
+		{
+			fclose((FILE*)m_oScratchFiles[iFile].pFile);
+			omp_destroy_lock(&m_oScratchFiles[iFile].oLock);
+		}
+		m_oScratchFiles.clear();
+
+		m_iWidth = 0;
+		m_iHeight = 0;
+		m_ePixelFormat = PixelFormatEnum::_NONE;
+		m_iFaceCount = 0;
+		m_iMipCount = 0;
+	}
+
+	bool TiledTexture::IsValid() const
+	{
+		return m_oScratchFiles.size() > 0;
+	}
+
+	int TiledTexture::GetMipWidth(int iMip) const
+	{
+		return Math::Max(m_iWidth >> iMip, 1);
+	}
+
+	int TiledTexture::GetMipHeight(int iMip) const
+	{
+		return Math::Max(m_iHeight >> iMip, 1);
+	}
+
+	int TiledTexture::GetTileCountX(int iMip) const
+	{
+		return (GetMipWidth(iMip) + m_iTileSize - 1) / m_iTileSize;
+	}
+
+	int TiledTexture::GetTileCountY(int iMip) const
+	{
+		return (GetMipHeight(iMip) + m_iTileSize - 1) / m_iTileSize;
+	}
+
+	size_t TiledTexture::GetTileIndex(int iMip, int iFace, int iTileX, int iTileY) const
+	{
+		CORE_ASSERT(iMip >= 0 && iMip < m_iMipCount);
+		CORE_ASSERT(iFace >= 0 && iFace < m_iFaceCount);
+		CORE_ASSERT(iTileX >= 0 && iTileX < GetTileCountX(iMip));
+		CORE_ASSERT(iTileY >= 0 && iTileY < GetTileCountY(iMip));
+		return m_iMipFirstTile[iMip] + ((size_t)iFace * GetTileCountY(iMip) + iTileY) * GetTileCountX(iMip) + iTileX;
+	}
+
+	bool TiledTexture::LoadTile(size_t iTile, void* pData)
+	{
+		// Tile n is the n / count tile of file n % count
+		ScratchFile& oFile = m_oScratchFiles[iTile % m_oScratchFiles.size()];
+		const size_t iOffset = (iTile / m_oScratchFiles.size()) * m_iTileDataSize;
+		omp_set_lock(&oFile.oLock);
+		bool bRes = _fseeki64((FILE*)oFile.pFile, iOffset, SEEK_SET) == 0
+			&& fread(pData, 1, m_iTileDataSize, (FILE*)oFile.pFile) == m_iTileDataSize;
+		omp_unset_lock(&oFile.oLock);
+		return bRes;
+	}
+
+	bool TiledTexture::StoreTile(size_t iTile, const void* pData)
+	{
+		ScratchFile& oFile = m_oScratchFiles[iTile % m_oScratchFiles.size()];
+		const size_t iOffset = (iTile / m_oScratchFiles.size()) * m_iTileDataSize;
+		omp_set_lock(&oFile.oLock);
+		bool bRes = _fseeki64((FILE*)oFile.pFile, iOffset, SEEK_SET) == 0
+			&& fwrite(pData, 1, m_iTileDataSize, (FILE*)oFile.pFile) == m_iTileDataSize;
+		omp_unset_lock(&oFile.oLock);
+		return bRes;
+	}
+
+	void TiledTexture::LinkSlotFront(int iSlot)
+	{
+		CacheSlot& oSlot = m_oSlots[iSlot];
+		oSlot.iPrev = -1;
+		oSlot.iNext = m_iSlotHead;
+		if (m_iSlotHead != -1)
+			m_oSlots[m_iSlotHead].iPrev = iSlot;
+		m_iSlotHead = iSlot;
+		if (m_iSlotTail == -1)
+			m_iSlotTail = iSlot;
+	}
+
+	void TiledTexture::UnlinkSlot(int iSlot)
+	{
+		CacheSlot& oSlot = m_oSlots[iSlot];
+		if (oSlot.iPrev != -1)
+			m_oSlots[oSlot.iPrev].iNext = oSlot.iNext;
+		else
+			m_iSlotHead = oSlot.iNext;
+		if (oSlot.iNext != -1)
+			m_oSlots[oSlot.iNext].iPrev = oSlot.iPrev;
+		else
+			m_iSlotTail = oSlot.iPrev;
+		oSlot.iPrev = oSlot.iNext = -1;
+	}
+
+	int TiledTexture::AcquireSlot(size_t* pOutEvictedTile)
+	{
+		*pOutEvictedTile = (size_t)-1;
+
+		// Grow the cache until memory budget is reached
+		if ((int)m_oSlots.size() < m_iMaxSlotCount)
+		{
+			CacheSlot oSlot;
+			oSlot.pData = Core::Malloc(m_iTileDataSize);
+			oSlot.iTile = (size_t)-1;
+			oSlot.iLockCount = 0;
+			oSlot.bDirty = false;
+			oSlot.bLoading = false;
+			oSlot.iPrev = oSlot.iNext = -1;
+			if (oSlot.pData != NULL)
+			{
+				// Slots are reserved at creation, lock address doesn't change
+				m_oSlots.push_back(oSlot);
+				omp_init_lock(&m_oSlots[m_oSlots.size() - 1].oIOLock);
+				return (int)m_oSlots.size() - 1;
+			}
+		}
+
+		// Evict least recently used unlocked tile, slots being loaded are locked
+		for (int iSlot = m_iSlotTail; iSlot != -1; iSlot = m_oSlots[iSlot].iPrev)
+		{
+			CacheSlot& oSlot = m_oSlots[iSlot];
+			if (oSlot.iLockCount > 0)
+				continue;
+
+			if (oSlot.iTile != (size_t)-1)
+			{
+				if (oSlot.bDirty)
+					*pOutEvictedTile = oSlot.iTile;
+				m_oTiles[oSlot.iTile].iSlot = -1;
+			}
+			oSlot.iTile = (size_t)-1;
+			oSlot.bDirty = false;
+			UnlinkSlot(iSlot);
+			return iSlot;
+		}
+		return -1;
+	}
+
+	void* TiledTexture::LockTile(int iMip, int iFace, int iTileX, int iTileY, LockModeEnum eMode)
+	{
+		size_t iTile = GetTileIndex(iMip, iFace, iTileX, iTileY);
+
+		omp_set_lock(&m_oLock);
+
+		// Wait for the threads loading the tile or writing it back, they hold the I/O lock of their slot
+		for (;;)
+		{
+			const TileInfo& oInfo = m_oTiles[iTile];
+			int iBusySlot = -1;
+			if (oInfo.iSlot != -1 && m_oSlots[oInfo.iSlot].bLoading)
+				iBusySlot = oInfo.iSlot;
+			else if (oInfo.iSlot == -1 && oInfo.iStoringSlot != -1)
+				iBusySlot = oInfo.iStoringSlot;
+			if (iBusySlot == -1)
+				break;
+
+			omp_unset_lock(&m_oLock);
+			omp_set_lock(&m_oSlots[iBusySlot].oIOLock);
+			omp_unset_lock(&m_oSlots[iBusySlot].oIOLock);
+			omp_set_lock(&m_oLock);
+		}
+
+		int iSlot = m_oTiles[iTile].iSlot;
+		if (iSlot != -1)
+		{
+			CacheSlot& oSlot = m_oSlots[iSlot];
+			UnlinkSlot(iSlot);
+			LinkSlotFront(iSlot);
+			++oSlot.iLockCount;
+			if (eMode != LockModeEnum::READ)
+				oSlot.bDirty = true;
+			void* pData = oSlot.pData;
+			omp_unset_lock(&m_oLock);
+			return pData;
+		}
+
+		size_t iEvictedTile;
+		iSlot = AcquireSlot(&iEvictedTile);
+		if (iSlot == -1)
+		{
+			omp_unset_lock(&m_oLock);
+			CORE_ASSERT(false, "Can't lock tile, cache is full");
+			return NULL;
+		}
+
+		// Slot is published as loading, I/O is done without holding the cache lock
+		CacheSlot& oSlot = m_oSlots[iSlot];
+		const bool bOnDisk = m_oTiles[iTile].bOnDisk;
+		if (iEvictedTile != (size_t)-1)
+			m_oTiles[iEvictedTile].iStoringSlot = iSlot;
+		m_oTiles[iTile].iSlot = iSlot;
+		oSlot.iTile = iTile;
+		oSlot.iLockCount = 1;
+		oSlot.bDirty = eMode != LockModeEnum::READ;
+		oSlot.bLoading = true;
+		LinkSlotFront(iSlot);
+		omp_set_lock(&oSlot.oIOLock);
+		omp_unset_lock(&m_oLock);
+
+		const bool bStored = iEvictedTile == (size_t)-1 || StoreTile(iEvictedTile, oSlot.pData);
+		bool bLoaded = bStored;
+		if (bStored && eMode != LockModeEnum::WRITE_DISCARD)
+		{
+			if (bOnDisk)
+				bLoaded = LoadTile(iTile, oSlot.pData);
+			else
+				memset(oSlot.pData, 0, m_iTileDataSize);
+		}
+
+		omp_set_lock(&m_oLock);
+		if (iEvictedTile != (size_t)-1)
+		{
+			m_oTiles[iEvictedTile].iStoringSlot = -1;
+			m_oTiles[iEvictedTile].bOnDisk |= bStored;
+		}
+		if (bStored == false)
+		{
+			// Evicted tile content is still in the slot, keep it cached
+			m_oTiles[iTile].iSlot = -1;
+			m_oTiles[iEvictedTile].iSlot = iSlot;
+			oSlot.iTile = iEvictedTile;
+			oSlot.bDirty = true;
+			oSlot.iLockCount = 0;
+		}
+		else if (bLoaded == false)
+		{
+			// Keep the empty slot reusable
+			m_oTiles[iTile].iSlot = -1;
+			oSlot.iTile = (size_t)-1;
+			oSlot.bDirty = false;
+			oSlot.iLockCount = 0;
+		}
+		oSlot.bLoading = false;
+		omp_unset_lock(&oSlot.oIOLock);
+		omp_unset_lock(&m_oLock);
+
+		CORE_ASSERT(bLoaded, "Can't lock tile, scratch file is not accessible");
+		void* pData = NULL;
+		if (bLoaded)
+			pData = oSlot.pData;
+		return pData;
+	}
+
+	void TiledTexture::UnlockTile(int iMip, int iFace, int iTileX, int iTileY)
+	{
+		size_t iTile = GetTileIndex(iMip, iFace, iTileX, iTileY);
+
+		omp_set_lock(&m_oLock);
+		int iSlot = m_oTiles[iTile].iSlot;
+		CORE_ASSERT(iSlot != -1 && m_oSlots[iSlot].iLockCount > 0);
+		if (iSlot != -1 && m_oSlots[iSlot].iLockCount > 0)
+		{
+			--m_oSlots[iSlot].iLockCount;
+		}
+		omp_unset_lock(&m_oLock);
+	}
+
+	ErrorCode TiledTexture::ReadRegion(int iMip, int iFace, int iX, int iY, int iWidth, int iHeight, void* pOut, size_t iOutPitch)
+	{
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[m_ePixelFormat];
+		if (pOut == NULL || iX < 0 || iY < 0 || iWidth <= 0 || iHeight <= 0
+			|| (iX % oInfos.iBlockWidth) != 0 || (iY % oInfos.iBlockHeight) != 0
+			|| iX + iWidth > GetMipWidth(iMip) || iY + iHeight > GetMipHeight(iMip))
+		{
+			return ErrorCode::InvalidArgument;
+		}
+
+		for (int iTileY = iY / m_iTileSize, iTileEndY = (iY + iHeight - 1) / m_iTileSize; iTileY <= iTileEndY; ++iTileY)
+		{
+			for (int iTileX = iX / m_iTileSize, iTileEndX = (iX + iWidth - 1) / m_iTileSize; iTileX <= iTileEndX; ++iTileX)
+			{
+				const char* pTile = (const char*)LockTile(iMip, iFace, iTileX, iTileY, LockModeEnum::READ);
+				if (pTile == NULL)
+				{
+					return ErrorCode(1, "Can't lock tile");
+				}
+
+				int iStartX = Math::Max(iX, iTileX * m_iTileSize);
+				int iEndX = Math::Min(iX + iWidth, (iTileX + 1) * m_iTileSize);
+				int iStartY = Math::Max(iY, iTileY * m_iTileSize);
+				int iEndY = Math::Min(iY + iHeight, (iTileY + 1) * m_iTileSize);
+
+				size_t iLineSize = (size_t)((iEndX - iStartX + oInfos.iBlockWidth - 1) / oInfos.iBlockWidth) * oInfos.iBlockSize;
+				for (int iLineY = iStartY; iLineY < iEndY; iLineY += oInfos.iBlockHeight)
+				{
+					const char* pSrc = pTile
+						+ (size_t)((iLineY - iTileY * m_iTileSize) / oInfos.iBlockHeight) * m_iTilePitch
+						+ (size_t)((iStartX - iTileX * m_iTileSize) / oInfos.iBlockWidth) * oInfos.iBlockSize;
+					char* pDst = (char*)pOut
+						+ (size_t)((iLineY - iY) / oInfos.iBlockHeight) * iOutPitch
+						+ (size_t)((iStartX - iX) / oInfos.iBlockWidth) * oInfos.iBlockSize;
+					memcpy(pDst, pSrc, iLineSize);
+				}
+
+				UnlockTile(iMip, iFace, iTileX, iTileY);
+			}
+		}
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode TiledTexture::WriteRegion(int iMip, int iFace, int iX, int iY, int iWidth, int iHeight, const void* pIn, size_t iInPitch)
+	{
+		const PixelFormatInfos& oInfos = PixelFormatEnumInfos[m_ePixelFormat];
+		if (pIn == NULL || iX < 0 || iY < 0 || iWidth <= 0 || iHeight <= 0
+			|| (iX % oInfos.iBlockWidth) != 0 || (iY % oInfos.iBlockHeight) != 0
+			|| iX + iWidth > GetMipWidth(iMip) || iY + iHeight > GetMipHeight(iMip))
+		{
+			return ErrorCode::InvalidArgument;
+		}
+
+		for (int iTileY = iY / m_iTileSize, iTileEndY = (iY + iHeight - 1) / m_iTileSize; iTileY <= iTileEndY; ++iTileY)
+		{
+			for (int iTileX = iX / m_iTileSize, iTileEndX = (iX + iWidth - 1) / m_iTileSize; iTileX <= iTileEndX; ++iTileX)
+			{
+				int iStartX = Math::Max(iX, iTileX * m_iTileSize);
+				int iEndX = Math::Min(iX + iWidth, (iTileX + 1) * m_iTileSize);
+				int iStartY = Math::Max(iY, iTileY * m_iTileSize);
+				int iEndY = Math::Min(iY + iHeight, (iTileY + 1) * m_iTileSize);
+
+				// Whole tile content is replaced, no need to read it back from the scratch file
+				bool bFullTile = iStartX == iTileX * m_iTileSize && iStartY == iTileY * m_iTileSize
+					&& (iEndX == (iTileX + 1) * m_iTileSize || iEndX == GetMipWidth(iMip))
+					&& (iEndY == (iTileY + 1) * m_iTileSize || iEndY == GetMipHeight(iMip));
+
+				char* pTile = (char*)LockTile(iMip, iFace, iTileX, iTileY, bFullTile ? LockModeEnum::WRITE_DISCARD : LockModeEnum::WRITE);
+				if (pTile == NULL)
+				{
+					return ErrorCode(1, "Can't lock tile");
+				}
+
+				size_t iLineSize = (size_t)((iEndX - iStartX + oInfos.iBlockWidth - 1) / oInfos.iBlockWidth) * oInfos.iBlockSize;
+				for (int iLineY = iStartY; iLineY < iEndY; iLineY += oInfos.iBlockHeight)
+				{
+					char* pDst = pTile
+						+ (size_t)((iLineY - iTileY * m_iTileSize) / oInfos.iBlockHeight) * m_iTilePitch
+						+ (size_t)((iStartX - iTileX * m_iTileSize) / oInfos.iBlockWidth) * oInfos.iBlockSize;
+					const char* pSrc = (const char*)pIn
+						+ (size_t)((iLineY - iY) / oInfos.iBlockHeight) * iInPitch
+						+ (size_t)((iStartX - iX) / oInfos.iBlockWidth) * oInfos.iBlockSize;
+					memcpy(pDst, pSrc, iLineSize);
+				}
+
+				UnlockTile(iMip, iFace, iTileX, iTileY);
+			}
+		}
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode TiledTexture::CopyFromTexture(const Texture& oTexture)
+	{
+		if (oTexture.IsValid() == false)
+		{
+			return ErrorCode::InvalidArgument;
+		}
+
+		if (oTexture.IsArray() || oTexture.IsVolume())
+		{
+			return ErrorCode(1, "Array and volume textures are not supported by tiled textures");
+		}
+
+		Desc oDesc;
+		oDesc.iWidth = oTexture.GetWidth();
+		oDesc.iHeight = oTexture.GetHeight();
+		oDesc.ePixelFormat = oTexture.GetPixelFormat();
+		oDesc.iFaceCount = oTexture.GetFaceCount();
+		oDesc.iMipCount = oTexture.GetMipCount();
+		if (IsValid())
+		{
+			oDesc.iTileSize = m_iTileSize;
+			oDesc.iMemoryBudget = m_iMemoryBudget;
+		}
+
+		ErrorCode oErr = Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		for (int iMip = 0; iMip < m_iMipCount; ++iMip)
+		{
+			for (int iFace = 0; iFace < m_iFaceCount; ++iFace)
+			{
+				const Texture::TextureFaceData& oFaceData = oTexture.GetData().GetFaceData(iMip, iFace);
+				oErr = WriteRegion(iMip, iFace, 0, 0, oFaceData.iWidth, oFaceData.iHeight, oFaceData.pData, oFaceData.iPitch);
+				if (oErr != ErrorCode::Ok)
+					return oErr;
+			}
+		}
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode TiledTexture::CopyToTexture(Texture* pOutTexture)
+	{
+		if (pOutTexture == NULL || IsValid() == false)
+		{
+			return ErrorCode::InvalidArgument;
+		}
+
+		if (m_iWidth > Texture::c_iMaxSize || m_iHeight > Texture::c_iMaxSize || m_iMipCount > Texture::c_iMaxMip)
+		{
+			return ErrorCode(1, "Tiled texture is too big for a Texture");
+		}
+
+		Texture oTemp;
+		Texture::Desc oDesc;
+		oDesc.iWidth = m_iWidth;
+		oDesc.iHeight = m_iHeight;
+		oDesc.ePixelFormat = m_ePixelFormat;
+		oDesc.iFaceCount = m_iFaceCount;
+		oDesc.iMipCount = m_iMipCount;
+		ErrorCode oErr = oTemp.Create(oDesc);
+		if (oErr != ErrorCode::Ok)
+			return oErr;
+
+		for (int iMip = 0; iMip < m_iMipCount; ++iMip)
+		{
+			for (int iFace = 0; iFace < m_iFaceCount; ++iFace)
+			{
+				const Texture::TextureFaceData& oFaceData = oTemp.GetData().GetFaceData(iMip, iFace);
+				oErr = ReadRegion(iMip, iFace, 0, 0, oFaceData.iWidth, oFaceData.iHeight, oFaceData.pData, oFaceData.iPitch);
+				if (oErr != ErrorCode::Ok)
+					return oErr;
+			}
+		}
+
+		oTemp.Swap(*pOutTexture);
+		return ErrorCode::Ok;
+	}
+
+	ErrorCode TiledTexture::Flush()
+	{
+		ErrorCode oErr = ErrorCode::Ok;
+		omp_set_lock(&m_oLock);
+		for (size_t iSlot = 0; iSlot < m_oSlots.size(); ++iSlot)
+		{
+			CacheSlot& oSlot = m_oSlots[iSlot];
+			if (oSlot.bDirty && oSlot.iTile != (size_t)-1)
+			{
+				CORE_ASSERT(oSlot.iLockCount == 0);
+				if (StoreTile(oSlot.iTile, oSlot.pData))
+				{
+					m_oTiles[oSlot.iTile].bOnDisk = true;
+					oSlot.bDirty = false;
+				}
+				else
+				{
+					oErr = ErrorCode(1, "Can't write tile to scratch files");
+				}
+			}
+		}
+		omp_unset_lock(&m_oLock);
+		return oErr;
+	}
+}
+//namespace Graphics
@@ -0,0 +1,143 @@
+#ifndef __GRAPHICS_TILED_TEXTURE_H__
+#define __GRAPHICS_TILED_TEXTURE_H__
+
+#include "Core/ErrorCode.h"
+#include "Core/Array.h"
+
+#include "Graphics/Texture.h"
+
+#include <omp.h>
+
+namespace Graphics
+{
+	/* Out-of-core texture storage
+	Each face of each mip is split in fixed size tiles stored in temporary scratch files.
+	Only a limited amount of tiles are kept in memory (LRU cache), the memory
+	budget bound the size of the cache, not the size of the texture.
+	Tiles are spread over one scratch file per thread and read/written outside of
+	the cache lock, so workers missing the cache load their tiles in parallel.
+	DDS files are streamed in and out by bands of rows (TextureLoader::LoadTiledDDS,
+	TextureWriter::WriteTiledDDS), so neither side needs the whole texture in memory.
+	*/
+	class TiledTexture
+	{
+	public:
+		static const int				c_iMaxSize = 1 << 20;
+		static const int				c_iMaxMip = 21;
+		static const int				c_iDefaultTileSize = 256;
+		static const size_t				c_iDefaultMemoryBudget = (size_t)512 * 1024 * 1024;
+
+		struct _LockModeEnum
+		{
+			enum Enum
+			{
+				READ,
+				WRITE,
+				WRITE_DISCARD // Previous content of the tile is not loaded
+			};
+		};
+		typedef _LockModeEnum::Enum LockModeEnum;
+
+		struct Desc : Texture::TextureData::Desc
+		{
+			Desc();
+			int							iTileSize; // In pixels, need to be a multiple of block size
+			size_t						iMemoryBudget; // In bytes
+		};
+	public:
+										TiledTexture();
+										~TiledTexture();
+
+		ErrorCode						Create(Desc& oDesc);
+		void							Destroy();
+		bool							IsValid() const;
+
+		int								GetWidth() const { return m_iWidth; }
+		int								GetHeight() const { return m_iHeight; }
+		PixelFormatEnum					GetPixelFormat() const { return m_ePixelFormat; }
+		int								GetFaceCount() const { return m_iFaceCount; }
+		int								GetMipCount() const { return m_iMipCount; }
+
+		int								GetTileSize() const { return m_iTileSize; }
+		size_t							GetTileDataSize() const { return m_iTileDataSize; }
+		size_t							GetTilePitch() const { return m_iTilePitch; }
+		size_t							GetMemoryBudget() const { return m_iMemoryBudget; }
+
+		int								GetMipWidth(int iMip) const;
+		int								GetMipHeight(int iMip) const;
+		int								GetTileCountX(int iMip) const;
+		int								GetTileCountY(int iMip) const;
+
+		// Returned pointer stay valid until UnlockTile, tile data has GetTilePitch() bytes per block line
+		void*							LockTile(int iMip, int iFace, int iTileX, int iTileY, LockModeEnum eMode);
+		void							UnlockTile(int iMip, int iFace, int iTileX, int iTileY);
+
+		// Positions and sizes in pixels, need to be aligned on block size
+		ErrorCode						ReadRegion(int iMip, int iFace, int iX, int iY, int iWidth, int iHeight, void* pOut, size_t iOutPitch);
+		ErrorCode						WriteRegion(int iMip, int iFace, int iX, int iY, int iWidth, int iHeight, const void* pIn, size_t iInPitch);
+
+		ErrorCode						CopyFromTexture(const Texture& oTexture);
+		ErrorCode						CopyToTexture(Texture* pOutTexture);
+
+		// Write back all dirty tiles to scratch files, no tile can be locked
+		ErrorCode						Flush();
+	protected:
+		struct TileInfo
+		{
+			int							iSlot;
+			int							iStoringSlot; // Slot writing back the tile after its eviction, -1 when none
+			bool						bOnDisk;
+		};
+
+		struct CacheSlot
+		{
+			CORE_PTR_VOID				pData;
+			size_t						iTile;
+			int							iLockCount;
+			bool						bDirty;
+			bool						bLoading; // Data is being read/written by the thread holding oIOLock
+			omp_lock_t					oIOLock;
+			int							iPrev;
+			int							iNext;
+		};
+
+		struct ScratchFile
+		{
+			void*						pFile;
+			omp_lock_t					oLock;
+		};
+
+		size_t							GetTileIndex(int iMip, int iFace, int iTileX, int iTileY) const;
+		// Scratch file I/O, called outside of m_oLock
+		bool							LoadTile(size_t iTile, void* pData);
+		bool							StoreTile(size_t iTile, const void* pData);
+		// Evicted dirty tile need to be written back by the caller, pOutEvictedTile is -1 when there is none
+		int								AcquireSlot(size_t* pOutEvictedTile);
+		void							LinkSlotFront(int iSlot);
+		void							UnlinkSlot(int iSlot);
+
+		int								m_iWidth;
+		int								m_iHeight;
+		PixelFormatEnum					m_ePixelFormat;
+		int								m_iFaceCount;
+		int								m_iMipCount;
+
+		int								m_iTileSize;
+		size_t							m_iTileDataSize;
+		size_t							m_iTilePitch;
+		size_t							m_iMemoryBudget;
+		size_t							m_iMipFirstTile[c_iMaxMip];
+
+		Core::Array<TileInfo>			m_oTiles;
+		Core::Array<CacheSlot>			m_oSlots;
+		int								m_iMaxSlotCount;
+		int								m_iSlotHead; // Most recently used
+		int								m_iSlotTail; // Least recently used
+
+		Core::Array<ScratchFile>		m_oScratchFiles;
+		omp_lock_t						m_oLock; // Tile table and cache slots
+	};
+}
+//namespace Graphics
+
+#endif //__GRAPHICS_TILED_TEXTURE_H__
@@ -1,2 +1,138 @@
 #define TINYEXR_IMPLEMENTATION
-#include "tinyexr.h"
\ No newline at end of file
+#include "tinyexr.h"
+
+#include "Core/Deflate.h"
+
+namespace Core
+{
+	namespace Deflate
+	{
+		static tinyexr::miniz::mz_bool AppendToArray(const void* pBuffer, int iLen, void* pUser)
+		{
+			Array<unsigned char>* pOut = (Array<unsigned char>*)pUser;
+			size_t iOffset = pOut->size();
+			if (iLen <= 0)
+				return MZ_TRUE;
+			if (pOut->resize(iOffset + (size_t)iLen) == false)
+				return MZ_FALSE;
+			memcpy(&(*pOut)[iOffset], pBuffer, (size_t)iLen);
+			return MZ_TRUE;
+		}
+
+		bool Compress(const void* pData, size_t iSize, int iLevel, bool bFinish, Array<unsigned char>* pOut)
+		{
+			using namespace tinyexr::miniz;
+
+			if (pOut == NULL || (pData == NULL && iSize > 0))
+				return false;
+
+			iLevel = iLevel < c_iMinLevel ? c_iMinLevel : (iLevel > c_iMaxLevel ? c_iMaxLevel : iLevel);
+
+			// Compressor state is too big for the stack
+			tdefl_compressor* pCompressor = (tdefl_compressor*)malloc(sizeof(tdefl_compressor));
+			if (pCompressor == NULL)
+				return false;
+
+			mz_uint iFlags = tdefl_create_comp_flags_from_zip_params(iLevel, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+			bool bOk = tdefl_init(pCompressor, AppendToArray, pOut, (int)iFlags) == TDEFL_STATUS_OKAY
+				&& tdefl_compress_buffer(pCompressor, pData, iSize, bFinish ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) == (bFinish ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+
+			free(pCompressor);
+			return bOk;
+		}
+
+		uint32_t Adler32(uint32_t iAdler, const void* pData, size_t iSize)
+		{
+			// miniz returns initial value on NULL buffer
+			if (iSize == 0)
+				return iAdler;
+			return (uint32_t)tinyexr::miniz::mz_adler32(iAdler, (const unsigned char*)pData, iSize);
+		}
+
+		uint32_t Crc32(uint32_t iCrc, const void* pData, size_t iSize)
+		{
+			if (iSize == 0)
+				return iCrc;
+			return (uint32_t)tinyexr::miniz::mz_crc32(iCrc, (const unsigned char*)pData, iSize);
+		}
+
+		uint32_t Adler32Combine(uint32_t iAdler1, uint32_t iAdler2, size_t iSize2)
+		{
+			// Same as zlib adler32_combine
+			const uint32_t c_iBase = 65521;
+			uint32_t iRem = (uint32_t)(iSize2 % c_iBase);
+			uint32_t iSum1 = iAdler1 & 0xFFFF;
+			uint32_t iSum2 = (iRem * iSum1) % c_iBase;
+			iSum1 += (iAdler2 & 0xFFFF) + c_iBase - 1;
+			iSum2 += ((iAdler1 >> 16) & 0xFFFF) + ((iAdler2 >> 16) & 0xFFFF) + c_iBase - iRem;
+			if (iSum1 >= c_iBase) iSum1 -= c_iBase;
+			if (iSum1 >= c_iBase) iSum1 -= c_iBase;
+			if (iSum2 >= ((uint32_t)c_iBase << 1)) iSum2 -= ((uint32_t)c_iBase << 1);
+			if (iSum2 >= c_iBase) iSum2 -= c_iBase;
+			return iSum1 | (iSum2 << 16);
+		}
+	}
+	//namespace Deflate
+}
+//namespace Core
+
+#include "Graphics/EXR.h"
+
+namespace EXR
+{
+	bool CompressBlock(CompressionEnum eCompression, PixelTypeEnum ePixelType, int iChannelCount, int iWidth, int iLineCount, const void* pData, size_t iSize, Core::Array<unsigned char>* pOut)
+	{
+		if (pData == NULL || pOut == NULL || iSize == 0)
+			return false;
+
+		size_t iOffset = pOut->size();
+		switch (eCompression)
+		{
+		case CompressionEnum::NONE:
+		{
+			if (pOut->resize(iOffset + iSize) == false)
+				return false;
+			memcpy(&(*pOut)[iOffset], pData, iSize);
+			return true;
+		}
+		case CompressionEnum::RLE:
+		{
+			tinyexr::tinyexr_uint64 iOutSize = (iSize * 3) / 2 + 1;
+			if (pOut->resize(iOffset + (size_t)iOutSize) == false)
+				return false;
+			tinyexr::CompressRle(&(*pOut)[iOffset], iOutSize, (const unsigned char*)pData, (unsigned long)iSize);
+			return pOut->resize(iOffset + (size_t)iOutSize);
+		}
+		case CompressionEnum::ZIPS:
+		case CompressionEnum::ZIP:
+		{
+			tinyexr::tinyexr_uint64 iOutSize = tinyexr::miniz::mz_compressBound((unsigned long)iSize);
+			if (pOut->resize(iOffset + (size_t)iOutSize) == false)
+				return false;
+			tinyexr::CompressZip(&(*pOut)[iOffset], iOutSize, (const unsigned char*)pData, (unsigned long)iSize);
+			return pOut->resize(iOffset + (size_t)iOutSize);
+		}
+		case CompressionEnum::PIZ:
+		{
+			std::vector<tinyexr::ChannelInfo> oChannels((size_t)iChannelCount);
+			for (int iChannel = 0; iChannel < iChannelCount; ++iChannel)
+			{
+				oChannels[iChannel].pixel_type = (int)ePixelType;
+				oChannels[iChannel].x_sampling = 1;
+				oChannels[iChannel].y_sampling = 1;
+				oChannels[iChannel].p_linear = 0;
+			}
+			// Same bound as tinyexr
+			unsigned int iOutSize = 8192 + (unsigned int)(2 * iSize);
+			if (pOut->resize(iOffset + iOutSize) == false)
+				return false;
+			if (tinyexr::CompressPiz(&(*pOut)[iOffset], &iOutSize, (const unsigned char*)pData, iSize, oChannels, iWidth, iLineCount) == false)
+				return false;
+			return pOut->resize(iOffset + iOutSize);
+		}
+		default:
+			return false;
+		}
+	}
+}
+//namespace EXR
@@ -50,6 +50,15 @@ Menus::Menus()
 	, m_iResizeNewWidth(0)
 	, m_iResizeNewHeight(0)
 	, m_fResizeRatio(0.f)
+	, m_bMipsNormalMapStoreLength(false)
+	, m_bMipsPreserveAlphaCoverage(false)
+	, m_fMipsAlphaCoverageReference(0.5f)
+	, m_iMipsFilter(Graphics::ResampleFilterEnum::DEFAULT)
+	, m_iMipsEdgeMode(Graphics::EdgeModeEnum::CLAMP)
+	, m_iResizeFilter(Graphics::ResampleFilterEnum::DEFAULT)
+	, m_iResizeEdgeMode(Graphics::EdgeModeEnum::CLAMP)
+	, m_iSpecularSampleCount(64)
+	, m_fSpecularTexelsPerSecond(0.0)
 {
 }
 
@@ -127,6 +136,53 @@ void Menus::OnMenu()
 			ImGui::EndMenu();
 		}
 
+		bool bIsCubemapLayout = oTexture.IsValid() && oTexture.GetFaceCount() == 1 && oTexture.IsArray() == false && oTexture.IsVolume() == false
+			&& Graphics::DetermineCubemapFormatFromImageSize(oTexture.GetWidth(), oTexture.GetHeight(), NULL, NULL);
+		if (ImGui::MenuItem("Convert to cubemap", NULL, false, bIsCubemapLayout))
+		{
+			ErrorCode oErr = Graphics::ConvertTextureToCubemap(oTexture, &oTexture);
+			CORE_VERIFY_OK(oErr);
+			if (oErr == ErrorCode::Ok)
+			{
+				Program::GetInstance()->UpdateTexture2DRes();
+			}
+		}
+
+		bool bIsCubemap = oTexture.IsValid() && oTexture.GetFaceCount() == Graphics::Texture::_E_FACE_COUNT && oTexture.IsArray() == false;
+		if (ImGui::BeginMenu("Convert cubemap to", bIsCubemap))
+		{
+			for (int iFormat = Graphics::E_CUBEMAPFORMAT_NONE + 1; iFormat < Graphics::_E_CUBEMAPFORMAT_COUNT; ++iFormat)
+			{
+				if (ImGui::MenuItem(Graphics::ECubemapFormat_string[iFormat]))
+				{
+					ErrorCode oErr = Graphics::ConvertCubemapToTexture(oTexture, (Graphics::ECubemapFormat)iFormat, &oTexture);
+					CORE_VERIFY_OK(oErr);
+					if (oErr == ErrorCode::Ok)
+					{
+						Program::GetInstance()->UpdateTexture2DRes();
+					}
+				}
+			}
+			ImGui::EndMenu();
+		}
+
+		if (ImGui::MenuItem("Prefilter specular (GGX)", NULL, false, bIsCubemap))
+		{
+			Graphics::SpecularFilterSettings oSpecularSettings;
+			oSpecularSettings.iSampleCount = m_iSpecularSampleCount;
+			ErrorCode oErr = Graphics::PrefilterSpecularCubemap(oTexture, &oTexture, &oSpecularSettings, &m_fSpecularTexelsPerSecond);
+			CORE_VERIFY_OK(oErr);
+			if (oErr == ErrorCode::Ok)
+			{
+				Program::GetInstance()->UpdateTexture2DRes();
+			}
+		}
+		ImGui::SliderInt("Specular samples", &m_iSpecularSampleCount, 1, 1024);
+		if (m_fSpecularTexelsPerSecond > 0.0)
+		{
+			ImGui::TextDisabled("Last prefilter : %.2f Mtexels/s", m_fSpecularTexelsPerSecond * 1e-6);
+		}
+
 		ImGui::Separator();
 
 		bool bIsResizablePixelFormat = oTexture.IsValid() && Graphics::IsPixelFormatResizable(oTexture.GetPixelFormat());
@@ -139,18 +195,41 @@ void Menus::OnMenu()
 			ImGui::SetTooltip("Resize not supported for this pixel format");
 		}
 
+		// Normal edit mode filters mips as normal maps
+		Graphics::MipSettings oMipSettings;
+		oMipSettings.bNormalMap = Program::GetInstance()->GetMode() == ProgramModeEnum::EDIT_NORMAL;
+		oMipSettings.bNormalMapStoreLength = m_bMipsNormalMapStoreLength;
+		oMipSettings.bPreserveAlphaCoverage = m_bMipsPreserveAlphaCoverage;
+		oMipSettings.fAlphaCoverageReference = m_fMipsAlphaCoverageReference;
+		oMipSettings.eFilter = (Graphics::ResampleFilterEnum)m_iMipsFilter;
+		oMipSettings.eEdgeMode = (Graphics::EdgeModeEnum)m_iMipsEdgeMode;
+
 		if (ImGui::MenuItem("Generate all mips", NULL, false, bIsResizablePixelFormat))
 		{
-			if (Graphics::GenerateMips(&oTexture, &oTexture, false) == ErrorCode::Ok)
+			if (Graphics::GenerateMips(&oTexture, &oTexture, false, &oMipSettings) == ErrorCode::Ok)
 				Program::GetInstance()->UpdateTexture2DRes();
 		}
 
 		if (ImGui::MenuItem("Generate missing mips", NULL, false, bIsResizablePixelFormat))
 		{
-			if (Graphics::GenerateMips(&oTexture, &oTexture, true) == ErrorCode::Ok)
+			if (Graphics::GenerateMips(&oTexture, &oTexture, true, &oMipSettings) == ErrorCode::Ok)
 				Program::GetInstance()->UpdateTexture2DRes();
 		}
 
+		if (oMipSettings.bNormalMap)
+		{
+			ImGui::MenuItem("Store normal length in alpha", NULL, &m_bMipsNormalMapStoreLength);
+		}
+
+		ImGui::MenuItem("Preserve alpha coverage", NULL, &m_bMipsPreserveAlphaCoverage);
+		if (m_bMipsPreserveAlphaCoverage)
+		{
+			ImGui::SliderFloat("Alpha test reference", &m_fMipsAlphaCoverageReference, 0.f, 1.f);
+		}
+
+		ImGui::Combo("Mips filter", &m_iMipsFilter, Graphics::ResampleFilterEnumStrings, Graphics::ResampleFilterEnum::_COUNT);
+		ImGui::Combo("Mips edges", &m_iMipsEdgeMode, Graphics::EdgeModeEnumStrings, Graphics::EdgeModeEnum::_COUNT);
+
 		ImGui::EndMenu();
 	}
 
@@ -191,6 +270,9 @@ void Menus::OnMenu()
 				m_iResizeNewWidth = (int)(m_iResizeNewHeight * m_fResizeRatio);
 		}
 
+		ImGui::Combo("Filter", &m_iResizeFilter, Graphics::ResampleFilterEnumStrings, Graphics::ResampleFilterEnum::_COUNT);
+		ImGui::Combo("Edges", &m_iResizeEdgeMode, Graphics::EdgeModeEnumStrings, Graphics::EdgeModeEnum::_COUNT);
+
 		if (oTexture.GetMipCount() > 1)
 		{
 			ImGui::TextDisabled("Mip maps will be erased");
@@ -198,7 +280,7 @@ void Menus::OnMenu()
 
 		if (ImGui::Button("Resize"))
 		{
-			ErrorCode oErr = Graphics::ResizeTexture(&oTexture, &oTexture, m_iResizeNewWidth, m_iResizeNewHeight);
+			ErrorCode oErr = Graphics::ResizeTexture(&oTexture, &oTexture, m_iResizeNewWidth, m_iResizeNewHeight, (Graphics::ResampleFilterEnum)m_iResizeFilter, (Graphics::EdgeModeEnum)m_iResizeEdgeMode);
 			CORE_VERIFY_OK(oErr);
 			if (oErr == ErrorCode::Ok)
 			{
@@ -14,6 +14,15 @@ protected:
 	int							m_iResizeNewWidth;
 	int							m_iResizeNewHeight;
 	double						m_fResizeRatio;
+	bool						m_bMipsNormalMapStoreLength;
+	bool						m_bMipsPreserveAlphaCoverage;
+	float						m_fMipsAlphaCoverageReference;
+	int							m_iMipsFilter;
+	int							m_iMipsEdgeMode;
+	int							m_iResizeFilter;
+	int							m_iResizeEdgeMode;
+	int							m_iSpecularSampleCount;
+	double						m_fSpecularTexelsPerSecond;
 };
 
 #endif //_MENUS_H_
\ No newline at end of file
@@ -171,14 +171,14 @@ bool Program::Run()
 {
 	m_pShortKeyManager->Manage(false);
 
-	if (m_oTexture.IsValid() && m_oDisplayOptions.iMip >= m_oTexture.GetMipCount())
+	if (m_oTexture.IsValid() && m_oDisplayOptions.iMip >= GraphicResources::Texture2D::GetDisplayMipCount(m_oTexture))
 	{
-		m_oDisplayOptions.iMip = m_oTexture.GetMipCount() - 1;
+		m_oDisplayOptions.iMip = GraphicResources::Texture2D::GetDisplayMipCount(m_oTexture) - 1;
 	}
 
-	if (m_oTexture.IsValid() && m_oDisplayOptions.iFace >= m_oTexture.GetFaceCount())
+	if (m_oTexture.IsValid() && m_oDisplayOptions.iFace >= GraphicResources::Texture2D::GetDisplayArraySize(m_oTexture))
 	{
-		m_oDisplayOptions.iFace = m_oTexture.GetFaceCount() - 1;
+		m_oDisplayOptions.iFace = GraphicResources::Texture2D::GetDisplayArraySize(m_oTexture) - 1;
 	}
 
 	return m_bRun && m_oImWindowMgr.Run(false) && m_oImWindowMgr.Run(true);
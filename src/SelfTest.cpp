@@ -0,0 +1,454 @@
+#include "SelfTest.h"
+
+#include "Graphics/Texture.h"
+#include "Graphics/TextureUtils.h"
+#include "Graphics/TiledTexture.h"
+#include "Graphics/TextureFingerprint.h"
+#include "Graphics/MipReduction.h"
+#include "Graphics/TextureLoaders/TextureLoaderDDS.h"
+#include "Graphics/TextureWriters/TextureWriterDDS.h"
+
+#include "Core/Array.h"
+#include "Core/MemoryStream.h"
+
+#include "Core/Assert.h"
+
+#include "Math/Math.h"
+
+#include <stdio.h>
+#include <string.h> // memcpy/memcmp
+#include <math.h> // sinf/cosf/fabsf
+
+namespace SelfTest
+{
+	using namespace Graphics;
+
+	// Smooth RGBA32F layers, pixels of rect [iX, iX + iWidth[ x [iY, iY + iHeight[ of mip 0 of the last layer follow a second pattern
+	static bool CreatePattern(int iWidth, int iHeight, int iArraySize, int iRectX, int iRectY, int iRectWidth, int iRectHeight, Texture* pOutTexture)
+	{
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = PixelFormatEnum::RGBA32_FLOAT;
+		oDesc.iWidth = iWidth;
+		oDesc.iHeight = iHeight;
+		oDesc.iArraySize = iArraySize;
+		if (pOutTexture->Create(oDesc) != ErrorCode::Ok)
+			return false;
+
+		for (int iLayer = 0; iLayer < iArraySize; ++iLayer)
+		{
+			const Texture::TextureFaceData& oFaceData = pOutTexture->GetData().GetFaceData(0, 0, iLayer);
+			for (int iY = 0; iY < iHeight; ++iY)
+			{
+				float* pLine = (float*)((char*)oFaceData.pData + (size_t)iY * oFaceData.iPitch);
+				for (int iX = 0; iX < iWidth; ++iX)
+				{
+					const bool bRect = iLayer == iArraySize - 1 && iX >= iRectX && iX < iRectX + iRectWidth && iY >= iRectY && iY < iRectY + iRectHeight;
+					const float fU = (float)iX / iWidth;
+					const float fV = (float)iY / iHeight;
+					pLine[iX * 4 + 0] = bRect ? 0.9f - 0.6f * fV : 0.5f + 0.4f * sinf(9.f * fU + iLayer) * cosf(7.f * fV);
+					pLine[iX * 4 + 1] = bRect ? 0.2f + 0.7f * fU : 0.5f + 0.3f * cosf(13.f * fU * fV);
+					pLine[iX * 4 + 2] = bRect ? ((iX / 3 + iY / 5) & 1 ? 0.8f : 0.3f) : fU * fV;
+					pLine[iX * 4 + 3] = bRect ? 0.6f : 1.f - 0.5f * fU;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Pattern is moved to the output when it already has the pixel format
+	static bool ConvertPattern(Texture* pPattern, PixelFormatEnum ePixelFormat, Texture* pOutTexture)
+	{
+		if (pPattern->GetPixelFormat() == ePixelFormat)
+		{
+			pOutTexture->Swap(*pPattern);
+			return true;
+		}
+		return ConvertPixelFormat(pPattern, pOutTexture, ePixelFormat) == ErrorCode::Ok;
+	}
+
+	// Copy mip 0 of all layers/faces to a single mip texture
+	static bool CopyFirstMip(const Texture& oTexture, Texture* pOutTexture)
+	{
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = oTexture.GetPixelFormat();
+		oDesc.iWidth = oTexture.GetWidth();
+		oDesc.iHeight = oTexture.GetHeight();
+		oDesc.iFaceCount = oTexture.GetFaceCount();
+		oDesc.iArraySize = oTexture.GetArraySize();
+		if (pOutTexture->Create(oDesc) != ErrorCode::Ok)
+			return false;
+		for (int iLayer = 0; iLayer < oTexture.GetArraySize(); ++iLayer)
+		{
+			for (int iFace = 0; iFace < oTexture.GetFaceCount(); ++iFace)
+			{
+				const Texture::TextureFaceData& oSrcFaceData = oTexture.GetData().GetFaceData(0, iFace, iLayer);
+				memcpy(pOutTexture->GetData().GetFaceData(0, iFace, iLayer).pData, oSrcFaceData.pData, oSrcFaceData.iSlicePitch);
+			}
+		}
+		return true;
+	}
+
+	// Mip reduction of a black and white checkerboard gives the average of the decoded pixels, for every format the reduction accepts:
+	// components packed across bytes can't be averaged byte per byte
+	static bool TestMipReduction(PixelFormatEnum ePixelFormat)
+	{
+		// Textures already in RGBA32F are read as is
+		const bool bFloat = ePixelFormat == PixelFormatEnum::RGBA32_FLOAT;
+		Texture oPattern, oSource, oSourceFloat, oDest, oDestFloat;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = PixelFormatEnum::RGBA32_FLOAT;
+		oDesc.iWidth = 2;
+		oDesc.iHeight = 2;
+		bool bResult = oPattern.Create(oDesc) == ErrorCode::Ok;
+		if (bResult)
+		{
+			const Texture::TextureFaceData& oFaceData = oPattern.GetData().GetFaceData(0, 0);
+			for (int iY = 0; iY < 2; ++iY)
+			{
+				float* pLine = (float*)((char*)oFaceData.pData + (size_t)iY * oFaceData.iPitch);
+				for (int iC = 0; iC < 2 * 4; ++iC)
+					pLine[iC] = ((iC / 4 + iY) & 1) ? 1.f : 0.f;
+			}
+		}
+
+		oDesc.ePixelFormat = ePixelFormat;
+		oDesc.iWidth = 1;
+		oDesc.iHeight = 1;
+		bResult = bResult
+			&& ConvertPattern(&oPattern, ePixelFormat, &oSource)
+			&& (bFloat || ConvertPixelFormat(&oSource, &oSourceFloat, PixelFormatEnum::RGBA32_FLOAT) == ErrorCode::Ok)
+			&& oDest.Create(oDesc) == ErrorCode::Ok;
+
+		if (bResult)
+		{
+			const Texture::TextureFaceData& oSrcFaceData = oSource.GetData().GetFaceData(0, 0);
+			const Texture::TextureFaceData& oDstFaceData = oDest.GetData().GetFaceData(0, 0);
+			bResult = MipReduction::Reduce(PixelFormatEnumInfos[ePixelFormat],
+				oSrcFaceData.pData, 2, 2, oSrcFaceData.iPitch, 0,
+				oDstFaceData.pData, 1, 1, oDstFaceData.iPitch, 0, 1)
+				&& (bFloat || ConvertPixelFormat(&oDest, &oDestFloat, PixelFormatEnum::RGBA32_FLOAT) == ErrorCode::Ok);
+		}
+
+		float fMaxError = 0.f;
+		if (bResult)
+		{
+			const Texture::TextureFaceData& oSrcFaceData = (bFloat ? oSource : oSourceFloat).GetData().GetFaceData(0, 0);
+			const float* pResult = (const float*)(bFloat ? oDest : oDestFloat).GetData().GetFaceData(0, 0).pData;
+			for (int iC = 0; iC < 4; ++iC)
+			{
+				float fAverage = 0.f;
+				for (int iY = 0; iY < 2; ++iY)
+				{
+					const float* pLine = (const float*)((const char*)oSrcFaceData.pData + (size_t)iY * oSrcFaceData.iPitch);
+					fAverage += pLine[iC] + pLine[4 + iC];
+				}
+				fMaxError = Math::Max(fMaxError, fabsf(pResult[iC] - fAverage / 4.f));
+			}
+		}
+
+		// 8 bits sRGB steps are up to 2/255 apart in linear around the average
+		const bool bSame = bResult && fMaxError <= 2.f / 255.f;
+
+		printf("Mip reduction %s : ", PixelFormatEnumInfos[ePixelFormat].pShortName);
+		if (bResult == false)
+			printf("FAILED (error)\n");
+		else if (bSame == false)
+			printf("FAILED (max error %f)\n", fMaxError);
+		else
+			printf("ok\n");
+		return bSame;
+	}
+
+	// Conversion chain gives the same pixels as the exact conversion through RGBA32F, for every 8 bits value
+	static bool TestConversion(PixelFormatEnum eSourcePixelFormat, PixelFormatEnum eDestPixelFormat)
+	{
+		Texture oRamp, oSource, oFloat, oResult, oReference;
+		Texture::Desc oDesc;
+		oDesc.ePixelFormat = PixelFormatEnum::RGBA8_UNORM;
+		oDesc.iWidth = 256;
+		oDesc.iHeight = 4;
+		bool bResult = oRamp.Create(oDesc) == ErrorCode::Ok;
+		if (bResult)
+		{
+			const Texture::TextureFaceData& oFaceData = oRamp.GetData().GetFaceData(0, 0);
+			for (int iY = 0; iY < oDesc.iHeight; ++iY)
+			{
+				unsigned char* pLine = (unsigned char*)oFaceData.pData + (size_t)iY * oFaceData.iPitch;
+				for (int iX = 0; iX < oDesc.iWidth; ++iX)
+				{
+					pLine[iX * 4 + 0] = (unsigned char)iX;
+					pLine[iX * 4 + 1] = (unsigned char)(255 - iX);
+					pLine[iX * 4 + 2] = (unsigned char)(iX * 7 + iY);
+					pLine[iX * 4 + 3] = (iY & 1) ? 255 : (unsigned char)iX;
+				}
+			}
+		}
+
+		bResult = bResult
+			&& ConvertPattern(&oRamp, eSourcePixelFormat, &oSource)
+			&& ConvertPixelFormat(&oSource, &oResult, eDestPixelFormat) == ErrorCode::Ok
+			&& ConvertPixelFormat(&oSource, &oFloat, PixelFormatEnum::RGBA32_FLOAT) == ErrorCode::Ok
+			&& ConvertPixelFormat(&oFloat, &oReference, eDestPixelFormat) == ErrorCode::Ok;
+
+		const bool bSame = bResult
+			&& memcmp(oResult.GetData().GetFaceData(0, 0).pData, oReference.GetData().GetFaceData(0, 0).pData, oReference.GetData().GetFaceData(0, 0).iSlicePitch) == 0;
+
+		printf("Conversion %s to %s : ", PixelFormatEnumInfos[eSourcePixelFormat].pShortName, PixelFormatEnumInfos[eDestPixelFormat].pShortName);
+		if (bResult == false)
+			printf("FAILED (error)\n");
+		else if (bSame == false)
+			printf("FAILED (differs from conversion through RGBA32F)\n");
+		else
+			printf("ok\n");
+		return bSame;
+	}
+
+	// GenerateDirtyMips after replacing a rect of mip 0 gives the same chain as GenerateMips of the new mip 0:
+	// updated footprints are equal to a full generation and don't seam against untouched regions
+	static bool TestDirtyMips(PixelFormatEnum ePixelFormat, int iWidth, int iHeight, const MipSettings& oSettings)
+	{
+		const int iArraySize = 2;
+		const int iRectX = 8;
+		const int iRectY = 12;
+		const int iRectWidth = 20;
+		const int iRectHeight = 16;
+		Texture oOldPattern, oNewPattern;
+		Texture oTexture, oNewFirstMip, oReferenceFirstMip, oReference;
+		bool bResult = CreatePattern(iWidth, iHeight, iArraySize, 0, 0, 0, 0, &oOldPattern)
+			&& CreatePattern(iWidth, iHeight, iArraySize, iRectX, iRectY, iRectWidth, iRectHeight, &oNewPattern)
+			&& ConvertPattern(&oOldPattern, ePixelFormat, &oTexture)
+			&& GenerateMips(&oTexture, &oTexture, false, &oSettings) == ErrorCode::Ok
+			&& ConvertPattern(&oNewPattern, ePixelFormat, &oNewFirstMip);
+
+		if (bResult)
+		{
+			// Block rows of the rect are copied in mip 0 of the last layer and marked
+			const Texture::TextureFaceData& oFaceData = oTexture.GetData().GetFaceData(0, 0, iArraySize - 1);
+			const Texture::TextureFaceData& oNewFaceData = oNewFirstMip.GetData().GetFaceData(0, 0, iArraySize - 1);
+			const PixelFormatInfos& oFormatInfos = PixelFormatEnumInfos[ePixelFormat];
+			CORE_ASSERT(iRectX % oFormatInfos.iBlockWidth == 0 && iRectY % oFormatInfos.iBlockHeight == 0);
+			for (int iBlockY = iRectY / oFormatInfos.iBlockHeight; iBlockY < (iRectY + iRectHeight + oFormatInfos.iBlockHeight - 1) / oFormatInfos.iBlockHeight; ++iBlockY)
+			{
+				const size_t iOffset = (size_t)iBlockY * oFaceData.iPitch + (size_t)(iRectX / oFormatInfos.iBlockWidth) * oFormatInfos.iBlockSize;
+				const size_t iSize = (size_t)((iRectWidth + oFormatInfos.iBlockWidth - 1) / oFormatInfos.iBlockWidth) * oFormatInfos.iBlockSize;
+				memcpy((char*)oFaceData.pData + iOffset, (const char*)oNewFaceData.pData + iOffset, iSize);
+			}
+			oTexture.MarkDirty(0, 0, iArraySize - 1, iRectX, iRectY, iRectWidth, iRectHeight);
+
+			bResult = GenerateDirtyMips(&oTexture, &oSettings) == ErrorCode::Ok
+				&& CopyFirstMip(oTexture, &oReferenceFirstMip)
+				&& GenerateMips(&oReferenceFirstMip, &oReference, false, &oSettings) == ErrorCode::Ok
+				&& oReference.GetMipCount() == oTexture.GetMipCount();
+		}
+
+		int iFirstDifferentMip = -1;
+		for (int iMip = 0; bResult && iMip < oTexture.GetMipCount() && iFirstDifferentMip < 0; ++iMip)
+		{
+			for (int iLayer = 0; iLayer < iArraySize; ++iLayer)
+			{
+				const Texture::TextureFaceData& oFaceData = oTexture.GetData().GetFaceData(iMip, 0, iLayer);
+				if (memcmp(oFaceData.pData, oReference.GetData().GetFaceData(iMip, 0, iLayer).pData, oFaceData.iSlicePitch) != 0)
+					iFirstDifferentMip = iMip;
+			}
+		}
+
+		printf("Dirty mips %s %dx%d %s%s : ", PixelFormatEnumInfos[ePixelFormat].pShortName, iWidth, iHeight, ResampleFilterEnumStrings[oSettings.eFilter], oSettings.bNormalMap ? " normal map" : "");
+		if (bResult == false)
+			printf("FAILED (error)\n");
+		else if (iFirstDifferentMip >= 0)
+			printf("FAILED (mip %d differs from GenerateMips)\n", iFirstDifferentMip);
+		else
+			printf("ok\n");
+		return bResult && iFirstDifferentMip < 0;
+	}
+
+	// Tiled GenerateMips gives the same chain as GenerateMips of the whole texture, odd sizes and tiles spanning the level borders included
+	static bool TestTiledMips(PixelFormatEnum ePixelFormat, int iWidth, int iHeight, int iTileSize)
+	{
+		Texture oPattern, oTexture, oReference, oTiledResult;
+		TiledTexture oTiled, oTiledMips;
+		TiledTexture::Desc oTiledDesc;
+		oTiledDesc.ePixelFormat = ePixelFormat;
+		oTiledDesc.iWidth = iWidth;
+		oTiledDesc.iHeight = iHeight;
+		oTiledDesc.iTileSize = iTileSize;
+		oTiledDesc.iMemoryBudget = 0; // Smallest cache, tiles go through the scratch files
+		bool bResult = CreatePattern(iWidth, iHeight, 1, 0, 0, 0, 0, &oPattern)
+			&& ConvertPattern(&oPattern, ePixelFormat, &oTexture)
+			&& GenerateMips(&oTexture, &oReference, false) == ErrorCode::Ok
+			&& oTiled.Create(oTiledDesc) == ErrorCode::Ok
+			&& oTiled.CopyFromTexture(oTexture) == ErrorCode::Ok
+			&& GenerateMips(&oTiled, &oTiledMips, false) == ErrorCode::Ok
+			&& oTiledMips.CopyToTexture(&oTiledResult) == ErrorCode::Ok
+			&& oTiledResult.GetMipCount() == oReference.GetMipCount();
+
+		int iFirstDifferentMip = -1;
+		for (int iMip = 0; bResult && iMip < oReference.GetMipCount() && iFirstDifferentMip < 0; ++iMip)
+		{
+			const Texture::TextureFaceData& oFaceData = oTiledResult.GetData().GetFaceData(iMip, 0);
+			if (memcmp(oFaceData.pData, oReference.GetData().GetFaceData(iMip, 0).pData, oFaceData.iSlicePitch) != 0)
+				iFirstDifferentMip = iMip;
+		}
+
+		printf("Tiled mips %s %dx%d tile %d : ", PixelFormatEnumInfos[ePixelFormat].pShortName, iWidth, iHeight, iTileSize);
+		if (bResult == false)
+			printf("FAILED (error)\n");
+		else if (iFirstDifferentMip >= 0)
+			printf("FAILED (mip %d differs from GenerateMips)\n", iFirstDifferentMip);
+		else
+			printf("ok\n");
+		return bResult && iFirstDifferentMip < 0;
+	}
+
+	// Streamed DDS file of tiled mips is identical to the DDS file of GenerateMips of the whole texture
+	static bool TestTiledDDS(PixelFormatEnum ePixelFormat, int iWidth, int iHeight, int iTileSize)
+	{
+		Texture oPattern, oTexture, oReference;
+		TiledTexture oTiled, oTiledMips;
+		bool bResult = CreatePattern(iWidth, iHeight, 1, 0, 0, 0, 0, &oPattern)
+			&& ConvertPattern(&oPattern, ePixelFormat, &oTexture)
+			&& GenerateMips(&oTexture, &oReference, false) == ErrorCode::Ok;
+
+		size_t iFileSize = 256;
+		for (int iMip = 0; bResult && iMip < oReference.GetMipCount(); ++iMip)
+			iFileSize += oReference.GetData().GetFaceData(iMip, 0).iSlicePitch;
+
+		Core::Array<char> oFiles;
+		bResult = bResult && oFiles.resize(iFileSize * 3);
+		bool bSame = false;
+		if (bResult)
+		{
+			Core::MemoryStream oSourceStream((void*)&oFiles[0], iFileSize);
+			Core::MemoryStream oReferenceStream((void*)&oFiles[iFileSize], iFileSize);
+			Core::MemoryStream oTiledStream((void*)&oFiles[iFileSize * 2], iFileSize);
+			bResult = TextureWriter::WriteDDSConverted(&oTexture, ePixelFormat, &oSourceStream) == ErrorCode::Ok
+				&& TextureWriter::WriteDDSConverted(&oReference, ePixelFormat, &oReferenceStream) == ErrorCode::Ok
+				&& oSourceStream.Seek(0, Core::Stream::SeekModeEnum::BEGIN)
+				&& TextureLoader::LoadTiledDDS(&oSourceStream, iTileSize, 0, &oTiled) == ErrorCode::Ok
+				&& GenerateMips(&oTiled, &oTiledMips, false) == ErrorCode::Ok
+				&& TextureWriter::WriteTiledDDS(&oTiledMips, &oTiledStream) == ErrorCode::Ok;
+			bSame = bResult
+				&& oTiledStream.Tell() == oReferenceStream.Tell()
+				&& memcmp(&oFiles[iFileSize], &oFiles[iFileSize * 2], oReferenceStream.Tell()) == 0;
+		}
+
+		printf("Tiled DDS %s %dx%d tile %d : ", PixelFormatEnumInfos[ePixelFormat].pShortName, iWidth, iHeight, iTileSize);
+		if (bResult == false)
+			printf("FAILED (error)\n");
+		else if (bSame == false)
+			printf("FAILED (file differs from GenerateMips)\n");
+		else
+			printf("ok\n");
+		return bResult && bSame;
+	}
+
+	// Perceptual hash read from a small mip is the hash of mip 0, sizes not multiple of 32 included
+	static bool TestFingerprintMips(PixelFormatEnum ePixelFormat, int iWidth, int iHeight)
+	{
+		Texture oPattern, oTexture, oMips;
+		TextureFingerprint oFingerprint, oMipsFingerprint;
+		bool bResult = CreatePattern(iWidth, iHeight, 1, iWidth / 3, iHeight / 4, iWidth / 5, iHeight / 3, &oPattern)
+			&& ConvertPattern(&oPattern, ePixelFormat, &oTexture)
+			&& GenerateMips(&oTexture, &oMips, false) == ErrorCode::Ok
+			&& ComputeTextureFingerprint(&oTexture, &oFingerprint) == ErrorCode::Ok
+			&& ComputeTextureFingerprint(&oMips, &oMipsFingerprint) == ErrorCode::Ok;
+
+		const int iDistance = bResult ? HammingDistance(oFingerprint.iPerceptualHash, oMipsFingerprint.iPerceptualHash) : 0;
+		printf("Fingerprint mips %s %dx%d : ", PixelFormatEnumInfos[ePixelFormat].pShortName, iWidth, iHeight);
+		if (bResult == false)
+			printf("FAILED (error)\n");
+		else if (iDistance != 0)
+			printf("FAILED (perceptual hashes differ by %d bits)\n", iDistance);
+		else
+			printf("ok\n");
+		return bResult && iDistance == 0;
+	}
+
+	int Run(int /*iArgCount*/, char** /*pArgs*/)
+	{
+		struct DirtyMipsCase
+		{
+			PixelFormatEnum			ePixelFormat;
+			int						iWidth;
+			int						iHeight;
+			ResampleFilterEnum		eFilter;
+			bool					bNormalMap;
+		};
+		const DirtyMipsCase c_oDirtyMipsCases[] =
+		{
+			{ PixelFormatEnum::RGBA8_UNORM, 128, 96, ResampleFilterEnum::DEFAULT, false },
+			{ PixelFormatEnum::RGBA8_UNORM, 100, 75, ResampleFilterEnum::DEFAULT, false },
+			{ PixelFormatEnum::RGBA8_UNORM_SRGB, 128, 96, ResampleFilterEnum::DEFAULT, false },
+			{ PixelFormatEnum::RGBA8_UNORM, 100, 75, ResampleFilterEnum::TRIANGLE, false },
+			{ PixelFormatEnum::RGBA8_UNORM, 128, 96, ResampleFilterEnum::DEFAULT, true },
+			{ PixelFormatEnum::RGBA32_FLOAT, 128, 96, ResampleFilterEnum::LANCZOS3, false },
+			{ PixelFormatEnum::R10G10B10A2_UNORM, 100, 75, ResampleFilterEnum::DEFAULT, false },
+			{ PixelFormatEnum::BC1, 128, 96, ResampleFilterEnum::DEFAULT, false },
+			{ PixelFormatEnum::BC1, 100, 76, ResampleFilterEnum::KAISER, false },
+			{ PixelFormatEnum::BC7, 128, 96, ResampleFilterEnum::DEFAULT, false },
+		};
+
+		int iFailed = 0;
+		for (int iFormat = 0; iFormat < PixelFormatEnum::_COUNT; ++iFormat)
+		{
+			const PixelFormatEnum ePixelFormat = (PixelFormatEnum)iFormat;
+			if (MipReduction::IsPixelFormatSupported(PixelFormatEnumInfos[ePixelFormat]) && TestMipReduction(ePixelFormat) == false)
+				++iFailed;
+		}
+
+		const PixelFormatEnum c_eConversionSources[] = { PixelFormatEnum::RGBA8_UNORM, PixelFormatEnum::RGB8_UNORM, PixelFormatEnum::BC7 };
+		for (int iSource = 0; iSource < (int)(sizeof(c_eConversionSources) / sizeof(c_eConversionSources[0])); ++iSource)
+		{
+			if (TestConversion(c_eConversionSources[iSource], PixelFormatEnum::RGBA16_FLOAT) == false)
+				++iFailed;
+		}
+
+		for (int iCase = 0; iCase < (int)(sizeof(c_oDirtyMipsCases) / sizeof(c_oDirtyMipsCases[0])); ++iCase)
+		{
+			const DirtyMipsCase& oCase = c_oDirtyMipsCases[iCase];
+			MipSettings oSettings;
+			oSettings.eFilter = oCase.eFilter;
+			oSettings.bNormalMap = oCase.bNormalMap;
+			if (TestDirtyMips(oCase.ePixelFormat, oCase.iWidth, oCase.iHeight, oSettings) == false)
+				++iFailed;
+		}
+
+		struct TiledMipsCase
+		{
+			PixelFormatEnum			ePixelFormat;
+			int						iWidth;
+			int						iHeight;
+			int						iTileSize;
+		};
+		const TiledMipsCase c_oTiledMipsCases[] =
+		{
+			{ PixelFormatEnum::RGBA8_UNORM, 256, 128, 32 },
+			{ PixelFormatEnum::RGBA8_UNORM, 301, 157, 32 },
+			{ PixelFormatEnum::RGBA8_UNORM_SRGB, 203, 99, 16 },
+			{ PixelFormatEnum::RGB8_UNORM, 97, 130, 16 },
+			{ PixelFormatEnum::R8_UNORM, 250, 3, 16 },
+			{ PixelFormatEnum::RGBA32_FLOAT, 75, 45, 16 },
+		};
+
+		for (int iCase = 0; iCase < (int)(sizeof(c_oTiledMipsCases) / sizeof(c_oTiledMipsCases[0])); ++iCase)
+		{
+			const TiledMipsCase& oCase = c_oTiledMipsCases[iCase];
+			if (TestTiledMips(oCase.ePixelFormat, oCase.iWidth, oCase.iHeight, oCase.iTileSize) == false)
+				++iFailed;
+		}
+
+		if (TestTiledDDS(PixelFormatEnum::RGBA8_UNORM, 301, 157, 32) == false)
+			++iFailed;
+		if (TestTiledDDS(PixelFormatEnum::RGBA32_FLOAT, 75, 45, 16) == false)
+			++iFailed;
+
+		if (TestFingerprintMips(PixelFormatEnum::RGBA8_UNORM, 1000, 600) == false)
+			++iFailed;
+		if (TestFingerprintMips(PixelFormatEnum::RGBA8_UNORM, 301, 157) == false)
+			++iFailed;
+
+		printf("%d failed\n", iFailed);
+		return iFailed == 0 ? 0 : 1;
+	}
+}
+//namespace SelfTest
@@ -0,0 +1,14 @@
+#ifndef __SELF_TEST_H__
+#define __SELF_TEST_H__
+
+/* Consistency checks of texture operations, run by Texeled --self-test
+Each check prints one line to stdout, failures give a non zero exit code.
+*/
+namespace SelfTest
+{
+	// Return the process exit code
+	int							Run(int iArgCount, char** pArgs);
+}
+//namespace SelfTest
+
+#endif //__SELF_TEST_H__
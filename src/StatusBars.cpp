@@ -41,6 +41,20 @@ void StatusBars::OnStatusBar()
 		ImGui::Text("%d", oTexture.GetHeight());
 		ImGui::PopFont();
 
+		//Depth
+		if (oTexture.GetDepth() > 1)
+		{
+			ImGui::PushFont(oFonts.pFontConsolas);
+			ImGui::SameLine();
+			ImGui::TextUnformatted("Depth:");
+			ImGui::PopFont();
+
+			ImGui::PushFont(oFonts.pFontConsolasBold);
+			ImGui::SameLine(0, 0);
+			ImGui::Text("%d", oTexture.GetDepth());
+			ImGui::PopFont();
+		}
+
 		//Face/Slice
 		if (oTexture.GetFaceCount() > 1)
 		{
@@ -55,6 +69,20 @@ void StatusBars::OnStatusBar()
 			ImGui::PopFont();
 		}
 
+		//Layers
+		if (oTexture.GetArraySize() > 1)
+		{
+			ImGui::PushFont(oFonts.pFontConsolas);
+			ImGui::SameLine();
+			ImGui::TextUnformatted("Layer:");
+			ImGui::PopFont();
+
+			ImGui::PushFont(oFonts.pFontConsolasBold);
+			ImGui::SameLine(0, 0);
+			ImGui::Text("%d", oTexture.GetArraySize());
+			ImGui::PopFont();
+		}
+
 		//Mips
 		if (oTexture.GetMipCount() > 1)
 		{
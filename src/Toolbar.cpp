@@ -4,8 +4,13 @@
 
 #include "Math/Math.h"
 
+#include "GraphicResources/Texture2D.h"
+
 #include "ImGuiUtils.h"
 
+#include <float.h> // FLT_MAX
+#include <math.h> // sqrt
+
 Toolbar::Toolbar()
 	: m_fBackupGamma(-1.f)
 {
@@ -104,10 +109,10 @@ void Toolbar::OnToolBar()
 
 	ImGui::PushItemWidth(200.f);
 	ImGui::SameLine();
-	ImGui::SliderInt("##Mip", &oDisplay.iMip, 0, Math::Max(0, oTexture.GetMipCount() - 1), "Mip:%.0f");
+	ImGui::SliderInt("##Mip", &oDisplay.iMip, 0, Math::Max(0, GraphicResources::Texture2D::GetDisplayMipCount(oTexture) - 1), "Mip:%.0f");
 
 	ImGui::SameLine();
-	ImGui::SliderInt("##Face", &oDisplay.iFace, 0, Math::Max(0, oTexture.GetFaceCount() - 1), "Face/Slice:%.0f");
+	ImGui::SliderInt("##Face", &oDisplay.iFace, 0, Math::Max(0, GraphicResources::Texture2D::GetDisplayArraySize(oTexture) - 1), "Face/Slice:%.0f");
 	ImGui::PopItemWidth();
 
 	ImGui::Checkbox("Show pixel grid", &oDisplay.bShowPixelGrid);
@@ -140,6 +145,70 @@ void Toolbar::OnToolBar()
 	}
 	ImGui::PopItemWidth();
 
+	ImGui::SameLine();
+	if (ImGui::Button("Auto##ColorRange"))
+	{
+		const Graphics::TextureStatistics* pStatistics = GetDisplayedStatistics();
+		if (pStatistics != NULL)
+		{
+			// Finite values of visible channels
+			float fMin = FLT_MAX;
+			float fMax = -FLT_MAX;
+			for (int iChannel = 0; iChannel < pStatistics->iChannelCount; ++iChannel)
+			{
+				const Graphics::ChannelStatistics& oChannel = pStatistics->oChannels[iChannel];
+				if ((oDisplay.eShowChannels & (1 << iChannel)) && oChannel.iFiniteCount > 0)
+				{
+					fMin = Math::Min(fMin, oChannel.fMin);
+					fMax = Math::Max(fMax, oChannel.fMax);
+				}
+			}
+			if (fMin <= fMax)
+			{
+				oDisplay.fRange[0] = fMin;
+				oDisplay.fRange[1] = Math::Max(fMax, fMin + c_fEpsylon);
+			}
+		}
+	}
+	if (ImGui::IsItemHovered())
+		ImGui::SetTooltip("Set range to min/max of visible channels");
+
+	ImGui::SameLine();
+	if (ImGui::Button("Statistics"))
+		ImGui::OpenPopup("Statistics");
+
+	if (ImGui::BeginPopup("Statistics"))
+	{
+		const Graphics::TextureStatistics* pStatistics = GetDisplayedStatistics();
+		if (pStatistics == NULL)
+		{
+			ImGui::TextDisabled("Statistics not available for this texture");
+		}
+		else
+		{
+			const char* const c_pChannelNames[4] = { "Red", "Green", "Blue", "Alpha" };
+			for (int iChannel = 0; iChannel < pStatistics->iChannelCount; ++iChannel)
+			{
+				const Graphics::ChannelStatistics& oChannel = pStatistics->oChannels[iChannel];
+				ImGui::PushID(iChannel);
+				ImGui::TextColored(oImageColor[iChannel], "%s", c_pChannelNames[iChannel]);
+				ImGui::Text("Min %g  Max %g  Mean %g  Std dev %g", oChannel.fMin, oChannel.fMax, oChannel.fMean, sqrt(oChannel.fVariance));
+				if (oChannel.iNaNCount > 0 || oChannel.iInfCount > 0)
+					ImGui::TextColored(ImVec4(1.f, 0.5f, 0.f, 1.f), "NaN %llu  Inf %llu", (unsigned long long)oChannel.iNaNCount, (unsigned long long)oChannel.iInfCount);
+
+				if (m_oHistogramValues.resize(pStatistics->iHistogramBinCount) && pStatistics->iHistogramBinCount > 0)
+				{
+					const uint64_t* pHistogram = pStatistics->GetHistogram(iChannel);
+					for (int iBin = 0; iBin < pStatistics->iHistogramBinCount; ++iBin)
+						m_oHistogramValues[iBin] = (float)pHistogram[iBin];
+					ImGui::PlotHistogram("##Histogram", m_oHistogramValues.begin(), pStatistics->iHistogramBinCount, 0, NULL, 0.f, FLT_MAX, ImVec2(256.f, 64.f));
+				}
+				ImGui::PopID();
+			}
+		}
+		ImGui::EndPopup();
+	}
+
 	char pFloatBuffer[65];
 	sprintf_s(pFloatBuffer, sizeof(pFloatBuffer), "%.1f", oDisplay.fGamma);
 
@@ -199,3 +268,28 @@ void Toolbar::OnToolBar()
 	}
 	ImGui::PopItemWidth();
 }
+
+const Graphics::TextureStatistics* Toolbar::GetDisplayedStatistics()
+{
+	const Graphics::Texture& oTexture = Program::GetInstance()->GetTexture();
+	const DisplayOptions& oDisplay = Program::GetInstance()->GetDisplayOptions();
+	if (oTexture.IsValid() == false)
+		return NULL;
+
+	int iMip = 0;
+	int iFace = 0;
+	int iLayer = 0;
+	if (oTexture.IsVolume() == false)
+	{
+		const int iElement = Math::Clamp(oDisplay.iFace, 0, GraphicResources::Texture2D::GetDisplayArraySize(oTexture) - 1);
+		iMip = Math::Clamp(oDisplay.iMip, 0, oTexture.GetMipCount() - 1);
+		iFace = iElement % oTexture.GetFaceCount();
+		iLayer = iElement / oTexture.GetFaceCount();
+	}
+
+	const Graphics::TextureStatistics* pStatistics = NULL;
+	ErrorCode oErr = m_oStatisticsCache.Get(&oTexture, iMip, iFace, iLayer, &pStatistics);
+	if (oErr != ErrorCode::Ok)
+		return NULL;
+	return pStatistics;
+}
@@ -3,6 +3,10 @@
 
 #include "ImWindow/ImwToolBar.h"
 
+#include "Core/Array.h"
+
+#include "Graphics/TextureStatistics.h"
+
 class Toolbar : ImWindow::ImwToolBar
 {
 public:
@@ -10,7 +14,12 @@ public:
 	~Toolbar();
 	virtual void				OnToolBar();
 protected:
+	// Statistics of the displayed mip and face, whole volume for volume textures
+	const Graphics::TextureStatistics*	GetDisplayedStatistics();
+
 	float						m_fBackupGamma;
+	Graphics::StatisticsCache	m_oStatisticsCache;
+	Core::Array<float>			m_oHistogramValues;
 };
 
 #endif //_TOOLBAR_H_
\ No newline at end of file
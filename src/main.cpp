@@ -4,6 +4,7 @@
 #include <crtdbg.h>
 
 #include "Program.h"
+#include "CommandLine.h"
 
 //#define CONSOLE
 
@@ -16,6 +17,19 @@ int main(int argc, char* argv[])
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 	//_CrtSetBreakAlloc(1337);
 
+	if (CommandLine::IsCommand(argc, argv))
+	{
+#ifndef CONSOLE
+		// Windows subsystem, write to the console of the calling shell
+		if (AttachConsole(ATTACH_PARENT_PROCESS))
+		{
+			freopen("CONOUT$", "w", stdout);
+			freopen("CONOUT$", "w", stderr);
+		}
+#endif //CONSOLE
+		return CommandLine::Run(argc, argv);
+	}
+
 #ifdef _DEBUG
 	AllocConsole();
 	AttachConsole(GetCurrentProcessId());